@@ -0,0 +1,159 @@
+/*******************************************************************************
+* Copyright © 2019 TRINAMIC Motion Control GmbH & Co. KG
+* (now owned by Analog Devices Inc.),
+*
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+// Descriptor driven axis parameter access, used by the TMC5160 and TMC5240 boards only.
+
+#include "AxisParameters.h"
+
+#define RECIPROCAL_MAX   0xFFFFF
+#define MICROSTEPS_MAX   256
+
+static inline uint32_t fieldMax(const AxisParameterTypeDef *parameter)
+{
+	return parameter->mask >> parameter->shift;
+}
+
+static int32_t reciprocal(int32_t value)
+{
+	return MIN(RECIPROCAL_MAX, (1 << 24) / ((value) ? value : 1));
+}
+
+// Field value to TMCL value
+static int32_t scaleRead(const AxisParameterTypeDef *parameter, int32_t value)
+{
+	switch(parameter->scaling)
+	{
+	case AP_SCALE_RECIPROCAL:
+		return reciprocal(value);
+	case AP_SCALE_MICROSTEPS:
+		return MICROSTEPS_MAX >> value;
+	default:
+		return value;
+	}
+}
+
+// TMCL value to field value. Returns false if the value has no field representation.
+static bool scaleWrite(const AxisParameterTypeDef *parameter, int32_t *value)
+{
+	switch(parameter->scaling)
+	{
+	case AP_SCALE_RECIPROCAL:
+		*value = reciprocal(*value);
+		return true;
+	case AP_SCALE_MICROSTEPS:
+		// Only powers of two are valid
+		for(int32_t mres = 0; mres <= 8; mres++)
+		{
+			if((MICROSTEPS_MAX >> mres) == *value)
+			{
+				*value = mres;
+				return true;
+			}
+		}
+		return false;
+	default:
+		return true;
+	}
+}
+
+const AxisParameterTypeDef *axisparameter_find(const AxisParameterTableTypeDef *table, uint8_t type)
+{
+	if(type >= table->count)
+		return NULL;
+
+	const AxisParameterTypeDef *parameter = &table->parameters[type];
+
+	return (parameter->flags & AP_RW) ? parameter : NULL;
+}
+
+uint32_t axisparameter_handle(const AxisParameterTableTypeDef *table, uint8_t readWrite, uint8_t motor, uint8_t type, int32_t *value)
+{
+	const AxisParameterTypeDef *parameter = axisparameter_find(table, type);
+	int32_t buffer;
+	int32_t min, max;
+
+	if(!parameter)
+		return TMC_ERROR_TYPE;
+
+	if(readWrite == READ)
+	{
+		if(!(parameter->flags & AP_READ))
+			return TMC_ERROR_TYPE;
+
+		table->readRegister(motor, parameter->address, &buffer);
+		buffer = ((uint32_t) buffer & parameter->mask) >> parameter->shift;
+
+		if((parameter->flags & AP_SIGNED) && (fieldMax(parameter) != 0xFFFFFFFF))
+		{
+			// Sign-extend from the top bit of the field
+			uint32_t signBit = (fieldMax(parameter) >> 1) + 1;
+			buffer = (int32_t) (((uint32_t) buffer ^ signBit) - signBit);
+		}
+
+		*value = scaleRead(parameter, buffer);
+	}
+	else if(readWrite == WRITE)
+	{
+		if(!(parameter->flags & AP_WRITE))
+			return TMC_ERROR_TYPE;
+
+		axisparameter_getLimit(table, LIMIT_MIN, type, &min);
+		axisparameter_getLimit(table, LIMIT_MAX, type, &max);
+		if((*value < min) || (*value > max))
+			return TMC_ERROR_VALUE;
+
+		int32_t field = *value;
+		if(!scaleWrite(parameter, &field))
+			return TMC_ERROR_VALUE;
+
+		if(parameter->mask == 0xFFFFFFFF)
+		{
+			buffer = field;
+		}
+		else
+		{
+			table->readRegister(motor, parameter->address, &buffer);
+			buffer = ((uint32_t) buffer & ~parameter->mask) | (((uint32_t) field << parameter->shift) & parameter->mask);
+		}
+
+		table->writeRegister(motor, parameter->address, buffer);
+	}
+
+	return TMC_ERROR_NONE;
+}
+
+uint32_t axisparameter_getLimit(const AxisParameterTableTypeDef *table, AxisParameterLimit limit, uint8_t type, int32_t *value)
+{
+	const AxisParameterTypeDef *parameter = axisparameter_find(table, type);
+
+	if(!parameter)
+		return TMC_ERROR_TYPE;
+
+	uint32_t max = fieldMax(parameter);
+
+	if(parameter->scaling == AP_SCALE_RECIPROCAL)
+	{
+		*value = (limit == LIMIT_MIN) ? 0 : RECIPROCAL_MAX;
+	}
+	else if(parameter->scaling == AP_SCALE_MICROSTEPS)
+	{
+		*value = (limit == LIMIT_MIN) ? 1 : MICROSTEPS_MAX;
+	}
+	else if(parameter->flags & AP_SIGNED)
+	{
+		// Two's complement range of the field: -2^(n-1) .. 2^(n-1)-1
+		*value = (limit == LIMIT_MIN) ? -(int32_t) (max >> 1) - 1 : (int32_t) (max >> 1);
+	}
+	else
+	{
+		*value = (limit == LIMIT_MIN) ? 0 : (int32_t) MIN(max, (uint32_t) s32_MAX);
+	}
+
+	return TMC_ERROR_NONE;
+}
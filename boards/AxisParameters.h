@@ -0,0 +1,65 @@
+/*******************************************************************************
+* Copyright © 2019 TRINAMIC Motion Control GmbH & Co. KG
+* (now owned by Analog Devices Inc.),
+*
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#ifndef AXISPARAMETERS_H_
+#define AXISPARAMETERS_H_
+
+	#include "Board.h"
+
+	// Access flags of an axis parameter descriptor. A descriptor without
+	// any flags is an empty table slot, the board handles that type itself.
+	#define AP_READ    (1<<0)
+	#define AP_WRITE   (1<<1)
+	#define AP_SIGNED  (1<<2) // Field is two's complement, sign-extend on read
+
+	#define AP_RW      (AP_READ | AP_WRITE)
+
+	// Conversion between the TMCL value and the register field
+	typedef enum
+	{
+		AP_SCALE_NONE,
+		AP_SCALE_RECIPROCAL, // Velocity thresholds given as time between steps: field = 2^24 / value, limited to 0xFFFFF
+		AP_SCALE_MICROSTEPS  // Microsteps per fullstep (1 .. 256) stored as MRES: field = log2(256 / value)
+	} AxisParameterScaling;
+
+	// One descriptor per TMCL axis parameter type. The value range is derived
+	// from the field width and the scaling, so TMCL_MIN/TMCL_MAX need no extra data.
+	// Only the TMC5160 and TMC5240 boards use these tables. All other boards decode
+	// their parameters in their own handleParameter() switch and are not converted.
+	typedef struct
+	{
+		uint32_t mask;
+		uint8_t address;
+		uint8_t shift;
+		uint8_t flags;
+		uint8_t scaling;
+	} AxisParameterTypeDef;
+
+	typedef struct
+	{
+		const AxisParameterTypeDef *parameters; // Indexed by axis parameter type
+		uint16_t count;
+		void (*readRegister)(uint8_t motor, uint8_t address, int32_t *value);
+		void (*writeRegister)(uint8_t motor, uint8_t address, int32_t value);
+	} AxisParameterTableTypeDef;
+
+	// Descriptor helpers for use with designated initializers: [type] = AP_FIELD(...)
+	#define AP_FIELD(address, mask, shift, flags)  { (mask), (address), (shift), (flags), AP_SCALE_NONE }
+	#define AP_REGISTER(address, mask, flags)      { (mask), (address), 0, (flags), AP_SCALE_NONE }
+
+	#define AP_FIELD_SCALED(address, mask, shift, flags, scaling)  { (mask), (address), (shift), (flags), (scaling) }
+	#define AP_REGISTER_SCALED(address, mask, flags, scaling)      { (mask), (address), 0, (flags), (scaling) }
+
+	#define AP_TABLE(table, read, write)  { (table), ARRAY_SIZE(table), (read), (write) }
+
+	const AxisParameterTypeDef *axisparameter_find(const AxisParameterTableTypeDef *table, uint8_t type);
+	uint32_t axisparameter_handle(const AxisParameterTableTypeDef *table, uint8_t readWrite, uint8_t motor, uint8_t type, int32_t *value);
+	uint32_t axisparameter_getLimit(const AxisParameterTableTypeDef *table, AxisParameterLimit limit, uint8_t type, int32_t *value);
+
+#endif /* AXISPARAMETERS_H_ */
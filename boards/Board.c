@@ -9,6 +9,9 @@
 
 #include "Board.h"
 
+// Reads of the probe register that have to match for an SPI clock to count as reliable
+#define SPI_PROBE_READS  16
+
 MotionControllerBoards motionControllerBoards;
 DriverBoards driverBoards;
 
@@ -73,6 +76,30 @@ static uint32_t dummy_getLimit(uint8_t type, uint8_t motor, int32_t *value)
 	return TMC_ERROR_FUNCTION;
 }
 
+static uint32_t dummy_readBlock(uint16_t address, uint8_t *data, size_t length)
+{
+	UNUSED(address);
+	UNUSED(data);
+	UNUSED(length);
+	return TMC_ERROR_FUNCTION;
+}
+
+static uint32_t dummy_writeBlock(uint16_t address, const uint8_t *data, size_t length)
+{
+	UNUSED(address);
+	UNUSED(data);
+	UNUSED(length);
+	return TMC_ERROR_FUNCTION;
+}
+
+static uint32_t dummy_readSnapshot(uint8_t *data, size_t size, size_t *length)
+{
+	UNUSED(data);
+	UNUSED(size);
+	UNUSED(length);
+	return TMC_ERROR_FUNCTION;
+}
+
 static uint8_t dummy_onPinChange(IOPinTypeDef *pin, IO_States state)
 {
 	UNUSED(pin);
@@ -156,6 +183,9 @@ void board_setDummyFunctions(EvalboardFunctionsTypeDef *channel)
 	channel->fullCover         = NULL;
 	channel->getMin            = dummy_getLimit;
 	channel->getMax            = dummy_getLimit;
+	channel->readBlock         = dummy_readBlock;
+	channel->writeBlock        = dummy_writeBlock;
+	channel->readSnapshot      = dummy_readSnapshot;
 	channel->onPinChange       = dummy_onPinChange;
 
 	channel->OTP_init          = dummy_OTP_init;
@@ -164,6 +194,124 @@ void board_setDummyFunctions(EvalboardFunctionsTypeDef *channel)
 	channel->OTP_program       = dummy_OTP_program;
 	channel->OTP_status        = dummy_OTP_status;
 	channel->OTP_lock          = dummy_OTP_lock;
+
+	board_releaseSPIProfile(channel);
+}
+
+// Give the bus back at the clock it had before the profile of the previous board
+void board_releaseSPIProfile(EvalboardFunctionsTypeDef *channel)
+{
+	if(channel->spiProfile.channel && channel->spiProfile.previousFrequency)
+		spi_setFrequency(channel->spiProfile.channel, channel->spiProfile.previousFrequency);
+
+	channel->spiProfile = SPI_PROFILE(NULL, 0, 0, 0, 0, 0);
+}
+
+// Read the probe register a couple of times and check the known bits
+static bool probeSPI(SPIProfileTypeDef *profile)
+{
+	int32_t value;
+
+	for(uint32_t i = 0; i < SPI_PROBE_READS; i++)
+	{
+		spi_readIntArray(profile->channel, &profile->probeAddress, &value, 1);
+		if(((uint32_t) value & profile->probeMask) != profile->probeValue)
+			return false;
+	}
+
+	return true;
+}
+
+// Switch the bus of a board to the clock of its profile.
+// With probing the clock gets lowered until the probe register reads back correctly,
+// then raised step by step up to the profile maximum while it keeps doing so.
+// The result stays one step below the fastest clock that passed as margin.
+// Returns the frequency set or 0 for boards without a profile.
+uint32_t board_applySPIProfile(EvalboardFunctionsTypeDef *channel, bool probe)
+{
+	SPIProfileTypeDef *profile = &channel->spiProfile;
+	uint32_t specified, frequency, margin, next;
+
+	if(!profile->channel || !profile->frequency)
+		return 0;
+
+	if(!profile->previousFrequency)
+		profile->previousFrequency = spi_getFrequency(profile->channel);
+
+	specified = frequency = spi_setFrequency(profile->channel, profile->frequency);
+
+	if(!probe || !profile->probeMask || !frequency)
+		return frequency;
+
+	while(!probeSPI(profile))
+	{
+		next = spi_setFrequency(profile->channel, frequency / 2);
+		if(!next || next >= frequency)
+		{
+			// No valid readback at any clock, the chip is probably not powered. Keep the profile clock.
+			return spi_setFrequency(profile->channel, profile->frequency);
+		}
+		frequency = next;
+	}
+
+	// The specified clock failed -> the step below the passing one, otherwise the specified clock
+	margin = (frequency < specified) ? frequency / 2 : frequency;
+
+	while(frequency < profile->maxFrequency)
+	{
+		next = spi_setFrequency(profile->channel, MIN(2 * frequency, profile->maxFrequency));
+		if(!next || next <= frequency || !probeSPI(profile))
+			break;
+		margin = frequency;
+		frequency = next;
+	}
+
+	next = spi_setFrequency(profile->channel, margin);
+
+	return (next) ? next : spi_setFrequency(profile->channel, frequency);
+}
+
+// Read the registers of a status snapshot and pack them into <data> as little endian 32 bit values.
+// The reads are pipelined over <spi>, boards on a bus without pipelining pass NULL and a <readInt> function.
+uint32_t board_readSnapshot(SPIChannelTypeDef *spi, int32_t (*readInt)(uint8_t address),
+		const SnapshotRegisterTypeDef *registers, uint8_t count, uint8_t *data, size_t size, size_t *length)
+{
+	uint8_t addresses[BOARD_SNAPSHOT_MAX];
+	int32_t values[BOARD_SNAPSHOT_MAX];
+
+	if(count > BOARD_SNAPSHOT_MAX)
+		return TMC_ERROR_VALUE;
+
+	if(size < count * 4)
+		return TMC_ERROR_VALUE;
+
+	for(uint8_t i = 0; i < count; i++)
+		addresses[i] = registers[i].address;
+
+	if(spi)
+	{
+		spi_readIntArray(spi, addresses, values, count);
+	}
+	else
+	{
+		for(uint8_t i = 0; i < count; i++)
+			values[i] = readInt(addresses[i]);
+	}
+
+	for(uint8_t i = 0; i < count; i++)
+	{
+		if(registers[i].signedBits)
+			values[i] = CAST_Sn_TO_S32(values[i], registers[i].signedBits);
+
+		data[4*i + 0] = values[i] & 0xFF;
+		data[4*i + 1] = (values[i] >> 8) & 0xFF;
+		data[4*i + 2] = (values[i] >> 16) & 0xFF;
+		data[4*i + 3] = (values[i] >> 24) & 0xFF;
+	}
+
+	*length = count * 4;
+
+	return TMC_ERROR_NONE;
 }
 
 void periodicJobDummy(uint32_t tick)
@@ -42,6 +42,16 @@
 #include "tmc/ic/TMC8461/TMC8461.h"
 #include "tmc/ic/TMC8462/TMC8462.h"
 
+// Evalboards compiled into the firmware. By default all boards are included.
+// Building with BOARDS="<name> ..." (see Makefile) defines BOARD_SELECTION and BOARD_<name> for each
+// selected board, which trims the board assignment tables and the chip object unions.
+// Usage: #if BOARD_ENABLED(BOARD_TMC5160)
+#if defined(BOARD_SELECTION)
+	#define BOARD_ENABLED(board)  (board)
+#else
+	#define BOARD_ENABLED(board)  1
+#endif
+
 // parameter access (for axis parameters)
 #define READ   0
 #define WRITE  1
@@ -64,6 +74,29 @@ typedef enum {
 	OTP_STATUS_FAILED = 3
 } OTP_Status;
 
+// SPI clock profile of a board, filled in by the board init.
+// Without a profile the bus keeps the HAL default frequency.
+typedef struct
+{
+	SPIChannelTypeDef *channel;   // Bus of the chip, NULL: no profile
+	uint32_t frequency;           // Clock the chip is specified for under all conditions
+	uint32_t maxFrequency;        // Upper limit for probing, e.g. the limit with an external chip clock
+	uint8_t  probeAddress;        // Register read back while probing
+	uint32_t probeMask;           // Bits of the probe register with a known value, 0: no probing
+	uint32_t probeValue;
+	uint32_t previousFrequency;   // Bus clock before the profile got applied
+} SPIProfileTypeDef;
+
+#define SPI_PROFILE(spiChannel, freq, maxFreq, address, mask, value) \
+	((SPIProfileTypeDef) { .channel = (spiChannel), .frequency = (freq), .maxFrequency = (maxFreq), \
+	                       .probeAddress = (address), .probeMask = (mask), .probeValue = (value), .previousFrequency = 0 })
+
+// Fixed clock without probing
+#define SPI_PROFILE_FIXED(spiChannel, freq)  SPI_PROFILE(spiChannel, freq, freq, 0, 0, 0)
+
+// Probing reads the VERSION field (bits 31..24) of the IOIN register (0x04)
+#define SPI_PROFILE_IOIN(spiChannel, freq, maxFreq, version)  SPI_PROFILE(spiChannel, freq, maxFreq, 0x04, 0xFF000000, (uint32_t) (version) << 24)
+
 // Evalboard channel struct
 typedef struct
 {
@@ -104,8 +137,14 @@ typedef struct
 	uint32_t (*getMin)              (uint8_t type, uint8_t motor, int32_t *value);
 	uint32_t (*getMax)              (uint8_t type, uint8_t motor, int32_t *value);
 
+	uint32_t (*readBlock)           (uint16_t address, uint8_t *data, size_t length);        // Burst read of <length> bytes starting at <address>
+	uint32_t (*writeBlock)          (uint16_t address, const uint8_t *data, size_t length);  // Burst write of <length> bytes starting at <address>
+	uint32_t (*readSnapshot)        (uint8_t *data, size_t size, size_t *length);            // Status registers of all motors in one go, <length> bytes written to <data>
+
 	uint8_t (*onPinChange)(IOPinTypeDef *pin, IO_States state);
 
+	SPIProfileTypeDef spiProfile;
+
 	void (*OTP_init)(void);
 	void (*OTP_address)(uint32_t address);
 	void (*OTP_value)(uint32_t value);
@@ -144,6 +183,7 @@ typedef struct
 	EvalboardFunctionsTypeDef ch1;
 	EvalboardFunctionsTypeDef ch2;
 	DriverState driverEnable; // global driver status
+	bool spiProbe; // probe the fastest reliable SPI clock of boards with a profile on assignment
 } EvalboardsTypeDef;
 
 extern EvalboardsTypeDef Evalboards;
@@ -157,39 +197,98 @@ typedef enum {
 
 // Group all the motion controller chip objects into a single union to save memory,
 // since we will only ever use one driver at a time
+// The union only contains the chips of the selected boards, so a trimmed build also saves the RAM.
 typedef union {
+#if BOARD_ENABLED(BOARD_TMC4361A)
     TMC4361ATypeDef tmc4361A;
+#endif
+#if BOARD_ENABLED(BOARD_TMC5031)
     TMC5031TypeDef tmc5031;
+#endif
+#if BOARD_ENABLED(BOARD_TMC5041)
     TMC5041TypeDef tmc5041;
+#endif
+#if BOARD_ENABLED(BOARD_TMC5062)
     TMC5062TypeDef tmc5062;
+#endif
+#if BOARD_ENABLED(BOARD_TMC5072)
     TMC5072TypeDef tmc5072;
+#endif
+#if BOARD_ENABLED(BOARD_TMC5130)
     TMC5130TypeDef tmc5130;
+#endif
+#if BOARD_ENABLED(BOARD_TMC5160)
     TMC5160TypeDef tmc5160;
+#endif
+#if BOARD_ENABLED(BOARD_TMC8461)
     TMC8461TypeDef tmc8461;
+#endif
+#if BOARD_ENABLED(BOARD_TMC8462)
     TMC8462TypeDef tmc8462;
+#endif
+    uint8_t none; // keeps the union valid without any of the boards above
 } MotionControllerBoards;
 extern MotionControllerBoards motionControllerBoards;
 
 // Group all the driver chip objects into a single union to save memory,
 // since we will only ever use one motion controller at a time
 typedef union {
+#if BOARD_ENABLED(BOARD_TMC2130)
     TMC2130TypeDef tmc2130;
+#endif
+#if BOARD_ENABLED(BOARD_TMC2160)
     TMC2160TypeDef tmc2160;
+#endif
+#if BOARD_ENABLED(BOARD_TMC2208)
     TMC2208TypeDef tmc2208;
+#endif
+#if BOARD_ENABLED(BOARD_TMC2224)
     TMC2224TypeDef tmc2224;
+#endif
+#if BOARD_ENABLED(BOARD_TMC2590)
     TMC2590TypeDef tmc2590;
+#endif
+#if BOARD_ENABLED(BOARD_TMC2660)
     TMC2660TypeDef tmc2660;
+#endif
+#if BOARD_ENABLED(BOARD_TMC7300)
     TMC7300TypeDef tmc7300;
+#endif
+#if BOARD_ENABLED(BOARD_TMC2209)
     TMC2209TypeDef tmc2209;
+#endif
+#if BOARD_ENABLED(BOARD_TMC2225)
     TMC2225TypeDef tmc2225;
+#endif
+#if BOARD_ENABLED(BOARD_TMC2226)
     TMC2226TypeDef tmc2226;
+#endif
+#if BOARD_ENABLED(BOARD_TMC2300)
     TMC2300TypeDef tmc2300;
+#endif
+#if BOARD_ENABLED(BOARD_MAX22216)
 	MAX22216TypeDef max22216;
+#endif
+    uint8_t none; // keeps the union valid without any of the boards above
 } DriverBoards;
 extern DriverBoards driverBoards;
 
 void periodicJobDummy(uint32_t tick);
 void board_setDummyFunctions(EvalboardFunctionsTypeDef *channel);
+uint32_t board_applySPIProfile(EvalboardFunctionsTypeDef *channel, bool probe);
+void board_releaseSPIProfile(EvalboardFunctionsTypeDef *channel);
+
+// Register of a status snapshot, see board_readSnapshot()
+typedef struct
+{
+	uint8_t address;
+	uint8_t signedBits; // Sign extend the value from this width, 0 keeps it as read
+} SnapshotRegisterTypeDef;
+
+#define BOARD_SNAPSHOT_MAX  16 // Registers per snapshot
+
+uint32_t board_readSnapshot(SPIChannelTypeDef *spi, int32_t (*readInt)(uint8_t address),
+		const SnapshotRegisterTypeDef *registers, uint8_t count, uint8_t *data, size_t size, size_t *length);
 
 #include "TMCDriver.h"
 #include "TMCMotionController.h"
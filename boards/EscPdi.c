@@ -0,0 +1,311 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#include "EscPdi.h"
+#include "hal/Timer.h"
+#include "tmc/IdDetection.h"
+
+/*
+ * ESC SPI PDI framing. Three byte addressing is always used so the whole 16 bit
+ * ESC address space (registers and process RAM) is reachable:
+ *   A[12:5] | A[4:0] ADDR_EXT | A[15:13] CMD 00
+ * The ESC increments the address after every data byte, so a single chip select
+ * frame transfers a whole block.
+ */
+#define ESC_SPI_CMD_READ_WAIT   0x03 // Read, followed by one wait state byte
+#define ESC_SPI_CMD_WRITE       0x04
+#define ESC_SPI_CMD_ADDR_EXT    0x06
+#define ESC_SPI_WAIT_STATE      0xFF
+#define ESC_SPI_READ_TERMINATE  0xFF // Sent with the last byte of a read
+
+// SyncManager <n> configuration: physical start address, followed by the length
+#define ESC_SM_CONFIG(n)   (0x0800 + 8 * (n))
+#define ESC_SM_OUTPUTS     2 // Process data written by the master
+#define ESC_SM_INPUTS      3 // Process data read by the master
+
+// PDI cycle engine
+#define PDI_CYCLE_PDO_SIZE   128 // Maximum size of each process data area [bytes]
+#define PDI_CYCLE_TIME_MIN   50  // Interrupt and timer overhead on top of the SPI transfers [µs]
+#define PDI_TRANSFER_FACTOR  2   // The byte wise SPI access needs up to twice the pure bit time
+#define PDI_READ_OVERHEAD    4   // Address and wait state bytes of a read
+#define PDI_WRITE_OVERHEAD   3   // Address bytes of a write
+
+static void sendAddress(uint16_t address, uint8_t command);
+static uint32_t minCycleTime(void);
+static void pdiCycle(void);
+static void timer_overflow(timer_channel channel);
+
+static SPIChannelTypeDef *escSPI;
+
+// Cycles the process data through the PDI from the timer interrupt.
+static struct
+{
+	volatile bool running;
+	PdiPayload payload;
+	uint32_t cycleTime; // [µs]
+	uint16_t outputAddress;
+	uint16_t outputLength;
+	uint16_t inputAddress;
+	uint16_t inputLength;
+	uint32_t counter;
+	uint8_t data[PDI_CYCLE_PDO_SIZE];
+
+	// Statistics
+	uint32_t cycles;
+	uint32_t overruns;
+	uint32_t startTime;
+	uint32_t lastTime;
+	uint32_t minPeriod;
+	uint32_t maxPeriod;
+	uint32_t transferTime; // Accumulated time of the SPI transfers [µs]
+	uint64_t bytes;        // Accumulated SPI bytes including the protocol overhead
+} PdiCycle;
+
+void escpdi_init(SPIChannelTypeDef *spi)
+{
+	escpdi_cycleStop();
+
+	escSPI = spi;
+
+	Timer.overflow_callback = timer_overflow;
+	Timer.init();
+}
+
+static void sendAddress(uint16_t address, uint8_t command)
+{
+	escSPI->readWrite((address >> 5) & 0xFF, false);
+	escSPI->readWrite(((address & 0x1F) << 3) | ESC_SPI_CMD_ADDR_EXT, false);
+	escSPI->readWrite(((address >> 8) & 0xE0) | (command << 2), false);
+}
+
+uint32_t escpdi_readBlock(uint16_t address, uint8_t *data, size_t length)
+{
+	// The auto increment does not wrap around the end of the address space
+	if(length == 0 || length > 0x10000UL - address)
+		return TMC_ERROR_VALUE;
+
+	sendAddress(address, ESC_SPI_CMD_READ_WAIT);
+	escSPI->readWrite(ESC_SPI_WAIT_STATE, false);
+
+	for(size_t i = 0; i < length - 1; i++)
+		data[i] = escSPI->readWrite(0x00, false);
+
+	data[length - 1] = escSPI->readWrite(ESC_SPI_READ_TERMINATE, true);
+
+	return TMC_ERROR_NONE;
+}
+
+uint32_t escpdi_writeBlock(uint16_t address, const uint8_t *data, size_t length)
+{
+	if(length == 0 || length > 0x10000UL - address)
+		return TMC_ERROR_VALUE;
+
+	sendAddress(address, ESC_SPI_CMD_WRITE);
+
+	for(size_t i = 0; i < length; i++)
+		escSPI->readWrite(data[i], (i == (length - 1))? true:false);
+
+	return TMC_ERROR_NONE;
+}
+
+// Shortest cycle time the current SPI clock allows for the configured process data [µs]
+static uint32_t minCycleTime(void)
+{
+	uint32_t frequency = spi_getFrequency(escSPI);
+	uint32_t bytes = 0;
+
+	if(frequency == 0)
+		return ~0;
+
+	if(PdiCycle.outputLength)
+		bytes += PdiCycle.outputLength + PDI_READ_OVERHEAD;
+
+	if(PdiCycle.inputLength)
+		bytes += PdiCycle.inputLength + PDI_WRITE_OVERHEAD;
+
+	uint64_t bitTime = ((uint64_t) bytes * 8 * 1000000 + frequency - 1) / frequency;
+
+	return PDI_CYCLE_TIME_MIN + PDI_TRANSFER_FACTOR * bitTime;
+}
+
+static void pdiCycle(void)
+{
+	uint32_t now = systick_getMicrosecondTick();
+
+	if(PdiCycle.cycles == 0)
+	{
+		PdiCycle.startTime = now;
+	}
+	else
+	{
+		uint32_t period = now - PdiCycle.lastTime;
+
+		PdiCycle.minPeriod = MIN(PdiCycle.minPeriod, period);
+		PdiCycle.maxPeriod = MAX(PdiCycle.maxPeriod, period);
+
+		// At least one timer period passed without a cycle
+		if(period >= 2 * PdiCycle.cycleTime)
+			PdiCycle.overruns++;
+	}
+	PdiCycle.lastTime = now;
+
+	// Reading the whole output area releases the SyncManager buffer
+	if(PdiCycle.outputLength)
+	{
+		escpdi_readBlock(PdiCycle.outputAddress, PdiCycle.data, PdiCycle.outputLength);
+		PdiCycle.bytes += PdiCycle.outputLength + PDI_READ_OVERHEAD;
+	}
+
+	if(PdiCycle.inputLength)
+	{
+		switch(PdiCycle.payload)
+		{
+		case PDI_PAYLOAD_LOOPBACK:
+			for(uint16_t i = PdiCycle.outputLength; i < PdiCycle.inputLength; i++)
+				PdiCycle.data[i] = 0;
+			break;
+		case PDI_PAYLOAD_COUNTER:
+			for(uint16_t i = 0; i < PdiCycle.inputLength; i++)
+				PdiCycle.data[i] = BYTE(PdiCycle.counter, i % 4);
+			break;
+		}
+
+		escpdi_writeBlock(PdiCycle.inputAddress, PdiCycle.data, PdiCycle.inputLength);
+		PdiCycle.bytes += PdiCycle.inputLength + PDI_WRITE_OVERHEAD;
+	}
+
+	PdiCycle.counter++;
+	PdiCycle.cycles++;
+	PdiCycle.transferTime += systick_getMicrosecondTick() - now;
+}
+
+uint32_t escpdi_cycleStart(uint32_t cycleTime, uint8_t payload)
+{
+	uint8_t config[4];
+
+	escpdi_cycleStop();
+
+	if(cycleTime == 0)
+		return TMC_ERROR_NONE;
+
+	if(payload > PDI_PAYLOAD_COUNTER)
+		return TMC_ERROR_VALUE;
+
+	// The process data areas are taken from the SyncManager configuration
+	escpdi_readBlock(ESC_SM_CONFIG(ESC_SM_OUTPUTS), config, sizeof(config));
+	PdiCycle.outputAddress  = _8_16(config[1], config[0]);
+	PdiCycle.outputLength   = _8_16(config[3], config[2]);
+
+	escpdi_readBlock(ESC_SM_CONFIG(ESC_SM_INPUTS), config, sizeof(config));
+	PdiCycle.inputAddress   = _8_16(config[1], config[0]);
+	PdiCycle.inputLength    = _8_16(config[3], config[2]);
+
+	if(PdiCycle.outputLength == 0 && PdiCycle.inputLength == 0)
+		return TMC_ERROR_CHIP;
+
+	if(PdiCycle.outputLength > PDI_CYCLE_PDO_SIZE || PdiCycle.inputLength > PDI_CYCLE_PDO_SIZE)
+		return TMC_ERROR_VALUE;
+
+	// Each cycle has to finish its transfers before the next timer interrupt
+	if(cycleTime < minCycleTime())
+		return TMC_ERROR_VALUE;
+
+	PdiCycle.payload       = payload;
+	PdiCycle.cycleTime     = cycleTime;
+	PdiCycle.counter       = 0;
+	PdiCycle.cycles        = 0;
+	PdiCycle.overruns      = 0;
+	PdiCycle.minPeriod     = ~0;
+	PdiCycle.maxPeriod     = 0;
+	PdiCycle.transferTime  = 0;
+	PdiCycle.bytes         = 0;
+
+	// The ID detection swaps the SPI chip select for the EEPROM readout
+	IDDetection.paused = true;
+
+	Timer.setFrequency(TIMER_CHANNEL_2, 1000000 / cycleTime);
+	PdiCycle.running = true;
+
+	return TMC_ERROR_NONE;
+}
+
+void escpdi_cycleStop(void)
+{
+	PdiCycle.running = false;
+	IDDetection.paused = false;
+}
+
+bool escpdi_cycleRunning(void)
+{
+	return PdiCycle.running;
+}
+
+uint32_t escpdi_cycleStats(uint8_t type, int32_t *value)
+{
+	uint32_t cycles, elapsed, transferTime, minPeriod, maxPeriod, overruns;
+	uint64_t bytes;
+
+	// Copy the interrupt owned values again if a cycle ran in between
+	do
+	{
+		cycles        = PdiCycle.cycles;
+		elapsed       = PdiCycle.lastTime - PdiCycle.startTime;
+		transferTime  = PdiCycle.transferTime;
+		bytes         = PdiCycle.bytes;
+		minPeriod     = PdiCycle.minPeriod;
+		maxPeriod     = PdiCycle.maxPeriod;
+		overruns      = PdiCycle.overruns;
+	} while(cycles != *(volatile uint32_t *) &PdiCycle.cycles);
+
+	switch(type)
+	{
+	case 0: // Completed cycles
+		*value = cycles;
+		break;
+	case 1: // Average cycle time [µs]
+		*value = (cycles > 1)? elapsed / (cycles - 1) : 0;
+		break;
+	case 2: // Minimum cycle time [µs]
+		*value = (cycles > 1)? minPeriod : 0;
+		break;
+	case 3: // Maximum cycle time [µs]
+		*value = maxPeriod;
+		break;
+	case 4: // Peak to peak jitter [µs]
+		*value = (cycles > 1)? maxPeriod - minPeriod : 0;
+		break;
+	case 5: // Average SPI transfer time per cycle [µs]
+		*value = (cycles > 0)? transferTime / cycles : 0;
+		break;
+	case 6: // SPI bandwidth while transferring [bytes/s]
+		*value = (transferTime > 0)? (bytes * 1000000) / transferTime : 0;
+		break;
+	case 7: // Average SPI throughput [bytes/s]
+		*value = (elapsed > 0)? (bytes * 1000000) / elapsed : 0;
+		break;
+	case 8: // Cycles missed because the previous cycle did not finish in time
+		*value = overruns;
+		break;
+	case 9: // Cycle time of the running benchmark [µs], 0 if stopped
+		*value = (PdiCycle.running)? PdiCycle.cycleTime : 0;
+		break;
+	case 10: // Shortest accepted cycle time of the last started benchmark [µs]
+		*value = minCycleTime();
+		break;
+	default:
+		return TMC_ERROR_TYPE;
+	}
+
+	return TMC_ERROR_NONE;
+}
+
+static void timer_overflow(timer_channel channel)
+{
+	UNUSED(channel);
+
+	if(PdiCycle.running)
+		pdiCycle();
+}
@@ -0,0 +1,37 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#ifndef ESC_PDI_H_
+#define ESC_PDI_H_
+
+	#include "Board.h"
+
+	/*
+	 * SPI PDI access shared by the EtherCAT slave controller boards (TMC8461, TMC8462).
+	 *
+	 * The block functions transfer a whole block in a single chip select frame.
+	 * The PDI cycle engine reads the output process data and writes the input
+	 * process data from the timer interrupt to benchmark the PDI timing.
+	 */
+
+	typedef enum {
+		PDI_PAYLOAD_LOOPBACK, // Input PDOs mirror the output PDOs
+		PDI_PAYLOAD_COUNTER   // Input PDOs carry a cycle counter
+	} PdiPayload;
+
+	void escpdi_init(SPIChannelTypeDef *spi);
+
+	uint32_t escpdi_readBlock(uint16_t address, uint8_t *data, size_t length);
+	uint32_t escpdi_writeBlock(uint16_t address, const uint8_t *data, size_t length);
+
+	// While the cycle is running, the ESC SPI channel belongs to the timer interrupt.
+	// Boards reject all other ESC accesses while escpdi_cycleRunning() is true.
+	uint32_t escpdi_cycleStart(uint32_t cycleTime, uint8_t payload);
+	void escpdi_cycleStop(void);
+	bool escpdi_cycleRunning(void);
+	uint32_t escpdi_cycleStats(uint8_t type, int32_t *value);
+
+#endif /* ESC_PDI_H_ */
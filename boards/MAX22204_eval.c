@@ -190,10 +190,10 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 	case 9:
 		// VREF
 		if (readWrite == READ) {
-			*value = (uint32_t) ((1.0 - Timer.getDuty(MAX22204_VREF_TIMER)) * 100);
+			*value = ((TIMER_DUTY_MAX - Timer.getDuty(MAX22204_VREF_TIMER)) * 100) >> TIMER_DUTY_SHIFT;
 		} else {
 			if ((uint32_t) *value <= 100) {
-				Timer.setDuty(MAX22204_VREF_TIMER, 1.0 - ((float)(*value) / 100));
+				Timer.setDuty(MAX22204_VREF_TIMER, TIMER_DUTY_MAX - TIMER_DUTY(*value, 100));
 			} else {
 				errors |= TMC_ERROR_VALUE;
 			}
@@ -506,7 +506,7 @@ void MAX22204_init(void)
 	Timer.init();
 	Timer.setPeriodMin(MAX22204_RAMDEBUG_TIMER, 1000);
 	Timer.setFrequencyMin(MAX22204_RAMDEBUG_TIMER, 1000);
-	Timer.setDuty(MAX22204_RAMDEBUG_TIMER, 0.5);
+	Timer.setDuty(MAX22204_RAMDEBUG_TIMER, TIMER_DUTY_MAX / 2);
 
 	//enableDriver(DRIVER_USE_GLOBAL_ENABLE);
 }
@@ -184,16 +184,16 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 		// VREF
 		if (readWrite == READ) {
 			#if defined(Landungsbruecke) || defined(LandungsbrueckeSmall)
-			*value = (uint32_t) ((1.0 - Timer.getDuty(TIMER_CHANNEL_3)) * 100);
+			*value = ((TIMER_DUTY_MAX - Timer.getDuty(TIMER_CHANNEL_3)) * 100) >> TIMER_DUTY_SHIFT;
 			#elif defined(LandungsbrueckeV3)
-			*value = (uint32_t) ((1.0 - Timer.getDuty(TIMER_CHANNEL_4)) * 100);
+			*value = ((TIMER_DUTY_MAX - Timer.getDuty(TIMER_CHANNEL_4)) * 100) >> TIMER_DUTY_SHIFT;
 			#endif
 		} else {
 			if ((uint32_t) *value <= 100) {
 				#if defined(Landungsbruecke) || defined(LandungsbrueckeSmall)
-				Timer.setDuty(TIMER_CHANNEL_3, 1.0 - ((float)(*value) / 100));
+				Timer.setDuty(TIMER_CHANNEL_3, TIMER_DUTY_MAX - TIMER_DUTY(*value, 100));
 				#elif defined(LandungsbrueckeV3)
-				Timer.setDuty(TIMER_CHANNEL_4, 1.0 - ((float)(*value) / 100));
+				Timer.setDuty(TIMER_CHANNEL_4, TIMER_DUTY_MAX - TIMER_DUTY(*value, 100));
 				#endif
 			} else {
 				errors |= TMC_ERROR_VALUE;
@@ -514,12 +514,12 @@ void MAX22210_init(void)
 #if defined(Landungsbruecke) || defined(LandungsbrueckeSmall)
 	Timer.setPeriodMin(TIMER_CHANNEL_1, 1000);
 	Timer.setFrequencyMin(TIMER_CHANNEL_1, 1000);
-	Timer.setDuty(TIMER_CHANNEL_1, 0.5);
+	Timer.setDuty(TIMER_CHANNEL_1, TIMER_DUTY_MAX / 2);
 
 #else
 	Timer.setPeriodMin(TIMER_CHANNEL_2, 1000);
 	Timer.setFrequencyMin(TIMER_CHANNEL_2, 1000);
-	Timer.setDuty(TIMER_CHANNEL_2, 0.5);
+	Timer.setDuty(TIMER_CHANNEL_2, TIMER_DUTY_MAX / 2);
 #endif
 	//enableDriver(DRIVER_USE_GLOBAL_ENABLE);
 }
@@ -415,8 +415,7 @@ void MAX22216_init(void)
 
 	MAX22216_SPIChannel = &HAL.SPI->ch2;
 	MAX22216_SPIChannel->CSN = &HAL.IOs->pins->SPI2_CSN0;
-
-	spi_setFrequency(MAX22216_SPIChannel, 12000000);
+	Evalboards.ch2.spiProfile = SPI_PROFILE_FIXED(MAX22216_SPIChannel, 12000000);
 
 	HAL.IOs->config->toOutput(Pins.CNTL[0]);
 	HAL.IOs->config->toOutput(Pins.CNTL[1]);
@@ -19,5 +19,9 @@
 	#define	SELF_TEST_SET_AN_2        6
 	#define	SELF_TEST_SET_MIXED       7
 	#define	SELF_TEST_SET_EXTIO       8
+	#define	SELF_TEST_PINS_PARALLEL   9   // All pin pairs at once, motor 0: group A drives, 1: group B drives
+	#define	SELF_TEST_SPI_LOOPBACK    10  // SDO -> SDI loopback at every prescaler, motor = SPI channel
+	#define	SELF_TEST_UART_LOOPBACK   11  // UART TX pin check, static DIO17 -> DIO16 pair result
+	#define	SELF_TEST_RUN             12  // Pin and SPI tests, result vector via the snapshot command
 
 #endif /* SELF_TEST_H */
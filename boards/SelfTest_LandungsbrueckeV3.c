@@ -8,16 +8,99 @@
 
 
 #include "tmc/IdDetection.h"
+#include "hal/SysTick.h"
 #include "SelfTest.h"
 #include "Board.h"
 
+// On-target test engine for end-of-line testing with the self test adapter.
+// The adapter connects the pins of groupA[i] and groupB[i]. Besides the pin by
+// pin checks the engine offers:
+//  - Pin pairs tested in parallel: All pins of one group are driven at once with
+//    one write per GPIO port and read back with one read per port. Walking one and
+//    checkerboard patterns also catch shorts between neighbouring pairs.
+//  - SPI loopback (SDO -> SDI over the adapter) at every SPI prescaler with bit
+//    error count and throughput.
+//  - UART pin check of the USART2 TX pin (DIO17 -> DIO16). The adapter has no
+//    TX -> RX pair, so only the static pair result is reported, no bit errors or
+//    throughput. It runs on request (SELF_TEST_UART_LOOPBACK).
+// SELF_TEST_RUN executes the pin and SPI tests and returns a bit field of failed tests. The
+// whole result vector is read in one request with the snapshot command:
+//
+//  Offset | Size | Content
+//  -------+------+--------------------------------------------------------------
+//       0 |    4 | Failed tests (SELF_TEST_FAILED_* bits)
+//       4 |    4 | Pin pairs OK mask, group A driving
+//       8 |    4 | Pin pairs OK mask, group B driving
+//      12 | 8x8  | SPI channel 1 steps: frequency [Hz], bit errors (16 bit), throughput [kbit/s] (16 bit)
+//      76 | 8x8  | SPI channel 2 steps, same layout
+//     140 |    4 | UART pair DIO17 -> DIO16 of the last SELF_TEST_UART_LOOPBACK: 1 connected, 0 not connected
+//
+// All values are little endian. The bit error rate of a step is the bit errors
+// divided by the tested bits (SELF_TEST_SPI_BYTES times 8).
+
+#define SELF_TEST_ALL_PINS        ((1 << SELF_TEST_PINS_PER_GROUP) - 1)
+#define SELF_TEST_PIN_PATTERNS    (4 + SELF_TEST_PINS_PER_GROUP) // low, high, 2x checkerboard, walking one
+#define SELF_TEST_MAX_PORTS       5 // GPIOA - GPIOE
+#define SELF_TEST_SETTLE_CYCLES   (5 * SYSTICK_CYCLES_PER_MICROSECOND)
+
+#define SELF_TEST_SPI_STEPS       8 // Prescaler 2 to 256
+#define SELF_TEST_SPI_BYTES       256
+#define SELF_TEST_SPI_FREQUENCY   4000000 // Steps up to this frequency have to be error free
+
+#define SELF_TEST_FAILED_PINS_A   (1 << 0)
+#define SELF_TEST_FAILED_PINS_B   (1 << 1)
+#define SELF_TEST_FAILED_SPI1     (1 << 2)
+#define SELF_TEST_FAILED_SPI2     (1 << 3)
+#define SELF_TEST_FAILED_UART     (1 << 4)
+
+#define SELF_TEST_RESULT_SIZE     (12 + 8 * 2 * SELF_TEST_SPI_STEPS + 4)
+
+typedef struct
+{
+	uint32_t port;
+	volatile uint32_t *setBitRegister;
+	volatile uint32_t *resetBitRegister;
+	uint32_t set;
+	uint32_t reset;
+	uint32_t input;
+} SelfTestPortTypeDef;
+
+typedef struct
+{
+	uint32_t rate; // Frequency or baud rate
+	uint16_t bitErrors;
+	uint16_t throughput; // kbit/s
+} SelfTestStepTypeDef;
+
+typedef struct
+{
+	uint32_t failed;
+	uint32_t pins[2];
+	SelfTestStepTypeDef spi[2][SELF_TEST_SPI_STEPS];
+	uint32_t uart;
+} SelfTestResultsTypeDef;
+
 static void deInit();
 static uint32_t selfTest(uint8_t type, uint8_t motor, int32_t *value);
 static void periodicJob(uint32_t tick);
+static uint32_t readSnapshot(uint8_t *data, size_t size, size_t *length);
+static uint8_t *writeWord(uint8_t *data, uint32_t value, uint8_t bytes);
+static uint8_t *writeSteps(uint8_t *data, const SelfTestStepTypeDef *steps, uint32_t count);
+
+static uint8_t addPort(SelfTestPortTypeDef *ports, uint8_t *count, IOPinTypeDef *pin);
+static uint32_t pinPattern(uint8_t step);
+static uint32_t testPinsParallel(IOPinTypeDef **outGroup, IOPinTypeDef **inGroup);
+static uint8_t prbs7(uint8_t *state);
+static uint32_t testSPILoopback(uint8_t channel, SelfTestStepTypeDef *steps);
+static bool testPair(IOPinTypeDef *out, IOPinTypeDef *in);
+static uint32_t testUARTLoopback(void);
+static uint32_t runAll(void);
 
 IOPinTypeDef *groupA[SELF_TEST_PINS_PER_GROUP];
 IOPinTypeDef *groupB[SELF_TEST_PINS_PER_GROUP];
 
+static SelfTestResultsTypeDef results;
+
 void SelfTest_init()
 {
 	groupA[0]   = &HAL.IOs->pins->DIO6;
@@ -67,6 +150,7 @@ void SelfTest_init()
 	Evalboards.ch1.userFunction  = selfTest;
 	Evalboards.ch1.deInit        = deInit;
 	Evalboards.ch1.periodicJob   = periodicJob;
+	Evalboards.ch1.readSnapshot  = readSnapshot;
 
 	//EXTI_DeInit();
 }
@@ -122,6 +206,34 @@ static uint32_t selfTest(uint8_t type, uint8_t motor, int32_t *value)
 		result &= ((1<<SELF_TEST_PINS_PER_GROUP) - 1);
 		*value = result;
 		break;
+	case SELF_TEST_PINS_PARALLEL:
+		if(motor == 0)
+		{
+			results.pins[0] = testPinsParallel(groupA, groupB);
+			*value = results.pins[0];
+		}
+		else if(motor == 1)
+		{
+			results.pins[1] = testPinsParallel(groupB, groupA);
+			*value = results.pins[1];
+		}
+		else
+		{
+			errors |= TMC_ERROR_MOTOR;
+		}
+		break;
+	case SELF_TEST_SPI_LOOPBACK:
+		if(motor < 2)
+			*value = testSPILoopback(motor, results.spi[motor]);
+		else
+			errors |= TMC_ERROR_MOTOR;
+		break;
+	case SELF_TEST_UART_LOOPBACK:
+		*value = testUARTLoopback();
+		break;
+	case SELF_TEST_RUN:
+		*value = runAll();
+		break;
 	case SELF_TEST_READ_AN:
 		*value = motor;
 
@@ -235,3 +347,300 @@ static void periodicJob(uint32_t tick)
 		lastTick = tick;
 	}
 }
+
+static uint8_t *writeWord(uint8_t *data, uint32_t value, uint8_t bytes)
+{
+	for(uint8_t i = 0; i < bytes; i++)
+		*data++ = value >> (8*i);
+
+	return data;
+}
+
+static uint8_t *writeSteps(uint8_t *data, const SelfTestStepTypeDef *steps, uint32_t count)
+{
+	for(uint32_t i = 0; i < count; i++)
+	{
+		data = writeWord(data, steps[i].rate, 4);
+		data = writeWord(data, steps[i].bitErrors, 2);
+		data = writeWord(data, steps[i].throughput, 2);
+	}
+
+	return data;
+}
+
+static uint32_t readSnapshot(uint8_t *data, size_t size, size_t *length)
+{
+	if(size < SELF_TEST_RESULT_SIZE)
+		return TMC_ERROR_VALUE;
+
+	data = writeWord(data, results.failed, 4);
+	data = writeWord(data, results.pins[0], 4);
+	data = writeWord(data, results.pins[1], 4);
+	data = writeSteps(data, results.spi[0], SELF_TEST_SPI_STEPS);
+	data = writeSteps(data, results.spi[1], SELF_TEST_SPI_STEPS);
+	writeWord(data, results.uart, 4);
+
+	*length = SELF_TEST_RESULT_SIZE;
+
+	return TMC_ERROR_NONE;
+}
+
+// Find the port of a pin in the port table, adding it if necessary
+static uint8_t addPort(SelfTestPortTypeDef *ports, uint8_t *count, IOPinTypeDef *pin)
+{
+	uint8_t i;
+
+	for(i = 0; i < *count; i++)
+	{
+		if(ports[i].port == pin->port)
+			return i;
+	}
+
+	ports[i].port              = pin->port;
+	ports[i].setBitRegister    = pin->setBitRegister;
+	ports[i].resetBitRegister  = pin->resetBitRegister;
+	(*count)++;
+
+	return i;
+}
+
+static uint32_t pinPattern(uint8_t step)
+{
+	switch(step)
+	{
+	case 0:
+		return 0;
+	case 1:
+		return SELF_TEST_ALL_PINS;
+	case 2:
+		return 0x15555 & SELF_TEST_ALL_PINS;
+	case 3:
+		return 0x0AAAA & SELF_TEST_ALL_PINS;
+	default:
+		return 1 << (step - 4);
+	}
+}
+
+// Drive all pins of outGroup at once and check the levels on inGroup.
+// Returns a mask with a bit set for each pin pair that passed every pattern.
+static uint32_t testPinsParallel(IOPinTypeDef **outGroup, IOPinTypeDef **inGroup)
+{
+	SelfTestPortTypeDef outPorts[SELF_TEST_MAX_PORTS];
+	SelfTestPortTypeDef inPorts[SELF_TEST_MAX_PORTS];
+	uint8_t outPort[SELF_TEST_PINS_PER_GROUP];
+	uint8_t inPort[SELF_TEST_PINS_PER_GROUP];
+	uint8_t outCount = 0;
+	uint8_t inCount = 0;
+	uint32_t result = SELF_TEST_ALL_PINS;
+	uint32_t i, step;
+
+	// Switch the inputs first so no pair is driven from both sides
+	for(i = 0; i < SELF_TEST_PINS_PER_GROUP; i++)
+	{
+		HAL.IOs->config->toInput(inGroup[i]);
+		inPort[i] = addPort(inPorts, &inCount, inGroup[i]);
+	}
+
+	for(i = 0; i < SELF_TEST_PINS_PER_GROUP; i++)
+	{
+		HAL.IOs->config->toOutput(outGroup[i]);
+		outPort[i] = addPort(outPorts, &outCount, outGroup[i]);
+	}
+
+	for(step = 0; step < SELF_TEST_PIN_PATTERNS; step++)
+	{
+		uint32_t pattern = pinPattern(step);
+
+		for(i = 0; i < outCount; i++)
+		{
+			outPorts[i].set    = 0;
+			outPorts[i].reset  = 0;
+		}
+
+		for(i = 0; i < SELF_TEST_PINS_PER_GROUP; i++)
+		{
+			if(pattern & (1 << i))
+				outPorts[outPort[i]].set |= outGroup[i]->bitWeight;
+			else
+				outPorts[outPort[i]].reset |= outGroup[i]->bitWeight;
+		}
+
+		// One write per port and level
+		for(i = 0; i < outCount; i++)
+		{
+			*outPorts[i].setBitRegister    = outPorts[i].set;
+			*outPorts[i].resetBitRegister  = outPorts[i].reset;
+		}
+
+		uint32_t start = systick_getCycleCount();
+		while((systick_getCycleCount() - start) < SELF_TEST_SETTLE_CYCLES);
+
+		for(i = 0; i < inCount; i++)
+			inPorts[i].input = GPIO_ISTAT(inPorts[i].port);
+
+		for(i = 0; i < SELF_TEST_PINS_PER_GROUP; i++)
+		{
+			bool expected = (pattern & (1 << i)) != 0;
+			bool actual = (inPorts[inPort[i]].input & inGroup[i]->bitWeight) != 0;
+
+			// Dummy pins never read high and fail like in the pin by pin test
+			if(IS_DUMMY_PIN(inGroup[i]) || (expected != actual))
+				result &= ~(1 << i);
+		}
+	}
+
+	return result;
+}
+
+// Next 8 bits of a PRBS7 sequence (x^7 + x^6 + 1)
+static uint8_t prbs7(uint8_t *state)
+{
+	uint8_t byte = 0;
+
+	for(uint8_t i = 0; i < 8; i++)
+	{
+		uint8_t bit = ((*state >> 6) ^ (*state >> 5)) & 1;
+		*state = ((*state << 1) | bit) & 0x7F;
+		byte = (byte << 1) | bit;
+	}
+
+	return byte;
+}
+
+// Loop SDO back to SDI at every prescaler. The CSN pin paired with SCK on the
+// adapter is switched to input and the data register is accessed directly, so
+// the chip select does not fight the clock.
+// Returns the highest frequency without bit errors.
+static uint32_t testSPILoopback(uint8_t channel, SelfTestStepTypeDef *steps)
+{
+	static uint8_t pattern[SELF_TEST_SPI_BYTES];
+	SPIChannelTypeDef *spiChannel = (channel == 0)? &HAL.SPI->ch1 : &HAL.SPI->ch2;
+	uint32_t periphery = spiChannel->periphery;
+	uint32_t oldPrescaler = SPI_CTL0(periphery) & SPI_CTL0_PSC;
+	uint32_t maxFrequency = 0;
+	uint8_t state = 0x7F;
+	uint32_t i, step;
+
+	if(channel == 0)
+	{
+		HAL.IOs->config->toInput(&HAL.IOs->pins->SPI1_CSN);
+		HAL.IOs->config->reset(&HAL.IOs->pins->SPI1_SCK);
+		HAL.IOs->config->reset(&HAL.IOs->pins->SPI1_SDO);
+		HAL.IOs->config->reset(&HAL.IOs->pins->SPI1_SDI);
+	}
+	else
+	{
+		HAL.IOs->config->toInput(&HAL.IOs->pins->SPI2_CSN2);
+		HAL.IOs->config->reset(&HAL.IOs->pins->SPI2_SCK);
+		HAL.IOs->config->reset(&HAL.IOs->pins->SPI2_SDO);
+		HAL.IOs->config->reset(&HAL.IOs->pins->SPI2_SDI);
+	}
+
+	for(i = 0; i < SELF_TEST_SPI_BYTES; i++)
+		pattern[i] = prbs7(&state);
+
+	results.failed &= ~((channel == 0)? SELF_TEST_FAILED_SPI1 : SELF_TEST_FAILED_SPI2);
+
+	for(step = 0; step < SELF_TEST_SPI_STEPS; step++)
+	{
+		uint32_t bitErrors = 0;
+
+		SPI_CTL0(periphery) = (SPI_CTL0(periphery) & ~SPI_CTL0_PSC) | CTL0_PSC(step);
+		steps[step].rate = spi_getFrequency(spiChannel);
+
+		// Drop a stale byte
+		if(spi_i2s_flag_get(periphery, SPI_FLAG_RBNE) != RESET)
+			spi_i2s_data_receive(periphery);
+
+		uint32_t start = systick_getCycleCount();
+		for(i = 0; i < SELF_TEST_SPI_BYTES; i++)
+		{
+			while(spi_i2s_flag_get(periphery, SPI_FLAG_TBE) == RESET);
+			spi_i2s_data_transmit(periphery, pattern[i]);
+			while(spi_i2s_flag_get(periphery, SPI_FLAG_RBNE) == RESET);
+			bitErrors += __builtin_popcount((spi_i2s_data_receive(periphery) ^ pattern[i]) & 0xFF);
+		}
+		uint32_t cycles = systick_getCycleCount() - start;
+
+		steps[step].bitErrors   = bitErrors;
+		steps[step].throughput  = (SELF_TEST_SPI_BYTES * 8 * 1000 * SYSTICK_CYCLES_PER_MICROSECOND) / MAX(cycles, 1);
+
+		if(bitErrors == 0)
+			maxFrequency = MAX(maxFrequency, steps[step].rate);
+		else if(steps[step].rate <= SELF_TEST_SPI_FREQUENCY)
+			results.failed |= (channel == 0)? SELF_TEST_FAILED_SPI1 : SELF_TEST_FAILED_SPI2;
+	}
+
+	SPI_CTL0(periphery) = (SPI_CTL0(periphery) & ~SPI_CTL0_PSC) | oldPrescaler;
+
+	// Give the chip select back to the SPI configuration
+	if(channel == 0)
+		HAL.IOs->config->reset(&HAL.IOs->pins->SPI1_CSN);
+	else
+		HAL.IOs->config->reset(&HAL.IOs->pins->SPI2_CSN2);
+
+	return maxFrequency;
+}
+
+// Check that the adapter connects out to in with static levels
+static bool testPair(IOPinTypeDef *out, IOPinTypeDef *in)
+{
+	bool connected = true;
+
+	HAL.IOs->config->toInput(in);
+	HAL.IOs->config->toOutput(out);
+
+	for(uint8_t level = 0; level < 2; level++)
+	{
+		if(level)
+			HAL.IOs->config->setHigh(out);
+		else
+			HAL.IOs->config->setLow(out);
+
+		uint32_t start = systick_getCycleCount();
+		while((systick_getCycleCount() - start) < SELF_TEST_SETTLE_CYCLES);
+
+		if(HAL.IOs->config->isHigh(in) != (level != 0))
+			connected = false;
+	}
+
+	HAL.IOs->config->reset(out);
+	HAL.IOs->config->reset(in);
+
+	return connected;
+}
+
+// UART pin check: USART2 TX (DIO17) has no RX pin on the adapter, only the DIO17 -> DIO16
+// pair. A half-duplex loopback would only receive the TX pin itself, so there is no bit error
+// rate or throughput to measure, the static pair test is the whole UART result.
+// Returns 1 if the pair is connected.
+static uint32_t testUARTLoopback(void)
+{
+	results.uart = testPair(&HAL.IOs->pins->DIO17, &HAL.IOs->pins->DIO16);
+
+	if(results.uart)
+		results.failed &= ~SELF_TEST_FAILED_UART;
+	else
+		results.failed |= SELF_TEST_FAILED_UART;
+
+	return results.uart;
+}
+
+// Run the pin and SPI tests and return the failed test bits, the details are read with the snapshot command.
+// The UART pin check only runs as SELF_TEST_UART_LOOPBACK.
+static uint32_t runAll(void)
+{
+	results.pins[0] = testPinsParallel(groupA, groupB);
+	results.pins[1] = testPinsParallel(groupB, groupA);
+
+	results.failed = 0;
+	if(results.pins[0] != SELF_TEST_ALL_PINS)
+		results.failed |= SELF_TEST_FAILED_PINS_A;
+	if(results.pins[1] != SELF_TEST_ALL_PINS)
+		results.failed |= SELF_TEST_FAILED_PINS_B;
+
+	testSPILoopback(0, results.spi[0]);
+	testSPILoopback(1, results.spi[1]);
+
+	return results.failed;
+}
@@ -183,7 +183,7 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 		} else {
 			if ((uint32_t) *value < VREF_FULLSCALE) {
 				vref = *value;
-				Timer.setDuty(TIMER_CHANNEL_1, ((float)vref) / VREF_FULLSCALE);
+				Timer.setDuty(TIMER_CHANNEL_1, TIMER_DUTY(vref, VREF_FULLSCALE));
 			} else {
 				errors |= TMC_ERROR_VALUE;
 			}
@@ -218,7 +218,7 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 			if(((uint32_t) *value) > 10000)
 				errors |= TMC_ERROR_TYPE;
 			else
-				Timer.setDuty(TIMER_CHANNEL_1, ((float)*value) / TIMER_MAX);
+				Timer.setDuty(TIMER_CHANNEL_1, TIMER_DUTY(*value, TIMER_MAX));
 		}
 	break;
 
@@ -577,7 +577,7 @@ void TMC2100_init(void)
 	vref = 2000;
 	HAL.IOs->config->set(Pins.AIN_REF_PWM);
 	Timer.init();
-	Timer.setDuty(TIMER_CHANNEL_1, ((float)vref) / VREF_FULLSCALE);
+	Timer.setDuty(TIMER_CHANNEL_1, TIMER_DUTY(vref, VREF_FULLSCALE));
 
 	enableDriver(DRIVER_USE_GLOBAL_ENABLE);
 	reset();
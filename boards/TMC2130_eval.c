@@ -251,7 +251,7 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 		} else {
 			if ((uint32_t) *value < VREF_FULLSCALE) {
 				vref = *value;
-				Timer.setDuty(TIMER_CHANNEL_1, ((float)vref) / VREF_FULLSCALE);
+				Timer.setDuty(TIMER_CHANNEL_1, TIMER_DUTY(vref, VREF_FULLSCALE));
 			} else {
 				errors |= TMC_ERROR_VALUE;
 			}
@@ -741,7 +741,7 @@ static uint32_t userFunction(uint8_t type, uint8_t motor, int32_t *value)
 		if(uvalue <= 20000)
 		{
 			HAL.IOs->config->setToState(Pins.AIN_REF_SW, (uvalue > 10000) ? IOS_HIGH : IOS_LOW);
-			Timer.setDuty(TIMER_CHANNEL_1, ((float)(uvalue % 10001)) / TIMER_MAX);
+			Timer.setDuty(TIMER_CHANNEL_1, TIMER_DUTY(uvalue % 10001, TIMER_MAX));
 		}
 		else
 		{
@@ -909,6 +909,8 @@ void TMC2130_init(void)
 	TMC2130_SPIChannel       = &HAL.SPI->ch2;
 	TMC2130_SPIChannel->CSN  = &HAL.IOs->pins->SPI2_CSN0;
 
+	Evalboards.ch2.spiProfile = SPI_PROFILE_IOIN(TMC2130_SPIChannel, 4000000, 8000000, 0x11);
+
 	// Initialize the software StepDir generator
 	StepDir_init(STEPDIR_PRECISION);
 	StepDir_setPins(0, Pins.REFL_STEP, Pins.REFR_DIR, NULL);
@@ -949,7 +951,7 @@ void TMC2130_init(void)
 	vref = 2000;
 	HAL.IOs->config->set(Pins.AIN_REF_PWM);
 	Timer.init();
-	Timer.setDuty(TIMER_CHANNEL_1, ((float)vref) / VREF_FULLSCALE);
+	Timer.setDuty(TIMER_CHANNEL_1, TIMER_DUTY(vref, VREF_FULLSCALE));
 
 	enableDriver(DRIVER_USE_GLOBAL_ENABLE);
 }
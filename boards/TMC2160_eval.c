@@ -733,7 +733,7 @@ static uint32_t userFunction(uint8_t type, uint8_t motor, int32_t *value)
 		if(uvalue <= 20000)
 		{
 			//HAL.IOs->config->setToState(Pins.AIN_REF_SW, (uvalue > 10000) ? IOS_HIGH : IOS_LOW);
-			Timer.setDuty(TIMER_CHANNEL_1, ((float)(uvalue % 10001)) / TIMER_MAX);
+			Timer.setDuty(TIMER_CHANNEL_1, TIMER_DUTY(uvalue % 10001, TIMER_MAX));
 		}
 		else
 		{
@@ -896,6 +896,8 @@ void TMC2160_init(void)
 	TMC2160_SPIChannel       = &HAL.SPI->ch2;
 	TMC2160_SPIChannel->CSN  = &HAL.IOs->pins->SPI2_CSN0;
 
+	Evalboards.ch2.spiProfile = SPI_PROFILE_IOIN(TMC2160_SPIChannel, 4000000, 8000000, 0x30);
+
 	StepDir_init(STEPDIR_PRECISION);
 	StepDir_setPins(0, Pins.REFL_STEP, Pins.REFR_DIR, NULL);
 
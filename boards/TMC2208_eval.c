@@ -233,7 +233,7 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 		} else {
 			if ((uint32_t) *value < VREF_FULLSCALE) {
 				vref = *value;
-				Timer.setDuty(timerChannel, ((float)vref) / VREF_FULLSCALE);
+				Timer.setDuty(timerChannel, TIMER_DUTY(vref, VREF_FULLSCALE));
 			} else {
 				errors |= TMC_ERROR_VALUE;
 			}
@@ -404,7 +404,7 @@ void TMC2208_init(void)
 	vref = 2000;
 	HAL.IOs->config->set(Pins.UC_PWM);
 	Timer.init();
-	Timer.setDuty(timerChannel, ((float)vref) / VREF_FULLSCALE);
+	Timer.setDuty(timerChannel, TIMER_DUTY(vref, VREF_FULLSCALE));
 
 	enableDriver(DRIVER_ENABLE);
 };
@@ -9,6 +9,7 @@
 
 #include "Board.h"
 #include "tmc/ic/TMC2209/TMC2209.h"
+#include "tmc/LoadMonitor.h"
 #include "tmc/StepDir.h"
 
 #undef  TMC2209_MAX_VELOCITY
@@ -41,6 +42,7 @@ static uint32_t SAP(uint8_t type, uint8_t motor, int32_t value);
 
 static void checkErrors (uint32_t tick);
 static void deInit(void);
+static void loadMonitorRead(uint8_t motor, uint16_t *stallGuard, uint8_t *coolStep, int32_t *velocity);
 static uint32_t userFunction(uint8_t type, uint8_t motor, int32_t *value);
 
 static void periodicJob(uint32_t tick);
@@ -255,7 +257,7 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 		} else {
 			if ((uint32_t) *value < VREF_FULLSCALE) {
 				vref = *value;
-				Timer.setDuty(timerChannel, ((float)vref) / VREF_FULLSCALE);
+				Timer.setDuty(timerChannel, TIMER_DUTY(vref, VREF_FULLSCALE));
 			} else {
 				errors |= TMC_ERROR_VALUE;
 			}
@@ -591,10 +593,10 @@ static uint32_t userFunction(uint8_t type, uint8_t motor, int32_t *value)
 		*value = tmc2209_get_slave(motorToIC(motor));
 		break;
 	case 3:
-		*value = Timer.getDuty(timerChannel) * 100 / TIMER_MAX;
+		*value = (Timer.getDuty(timerChannel) * 100) >> TIMER_DUTY_SHIFT;
 		break;
 	case 4:
-		Timer.setDuty(timerChannel, ((float)*value) / 100);
+		Timer.setDuty(timerChannel, TIMER_DUTY(MIN(MAX(*value, 0), 100), 100));
 		break;
 	case 5: // Set pin state
 		state = (*value) & 0x03;
@@ -653,8 +655,17 @@ static uint32_t userFunction(uint8_t type, uint8_t motor, int32_t *value)
 	return errors;
 }
 
+static void loadMonitorRead(uint8_t motor, uint16_t *stallGuard, uint8_t *coolStep, int32_t *velocity)
+{
+	*stallGuard  = tmc2209_readInt(motorToIC(motor), TMC2209_SG_RESULT);
+	*coolStep    = TMC2209_FIELD_READ(motorToIC(motor), TMC2209_DRVSTATUS, TMC2209_CS_ACTUAL_MASK, TMC2209_CS_ACTUAL_SHIFT);
+	*velocity    = StepDir_getActualVelocity(motor);
+}
+
 static void deInit(void)
 {
+	loadmonitor_setReadFunction(NULL, 0);
+
 	enableDriver(DRIVER_DISABLE);
 	HAL.IOs->config->reset(Pins.ENN);
 	HAL.IOs->config->reset(Pins.SPREAD);
@@ -764,6 +775,8 @@ void TMC2209_init(void)
 	Evalboards.ch2.deInit               = deInit;
 	Evalboards.ch2.periodicJob          = periodicJob;
 
+	loadmonitor_setReadFunction(loadMonitorRead, MOTORS);
+
 	tmc2209_init(&TMC2209, 0, 0, TMC2209_config, &tmc2209_defaultRegisterResetState[0]);
 
 	StepDir_init(STEPDIR_PRECISION);
@@ -784,7 +797,7 @@ void TMC2209_init(void)
 	vref = 2000;
 	HAL.IOs->config->set(Pins.UC_PWM);
 	Timer.init();
-	Timer.setDuty(timerChannel, ((float)vref) / VREF_FULLSCALE);
+	Timer.setDuty(timerChannel, TIMER_DUTY(vref, VREF_FULLSCALE));
 
 	enableDriver(DRIVER_ENABLE);
 };
@@ -250,7 +250,7 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 		} else {
 			if ((uint32_t) *value < VREF_FULLSCALE) {
 				vref = *value;
-				Timer.setDuty(timerChannel, ((float)vref) / VREF_FULLSCALE);
+				Timer.setDuty(timerChannel, TIMER_DUTY(vref, VREF_FULLSCALE));
 			} else {
 				errors |= TMC_ERROR_VALUE;
 			}
@@ -493,10 +493,10 @@ static uint32_t userFunction(uint8_t type, uint8_t motor, int32_t *value)
 		*value = tmc2225_get_slave(motorToIC(motor));
 		break;
 	case 3:
-		*value = Timer.getDuty(timerChannel) * 100 / TIMER_MAX;
+		*value = (Timer.getDuty(timerChannel) * 100) >> TIMER_DUTY_SHIFT;
 		break;
 	case 4:
-		Timer.setDuty(timerChannel, ((float)*value) / 100);
+		Timer.setDuty(timerChannel, TIMER_DUTY(MIN(MAX(*value, 0), 100), 100));
 		break;
 	default:
 		errors |= TMC_ERROR_TYPE;
@@ -630,7 +630,7 @@ void TMC2225_init(void)
 	vref = 2000;
 	HAL.IOs->config->set(Pins.UC_PWM);
 	Timer.init();
-	Timer.setDuty(timerChannel, ((float)vref) / VREF_FULLSCALE);
+	Timer.setDuty(timerChannel, TIMER_DUTY(vref, VREF_FULLSCALE));
 
 	enableDriver(DRIVER_ENABLE);
 };
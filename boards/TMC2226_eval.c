@@ -617,10 +617,10 @@ static uint32_t userFunction(uint8_t type, uint8_t motor, int32_t *value)
 		*value = StepDir_getStatus(motor);
 		break;
 	case 3:
-		*value = Timer.getDuty(timerChannel) * 100 / TIMER_MAX;
+		*value = (Timer.getDuty(timerChannel) * 100) >> TIMER_DUTY_SHIFT;
 		break;
 	case 4:
-		Timer.setDuty(timerChannel, ((float)*value) / 100);
+		Timer.setDuty(timerChannel, TIMER_DUTY(MIN(MAX(*value, 0), 100), 100));
 		break;
 	case 5: // Set pin state
 		state = (*value) & 0x03;
@@ -729,7 +729,7 @@ static void setVREF(uint16_t value)
 	// Calculating VREF from the timer duty cycle introduces rounding errors
 	vref = value;
 
-	Timer.setDuty(timerChannel, ((float)vref) / VREF_FULLSCALE);
+	Timer.setDuty(timerChannel, TIMER_DUTY(vref, VREF_FULLSCALE));
 }
 
 static void periodicJob(uint32_t tick)
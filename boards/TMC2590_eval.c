@@ -712,6 +712,7 @@ void TMC2590_init(void)
 
 	TMC2590_SPIChannel = &HAL.SPI->ch2;
 	TMC2590_SPIChannel->CSN = Pins.CSN;
+	Evalboards.ch2.spiProfile = SPI_PROFILE_FIXED(TMC2590_SPIChannel, 4000000);
 
 	StepDir_init(STEPDIR_PRECISION);
 	StepDir_setPins(0, Pins.STEP, Pins.DIR, Pins.SG_TST);
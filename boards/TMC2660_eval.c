@@ -783,6 +783,7 @@ void TMC2660_init(void)
 
 	TMC2660_SPIChannel = &HAL.SPI->ch2;
 	TMC2660_SPIChannel->CSN = Pins.CSN;
+	Evalboards.ch2.spiProfile = SPI_PROFILE_FIXED(TMC2660_SPIChannel, 4000000);
 
 	TMC2660.standStillCurrentScale  = I_STAND_STILL;
 	TMC2660.standStillTimeout       = T_STAND_STILL;
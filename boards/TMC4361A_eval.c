@@ -33,6 +33,9 @@ static uint32_t userFunction(uint8_t type, uint8_t motor, int32_t *value);
 static uint8_t reset();
 static uint8_t restore();
 
+static void coverProcess(void);
+static void coverFlush(void);
+
 typedef struct
 {
 	IOPinTypeDef  *TARGET_REACHED;
@@ -52,6 +55,40 @@ static SPIChannelTypeDef *TMC4361A_SPIChannel;
 
 static uint32_t vmax_position = 0;
 
+// Cover datagram engine
+#define COVER_QUEUE_SIZE    16      // Must be a power of 2
+#define COVER_MARGIN        100     // [µs] Latency until the datagram starts, measured COVER_LOW write -> COVER_DONE: ~90µs
+
+// Timing fields of SPIOUT_CONF [clock cycles]
+#define SPI_OUT_LOW_TIME(conf)    (((conf) >> 20) & 0x0F)
+#define SPI_OUT_HIGH_TIME(conf)   (((conf) >> 24) & 0x0F)
+#define SPI_OUT_BLOCK_TIME(conf)  (((conf) >> 28) & 0x0F)
+
+typedef enum
+{
+	COVER_IDLE,
+	COVER_BUSY
+} CoverState;
+
+typedef struct
+{
+	uint64_t data;
+	uint8_t length;
+} CoverDatagram;
+
+static struct
+{
+	CoverDatagram queue[COVER_QUEUE_SIZE];
+	uint8_t head;
+	uint8_t tail;
+	CoverState state;
+	uint32_t start;     // Microsecond tick of the last cover transmission
+	uint32_t duration;  // [µs] Time the last cover transmission takes at most
+	bool timingValid;   // spiOutConf and clockMHz match the chip, cleared when either register gets written
+	uint32_t spiOutConf;
+	uint32_t clockMHz;
+} Cover;
+
 // Helper macro - Access the chip object in the motion controller boards union
 #define TMC4361A (motionControllerBoards.tmc4361A)
 
@@ -85,10 +122,90 @@ void tmc4361A_readWriteArray(uint8_t channel, uint8_t *data, size_t length)
 // cover function doesn't know.
 static void tmc4361A_fullCover(uint8_t *data, size_t length)
 {
+	coverFlush();
 	tmc4361A_readWriteCover(&TMC4361A, data, length);
 }
 
-// The cover function emulates the SPI readWrite function
+// Upper limit for the transfer of a cover datagram with length bytes [µs].
+// The COVER_DONE event would tell exactly, but EVENTS is clear-on-read and
+// belongs to the host, so the time is derived from the SPI output timing.
+// The timing registers are only read again after they got written.
+static uint32_t coverDuration(uint8_t length)
+{
+	if(!Cover.timingValid)
+	{
+		Cover.spiOutConf  = tmc4361A_readInt(&TMC4361A, TMC4361A_SPIOUT_CONF);
+		Cover.clockMHz    = MAX(tmc4361A_readInt(&TMC4361A, TMC4361A_CLK_FREQ) / 1000000, 1);
+		Cover.timingValid = true;
+	}
+
+	uint32_t conf = Cover.spiOutConf;
+	uint32_t cycles = length * 8 * (SPI_OUT_LOW_TIME(conf) + SPI_OUT_HIGH_TIME(conf) + 2) + SPI_OUT_BLOCK_TIME(conf) + 1;
+
+	// A datagram of the automatic driver status polling may be running in front of this one
+	return 2 * cycles / Cover.clockMHz + COVER_MARGIN;
+}
+
+// Send a cover datagram to the driver. The lower 4 bytes go into the cover low
+// register, the higher 4 bytes, if present, go into the cover high register.
+static void coverSend(uint64_t data, uint8_t length)
+{
+	Cover.duration = coverDuration(length);
+
+	if(length > 4)
+		tmc4361A_writeInt(&TMC4361A, TMC4361A_COVER_HIGH_WR, data >> 32);
+	tmc4361A_writeInt(&TMC4361A, TMC4361A_COVER_LOW_WR, data & 0xFFFFFFFF);
+
+	Cover.start = systick_getMicrosecondTick();
+	Cover.state = COVER_BUSY;
+}
+
+// Check once whether the last cover datagram is done, without touching the chip
+static bool coverPoll(void)
+{
+	if(Cover.state == COVER_IDLE)
+		return true;
+
+	if((systick_getMicrosecondTick() - Cover.start) > Cover.duration)
+		Cover.state = COVER_IDLE;
+
+	return Cover.state == COVER_IDLE;
+}
+
+static void coverWait(void)
+{
+	while(!coverPoll());
+}
+
+// Advance the queued cover writes without blocking. Called from periodicJob.
+static void coverProcess(void)
+{
+	if(!coverPoll())
+		return;
+
+	if(Cover.tail == Cover.head)
+		return;
+
+	CoverDatagram *datagram = &Cover.queue[Cover.tail];
+	Cover.tail = (Cover.tail + 1) & (COVER_QUEUE_SIZE - 1);
+
+	coverSend(datagram->data, datagram->length);
+}
+
+// Complete all queued cover writes, used before anything depends on their order
+static void coverFlush(void)
+{
+	do
+	{
+		coverWait();
+		coverProcess();
+	} while(Cover.state != COVER_IDLE);
+}
+
+// The cover function emulates the SPI readWrite function.
+// Driver register writes get queued and sent in the background, so the caller
+// does not wait for the cover transfer. Reads (and TMC2660 datagrams, which
+// always carry a reply) are sent synchronously after the queue is drained.
 static uint8_t tmc4361A_cover(uint8_t data, uint8_t lastTransfer)
 {
 	static uint64_t coverIn = 0;     // read from squirrel
@@ -108,29 +225,44 @@ static uint8_t tmc4361A_cover(uint8_t data, uint8_t lastTransfer)
 
 	if(lastTransfer)
 	{
-		/* Write data to cover register(s). The lower 4 bytes go into the cover low register,
-		 * the higher 4 bytes, if present, go into the cover high register.
-		 * The datagram needs to be sent twice, otherwise the read buffer will be delayed by
-		 * one read/write datagram.
-		 */
+		bool isWrite = (coverLength == 5) && (Evalboards.ch2.id != ID_TMC2660) && ((coverOut >> 32) & TMC_WRITE_BIT);
+		uint8_t next = (Cover.head + 1) & (COVER_QUEUE_SIZE - 1);
 
-		// Send the buffered datagram & wait a bit before continuing so the 4361 can complete the datagram to the driver
-		// measured delay between COVER_LOW transmission and COVER_DONE flag: ~90µs -> 1 ms more than enough
-		// todo CHECK 3: Delay measurement only done on TMC4361, not 4361A - make sure the required delay didnt change (LH) #1
-		if(coverLength > 4)
-			tmc4361A_writeInt(&TMC4361A, TMC4361A_COVER_HIGH_WR, coverOut >> 32);
-		tmc4361A_writeInt(&TMC4361A, TMC4361A_COVER_LOW_WR, coverOut & 0xFFFFFFFF);
-		wait(1);
+		if(isWrite)
+		{
+			// Wait for a free slot if the queue is full
+			while(next == Cover.tail)
+			{
+				coverWait();
+				coverProcess();
+			}
 
-		// Trigger a re-send by writing the low register again
-		tmc4361A_writeInt(&TMC4361A, TMC4361A_COVER_LOW_WR, coverOut & 0xFFFFFFFF);
+			Cover.queue[Cover.head].data   = coverOut;
+			Cover.queue[Cover.head].length = coverLength;
+			Cover.head = next;
 
-		// Read the reply
-		coverIn = 0;
-		if(coverLength > 4)
-			coverIn |= (uint64_t) tmc4361A_readInt(&TMC4361A, TMC4361A_COVER_DRV_HIGH_RD) << 32;
-		coverIn |= tmc4361A_readInt(&TMC4361A, TMC4361A_COVER_DRV_LOW_RD);
-		coverIn <<= (8-coverLength) * 8; // Shift the highest byte of the reply to the highest byte of the buffer uint64_t
+			coverProcess();
+			coverIn = 0;
+		}
+		else
+		{
+			/* The datagram needs to be sent twice, otherwise the read buffer will be delayed by
+			 * one read/write datagram. Instead of a fixed delay each send waits for its transfer time.
+			 */
+			coverFlush();
+
+			coverSend(coverOut, coverLength);
+			coverWait();
+			coverSend(coverOut, coverLength);
+			coverWait();
+
+			// Read the reply
+			coverIn = 0;
+			if(coverLength > 4)
+				coverIn |= (uint64_t) tmc4361A_readInt(&TMC4361A, TMC4361A_COVER_DRV_HIGH_RD) << 32;
+			coverIn |= tmc4361A_readInt(&TMC4361A, TMC4361A_COVER_DRV_LOW_RD);
+			coverIn <<= (8-coverLength) * 8; // Shift the highest byte of the reply to the highest byte of the buffer uint64_t
+		}
 
 		// Clear write buffer
 		coverOut = 0;
@@ -694,14 +826,21 @@ static void writeRegister(uint8_t motor, uint8_t address, int32_t value)
 	static int32_t high;
 	switch(address) {
 	case TMC4361A_COVER_HIGH_WR:
+		coverFlush();
 		high = value;
 		break;
 	case TMC4361A_COVER_LOW_WR:
+		coverFlush();
 		if(Evalboards.ch2.id == ID_TMC2660) // TMC2660 -> 20 bit registers, 8 bit address
 			Evalboards.ch2.writeRegister(motor, TMC2660_ADDRESS(value), TMC2660_VALUE(value));
 		else // All other drivers -> 32 bit registers, 8 bit address
 			Evalboards.ch2.writeRegister(motor, TMC_ADDRESS(high), value);
 		break;
+	case TMC4361A_SPIOUT_CONF:
+	case TMC4361A_CLK_FREQ:
+		coverFlush();
+		Cover.timingValid = false;
+		break;
 	case TMC4361A_SCALE_VALUES:
 		/* Only possible with IHOLD and only with TMC2130 and TMC2160, since write-only registers changed actively by
 		 * the TMC43XX (not via cover datagrams) are impossible to track.
@@ -721,11 +860,19 @@ static void writeRegister(uint8_t motor, uint8_t address, int32_t value)
 
 static void readRegister(uint8_t motor, uint8_t address, int32_t *value)
 {
+	switch(address) {
+	case TMC4361A_COVER_DRV_LOW_RD:
+	case TMC4361A_COVER_DRV_HIGH_RD:
+		coverFlush();
+		break;
+	}
+
 	*value	= tmc4361A_readInt(motorToIC(motor), address);
 }
 
 static void periodicJob(uint32_t tick)
 {
+	coverProcess();
 	tmc4361A_periodicJob(&TMC4361A, tick);
 }
 
@@ -819,6 +966,7 @@ static uint32_t userFunction(uint8_t type, uint8_t motor, int32_t *value)
 
 static void deInit(void)
 {
+	coverFlush();
 	HAL.IOs->config->setLow(Pins.NRST);
 
 	HAL.IOs->config->reset(Pins.STOP_L);
@@ -882,6 +1030,9 @@ static void configCallback(TMC4361ATypeDef *tmc4361A, ConfigState state)
 	value = 0x44400040 | (dataLength << 13) | (driver << 0);
 	tmc4361A_writeInt(tmc4361A, TMC4361A_SPIOUT_CONF, value);
 
+	// The register reset/restore wrote the timing registers, CLK_FREQ included
+	Cover.timingValid = false;
+
 	// Reset/Restore driver
 	if(state == CONFIG_RESET)
 	{
@@ -930,12 +1081,18 @@ void TMC4361A_init(void)
 
 	TMC4361A_SPIChannel = &HAL.SPI->ch1;
 	TMC4361A_SPIChannel->CSN = &HAL.IOs->pins->SPI1_CSN;
+	Evalboards.ch1.spiProfile = SPI_PROFILE_FIXED(TMC4361A_SPIChannel, 4000000);
 
 	Evalboards.ch1.config->state        = CONFIG_RESET;
 	Evalboards.ch1.config->configIndex  = 0;
 	Evalboards.ch1.config->reset        = reset;
 	Evalboards.ch1.config->restore      = restore;
 
+	Cover.head   = 0;
+	Cover.tail   = 0;
+	Cover.state  = COVER_IDLE;
+	Cover.timingValid = false;
+
 	Evalboards.ch1.cover                = tmc4361A_cover;
 	Evalboards.ch1.rotate               = rotate;
 	Evalboards.ch1.right                = right;
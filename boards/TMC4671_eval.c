@@ -24,6 +24,10 @@ static ConfigurationTypeDef *TMC4671_config;
 static SPIChannelTypeDef *TMC4671_SPIChannel;
 
 static void timer_overflow(void);
+static void debugBurstRead(const uint8_t *types, const uint32_t *addresses, uint32_t *samples, uint8_t count);
+static void debugRestoreSelects(uint8_t address);
+static uint32_t autotuneStart(uint8_t motor, int32_t loop);
+static void autotuneProcess(uint8_t motor, uint32_t tick);
 
 typedef struct
 {
@@ -54,6 +58,107 @@ typedef struct
 
 static TMinimalMotorConfig motorConfig[TMC4671_MOTORS];
 
+// Stacked register selections changed by the RAMDebug burst read. The host
+// selection is restored lazily once the host accesses one of these registers.
+typedef struct
+{
+	uint8_t selectAddress;
+	uint8_t dataAddress;
+	int32_t hostValue;
+} TDebugSelect;
+
+static TDebugSelect debugSelects[4];
+static uint8_t debugSelectCount = 0;
+
+// Last selection written by the burst read, kept across samples so a single
+// stacked channel only costs the data read. Invalidated when the host selection gets restored.
+static int16_t debugLastSelectAddress = -1;
+static uint8_t debugLastSelectValue = 0;
+
+// PI autotuning
+#define AUTOTUNE_PWM_CLOCK          100000000 // PWM counter clock [Hz]
+#define AUTOTUNE_SAMPLES            512
+#define AUTOTUNE_BASELINE_SAMPLES   16
+#define AUTOTUNE_PRESCALER(loop)    (((loop) == AUTOTUNE_LOOP_CURRENT) ? 1 : ((loop) == AUTOTUNE_LOOP_VELOCITY) ? 4 : 8)
+#define AUTOTUNE_SETTLE_TIME        200  // [ms]
+#define AUTOTUNE_CAPTURE_TIMEOUT    2000 // [ms]
+#define AUTOTUNE_MAX_ITERATIONS     12
+#define AUTOTUNE_P_MIN              16
+#define AUTOTUNE_GAIN_MAX           32767
+#define AUTOTUNE_OVERSHOOT_MIN      50   // [1/1000]
+#define AUTOTUNE_OVERSHOOT_MAX      150  // [1/1000]
+#define AUTOTUNE_RATIO_MIN          900  // steady state / step [1/1000]
+#define AUTOTUNE_RELAY_SKIP         2    // Relay oscillation periods ignored until the oscillation is steady
+#define AUTOTUNE_RELAY_PERIODS      4    // Relay oscillation periods averaged
+#define AUTOTUNE_RELAY_TIMEOUT      5000 // [ms]
+#define AUTOTUNE_RELAY_RESOLUTION   20   // Minimum relay period in multiples of the timing resolution
+
+typedef enum
+{
+	AUTOTUNE_LOOP_NONE,
+	AUTOTUNE_LOOP_CURRENT,
+	AUTOTUNE_LOOP_VELOCITY,
+	AUTOTUNE_LOOP_POSITION
+} TAutotuneLoop;
+
+typedef enum
+{
+	AUTOTUNE_METHOD_STEP,
+	AUTOTUNE_METHOD_RELAY
+} TAutotuneMethod;
+
+typedef enum
+{
+	AUTOTUNE_IDLE,
+	AUTOTUNE_RUNNING,
+	AUTOTUNE_DONE,
+	AUTOTUNE_FAILED
+} TAutotuneStatus;
+
+typedef enum
+{
+	AUTOTUNE_PHASE_SETTLE,
+	AUTOTUNE_PHASE_CAPTURE,
+	AUTOTUNE_PHASE_ANALYSE,
+	AUTOTUNE_PHASE_RELAY
+} TAutotunePhase;
+
+typedef struct
+{
+	uint8_t   loop;
+	uint8_t   method;
+	uint8_t   status;
+	uint8_t   phase;
+	uint8_t   iteration;
+	int32_t   amplitude;   // Step or relay height, 0 selects a default per loop
+	int32_t   step;
+	int32_t   stepRaw;     // Step read back from the target register, in the unit of the captured values
+	int32_t   start;       // Position at the start of position loop tuning
+	int32_t   p;
+	int32_t   savedP;
+	int32_t   savedI;
+	uint32_t  stepIndex;   // Capture index at which the step was applied
+	uint32_t  timestamp;
+	int32_t   riseTime;    // Measured 90% rise time or relay oscillation period [µs]
+
+	// Relay experiment
+	int8_t    relaySign;
+	int32_t   relayHeight; // Relay output read back from the chip
+	int32_t   hysteresis;
+	int32_t   noiseMin;
+	int32_t   noiseMax;
+	int32_t   peakMin;
+	int32_t   peakMax;
+	uint8_t   periods;
+	uint32_t  switchTime;  // [µs]
+	uint32_t  sampleTime;  // [µs]
+	uint32_t  sampleGap;   // Longest time between two relay samples, the timing resolution [µs]
+	uint32_t  periodSum;   // [µs]
+	int64_t   amplitudeSum;
+} TAutotune;
+
+static TAutotune autotune;
+
 // variables for ramp generator support
 TMC_LinearRamp rampGenerator[TMC4671_MOTORS];
 uint8_t actualMotionMode[TMC4671_MOTORS];
@@ -334,6 +439,7 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 	case 28: // Linear target velocity [µm/s]
 		if (readWrite == READ)
 		{
+			debugRestoreSelects(TMC4671_INTERIM_ADDR);
 			tmc4671_writeInt(motor, TMC4671_INTERIM_ADDR, 2);
 			int32_t velocity = tmc4671_readInt(motor, TMC4671_INTERIM_DATA);
 
@@ -503,6 +609,51 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 			}
 		}
 		break;
+	case 77: // PI autotuning: start with 1 = current, 2 = velocity, 3 = position loop, 0 = abort
+		if (readWrite == READ)
+		{
+			*value = autotune.status;
+		}
+		else
+		{
+			errors |= autotuneStart(motor, *value);
+		}
+		break;
+	case 78: // PI autotuning step amplitude or relay height (0 = default)
+		if (readWrite == READ)
+		{
+			*value = autotune.amplitude;
+		}
+		else
+		{
+			autotune.amplitude = *value;
+		}
+		break;
+	case 79: // PI autotuning measured rise time or relay oscillation period [µs]
+		if (readWrite == READ)
+		{
+			*value = autotune.riseTime;
+		}
+		else
+		{
+			errors |= TMC_ERROR_TYPE;
+		}
+		break;
+	case 80: // PI autotuning experiment: 0 = step response, 1 = relay feedback (velocity and position loop)
+		if (readWrite == READ)
+		{
+			*value = autotune.method;
+		}
+		else
+		{
+			if (autotune.status == AUTOTUNE_RUNNING)
+				errors |= TMC_ERROR_NOT_DONE;
+			else if (*value == AUTOTUNE_METHOD_STEP || *value == AUTOTUNE_METHOD_RELAY)
+				autotune.method = *value;
+			else
+				errors |= TMC_ERROR_VALUE;
+		}
+		break;
 
 // add biquad settings here!
 
@@ -619,6 +770,7 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 	case 192:
 		// target velocity (PIDIN_TARGET_VELOCITY)
 		if(readWrite == READ) {
+			debugRestoreSelects(TMC4671_INTERIM_ADDR);
 			tmc4671_writeInt(motor, TMC4671_INTERIM_ADDR, 2);
 			*value = tmc4671_readInt(motor, TMC4671_INTERIM_DATA);
 		}
@@ -756,6 +908,509 @@ static uint32_t getMeasuredSpeed(uint8_t motor, int32_t *value)
 	return TMC_ERROR_NONE;
 }
 
+// => Autotuning
+// The PI parameters get tuned with step experiments: A step is applied to the
+// loop under test while RAMDebug records the response. From the capture the
+// overshoot, the steady state ratio and the rise time are evaluated. P gets
+// raised or lowered until the response is fast without overshooting too
+// much, then I is derived from the rise time (integration time = rise time).
+// All analysis is done in integer math on the capture buffer.
+//
+// The velocity and position loops can be tuned with a relay experiment instead:
+// The loop under test is opened and its output (torque or velocity target) is
+// switched between +d and -d whenever the actual value crosses the target. The
+// resulting limit cycle gives the ultimate gain Ku = 4d / (pi * a) from its
+// amplitude a and the ultimate period Tu, from which the Ziegler-Nichols rules
+// give the gains. The relay is switched from the main loop, so the oscillation
+// period has to be well above 1ms, which rules out the current loop.
+
+// Measured value of the loop under test
+static int32_t autotuneReadSample(uint32_t index)
+{
+	uint32_t sample = 0;
+
+	debug_getSample(index, &sample);
+
+	// The flux is the lower half of PID_TORQUE_FLUX_ACTUAL
+	if(autotune.loop == AUTOTUNE_LOOP_CURRENT)
+		return (int16_t) (sample & 0xFFFF);
+
+	return (int32_t) sample;
+}
+
+static void autotuneSetTarget(uint8_t motor, int32_t target)
+{
+	switch(autotune.loop)
+	{
+	case AUTOTUNE_LOOP_CURRENT:
+		tmc4671_setTargetFlux_mA(motor, motorConfig[motor].torqueMeasurementFactor, target);
+		break;
+	case AUTOTUNE_LOOP_VELOCITY:
+		tmc4671_writeInt(motor, TMC4671_PID_VELOCITY_TARGET, target);
+		break;
+	case AUTOTUNE_LOOP_POSITION:
+		tmc4671_writeInt(motor, TMC4671_PID_POSITION_TARGET, autotune.start + target);
+		break;
+	}
+}
+
+// Target of the loop under test as written to the chip, in the unit of the captured values
+static int32_t autotuneReadTarget(uint8_t motor)
+{
+	switch(autotune.loop)
+	{
+	case AUTOTUNE_LOOP_CURRENT:
+		// The flux target is the lower half of PID_TORQUE_FLUX_TARGET
+		return (int16_t) (tmc4671_readInt(motor, TMC4671_PID_TORQUE_FLUX_TARGET) & 0xFFFF);
+	case AUTOTUNE_LOOP_VELOCITY:
+		return tmc4671_readInt(motor, TMC4671_PID_VELOCITY_TARGET);
+	case AUTOTUNE_LOOP_POSITION:
+		return tmc4671_readInt(motor, TMC4671_PID_POSITION_TARGET) - autotune.start;
+	}
+
+	return 0;
+}
+
+// Relay output: The torque target [mA] when tuning the velocity loop, the velocity target when tuning the position loop
+static void autotuneSetRelay(uint8_t motor, int32_t output)
+{
+	if(autotune.loop == AUTOTUNE_LOOP_VELOCITY)
+		tmc4671_setTargetTorque_mA(motor, motorConfig[motor].torqueMeasurementFactor, output);
+	else
+		tmc4671_writeInt(motor, TMC4671_PID_VELOCITY_TARGET, output);
+}
+
+// Relay output as written to the chip, in the unit of the gains
+static int32_t autotuneReadRelay(uint8_t motor)
+{
+	// The torque target is the upper half of PID_TORQUE_FLUX_TARGET
+	if(autotune.loop == AUTOTUNE_LOOP_VELOCITY)
+		return (int16_t) (tmc4671_readInt(motor, TMC4671_PID_TORQUE_FLUX_TARGET) >> 16);
+
+	return tmc4671_readInt(motor, TMC4671_PID_VELOCITY_TARGET);
+}
+
+// Actual value of the loop under test during the relay experiment
+static int32_t autotuneReadActual(uint8_t motor)
+{
+	if(autotune.loop == AUTOTUNE_LOOP_VELOCITY)
+		return tmc4671_readInt(motor, TMC4671_PID_VELOCITY_ACTUAL);
+
+	return tmc4671_readInt(motor, TMC4671_PID_POSITION_ACTUAL) - autotune.start;
+}
+
+static void autotuneSetGains(uint8_t motor, int32_t p, int32_t i)
+{
+	switch(autotune.loop)
+	{
+	case AUTOTUNE_LOOP_CURRENT:
+		// Tune on the flux axis so the motor does not move, torque uses the same gains
+		handleParameter(WRITE, motor, 72, &p);
+		handleParameter(WRITE, motor, 73, &i);
+		handleParameter(WRITE, motor, 70, &p);
+		handleParameter(WRITE, motor, 71, &i);
+		break;
+	case AUTOTUNE_LOOP_VELOCITY:
+		handleParameter(WRITE, motor, 74, &p);
+		handleParameter(WRITE, motor, 75, &i);
+		break;
+	case AUTOTUNE_LOOP_POSITION:
+		handleParameter(WRITE, motor, 76, &p);
+		break;
+	}
+}
+
+// The PI controllers run at the PWM frequency
+static int32_t autotunePWMFrequency(uint8_t motor)
+{
+	return AUTOTUNE_PWM_CLOCK / (tmc4671_readInt(motor, TMC4671_PWM_MAXCNT) + 1);
+}
+
+// P is Q8.8 and I is Q0.16 per PWM cycle: Ti[cycles] = 256 * P / I
+static int32_t autotuneIntegral(int32_t p, int64_t cycles)
+{
+	return MIN(MAX(((int64_t) p * 256) / MAX(cycles, 1), 1), AUTOTUNE_GAIN_MAX);
+}
+
+// Stop the experiment, put back the gains from before the autotuning and hand RAMDebug back to the host
+static void autotuneAbort(uint8_t motor)
+{
+	if(autotune.method == AUTOTUNE_METHOD_RELAY)
+	{
+		autotuneSetRelay(motor, 0);
+	}
+	else
+	{
+		autotuneSetTarget(motor, 0);
+		debug_restoreConfig();
+	}
+
+	autotuneSetGains(motor, autotune.savedP, autotune.savedI);
+	autotune.status = AUTOTUNE_FAILED;
+}
+
+static uint32_t autotuneStart(uint8_t motor, int32_t loop)
+{
+	if(loop == AUTOTUNE_LOOP_NONE)
+	{
+		if(autotune.status == AUTOTUNE_RUNNING)
+			autotuneAbort(motor);
+
+		return TMC_ERROR_NONE;
+	}
+
+	if(autotune.status == AUTOTUNE_RUNNING)
+		return TMC_ERROR_NOT_DONE;
+
+	if(loop > AUTOTUNE_LOOP_POSITION)
+		return TMC_ERROR_VALUE;
+
+	// The current loop is too fast for the relay switched from the main loop
+	if((autotune.method == AUTOTUNE_METHOD_RELAY) && (loop == AUTOTUNE_LOOP_CURRENT))
+		return TMC_ERROR_VALUE;
+
+	autotune.loop      = loop;
+	autotune.iteration = 0;
+	autotune.riseTime  = 0;
+	autotune.step      = autotune.amplitude;
+	autotune.savedI    = 0;
+
+	// Keep the ramp generator from overwriting the targets
+	actualMotionMode[motor] = TMC4671_MOTION_MODE_STOPPED;
+
+	switch(loop)
+	{
+	case AUTOTUNE_LOOP_CURRENT:
+		if(autotune.step == 0)
+			autotune.step = motorConfig[motor].maximumCurrent / 2;
+		handleParameter(READ, motor, 72, &autotune.savedP);
+		handleParameter(READ, motor, 73, &autotune.savedI);
+		tmc4671_switchToMotionMode(motor, TMC4671_MOTION_MODE_TORQUE);
+		tmc4671_setTargetTorque_mA(motor, motorConfig[motor].torqueMeasurementFactor, 0);
+		break;
+	case AUTOTUNE_LOOP_VELOCITY:
+		if(autotune.step == 0)
+		{
+			autotune.step = (autotune.method == AUTOTUNE_METHOD_RELAY) ? motorConfig[motor].maximumCurrent / 4
+					: tmc4671_readInt(motor, TMC4671_PID_VELOCITY_LIMIT) / 4;
+		}
+		handleParameter(READ, motor, 74, &autotune.savedP);
+		handleParameter(READ, motor, 75, &autotune.savedI);
+		break;
+	case AUTOTUNE_LOOP_POSITION:
+		if(autotune.step == 0)
+		{
+			autotune.step = (autotune.method == AUTOTUNE_METHOD_RELAY) ? tmc4671_readInt(motor, TMC4671_PID_VELOCITY_LIMIT) / 8
+					: POSITION_SCALE_MAX / 4;
+		}
+		handleParameter(READ, motor, 76, &autotune.savedP);
+		autotune.start = tmc4671_readInt(motor, TMC4671_PID_POSITION_ACTUAL);
+		break;
+	}
+
+	if(autotune.method == AUTOTUNE_METHOD_RELAY)
+	{
+		// Open the loop under test, the relay drives the loop below it
+		if(loop == AUTOTUNE_LOOP_VELOCITY)
+			tmc4671_switchToMotionMode(motor, TMC4671_MOTION_MODE_TORQUE);
+		else
+			tmc4671_switchToMotionMode(motor, TMC4671_MOTION_MODE_VELOCITY);
+
+		autotuneSetRelay(motor, 0);
+
+		// The noise seen while settling sets the relay hysteresis
+		autotune.noiseMin = INT32_MAX;
+		autotune.noiseMax = INT32_MIN;
+	}
+	else
+	{
+		if(loop == AUTOTUNE_LOOP_VELOCITY)
+			tmc4671_switchToMotionMode(motor, TMC4671_MOTION_MODE_VELOCITY);
+		else if(loop == AUTOTUNE_LOOP_POSITION)
+			tmc4671_switchToMotionMode(motor, TMC4671_MOTION_MODE_POSITION);
+
+		// Search P with the integrator disabled
+		autotune.p = MAX(autotune.savedP, AUTOTUNE_P_MIN);
+		autotuneSetGains(motor, autotune.p, 0);
+		autotuneSetTarget(motor, 0);
+
+		// The capture configuration of the host is put back afterwards
+		debug_saveConfig();
+	}
+
+	autotune.status    = AUTOTUNE_RUNNING;
+	autotune.phase     = AUTOTUNE_PHASE_SETTLE;
+	autotune.timestamp = systick_getTick();
+
+	return TMC_ERROR_NONE;
+}
+
+// Evaluate the captured step response. Returns false if the loop did not react.
+static bool autotuneAnalyse(int32_t *overshoot, int32_t *ratio, int32_t *rise)
+{
+	uint32_t count = debug_getInfo(3);
+	uint32_t tail  = count / 8;
+	int32_t sign   = (autotune.stepRaw < 0) ? -1 : 1;
+	int64_t sum;
+	int32_t baseline, final, peak;
+	uint32_t i;
+
+	if((autotune.stepIndex == 0) || (count < autotune.stepIndex + 2 * tail) || (tail == 0) || (autotune.stepRaw == 0))
+		return false;
+
+	for(i = 0, sum = 0; i < autotune.stepIndex; i++)
+		sum += autotuneReadSample(i);
+	baseline = sum / (int32_t) autotune.stepIndex;
+
+	for(i = count - tail, sum = 0; i < count; i++)
+		sum += autotuneReadSample(i);
+	final = sign * (int32_t) (sum / (int32_t) tail - baseline);
+
+	if(final < (sign * autotune.stepRaw) / 16)
+		return false;
+
+	peak = final;
+	*rise = count - autotune.stepIndex;
+	for(i = autotune.stepIndex; i < count; i++)
+	{
+		int32_t value = sign * (autotuneReadSample(i) - baseline);
+
+		peak = MAX(peak, value);
+		if((value >= final - final / 10) && ((int32_t) (i - autotune.stepIndex) < *rise))
+			*rise = i - autotune.stepIndex;
+	}
+
+	*overshoot = ((int64_t) (peak - final) * 1000) / final;
+	*ratio     = ((int64_t) final * 1000) / (sign * autotune.stepRaw);
+	*rise      = MAX(*rise, 1);
+
+	return true;
+}
+
+static void autotuneFinish(uint8_t motor, int32_t riseSamples)
+{
+	int32_t i = 0;
+
+	// Sample period in PWM cycles
+	int32_t captureFrequency = MAX(debug_getInfo(2), 1);
+	int32_t cyclesPerSample = MAX(autotunePWMFrequency(motor) * AUTOTUNE_PRESCALER(autotune.loop) / captureFrequency, 1);
+
+	autotune.riseTime = ((int64_t) riseSamples * AUTOTUNE_PRESCALER(autotune.loop) * 1000000) / captureFrequency;
+
+	if(autotune.loop != AUTOTUNE_LOOP_POSITION)
+		i = autotuneIntegral(autotune.p, (int64_t) riseSamples * cyclesPerSample);
+
+	autotuneSetGains(motor, autotune.p, i);
+	debug_restoreConfig();
+	autotune.status = AUTOTUNE_DONE;
+}
+
+// Gains from the relay limit cycle. Velocity loop: Ziegler-Nichols PI with
+// Kp = 0.45 * Ku and Ti = Tu / 1.2. Position loop: P only with Kp = 0.5 * Ku.
+// With Ku = 4d / (pi * a) and P in Q8.8 this is P = d * 256 * 0.573 / a or
+// P = d * 256 * 0.637 / a respectively.
+static void autotuneFinishRelay(uint8_t motor)
+{
+	int32_t amplitude = autotune.amplitudeSum / AUTOTUNE_RELAY_PERIODS;
+	int32_t height    = (autotune.relayHeight < 0) ? -autotune.relayHeight : autotune.relayHeight;
+	int32_t p, i = 0;
+
+	autotuneSetRelay(motor, 0);
+
+	// An oscillation within the noise band tells nothing about the loop
+	if((amplitude <= autotune.hysteresis) || (amplitude == 0) || (height == 0))
+	{
+		autotuneAbort(motor);
+		return;
+	}
+
+	// Ultimate period [µs]. The switches are only seen when the relay gets sampled,
+	// a period of a few sample intervals is too coarse to tune with.
+	autotune.riseTime = autotune.periodSum / AUTOTUNE_RELAY_PERIODS;
+
+	if((uint32_t) autotune.riseTime < AUTOTUNE_RELAY_RESOLUTION * autotune.sampleGap)
+	{
+		autotuneAbort(motor);
+		return;
+	}
+
+	if(autotune.loop == AUTOTUNE_LOOP_VELOCITY)
+	{
+		p = ((int64_t) height * 256 * 573) / ((int64_t) amplitude * 1000);
+		p = MIN(MAX(p, 1), AUTOTUNE_GAIN_MAX);
+		i = autotuneIntegral(p, ((int64_t) autotune.riseTime * autotunePWMFrequency(motor)) / 1200000);
+
+		tmc4671_switchToMotionMode(motor, TMC4671_MOTION_MODE_VELOCITY);
+	}
+	else
+	{
+		p = ((int64_t) height * 256 * 637) / ((int64_t) amplitude * 1000);
+		p = MIN(MAX(p, 1), AUTOTUNE_GAIN_MAX);
+
+		tmc4671_switchToMotionMode(motor, TMC4671_MOTION_MODE_POSITION);
+	}
+
+	autotune.p = p;
+	autotuneSetGains(motor, p, i);
+	autotuneSetTarget(motor, 0);
+	autotune.status = AUTOTUNE_DONE;
+}
+
+// Switch the relay on each crossing outside the hysteresis band and measure
+// period and amplitude between the switches from - to +
+static void autotuneRelay(uint8_t motor, uint32_t tick)
+{
+	uint32_t time = systick_getMicrosecondTick();
+	int32_t value = autotuneReadActual(motor);
+
+	autotune.sampleGap  = MAX(autotune.sampleGap, time - autotune.sampleTime);
+	autotune.sampleTime = time;
+
+	autotune.peakMin = MIN(autotune.peakMin, value);
+	autotune.peakMax = MAX(autotune.peakMax, value);
+
+	if((autotune.relaySign > 0) && (value > autotune.hysteresis))
+	{
+		autotune.relaySign = -1;
+		autotuneSetRelay(motor, -autotune.step);
+	}
+	else if((autotune.relaySign < 0) && (value < -autotune.hysteresis))
+	{
+		autotune.relaySign = 1;
+		autotuneSetRelay(motor, autotune.step);
+
+		// The first periods are skipped until the oscillation is steady
+		if(autotune.periods > AUTOTUNE_RELAY_SKIP)
+		{
+			autotune.periodSum    += time - autotune.switchTime;
+			autotune.amplitudeSum += (autotune.peakMax - autotune.peakMin) / 2;
+		}
+
+		autotune.periods++;
+		autotune.switchTime = time;
+		autotune.peakMin    = value;
+		autotune.peakMax    = value;
+
+		if(autotune.periods > AUTOTUNE_RELAY_SKIP + AUTOTUNE_RELAY_PERIODS)
+		{
+			autotuneFinishRelay(motor);
+			return;
+		}
+	}
+
+	if((tick - autotune.timestamp) > AUTOTUNE_RELAY_TIMEOUT)
+		autotuneAbort(motor);
+}
+
+static void autotuneProcess(uint8_t motor, uint32_t tick)
+{
+	int32_t overshoot, ratio, rise;
+
+	if(autotune.status != AUTOTUNE_RUNNING)
+		return;
+
+	switch(autotune.phase)
+	{
+	case AUTOTUNE_PHASE_SETTLE:
+		if(autotune.method == AUTOTUNE_METHOD_RELAY)
+		{
+			int32_t value = autotuneReadActual(motor);
+
+			autotune.noiseMin = MIN(autotune.noiseMin, value);
+			autotune.noiseMax = MAX(autotune.noiseMax, value);
+		}
+
+		if((tick - autotune.timestamp) < AUTOTUNE_SETTLE_TIME)
+			break;
+
+		if(autotune.method == AUTOTUNE_METHOD_RELAY)
+		{
+			autotune.hysteresis   = autotune.noiseMax - autotune.noiseMin;
+			autotune.relaySign    = 1;
+			autotuneSetRelay(motor, autotune.step);
+			autotune.relayHeight  = autotuneReadRelay(motor);
+			autotune.periods      = 0;
+			autotune.periodSum    = 0;
+			autotune.sampleTime   = systick_getMicrosecondTick();
+			autotune.sampleGap    = 1;
+			autotune.amplitudeSum = 0;
+			autotune.peakMin      = INT32_MAX;
+			autotune.peakMax      = INT32_MIN;
+
+			autotune.phase     = AUTOTUNE_PHASE_RELAY;
+			autotune.timestamp = tick;
+			break;
+		}
+
+		// Record the baseline for a few samples, then apply the step
+		debug_init();
+		debug_setSampleCount(AUTOTUNE_SAMPLES);
+		debug_setPrescaler(AUTOTUNE_PRESCALER(autotune.loop));
+		debug_setChannel(CAPTURE_REGISTER, (autotune.loop == AUTOTUNE_LOOP_CURRENT) ? TMC4671_PID_TORQUE_FLUX_ACTUAL
+				: (autotune.loop == AUTOTUNE_LOOP_VELOCITY) ? TMC4671_PID_VELOCITY_ACTUAL : TMC4671_PID_POSITION_ACTUAL);
+		debug_enableTrigger(TRIGGER_UNCONDITIONAL, 0);
+
+		autotune.stepIndex = 0;
+		autotune.phase     = AUTOTUNE_PHASE_CAPTURE;
+		autotune.timestamp = tick;
+		break;
+	case AUTOTUNE_PHASE_CAPTURE:
+		if((autotune.stepIndex == 0) && ((uint32_t) debug_getInfo(3) >= AUTOTUNE_BASELINE_SAMPLES))
+		{
+			autotune.stepIndex = debug_getInfo(3);
+			autotuneSetTarget(motor, autotune.step);
+
+			// The step is given in mA for the current loop, the capture holds raw values
+			autotune.stepRaw = autotuneReadTarget(motor);
+		}
+
+		if(debug_getState() == RAMDEBUG_COMPLETE)
+		{
+			autotuneSetTarget(motor, 0);
+			autotune.phase = AUTOTUNE_PHASE_ANALYSE;
+		}
+		else if((tick - autotune.timestamp) > AUTOTUNE_CAPTURE_TIMEOUT)
+		{
+			autotuneAbort(motor);
+		}
+		break;
+	case AUTOTUNE_PHASE_ANALYSE:
+		autotune.iteration++;
+		autotune.phase     = AUTOTUNE_PHASE_SETTLE;
+		autotune.timestamp = tick;
+
+		if(!autotuneAnalyse(&overshoot, &ratio, &rise))
+		{
+			// No usable response - raise P unless it is exhausted
+			if(autotune.p >= AUTOTUNE_GAIN_MAX || autotune.iteration >= AUTOTUNE_MAX_ITERATIONS)
+				autotuneAbort(motor);
+			else
+				autotune.p = MIN(autotune.p * 2, AUTOTUNE_GAIN_MAX);
+		}
+		else if(overshoot > AUTOTUNE_OVERSHOOT_MAX && autotune.p > AUTOTUNE_P_MIN && autotune.iteration < AUTOTUNE_MAX_ITERATIONS)
+		{
+			autotune.p = MAX(autotune.p * 3 / 4, AUTOTUNE_P_MIN);
+		}
+		else if(overshoot < AUTOTUNE_OVERSHOOT_MIN && ratio < AUTOTUNE_RATIO_MIN && autotune.p < AUTOTUNE_GAIN_MAX && autotune.iteration < AUTOTUNE_MAX_ITERATIONS)
+		{
+			autotune.p = MIN(autotune.p * 3 / 2 + 1, AUTOTUNE_GAIN_MAX);
+		}
+		else
+		{
+			autotuneFinish(motor, rise);
+			break;
+		}
+
+		if(autotune.status == AUTOTUNE_RUNNING)
+			autotuneSetGains(motor, autotune.p, 0);
+		break;
+	case AUTOTUNE_PHASE_RELAY:
+		autotuneRelay(motor, tick);
+		break;
+	}
+}
+// <= Autotuning
+
 static void periodicJob(uint32_t actualSystick)
 {
 	int32_t motor;
@@ -770,6 +1425,8 @@ static void periodicJob(uint32_t actualSystick)
 				&(motorConfig[motor].last_Phi_E_Selection), &(motorConfig[motor].last_UQ_UD_EXT), &(motorConfig[motor].last_PHI_E_EXT));
 	}
 
+	autotuneProcess(DEFAULT_MOTOR, actualSystick);
+
 	// 1ms velocity ramp handling
 	static uint32_t lastSystick;
 	if (lastSystick != actualSystick)
@@ -860,15 +1517,88 @@ static void timer_overflow(void)
 static void writeRegister(uint8_t motor, uint8_t address, int32_t value)
 {
 	UNUSED(motor);
+	debugRestoreSelects(address);
 	tmc4671_writeInt(DEFAULT_MOTOR, address, value);
 }
 
 static void readRegister(uint8_t motor, uint8_t address, int32_t *value)
 {
 	UNUSED(motor);
+	debugRestoreSelects(address);
 	*value = tmc4671_readInt(DEFAULT_MOTOR, address);
 }
 
+// Exchange one 40 bit datagram as a single array transfer
+static int32_t debugTransfer(uint8_t address, int32_t value)
+{
+	uint8_t data[5] = { address, BYTE(value, 3), BYTE(value, 2), BYTE(value, 1), BYTE(value, 0) };
+
+	TMC4671_SPIChannel->readWriteArray(data, ARRAY_SIZE(data));
+
+	return ((uint32_t) data[1] << 24) | ((uint32_t) data[2] << 16) | ((uint32_t) data[3] << 8) | data[4];
+}
+
+// RAMDebug burst read: All register channels of a sample get read back to back
+// without going through readRegister. For stacked registers the select gets
+// written only when it differs from the last one written - the host selection is
+// saved once and restored lazily instead of around every single sample.
+static void debugBurstRead(const uint8_t *types, const uint32_t *addresses, uint32_t *samples, uint8_t count)
+{
+	for(uint8_t i = 0; i < count; i++)
+	{
+		uint8_t dataAddress = addresses[i] & 0x7F;
+
+		if(types[i] == CAPTURE_STACKED_REGISTER)
+		{
+			uint8_t selectAddress = (addresses[i] >> 8) & 0x7F;
+			uint8_t selectValue   = (addresses[i] >> 16) & 0xFF;
+			uint8_t j;
+
+			// Save the host selection the first time this select register gets used
+			for(j = 0; j < debugSelectCount; j++)
+				if(debugSelects[j].selectAddress == selectAddress)
+					break;
+
+			if(j == debugSelectCount && j < ARRAY_SIZE(debugSelects))
+			{
+				debugSelects[j].selectAddress = selectAddress;
+				debugSelects[j].dataAddress   = dataAddress;
+				debugSelects[j].hostValue     = debugTransfer(selectAddress, 0);
+				debugSelectCount++;
+			}
+
+			if((selectAddress != debugLastSelectAddress) || (selectValue != debugLastSelectValue))
+			{
+				debugTransfer(selectAddress | TMC_WRITE_BIT, selectValue);
+				debugLastSelectAddress = selectAddress;
+				debugLastSelectValue   = selectValue;
+			}
+		}
+
+		samples[i] = debugTransfer(dataAddress, 0);
+	}
+}
+
+static void debugRestoreSelects(uint8_t address)
+{
+	bool restore = false;
+
+	address &= 0x7F;
+
+	for(uint8_t i = 0; i < debugSelectCount; i++)
+		if((debugSelects[i].selectAddress == address) || (debugSelects[i].dataAddress == address))
+			restore = true;
+
+	if(!restore)
+		return;
+
+	for(uint8_t i = 0; i < debugSelectCount; i++)
+		tmc4671_writeInt(DEFAULT_MOTOR, debugSelects[i].selectAddress, debugSelects[i].hostValue);
+
+	debugSelectCount = 0;
+	debugLastSelectAddress = -1;
+}
+
 static uint32_t SAP(uint8_t type, uint8_t motor, int32_t value)
 {
 	return handleParameter(WRITE, motor, type, &value);
@@ -900,8 +1630,10 @@ static void enableDriver(DriverState state)
 
 static void deInit(void)
 {
+	autotuneStart(DEFAULT_MOTOR, AUTOTUNE_LOOP_NONE);
 	enableDriver(DRIVER_DISABLE);
 	HAL.IOs->config->setLow(PIN_DRV_ENN);
+	debug_setBurstRead(CHANNEL_1, NULL);
 };
 
 static uint8_t reset()
@@ -946,6 +1678,7 @@ void TMC4671_init(void)
 
 	TMC4671_SPIChannel = &HAL.SPI->ch1;
 	TMC4671_SPIChannel->CSN = &HAL.IOs->pins->SPI1_CSN;
+	Evalboards.ch1.spiProfile = SPI_PROFILE_FIXED(TMC4671_SPIChannel, 4000000);
 
 	TMC4671_config = Evalboards.ch1.config;
 
@@ -1029,4 +1762,11 @@ void TMC4671_init(void)
 	Timer.init();
 	Timer.setFrequency(TIMER_CHANNEL_2, 10000);
 	debug_updateFrequency(10000);
+
+	autotune.status    = AUTOTUNE_IDLE;
+	autotune.amplitude = 0;
+
+	// Read the RAMDebug register channels in one SPI burst per sample
+	debugSelectCount = 0;
+	debug_setBurstRead(CHANNEL_1, debugBurstRead);
 }
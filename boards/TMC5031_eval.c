@@ -830,6 +830,7 @@ void TMC5031_init(void)
 
 	TMC5031_SPIChannel = &HAL.SPI->ch1;
 	TMC5031_SPIChannel->CSN = &HAL.IOs->pins->SPI1_CSN;
+	Evalboards.ch1.spiProfile = SPI_PROFILE_FIXED(TMC5031_SPIChannel, 4000000);
 
 	TMC5031_config = Evalboards.ch1.config;
 
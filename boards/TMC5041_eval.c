@@ -17,6 +17,13 @@
 #define VM_MIN  50   // VM[V/10] min
 #define VM_MAX  280  // VM[V/10] max +10%
 
+// Status snapshot: XACTUAL, VACTUAL (signed 24 bit), XTARGET and RAMPSTAT per motor
+static const SnapshotRegisterTypeDef snapshotRegisters[] =
+{
+	{ TMC5041_XACTUAL(0), 0 }, { TMC5041_VACTUAL(0), 24 }, { TMC5041_XTARGET(0), 0 }, { TMC5041_RAMPSTAT(0), 0 },
+	{ TMC5041_XACTUAL(1), 0 }, { TMC5041_VACTUAL(1), 24 }, { TMC5041_XTARGET(1), 0 }, { TMC5041_RAMPSTAT(1), 0 }
+};
+
 static uint32_t right(uint8_t motor, int32_t velocity);
 static uint32_t left(uint8_t motor, int32_t velocity);
 static uint32_t rotate(uint8_t motor, int32_t velocity);
@@ -29,6 +36,7 @@ static uint32_t SAP(uint8_t type, uint8_t motor, int32_t value);
 static void readRegister(uint8_t motor, uint8_t address, int32_t *value);
 static void writeRegister(uint8_t motor, uint8_t address, int32_t value);
 static uint32_t getMeasuredSpeed(uint8_t motor, int32_t *value);
+static uint32_t readSnapshot(uint8_t *data, size_t size, size_t *length);
 
 static void periodicJob(uint32_t tick);
 static void checkErrors	(uint32_t tick);
@@ -660,6 +668,12 @@ static void readRegister(uint8_t motor, uint8_t address, int32_t *value)
 	*value = tmc5041_readInt(&TMC5041, address);
 }
 
+// Status registers of both motors, pipelined over SPI
+static uint32_t readSnapshot(uint8_t *data, size_t size, size_t *length)
+{
+	return board_readSnapshot(TMC5041_SPIChannel, NULL, snapshotRegisters, ARRAY_SIZE(snapshotRegisters), data, size, length);
+}
+
 static void periodicJob(uint32_t tick)
 {
 	tmc5041_periodicJob(&TMC5041, tick);
@@ -740,6 +754,8 @@ void TMC5041_init(void)
 	TMC5041_SPIChannel = &HAL.SPI->ch1;
 	TMC5041_SPIChannel->CSN = &HAL.IOs->pins->SPI1_CSN;
 
+	Evalboards.ch1.spiProfile = SPI_PROFILE_IOIN(TMC5041_SPIChannel, 4000000, 8000000, 0x10);
+
 	TMC5041_config = Evalboards.ch1.config;
 
 	Evalboards.ch1.config->reset        = reset;
@@ -759,6 +775,7 @@ void TMC5041_init(void)
 	Evalboards.ch1.readRegister         = readRegister;
 	Evalboards.ch1.periodicJob          = periodicJob;
 	Evalboards.ch1.userFunction         = userFunction;
+	Evalboards.ch1.readSnapshot         = readSnapshot;
 	Evalboards.ch1.getMeasuredSpeed     = getMeasuredSpeed;
 	Evalboards.ch1.enableDriver         = enableDriver;
 	Evalboards.ch1.checkErrors          = checkErrors;
@@ -832,6 +832,7 @@ void TMC5062_init(void)
 
 	TMC5062_SPIChannel = &HAL.SPI->ch1;
 	TMC5062_SPIChannel->CSN = &HAL.IOs->pins->SPI1_CSN;
+	Evalboards.ch1.spiProfile = SPI_PROFILE_FIXED(TMC5062_SPIChannel, 4000000);
 
 	TMC5062_MicroStepTable microStepTable;
 	microStepTable.LUT_0  = 0xAAAAB554;
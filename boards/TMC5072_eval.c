@@ -19,6 +19,13 @@
 
 #define DEFAULT_CHANNEL 0
 
+// Status snapshot: XACTUAL, VACTUAL (signed 24 bit), XTARGET and RAMPSTAT per motor
+static const SnapshotRegisterTypeDef snapshotRegisters[] =
+{
+	{ TMC5072_XACTUAL(0), 0 }, { TMC5072_VACTUAL(0), 24 }, { TMC5072_XTARGET(0), 0 }, { TMC5072_RAMPSTAT(0), 0 },
+	{ TMC5072_XACTUAL(1), 0 }, { TMC5072_VACTUAL(1), 24 }, { TMC5072_XTARGET(1), 0 }, { TMC5072_RAMPSTAT(1), 0 }
+};
+
 static uint32_t right(uint8_t motor, int32_t velocity);
 static uint32_t left(uint8_t motor, int32_t velocity);
 static uint32_t rotate(uint8_t motor, int32_t velocity);
@@ -31,6 +38,7 @@ static uint32_t SAP(uint8_t type, uint8_t motor, int32_t value);
 static void readRegister(uint8_t motor, uint8_t address, int32_t *value);
 static void writeRegister(uint8_t motor, uint8_t address, int32_t value);
 static uint32_t getMeasuredSpeed(uint8_t motor, int32_t *value);
+static uint32_t readSnapshot(uint8_t *data, size_t size, size_t *length);
 
 static void periodicJob(uint32_t tick);
 static void checkErrors	(uint32_t tick);
@@ -662,6 +670,12 @@ static void readRegister(uint8_t motor, uint8_t address, int32_t *value)
 	*value = tmc5072_readInt(motorToIC(motor), address);
 }
 
+// Status registers of both motors, pipelined over SPI
+static uint32_t readSnapshot(uint8_t *data, size_t size, size_t *length)
+{
+	return board_readSnapshot(TMC5072_SPIChannel, NULL, snapshotRegisters, ARRAY_SIZE(snapshotRegisters), data, size, length);
+}
+
 static void periodicJob(uint32_t tick)
 {
 	for(uint8_t motor = 0; motor < TMC5072_MOTORS; motor++)
@@ -783,6 +797,8 @@ void TMC5072_init(void)
 	TMC5072_SPIChannel = &HAL.SPI->ch1;
 	TMC5072_SPIChannel->CSN = &HAL.IOs->pins->SPI1_CSN;
 
+	Evalboards.ch1.spiProfile = SPI_PROFILE_IOIN(TMC5072_SPIChannel, 4000000, 8000000, 0x10);
+
 	Evalboards.ch1.config->reset        = reset;
 	Evalboards.ch1.config->restore      = restore;
 	Evalboards.ch1.config->state        = CONFIG_RESET;
@@ -800,6 +816,7 @@ void TMC5072_init(void)
 	Evalboards.ch1.readRegister         = readRegister;
 	Evalboards.ch1.periodicJob          = periodicJob;
 	Evalboards.ch1.userFunction         = userFunction;
+	Evalboards.ch1.readSnapshot         = readSnapshot;
 	Evalboards.ch1.getMeasuredSpeed     = getMeasuredSpeed;
 	Evalboards.ch1.enableDriver         = enableDriver;
 	Evalboards.ch1.checkErrors          = checkErrors;
@@ -226,7 +226,7 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 		} else {
 			if ((uint32_t) *value < VREF_FULLSCALE) {
 				vref = *value;
-				Timer.setDuty(TIMER_CHANNEL_1, ((float)vref) / VREF_FULLSCALE);
+				Timer.setDuty(TIMER_CHANNEL_1, TIMER_DUTY(vref, VREF_FULLSCALE));
 			} else {
 				errors |= TMC_ERROR_VALUE;
 			}
@@ -831,7 +831,7 @@ static uint32_t userFunction(uint8_t type, uint8_t motor, int32_t *value)
 			else
 				HAL.IOs->config->setLow(Pins.AIN_REF_SW);
 
-			Timer.setDuty(TIMER_CHANNEL_1, ((float)(*value % 10001)) / TIMER_MAX);
+			Timer.setDuty(TIMER_CHANNEL_1, TIMER_DUTY(MAX(*value, 0) % 10001, TIMER_MAX));
 		}
 		else
 		{
@@ -997,6 +997,8 @@ void TMC5130_init(void)
 	TMC5130_SPIChannel = &HAL.SPI->ch1;
 	TMC5130_SPIChannel->CSN = &HAL.IOs->pins->SPI1_CSN;
 
+	Evalboards.ch1.spiProfile = SPI_PROFILE_IOIN(TMC5130_SPIChannel, 4000000, 8000000, 0x11);
+
 	Evalboards.ch1.config->reset        = reset;
 	Evalboards.ch1.config->restore      = restore;
 	Evalboards.ch1.config->state        = CONFIG_RESET;
@@ -1038,7 +1040,7 @@ void TMC5130_init(void)
 	vref = 2000;
 	HAL.IOs->config->set(Pins.AIN_REF_PWM);
 	Timer.init();
-	Timer.setDuty(TIMER_CHANNEL_1, ((float)vref) / VREF_FULLSCALE);
+	Timer.setDuty(TIMER_CHANNEL_1, TIMER_DUTY(vref, VREF_FULLSCALE));
 
 	enableDriver(DRIVER_USE_GLOBAL_ENABLE);
 };
@@ -9,6 +9,8 @@
 
 #include "Board.h"
 #include "tmc/ic/TMC5160/TMC5160.h"
+#include "tmc/LoadMonitor.h"
+#include "AxisParameters.h"
 
 #define ERRORS_VM        (1<<0)
 #define ERRORS_VM_UNDER  (1<<1)
@@ -35,6 +37,8 @@ static uint32_t moveTo(uint8_t motor, int32_t position);
 static uint32_t moveBy(uint8_t motor, int32_t *ticks);
 static uint32_t GAP(uint8_t type, uint8_t motor, int32_t *value);
 static uint32_t SAP(uint8_t type, uint8_t motor, int32_t value);
+static uint32_t getMin(uint8_t type, uint8_t motor, int32_t *value);
+static uint32_t getMax(uint8_t type, uint8_t motor, int32_t *value);
 static void readRegister(uint8_t motor, uint8_t address, int32_t *value);
 static void writeRegister(uint8_t motor, uint8_t address, int32_t value);
 static uint32_t getMeasuredSpeed(uint8_t motor, int32_t *value);
@@ -51,6 +55,7 @@ static void init_comm(TMC_Board_Comm_Mode mode);
 static void periodicJob(uint32_t tick);
 static void checkErrors(uint32_t tick);
 static void deInit(void);
+static void loadMonitorRead(uint8_t motor, uint16_t *stallGuard, uint8_t *coolStep, int32_t *velocity);
 static uint32_t userFunction(uint8_t type, uint8_t motor, int32_t *value);
 
 static uint8_t reset();
@@ -221,6 +226,61 @@ static uint32_t moveBy(uint8_t motor, int32_t *ticks)
 	return 0;
 }
 
+// Axis parameters that map directly onto a register or register field, optionally with a scaling.
+// Types with other conversions or side effects are handled in handleParameter().
+static const AxisParameterTypeDef axisParameterTable[] =
+{
+	[0]   = AP_REGISTER(TMC5160_XTARGET,   0xFFFFFFFF, AP_RW | AP_SIGNED),  // Target position
+	[1]   = AP_REGISTER(TMC5160_XACTUAL,   0xFFFFFFFF, AP_RW | AP_SIGNED),  // Actual position
+	[3]   = AP_REGISTER(TMC5160_VACTUAL,   0x00FFFFFF, AP_READ | AP_SIGNED),  // Actual speed
+	[5]   = AP_REGISTER(TMC5160_AMAX,      0x0000FFFF, AP_RW),  // Maximum acceleration
+	[6]   = AP_FIELD(TMC5160_IHOLD_IRUN, TMC5160_IRUN_MASK, TMC5160_IRUN_SHIFT, AP_RW),  // Maximum current
+	[7]   = AP_FIELD(TMC5160_IHOLD_IRUN, TMC5160_IHOLD_MASK, TMC5160_IHOLD_SHIFT, AP_RW),  // Standby current
+	[8]   = AP_FIELD(TMC5160_RAMPSTAT, TMC5160_POSITION_REACHED_MASK, TMC5160_POSITION_REACHED_SHIFT, AP_READ),  // Position reached flag
+	[12]  = AP_FIELD(TMC5160_SWMODE, TMC5160_STOP_R_ENABLE_MASK, TMC5160_STOP_R_ENABLE_SHIFT, AP_RW),  // Automatic right stop
+	[13]  = AP_FIELD(TMC5160_SWMODE, TMC5160_STOP_L_ENABLE_MASK, TMC5160_STOP_L_ENABLE_SHIFT, AP_RW),  // Automatic left stop
+	[14]  = AP_REGISTER(TMC5160_SWMODE,    0x00000FFF, AP_RW),  // SW_MODE Register
+	[15]  = AP_REGISTER(TMC5160_A1,        0x0000FFFF, AP_RW),  // Acceleration A1
+	[16]  = AP_REGISTER(TMC5160_V1,        0x000FFFFF, AP_RW),  // Velocity V1
+	[17]  = AP_REGISTER(TMC5160_DMAX,      0x0000FFFF, AP_RW),  // Maximum Deceleration
+	[18]  = AP_REGISTER(TMC5160_D1,        0x0000FFFF, AP_RW),  // Deceleration D1
+	[19]  = AP_REGISTER(TMC5160_VSTART,    0x0003FFFF, AP_RW),  // Velocity VSTART
+	[20]  = AP_REGISTER(TMC5160_VSTOP,     0x0003FFFF, AP_RW),  // Velocity VSTOP
+	[21]  = AP_REGISTER(TMC5160_TZEROWAIT, 0x0000FFFF, AP_RW),  // Waiting time after ramp down
+	[23]  = AP_REGISTER_SCALED(TMC5160_THIGH, 0x000FFFFF, AP_RW, AP_SCALE_RECIPROCAL),  // Speed threshold for high speed mode
+	[24]  = AP_REGISTER(TMC5160_VDCMIN,    0x007FFFFF, AP_RW),  // Minimum speed for switching to dcStep
+	[27]  = AP_FIELD(TMC5160_CHOPCONF, TMC5160_VHIGHCHM_MASK, TMC5160_VHIGHCHM_SHIFT, AP_RW),  // High speed chopper mode
+	[28]  = AP_FIELD(TMC5160_CHOPCONF, TMC5160_VHIGHFS_MASK, TMC5160_VHIGHFS_SHIFT, AP_RW),  // High speed fullstep mode
+	[33]  = AP_FIELD(TMC5160_GCONF, TMC5160_RECALIBRATE_MASK, TMC5160_RECALIBRATE_SHIFT, AP_RW),  // Analog I Scale
+	[34]  = AP_FIELD(TMC5160_GCONF, TMC5160_REFR_DIR_MASK, TMC5160_REFR_DIR_SHIFT, AP_RW),  // Internal RSense
+	[35]  = AP_FIELD(TMC5160_GLOBAL_SCALER, TMC5160_GLOBAL_SCALER_MASK, TMC5160_GLOBAL_SCALER_SHIFT, AP_RW),  // Global current scaler
+	[140] = AP_FIELD_SCALED(TMC5160_CHOPCONF, TMC5160_MRES_MASK, TMC5160_MRES_SHIFT, AP_RW, AP_SCALE_MICROSTEPS),  // Microstep Resolution
+	[162] = AP_FIELD(TMC5160_CHOPCONF, TMC5160_TBL_MASK, TMC5160_TBL_SHIFT, AP_RW),  // Chopper blank time
+	[163] = AP_FIELD(TMC5160_CHOPCONF, TMC5160_CHM_MASK, TMC5160_CHM_SHIFT, AP_RW),  // Constant TOff Mode
+	[164] = AP_FIELD(TMC5160_CHOPCONF, TMC5160_DISFDCC_MASK, TMC5160_DISFDCC_SHIFT, AP_RW),  // Disable fast decay comparator
+	[167] = AP_FIELD(TMC5160_CHOPCONF, TMC5160_TOFF_MASK, TMC5160_TOFF_SHIFT, AP_RW),  // Chopper off time
+	[168] = AP_FIELD(TMC5160_COOLCONF, TMC5160_SEIMIN_MASK, TMC5160_SEIMIN_SHIFT, AP_RW),  // smartEnergy current minimum (SEIMIN)
+	[169] = AP_FIELD(TMC5160_COOLCONF, TMC5160_SEDN_MASK, TMC5160_SEDN_SHIFT, AP_RW),  // smartEnergy current down step
+	[170] = AP_FIELD(TMC5160_COOLCONF, TMC5160_SEMAX_MASK, TMC5160_SEMAX_SHIFT, AP_RW),  // smartEnergy hysteresis
+	[171] = AP_FIELD(TMC5160_COOLCONF, TMC5160_SEUP_MASK, TMC5160_SEUP_SHIFT, AP_RW),  // smartEnergy current up step
+	[172] = AP_FIELD(TMC5160_COOLCONF, TMC5160_SEMIN_MASK, TMC5160_SEMIN_SHIFT, AP_RW),  // smartEnergy hysteresis start
+	[173] = AP_FIELD(TMC5160_COOLCONF, TMC5160_SFILT_MASK, TMC5160_SFILT_SHIFT, AP_RW),  // stallGuard2 filter enable
+	[174] = AP_FIELD(TMC5160_COOLCONF, TMC5160_SGT_MASK, TMC5160_SGT_SHIFT, AP_RW | AP_SIGNED),  // stallGuard2 threshold
+	[180] = AP_FIELD(TMC5160_DRVSTATUS, TMC5160_CS_ACTUAL_MASK, TMC5160_CS_ACTUAL_SHIFT, AP_READ),  // smartEnergy actual current
+	[182] = AP_REGISTER_SCALED(TMC5160_TCOOLTHRS, 0x000FFFFF, AP_RW, AP_SCALE_RECIPROCAL),  // smartEnergy threshold speed
+	[184] = AP_FIELD(TMC5160_CHOPCONF, TMC5160_RNDTF_MASK, TMC5160_RNDTF_SHIFT, AP_RW),  // Random TOff mode
+	[186] = AP_REGISTER_SCALED(TMC5160_TPWMTHRS, 0x000FFFFF, AP_RW, AP_SCALE_RECIPROCAL),  // PWM threshold speed
+	[188] = AP_FIELD(TMC5160_PWMCONF, TMC5160_PWM_OFS_MASK, TMC5160_PWM_OFS_SHIFT, AP_RW),  // PWM amplitude
+	[191] = AP_FIELD(TMC5160_PWMCONF, TMC5160_PWM_FREQ_MASK, TMC5160_PWM_FREQ_SHIFT, AP_RW),  // PWM frequency
+	[192] = AP_FIELD(TMC5160_PWMCONF, TMC5160_PWM_AUTOSCALE_MASK, TMC5160_PWM_AUTOSCALE_SHIFT, AP_RW),  // PWM autoscale
+	[204] = AP_FIELD(TMC5160_PWMCONF, TMC5160_FREEWHEEL_MASK, TMC5160_FREEWHEEL_SHIFT, AP_RW),  // Freewheeling mode
+	[206] = AP_FIELD(TMC5160_DRVSTATUS, TMC5160_SG_RESULT_MASK, TMC5160_SG_RESULT_SHIFT, AP_READ),  // Load value
+	[209] = AP_REGISTER(TMC5160_XENC,      0xFFFFFFFF, AP_RW | AP_SIGNED),  // Encoder position
+	[210] = AP_REGISTER(TMC5160_ENC_CONST, 0xFFFFFFFF, AP_RW | AP_SIGNED),  // Encoder Resolution
+};
+
+static const AxisParameterTableTypeDef axisParameters = AP_TABLE(axisParameterTable, readRegister, writeRegister);
+
 static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type, int32_t *value)
 {
 	uint32_t buffer;
@@ -229,24 +289,11 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 	if(motor >= TMC5160_MOTORS)
 		return TMC_ERROR_MOTOR;
 
+	if(axisparameter_find(&axisParameters, type))
+		return axisparameter_handle(&axisParameters, readWrite, motor, type, value);
+
 	switch(type)
 	{
-	case 0:
-		// Target position
-		if(readWrite == READ) {
-			*value = tmc5160_readInt(motorToIC(motor), TMC5160_XTARGET);
-		} else if(readWrite == WRITE) {
-			tmc5160_writeInt(motorToIC(motor), TMC5160_XTARGET, *value);
-		}
-		break;
-	case 1:
-		// Actual position
-		if(readWrite == READ) {
-			*value = tmc5160_readInt(motorToIC(motor), TMC5160_XACTUAL);
-		} else if(readWrite == WRITE) {
-			tmc5160_writeInt(motorToIC(motor), TMC5160_XACTUAL, *value);
-		}
-		break;
 	case 2:
 		// Target speed
 		if(readWrite == READ) {
@@ -256,15 +303,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 			vMaxModified = true;
 		}
 		break;
-	case 3:
-		// Actual speed
-		if(readWrite == READ) {
-			*value = tmc5160_readInt(motorToIC(motor), TMC5160_VACTUAL);
-			*value = CAST_Sn_TO_S32(*value, 24);
-		} else if(readWrite == WRITE) {
-			errors |= TMC_ERROR_TYPE;
-		}
-		break;
 	case 4:
 		// Maximum speed
 		if(readWrite == READ) {
@@ -275,38 +313,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 				tmc5160_writeInt(motorToIC(motor), TMC5160_VMAX, abs(*value));
 		}
 		break;
-	case 5:
-		// Maximum acceleration
-		if(readWrite == READ) {
-			*value = tmc5160_readInt(motorToIC(motor), TMC5160_AMAX);
-		} else if(readWrite == WRITE) {
-			tmc5160_writeInt(motorToIC(motor), TMC5160_AMAX, *value);
-		}
-		break;
-	case 6:
-		// Maximum current
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_IHOLD_IRUN, TMC5160_IRUN_MASK, TMC5160_IRUN_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_IHOLD_IRUN, TMC5160_IRUN_MASK, TMC5160_IRUN_SHIFT, *value);
-		}
-		break;
-	case 7:
-		// Standby current
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_IHOLD_IRUN, TMC5160_IHOLD_MASK, TMC5160_IHOLD_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_IHOLD_IRUN, TMC5160_IHOLD_MASK, TMC5160_IHOLD_SHIFT, *value);
-		}
-		break;
-	case 8:
-		// Position reached flag
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_RAMPSTAT, TMC5160_POSITION_REACHED_MASK, TMC5160_POSITION_REACHED_SHIFT);
-		} else if(readWrite == WRITE) {
-			errors |= TMC_ERROR_TYPE;
-		}
-		break;
 	case 10:
 		// Right endstop
 		if(readWrite == READ) {
@@ -323,120 +329,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 			errors |= TMC_ERROR_TYPE;
 		}
 		break;
-	case 12:
-		// Automatic right stop
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_SWMODE, TMC5160_STOP_R_ENABLE_MASK, TMC5160_STOP_R_ENABLE_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_SWMODE, TMC5160_STOP_R_ENABLE_MASK, TMC5160_STOP_R_ENABLE_SHIFT, *value);
-		}
-		break;
-	case 13:
-		// Automatic left stop
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_SWMODE, TMC5160_STOP_L_ENABLE_MASK, TMC5160_STOP_L_ENABLE_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_SWMODE, TMC5160_STOP_L_ENABLE_MASK, TMC5160_STOP_L_ENABLE_SHIFT, *value);
-		}
-		break;
-	case 14:
-		// SW_MODE Register
-		if(readWrite == READ) {
-			*value = tmc5160_readInt(motorToIC(motor), TMC5160_SWMODE);
-		} else if(readWrite == WRITE) {
-			tmc5160_writeInt(motorToIC(motor), TMC5160_SWMODE, *value);
-		}
-		break;
-	case 15:
-		// Acceleration A1
-		if(readWrite == READ) {
-			*value = tmc5160_readInt(motorToIC(motor), TMC5160_A1);
-		} else if(readWrite == WRITE) {
-			tmc5160_writeInt(motorToIC(motor), TMC5160_A1, *value);
-		}
-		break;
-	case 16:
-		// Velocity V1
-		if(readWrite == READ) {
-			*value = tmc5160_readInt(motorToIC(motor), TMC5160_V1);
-		} else if(readWrite == WRITE) {
-			tmc5160_writeInt(motorToIC(motor), TMC5160_V1, *value);
-		}
-		break;
-	case 17:
-		// Maximum Deceleration
-		if(readWrite == READ) {
-			*value = tmc5160_readInt(motorToIC(motor), TMC5160_DMAX);
-		} else if(readWrite == WRITE) {
-			tmc5160_writeInt(motorToIC(motor), TMC5160_DMAX, *value);
-		}
-		break;
-	case 18:
-		// Deceleration D1
-		if(readWrite == READ) {
-			*value = tmc5160_readInt(motorToIC(motor), TMC5160_D1);
-		} else if(readWrite == WRITE) {
-			tmc5160_writeInt(motorToIC(motor), TMC5160_D1, *value);
-		}
-		break;
-	case 19:
-		// Velocity VSTART
-		if(readWrite == READ) {
-			*value = tmc5160_readInt(motorToIC(motor), TMC5160_VSTART);
-		} else if(readWrite == WRITE) {
-			tmc5160_writeInt(motorToIC(motor), TMC5160_VSTART, *value);
-		}
-		break;
-	case 20:
-		// Velocity VSTOP
-		if(readWrite == READ) {
-			*value = tmc5160_readInt(motorToIC(motor), TMC5160_VSTOP);
-		} else if(readWrite == WRITE) {
-			tmc5160_writeInt(motorToIC(motor), TMC5160_VSTOP, *value);
-		}
-		break;
-	case 21:
-		// Waiting time after ramp down
-		if(readWrite == READ) {
-			*value = tmc5160_readInt(motorToIC(motor), TMC5160_TZEROWAIT);
-		} else if(readWrite == WRITE) {
-			tmc5160_writeInt(motorToIC(motor), TMC5160_TZEROWAIT, *value);
-		}
-		break;
-	case 23:
-		// Speed threshold for high speed mode
-		if(readWrite == READ) {
-			buffer = tmc5160_readInt(motorToIC(motor), TMC5160_THIGH);
-			*value = MIN(0xFFFFF, (1 << 24) / ((buffer)? buffer : 1));
-		} else if(readWrite == WRITE) {
-			*value = MIN(0xFFFFF, (1 << 24) / ((*value)? *value:1));
-			tmc5160_writeInt(motorToIC(motor), TMC5160_THIGH, *value);
-		}
-		break;
-	case 24:
-		// Minimum speed for switching to dcStep
-		if(readWrite == READ) {
-			*value = tmc5160_readInt(motorToIC(motor), TMC5160_VDCMIN);
-		} else if(readWrite == WRITE) {
-			tmc5160_writeInt(motorToIC(motor), TMC5160_VDCMIN, *value);
-		}
-		break;
-	case 27:
-		// High speed chopper mode
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_CHOPCONF, TMC5160_VHIGHCHM_MASK, TMC5160_VHIGHCHM_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_CHOPCONF, TMC5160_VHIGHCHM_MASK, TMC5160_VHIGHCHM_SHIFT, *value);
-		}
-		break;
-	case 28:
-		// High speed fullstep mode
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_CHOPCONF, TMC5160_VHIGHFS_MASK, TMC5160_VHIGHFS_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_CHOPCONF, TMC5160_VHIGHFS_MASK, TMC5160_VHIGHFS_SHIFT, *value);
-		}
-		break;
 	case 29:
 		// Measured Speed
 		if(readWrite == READ) {
@@ -445,83 +337,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 			errors |= TMC_ERROR_TYPE;
 		}
 		break;
-	case 33:
-		// Analog I Scale
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_GCONF, TMC5160_RECALIBRATE_MASK, TMC5160_RECALIBRATE_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_GCONF, TMC5160_RECALIBRATE_MASK, TMC5160_RECALIBRATE_SHIFT, *value);
-		}
-		break;
-	case 34:
-		// Internal RSense
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_GCONF, TMC5160_REFR_DIR_MASK, TMC5160_REFR_DIR_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_GCONF, TMC5160_REFR_DIR_MASK, TMC5160_REFR_DIR_SHIFT, *value);
-		}
-		break;
-	case 35:
-		// Global current scaler
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_GLOBAL_SCALER, TMC5160_GLOBAL_SCALER_MASK, TMC5160_GLOBAL_SCALER_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_GLOBAL_SCALER, TMC5160_GLOBAL_SCALER_MASK, TMC5160_GLOBAL_SCALER_SHIFT, *value);
-		}
-		break;
-	case 140:
-		// Microstep Resolution
-		if(readWrite == READ) {
-			*value = 0x100 >> TMC5160_FIELD_READ(motorToIC(motor), TMC5160_CHOPCONF, TMC5160_MRES_MASK, TMC5160_MRES_SHIFT);
-		} else if(readWrite == WRITE) {
-			switch(*value)
-			{
-				case 1:    *value = 8;   break;
-				case 2:    *value = 7;   break;
-				case 4:    *value = 6;   break;
-				case 8:    *value = 5;   break;
-				case 16:   *value = 4;   break;
-				case 32:   *value = 3;   break;
-				case 64:   *value = 2;   break;
-				case 128:  *value = 1;   break;
-				case 256:  *value = 0;   break;
-				default:   *value = -1;  break;
-			}
-
-			if(*value != -1)
-			{
-				TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_CHOPCONF, TMC5160_MRES_MASK, TMC5160_MRES_SHIFT, *value);
-			}
-			else
-			{
-				errors |= TMC_ERROR_VALUE;
-			}
-		}
-		break;
-	case 162:
-		// Chopper blank time
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_CHOPCONF, TMC5160_TBL_MASK, TMC5160_TBL_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_CHOPCONF, TMC5160_TBL_MASK, TMC5160_TBL_SHIFT, *value);
-		}
-		break;
-	case 163:
-		// Constant TOff Mode
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_CHOPCONF, TMC5160_CHM_MASK, TMC5160_CHM_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_CHOPCONF, TMC5160_CHM_MASK, TMC5160_CHM_SHIFT, *value);
-		}
-		break;
-	case 164:
-		// Disable fast decay comparator
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_CHOPCONF, TMC5160_DISFDCC_MASK, TMC5160_DISFDCC_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_CHOPCONF, TMC5160_DISFDCC_MASK, TMC5160_DISFDCC_SHIFT, *value);
-		}
-		break;
 	case 165:
 		// Chopper hysteresis end / fast decay time
 		buffer = tmc5160_readInt(motorToIC(motor), TMC5160_CHOPCONF);
@@ -573,79 +388,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 			}
 		}
 		break;
-	case 167:
-		// Chopper off time
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_CHOPCONF, TMC5160_TOFF_MASK, TMC5160_TOFF_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_CHOPCONF, TMC5160_TOFF_MASK, TMC5160_TOFF_SHIFT, *value);
-		}
-		break;
-	case 168:
-		// smartEnergy current minimum (SEIMIN)
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_COOLCONF, TMC5160_SEIMIN_MASK, TMC5160_SEIMIN_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_COOLCONF, TMC5160_SEIMIN_MASK, TMC5160_SEIMIN_SHIFT, *value);
-		}
-		break;
-	case 169:
-		// smartEnergy current down step
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_COOLCONF, TMC5160_SEDN_MASK, TMC5160_SEDN_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_COOLCONF, TMC5160_SEDN_MASK, TMC5160_SEDN_SHIFT, *value);
-		}
-		break;
-	case 170:
-		// smartEnergy hysteresis
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_COOLCONF, TMC5160_SEMAX_MASK, TMC5160_SEMAX_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_COOLCONF, TMC5160_SEMAX_MASK, TMC5160_SEMAX_SHIFT, *value);
-		}
-		break;
-	case 171:
-		// smartEnergy current up step
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_COOLCONF, TMC5160_SEUP_MASK, TMC5160_SEUP_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_COOLCONF, TMC5160_SEUP_MASK, TMC5160_SEUP_SHIFT, *value);
-		}
-		break;
-	case 172:
-		// smartEnergy hysteresis start
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_COOLCONF, TMC5160_SEMIN_MASK, TMC5160_SEMIN_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_COOLCONF, TMC5160_SEMIN_MASK, TMC5160_SEMIN_SHIFT, *value);
-		}
-		break;
-	case 173:
-		// stallGuard2 filter enable
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_COOLCONF, TMC5160_SFILT_MASK, TMC5160_SFILT_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_COOLCONF, TMC5160_SFILT_MASK, TMC5160_SFILT_SHIFT, *value);
-		}
-		break;
-	case 174:
-		// stallGuard2 threshold
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_COOLCONF, TMC5160_SGT_MASK, TMC5160_SGT_SHIFT);
-			*value = CAST_Sn_TO_S32(*value, 7);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_COOLCONF, TMC5160_SGT_MASK, TMC5160_SGT_SHIFT, *value);
-		}
-		break;
-	case 180:
-		// smartEnergy actual current
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_DRVSTATUS, TMC5160_CS_ACTUAL_MASK, TMC5160_CS_ACTUAL_SHIFT);
-		} else if(readWrite == WRITE) {
-			errors |= TMC_ERROR_TYPE;
-		}
-		break;
 	case 181:
 		// smartEnergy stall velocity
 		//this function sort of doubles with 182 but is necessary to allow cross chip compliance
@@ -666,24 +408,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 			tmc5160_writeInt(motorToIC(motor), TMC5160_TCOOLTHRS, *value);
 		}
 		break;
-	case 182:
-		// smartEnergy threshold speed
-		if(readWrite == READ) {
-			buffer = tmc5160_readInt(motorToIC(motor), TMC5160_TCOOLTHRS);
-			*value = MIN(0xFFFFF, (1<<24) / ((buffer)? buffer:1));
-		} else if(readWrite == WRITE) {
-			*value = MIN(0xFFFFF, (1<<24) / ((*value)? *value:1));
-			tmc5160_writeInt(motorToIC(motor), TMC5160_TCOOLTHRS, *value);
-		}
-		break;
-	case 184:
-		// Random TOff mode
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_CHOPCONF, TMC5160_RNDTF_MASK, TMC5160_RNDTF_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_CHOPCONF, TMC5160_RNDTF_MASK, TMC5160_RNDTF_SHIFT, *value);
-		}
-		break;
 	case 185:
 		// Chopper synchronization
 		if(readWrite == READ) {
@@ -695,16 +419,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 			tmc5160_writeInt(motorToIC(motor), TMC5160_CHOPCONF,buffer);
 		}
 		break;
-	case 186:
-		// PWM threshold speed
-		if(readWrite == READ) {
-			buffer = tmc5160_readInt(motorToIC(motor), TMC5160_TPWMTHRS);
-			*value = MIN(0xFFFFF, (1<<24) / ((buffer)? buffer:1));
-		} else if(readWrite == WRITE) {
-			*value = MIN(0xFFFFF, (1<<24) / ((*value)? *value:1));
-			tmc5160_writeInt(motorToIC(motor), TMC5160_TPWMTHRS, *value);
-		}
-		break;
 	case 187:
 		// PWM gradient
 		if(readWrite == READ) {
@@ -716,76 +430,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_GCONF, TMC5160_EN_PWM_MODE_MASK, TMC5160_EN_PWM_MODE_SHIFT, (*value) ? 1 : 0);
 		}
 		break;
-	case 188:
-		// PWM amplitude
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_PWMCONF, TMC5160_PWM_OFS_MASK, TMC5160_PWM_OFS_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_PWMCONF, TMC5160_PWM_OFS_MASK, TMC5160_PWM_OFS_SHIFT, *value);
-		}
-		break;
-	case 191:
-		// PWM frequency
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_PWMCONF, TMC5160_PWM_FREQ_MASK, TMC5160_PWM_FREQ_SHIFT);
-		} else if(readWrite == WRITE) {
-			if(*value >= 0 && *value < 4)
-			{
-				TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_PWMCONF, TMC5160_PWM_FREQ_MASK, TMC5160_PWM_FREQ_SHIFT, *value);
-			}
-			else
-			{
-				errors |= TMC_ERROR_VALUE;
-			}
-		}
-		break;
-	case 192:
-		// PWM autoscale
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_PWMCONF, TMC5160_PWM_AUTOSCALE_MASK, TMC5160_PWM_AUTOSCALE_SHIFT);
-		} else if(readWrite == WRITE) {
-			if(*value >= 0 && *value < 2)
-			{
-				TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_PWMCONF, TMC5160_PWM_AUTOSCALE_MASK, TMC5160_PWM_AUTOSCALE_SHIFT, *value);
-			}
-			else
-			{
-				errors |= TMC_ERROR_VALUE;
-			}
-		}
-		break;
-	case 204:
-		// Freewheeling mode
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_PWMCONF, TMC5160_FREEWHEEL_MASK, TMC5160_FREEWHEEL_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5160_FIELD_WRITE(motorToIC(motor), TMC5160_PWMCONF, TMC5160_FREEWHEEL_MASK, TMC5160_FREEWHEEL_SHIFT, *value);
-		}
-		break;
-	case 206:
-		// Load value
-		if(readWrite == READ) {
-			*value = TMC5160_FIELD_READ(motorToIC(motor), TMC5160_DRVSTATUS, TMC5160_SG_RESULT_MASK, TMC5160_SG_RESULT_SHIFT);
-		} else if(readWrite == WRITE) {
-			errors |= TMC_ERROR_TYPE;
-		}
-		break;
-	case 209:
-		// Encoder position
-		if(readWrite == READ) {
-			*value = tmc5160_readInt(motorToIC(motor), TMC5160_XENC);
-		} else if(readWrite == WRITE) {
-			tmc5160_writeInt(motorToIC(motor), TMC5160_XENC, *value);
-		}
-		break;
-	case 210:
-		// Encoder Resolution
-		if(readWrite == READ) {
-			*value = tmc5160_readInt(motorToIC(motor), TMC5160_ENC_CONST);
-		} else if(readWrite == WRITE) {
-			tmc5160_writeInt(motorToIC(motor), TMC5160_ENC_CONST, *value);
-		}
-		break;
 	default:
 		errors |= TMC_ERROR_TYPE;
 		break;
@@ -803,6 +447,22 @@ static uint32_t GAP(uint8_t type, uint8_t motor, int32_t *value)
 	return handleParameter(READ, motor, type, value);
 }
 
+static uint32_t getMin(uint8_t type, uint8_t motor, int32_t *value)
+{
+	if(motor >= TMC5160_MOTORS)
+		return TMC_ERROR_MOTOR;
+
+	return axisparameter_getLimit(&axisParameters, LIMIT_MIN, type, value);
+}
+
+static uint32_t getMax(uint8_t type, uint8_t motor, int32_t *value)
+{
+	if(motor >= TMC5160_MOTORS)
+		return TMC_ERROR_MOTOR;
+
+	return axisparameter_getLimit(&axisParameters, LIMIT_MAX, type, value);
+}
+
 static uint32_t getMeasuredSpeed(uint8_t motor, int32_t *value)
 {
 	if(motor >= TMC5160_MOTORS)
@@ -982,8 +642,20 @@ static uint32_t userFunction(uint8_t type, uint8_t motor, int32_t *value)
 	return errors;
 }
 
+static void loadMonitorRead(uint8_t motor, uint16_t *stallGuard, uint8_t *coolStep, int32_t *velocity)
+{
+	// SG_RESULT and CS_ACTUAL share the DRV_STATUS register
+	uint32_t drvStatus = tmc5160_readInt(motorToIC(motor), TMC5160_DRVSTATUS);
+
+	*stallGuard  = (drvStatus & TMC5160_SG_RESULT_MASK) >> TMC5160_SG_RESULT_SHIFT;
+	*coolStep    = (drvStatus & TMC5160_CS_ACTUAL_MASK) >> TMC5160_CS_ACTUAL_SHIFT;
+	*velocity    = CAST_Sn_TO_S32(tmc5160_readInt(motorToIC(motor), TMC5160_VACTUAL), 24);
+}
+
 static void deInit(void)
 {
+	loadmonitor_setReadFunction(NULL, 0);
+
 	HAL.IOs->config->setLow(Pins.DRV_ENN_CFG6);
 	HAL.IOs->config->setLow(Pins.SD_MODE);
 	HAL.IOs->config->setLow(Pins.SPI_MODE);
@@ -1087,6 +759,10 @@ void TMC5160_init(void)
 
 	init_comm((uart_mode) ? TMC_BOARD_COMM_UART : TMC_BOARD_COMM_SPI);
 
+	// The UART interface has no SPI clock
+	if(!uart_mode)
+		Evalboards.ch1.spiProfile = SPI_PROFILE_IOIN(TMC5160_SPIChannel, 4000000, 8000000, 0x30);
+
 	Evalboards.ch1.config->reset        = reset;
 	Evalboards.ch1.config->restore      = restore;
 	Evalboards.ch1.config->state        = CONFIG_RESET;
@@ -1101,6 +777,8 @@ void TMC5160_init(void)
 	Evalboards.ch1.stop                 = stop;
 	Evalboards.ch1.GAP                  = GAP;
 	Evalboards.ch1.SAP                  = SAP;
+	Evalboards.ch1.getMin               = getMin;
+	Evalboards.ch1.getMax               = getMax;
 	Evalboards.ch1.moveTo               = moveTo;
 	Evalboards.ch1.moveBy               = moveBy;
 	Evalboards.ch1.writeRegister        = writeRegister;
@@ -1115,5 +793,7 @@ void TMC5160_init(void)
 	Evalboards.ch1.VMMax                = VM_MAX;
 	Evalboards.ch1.deInit               = deInit;
 
+	loadmonitor_setReadFunction(loadMonitorRead, TMC5160_MOTORS);
+
 	enableDriver(DRIVER_USE_GLOBAL_ENABLE);
 };
@@ -8,7 +8,9 @@
 
 
 #include "Board.h"
+#include "AxisParameters.h"
 #include "tmc/ic/TMC5240/TMC5240.h"
+#include "tmc/LoadMonitor.h"
 
 #define ERRORS_VM        (1<<0)
 #define ERRORS_VM_UNDER  (1<<1)
@@ -38,6 +40,8 @@ static uint32_t moveTo(uint8_t motor, int32_t position);
 static uint32_t moveBy(uint8_t motor, int32_t *ticks);
 static uint32_t GAP(uint8_t type, uint8_t motor, int32_t *value);
 static uint32_t SAP(uint8_t type, uint8_t motor, int32_t value);
+static uint32_t getMin(uint8_t type, uint8_t motor, int32_t *value);
+static uint32_t getMax(uint8_t type, uint8_t motor, int32_t *value);
 static void readRegister(uint8_t motor, uint8_t address, int32_t *value);
 static void writeRegister(uint8_t motor, uint8_t address, int32_t value);
 static uint32_t getMeasuredSpeed(uint8_t motor, int32_t *value);
@@ -51,6 +55,7 @@ static void init_comm(TMC_Board_Comm_Mode mode);
 static void periodicJob(uint32_t tick);
 static void checkErrors(uint32_t tick);
 static void deInit(void);
+static void loadMonitorRead(uint8_t motor, uint16_t *stallGuard, uint8_t *coolStep, int32_t *velocity);
 static uint32_t userFunction(uint8_t type, uint8_t motor, int32_t *value);
 
 static uint8_t reset();
@@ -215,6 +220,75 @@ static uint32_t moveBy(uint8_t motor, int32_t *ticks)
 	return 0;
 }
 
+// Axis parameters that map directly onto a register or register field, optionally with a scaling.
+// Types with other conversions or side effects are handled in handleParameter().
+static const AxisParameterTypeDef axisParameterTable[] =
+{
+	[0]   = AP_REGISTER(TMC5240_XTARGET,   0xFFFFFFFF, AP_RW | AP_SIGNED),  // Target position
+	[1]   = AP_REGISTER(TMC5240_XACTUAL,   0xFFFFFFFF, AP_RW | AP_SIGNED),  // Actual position
+	[3]   = AP_REGISTER(TMC5240_VACTUAL,   0x00FFFFFF, AP_READ | AP_SIGNED),  // Actual speed
+	[5]   = AP_REGISTER(TMC5240_AMAX,      0x0003FFFF, AP_RW),  // Maximum acceleration
+	[6]   = AP_FIELD(TMC5240_IHOLD_IRUN, TMC5240_IRUN_MASK, TMC5240_IRUN_SHIFT, AP_RW),  // Maximum current
+	[7]   = AP_FIELD(TMC5240_IHOLD_IRUN, TMC5240_IHOLD_MASK, TMC5240_IHOLD_SHIFT, AP_RW),  // Standby current
+	[8]   = AP_FIELD(TMC5240_RAMPSTAT, TMC5240_POSITION_REACHED_MASK, TMC5240_POSITION_REACHED_SHIFT, AP_READ),  // Position reached flag
+	[12]  = AP_FIELD(TMC5240_SWMODE, TMC5240_STOP_R_ENABLE_MASK, TMC5240_STOP_R_ENABLE_SHIFT, AP_RW),  // Automatic right stop
+	[13]  = AP_FIELD(TMC5240_SWMODE, TMC5240_STOP_L_ENABLE_MASK, TMC5240_STOP_L_ENABLE_SHIFT, AP_RW),  // Automatic left stop
+	[14]  = AP_REGISTER(TMC5240_SWMODE,    0x00003FFF, AP_RW),  // SW_MODE Register
+	[15]  = AP_REGISTER(TMC5240_DMAX,      0x0003FFFF, AP_RW),  // Maximum Deceleration
+	[16]  = AP_REGISTER(TMC5240_VSTART,    0x0003FFFF, AP_RW),  // Velocity VSTART
+	[17]  = AP_REGISTER(TMC5240_A1,        0x0003FFFF, AP_RW),  // Acceleration A1
+	[18]  = AP_REGISTER(TMC5240_V1,        0x000FFFFF, AP_RW),  // Velocity V1
+	[19]  = AP_REGISTER(TMC5240_D1,        0x0003FFFF, AP_RW),  // Deceleration D1
+	[20]  = AP_REGISTER(TMC5240_VSTOP,     0x0003FFFF, AP_RW),  // Velocity VSTOP
+	[21]  = AP_REGISTER(TMC5240_TZEROWAIT, 0x0000FFFF, AP_RW),  // Waiting time after ramp down
+	[22]  = AP_REGISTER(TMC5240_V2,        0x000FFFFF, AP_RW),  // Velocity V2
+	[23]  = AP_REGISTER(TMC5240_D2,        0x0003FFFF, AP_RW),  // Deceleration D2
+	[24]  = AP_REGISTER(TMC5240_A2,        0x0003FFFF, AP_RW),  // Acceleration A2
+	[25]  = AP_REGISTER(TMC5240_TVMAX,     0xFFFFFFFF, AP_RW),  // TVMAX
+	[26]  = AP_REGISTER_SCALED(TMC5240_THIGH, 0x000FFFFF, AP_RW, AP_SCALE_RECIPROCAL),  // Speed threshold for high speed mode
+	[27]  = AP_REGISTER(TMC5240_VDCMIN,    0x007FFFFF, AP_RW),  // Minimum speed for switching to dcStep
+	[28]  = AP_FIELD(TMC5240_CHOPCONF, TMC5240_VHIGHCHM_MASK, TMC5240_VHIGHCHM_SHIFT, AP_RW),  // High speed chopper mode
+	[29]  = AP_FIELD(TMC5240_CHOPCONF, TMC5240_VHIGHFS_MASK, TMC5240_VHIGHFS_SHIFT, AP_RW),  // High speed fullstep mode
+	[34]  = AP_FIELD(TMC5240_GCONF, TMC5240_REFR_DIR_MASK, TMC5240_REFR_DIR_SHIFT, AP_RW),  // Internal RSense
+	[140] = AP_FIELD_SCALED(TMC5240_CHOPCONF, TMC5240_MRES_MASK, TMC5240_MRES_SHIFT, AP_RW, AP_SCALE_MICROSTEPS),  // Microstep Resolution
+	[162] = AP_FIELD(TMC5240_CHOPCONF, TMC5240_TBL_MASK, TMC5240_TBL_SHIFT, AP_RW),  // Chopper blank time
+	[163] = AP_FIELD(TMC5240_CHOPCONF, TMC5240_CHM_MASK, TMC5240_CHM_SHIFT, AP_RW),  // Constant TOff Mode
+	[164] = AP_FIELD(TMC5240_CHOPCONF, TMC5240_DISFDCC_MASK, TMC5240_DISFDCC_SHIFT, AP_RW),  // Disable fast decay comparator
+	[167] = AP_FIELD(TMC5240_CHOPCONF, TMC5240_TOFF_MASK, TMC5240_TOFF_SHIFT, AP_RW),  // Chopper off time
+	[168] = AP_FIELD(TMC5240_COOLCONF, TMC5240_SEIMIN_MASK, TMC5240_SEIMIN_SHIFT, AP_RW),  // smartEnergy current minimum (SEIMIN)
+	[169] = AP_FIELD(TMC5240_COOLCONF, TMC5240_SEDN_MASK, TMC5240_SEDN_SHIFT, AP_RW),  // smartEnergy current down step
+	[170] = AP_FIELD(TMC5240_COOLCONF, TMC5240_SEMAX_MASK, TMC5240_SEMAX_SHIFT, AP_RW),  // smartEnergy hysteresis
+	[171] = AP_FIELD(TMC5240_COOLCONF, TMC5240_SEUP_MASK, TMC5240_SEUP_SHIFT, AP_RW),  // smartEnergy current up step
+	[172] = AP_FIELD(TMC5240_COOLCONF, TMC5240_SEMIN_MASK, TMC5240_SEMIN_SHIFT, AP_RW),  // smartEnergy hysteresis start
+	[173] = AP_FIELD(TMC5240_SG4_THRS, TMC5240_SG4_FILT_EN_MASK, TMC5240_SG4_FILT_EN_SHIFT, AP_RW),  // stallGuard4 filter enable
+	[174] = AP_FIELD(TMC5240_SG4_THRS, TMC5240_SG4_THRS_MASK, TMC5240_SG4_THRS_SHIFT, AP_RW | AP_SIGNED),  // stallGuard4 threshold
+	[175] = AP_FIELD(TMC5240_COOLCONF, TMC5240_SFILT_MASK, TMC5240_SFILT_SHIFT, AP_RW),  // stallGuard2 filter enable
+	[176] = AP_FIELD(TMC5240_COOLCONF, TMC5240_SGT_MASK, TMC5240_SGT_SHIFT, AP_RW | AP_SIGNED),  // stallGuard2 threshold
+	[180] = AP_FIELD(TMC5240_DRVSTATUS, TMC5240_CS_ACTUAL_MASK, TMC5240_CS_ACTUAL_SHIFT, AP_READ),  // smartEnergy actual current
+	[182] = AP_REGISTER_SCALED(TMC5240_TCOOLTHRS, 0x000FFFFF, AP_RW, AP_SCALE_RECIPROCAL),  // smartEnergy threshold speed
+	[184] = AP_FIELD(TMC5240_SG4_THRS, TMC5240_SG_ANGLE_OFFSET_MASK, TMC5240_SG_ANGLE_OFFSET_SHIFT, AP_RW),  // SG_ANGLE_OFFSET
+	[186] = AP_REGISTER_SCALED(TMC5240_TPWMTHRS, 0x000FFFFF, AP_RW, AP_SCALE_RECIPROCAL),  // PWM threshold speed
+	[188] = AP_FIELD(TMC5240_PWMCONF, TMC5240_PWM_OFS_MASK, TMC5240_PWM_OFS_SHIFT, AP_RW),  // PWM amplitude
+	[191] = AP_FIELD(TMC5240_PWMCONF, TMC5240_PWM_FREQ_MASK, TMC5240_PWM_FREQ_SHIFT, AP_RW),  // PWM frequency
+	[192] = AP_FIELD(TMC5240_PWMCONF, TMC5240_PWM_AUTOSCALE_MASK, TMC5240_PWM_AUTOSCALE_SHIFT, AP_RW),  // PWM autoscale
+	[193] = AP_FIELD(TMC5240_PWMSCALE, TMC5240_PWM_SCALE_SUM_MASK, TMC5240_PWM_SCALE_SUM_SHIFT, AP_READ),  // PWM scale sum
+	[194] = AP_FIELD(TMC5240_MSCNT, TMC5240_MSCNT_MASK, TMC5240_MSCNT_SHIFT, AP_READ),  // MSCNT
+	[195] = AP_FIELD(TMC5240_PWMCONF, TMC5240_PWM_MEAS_SD_ENABLE_MASK, TMC5240_PWM_MEAS_SD_ENABLE_SHIFT, AP_RW),  // MEAS_SD_EN
+	[196] = AP_FIELD(TMC5240_PWMCONF, TMC5240_PWM_DIS_REG_STST_MASK, TMC5240_PWM_DIS_REG_STST_SHIFT, AP_RW),  // DIS_REG_STST
+	[204] = AP_FIELD(TMC5240_PWMCONF, TMC5240_FREEWHEEL_MASK, TMC5240_FREEWHEEL_SHIFT, AP_RW),  // Freewheeling mode
+	[206] = AP_FIELD(TMC5240_DRVSTATUS, TMC5240_SG_RESULT_MASK, TMC5240_SG_RESULT_SHIFT, AP_READ),  // Load value
+	[209] = AP_REGISTER(TMC5240_XENC,      0xFFFFFFFF, AP_RW | AP_SIGNED),  // Encoder position
+	[210] = AP_REGISTER(TMC5240_ENC_CONST, 0xFFFFFFFF, AP_RW | AP_SIGNED),  // Encoder Resolution
+	[212] = AP_FIELD(TMC5240_DRV_CONF, TMC5240_CURRENT_RANGE_MASK, TMC5240_CURRENT_RANGE_SHIFT, AP_RW),  // Current range from DRV_CONF reg
+	[213] = AP_FIELD(TMC5240_ADC_TEMP, TMC5240_ADC_TEMP_MASK, TMC5240_ADC_TEMP_SHIFT, AP_READ),  // ADCTemperatur
+	[214] = AP_FIELD(TMC5240_ADC_VSUPPLY_AIN, TMC5240_ADC_AIN_MASK, TMC5240_ADC_AIN_SHIFT, AP_READ),  // ADCIN
+	[215] = AP_FIELD(TMC5240_ADC_VSUPPLY_AIN, TMC5240_ADC_VSUPPLY_MASK, TMC5240_ADC_VSUPPLY_SHIFT, AP_READ),  // ADCSupply
+	[216] = AP_FIELD(TMC5240_OTW_OV_VTH, TMC5240_OVERVOLTAGE_VTH_MASK, TMC5240_OVERVOLTAGE_VTH_SHIFT, AP_RW),  // Overvoltage Limit ADC value
+	[217] = AP_FIELD(TMC5240_OTW_OV_VTH, TMC5240_OVERTEMPPREWARNING_VTH_MASK, TMC5240_OVERTEMPPREWARNING_VTH_SHIFT, AP_RW),  // Overtemperature Warning Limit
+};
+
+static const AxisParameterTableTypeDef axisParameters = AP_TABLE(axisParameterTable, readRegister, writeRegister);
+
 static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type, int32_t *value)
 {
 	uint32_t buffer;
@@ -223,24 +297,11 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 	if(motor >= TMC5240_MOTORS)
 		return TMC_ERROR_MOTOR;
 
+	if(axisparameter_find(&axisParameters, type))
+		return axisparameter_handle(&axisParameters, readWrite, motor, type, value);
+
 	switch(type)
 	{
-	case 0:
-		// Target position
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_XTARGET);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_XTARGET, *value);
-		}
-		break;
-	case 1:
-		// Actual position
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_XACTUAL);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_XACTUAL, *value);
-		}
-		break;
 	case 2:
 		// Target speed
 		if(readWrite == READ) {
@@ -250,15 +311,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 			vMaxModified = true;
 		}
 		break;
-	case 3:
-		// Actual speed
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_VACTUAL);
-			*value = CAST_Sn_TO_S32(*value, 24);
-		} else if(readWrite == WRITE) {
-			errors |= TMC_ERROR_TYPE;
-		}
-		break;
 	case 4:
 		// Maximum speed
 		if(readWrite == READ) {
@@ -269,38 +321,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 				tmc5240_writeInt(motorToIC(motor), TMC5240_VMAX, abs(*value));
 		}
 		break;
-	case 5:
-		// Maximum acceleration
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_AMAX);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_AMAX, *value);
-		}
-		break;
-	case 6:
-		// Maximum current
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_IHOLD_IRUN, TMC5240_IRUN_MASK, TMC5240_IRUN_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_IHOLD_IRUN, TMC5240_IRUN_MASK, TMC5240_IRUN_SHIFT, *value);
-		}
-		break;
-	case 7:
-		// Standby current
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_IHOLD_IRUN, TMC5240_IHOLD_MASK, TMC5240_IHOLD_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_IHOLD_IRUN, TMC5240_IHOLD_MASK, TMC5240_IHOLD_SHIFT, *value);
-		}
-		break;
-	case 8:
-		// Position reached flag
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_RAMPSTAT, TMC5240_POSITION_REACHED_MASK, TMC5240_POSITION_REACHED_SHIFT);
-		} else if(readWrite == WRITE) {
-			errors |= TMC_ERROR_TYPE;
-		}
-		break;
 	case 10:
 		// Right endstop
 		if(readWrite == READ) {
@@ -317,154 +337,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 			errors |= TMC_ERROR_TYPE;
 		}
 		break;
-	case 12:
-		// Automatic right stop
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_SWMODE, TMC5240_STOP_R_ENABLE_MASK, TMC5240_STOP_R_ENABLE_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_SWMODE, TMC5240_STOP_R_ENABLE_MASK, TMC5240_STOP_R_ENABLE_SHIFT, *value);
-		}
-		break;
-	case 13:
-		// Automatic left stop
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_SWMODE, TMC5240_STOP_L_ENABLE_MASK, TMC5240_STOP_L_ENABLE_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_SWMODE, TMC5240_STOP_L_ENABLE_MASK, TMC5240_STOP_L_ENABLE_SHIFT, *value);
-		}
-		break;
-	case 14:
-		// SW_MODE Register
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_SWMODE);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_SWMODE, *value);
-		}
-		break;
-	case 15:
-		// Maximum Deceleration
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_DMAX);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_DMAX, *value);
-		}
-		break;
-	case 16:
-		// Velocity VSTART
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_VSTART);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_VSTART, *value);
-		}
-		break;
-	case 17:
-		// Acceleration A1
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_A1);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_A1, *value);
-		}
-		break;
-	case 18:
-		// Velocity V1
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_V1);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_V1, *value);
-		}
-		break;
-	case 19:
-		// Deceleration D1
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_D1);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_D1, *value);
-		}
-		break;
-	case 20:
-		// Velocity VSTOP
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_VSTOP);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_VSTOP, *value);
-		}
-		break;
-	case 21:
-		// Waiting time after ramp down
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_TZEROWAIT);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_TZEROWAIT, *value);
-		}
-		break;
-	case 22:
-		// Velocity V2
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_V2);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_V2, *value);
-		}
-		break;
-	case 23:
-		// Deceleration D2
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_D2);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_D2, *value);
-		}
-		break;
-	case 24:
-		// Acceleration A2
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_A2);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_A2, *value);
-		}
-		break;
-	case 25:
-		// TVMAX
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_TVMAX);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_TVMAX, *value);
-		}
-		break;
-
-
-	case 26:
-		// Speed threshold for high speed mode
-		if(readWrite == READ) {
-			buffer = tmc5240_readInt(motorToIC(motor), TMC5240_THIGH);
-			*value = MIN(0xFFFFF, (1 << 24) / ((buffer)? buffer : 1));
-		} else if(readWrite == WRITE) {
-			*value = MIN(0xFFFFF, (1 << 24) / ((*value)? *value:1));
-			tmc5240_writeInt(motorToIC(motor), TMC5240_THIGH, *value);
-		}
-		break;
-	case 27:
-		// Minimum speed for switching to dcStep
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_VDCMIN);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_VDCMIN, *value);
-		}
-		break;
-	case 28:
-		// High speed chopper mode
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_CHOPCONF, TMC5240_VHIGHCHM_MASK, TMC5240_VHIGHCHM_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_CHOPCONF, TMC5240_VHIGHCHM_MASK, TMC5240_VHIGHCHM_SHIFT, *value);
-		}
-		break;
-	case 29:
-		// High speed fullstep mode
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_CHOPCONF, TMC5240_VHIGHFS_MASK, TMC5240_VHIGHFS_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_CHOPCONF, TMC5240_VHIGHFS_MASK, TMC5240_VHIGHFS_SHIFT, *value);
-		}
-		break;
 	case 30:
 		// Measured Speed
 		if(readWrite == READ) {
@@ -473,14 +345,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 			errors |= TMC_ERROR_TYPE;
 		}
 		break;
-	case 34:
-		// Internal RSense
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_GCONF, TMC5240_REFR_DIR_MASK, TMC5240_REFR_DIR_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_GCONF, TMC5240_REFR_DIR_MASK, TMC5240_REFR_DIR_SHIFT, *value);
-		}
-		break;
 	case 35:
 		// Global current scaler
 		if(readWrite == READ) {
@@ -492,59 +356,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 				TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_GLOBAL_SCALER, TMC5240_GLOBAL_SCALER_MASK, TMC5240_GLOBAL_SCALER_SHIFT, 0);
 		}
 		break;
-	case 140:
-		// Microstep Resolution
-		if(readWrite == READ) {
-			*value = 0x100 >> TMC5240_FIELD_READ(motorToIC(motor), TMC5240_CHOPCONF, TMC5240_MRES_MASK, TMC5240_MRES_SHIFT);
-		} else if(readWrite == WRITE) {
-			switch(*value)
-			{
-				case 1:    *value = 8;   break;
-				case 2:    *value = 7;   break;
-				case 4:    *value = 6;   break;
-				case 8:    *value = 5;   break;
-				case 16:   *value = 4;   break;
-				case 32:   *value = 3;   break;
-				case 64:   *value = 2;   break;
-				case 128:  *value = 1;   break;
-				case 256:  *value = 0;   break;
-				default:   *value = -1;  break;
-			}
-
-			if(*value != -1)
-			{
-				TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_CHOPCONF, TMC5240_MRES_MASK, TMC5240_MRES_SHIFT, *value);
-			}
-			else
-			{
-				errors |= TMC_ERROR_VALUE;
-			}
-		}
-		break;
-	case 162:
-		// Chopper blank time
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_CHOPCONF, TMC5240_TBL_MASK, TMC5240_TBL_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_CHOPCONF, TMC5240_TBL_MASK, TMC5240_TBL_SHIFT, *value);
-		}
-		break;
-	case 163:
-		// Constant TOff Mode
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_CHOPCONF, TMC5240_CHM_MASK, TMC5240_CHM_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_CHOPCONF, TMC5240_CHM_MASK, TMC5240_CHM_SHIFT, *value);
-		}
-		break;
-	case 164:
-		// Disable fast decay comparator
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_CHOPCONF, TMC5240_DISFDCC_MASK, TMC5240_DISFDCC_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_CHOPCONF, TMC5240_DISFDCC_MASK, TMC5240_DISFDCC_SHIFT, *value);
-		}
-		break;
 	case 165:
 		// Chopper hysteresis end / fast decay time
 		buffer = tmc5240_readInt(motorToIC(motor), TMC5240_CHOPCONF);
@@ -596,96 +407,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 			}
 		}
 		break;
-	case 167:
-		// Chopper off time
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_CHOPCONF, TMC5240_TOFF_MASK, TMC5240_TOFF_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_CHOPCONF, TMC5240_TOFF_MASK, TMC5240_TOFF_SHIFT, *value);
-		}
-		break;
-	case 168:
-		// smartEnergy current minimum (SEIMIN)
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_COOLCONF, TMC5240_SEIMIN_MASK, TMC5240_SEIMIN_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_COOLCONF, TMC5240_SEIMIN_MASK, TMC5240_SEIMIN_SHIFT, *value);
-		}
-		break;
-	case 169:
-		// smartEnergy current down step
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_COOLCONF, TMC5240_SEDN_MASK, TMC5240_SEDN_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_COOLCONF, TMC5240_SEDN_MASK, TMC5240_SEDN_SHIFT, *value);
-		}
-		break;
-	case 170:
-		// smartEnergy hysteresis
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_COOLCONF, TMC5240_SEMAX_MASK, TMC5240_SEMAX_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_COOLCONF, TMC5240_SEMAX_MASK, TMC5240_SEMAX_SHIFT, *value);
-		}
-		break;
-	case 171:
-		// smartEnergy current up step
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_COOLCONF, TMC5240_SEUP_MASK, TMC5240_SEUP_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_COOLCONF, TMC5240_SEUP_MASK, TMC5240_SEUP_SHIFT, *value);
-		}
-		break;
-	case 172:
-		// smartEnergy hysteresis start
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_COOLCONF, TMC5240_SEMIN_MASK, TMC5240_SEMIN_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_COOLCONF, TMC5240_SEMIN_MASK, TMC5240_SEMIN_SHIFT, *value);
-		}
-		break;
-	case 173:
-		// stallGuard4 filter enable
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_SG4_THRS, TMC5240_SG4_FILT_EN_MASK, TMC5240_SG4_FILT_EN_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_SG4_THRS, TMC5240_SG4_FILT_EN_MASK, TMC5240_SG4_FILT_EN_SHIFT, *value);
-		}
-		break;
-	case 174:
-		// stallGuard4 threshold
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_SG4_THRS, TMC5240_SG4_THRS_MASK, TMC5240_SG4_THRS_SHIFT);
-			*value = CAST_Sn_TO_S32(*value, 7);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_SG4_THRS, TMC5240_SG4_THRS_MASK, TMC5240_SG4_THRS_SHIFT, *value);
-		}
-		break;
-	case 175:
-		// stallGuard2 filter enable
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_COOLCONF, TMC5240_SFILT_MASK, TMC5240_SFILT_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_COOLCONF, TMC5240_SFILT_MASK, TMC5240_SFILT_SHIFT, *value);
-		}
-		break;
-	case 176:
-		// stallGuard2 threshold
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_COOLCONF, TMC5240_SGT_MASK, TMC5240_SGT_SHIFT);
-			*value = CAST_Sn_TO_S32(*value, 7);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_COOLCONF, TMC5240_SGT_MASK, TMC5240_SGT_SHIFT, *value);
-		}
-		break;
-	case 180:
-		// smartEnergy actual current
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_DRVSTATUS, TMC5240_CS_ACTUAL_MASK, TMC5240_CS_ACTUAL_SHIFT);
-		} else if(readWrite == WRITE) {
-			errors |= TMC_ERROR_TYPE;
-		}
-		break;
 	case 181:
 		// smartEnergy stall velocity
 		//this function sort of doubles with 182 but is necessary to allow cross chip compliance
@@ -706,24 +427,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 			tmc5240_writeInt(motorToIC(motor), TMC5240_TCOOLTHRS, *value);
 		}
 		break;
-	case 182:
-		// smartEnergy threshold speed
-		if(readWrite == READ) {
-			buffer = tmc5240_readInt(motorToIC(motor), TMC5240_TCOOLTHRS);
-			*value = MIN(0xFFFFF, (1<<24) / ((buffer)? buffer:1));
-		} else if(readWrite == WRITE) {
-			*value = MIN(0xFFFFF, (1<<24) / ((*value)? *value:1));
-			tmc5240_writeInt(motorToIC(motor), TMC5240_TCOOLTHRS, *value);
-		}
-		break;
-	case 184:
-			// SG_ANGLE_OFFSET
-			if(readWrite == READ) {
-				*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_SG4_THRS, TMC5240_SG_ANGLE_OFFSET_MASK, TMC5240_SG_ANGLE_OFFSET_SHIFT);
-			} else if(readWrite == WRITE) {
-				TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_SG4_THRS, TMC5240_SG_ANGLE_OFFSET_MASK, TMC5240_SG_ANGLE_OFFSET_SHIFT, *value);
-			}
-			break;
 	case 185:
 		// Chopper synchronization
 		if(readWrite == READ) {
@@ -735,16 +438,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 			tmc5240_writeInt(motorToIC(motor), TMC5240_CHOPCONF,buffer);
 		}
 		break;
-	case 186:
-		// PWM threshold speed
-		if(readWrite == READ) {
-			buffer = tmc5240_readInt(motorToIC(motor), TMC5240_TPWMTHRS);
-			*value = MIN(0xFFFFF, (1<<24) / ((buffer)? buffer:1));
-		} else if(readWrite == WRITE) {
-			*value = MIN(0xFFFFF, (1<<24) / ((*value)? *value:1));
-			tmc5240_writeInt(motorToIC(motor), TMC5240_TPWMTHRS, *value);
-		}
-		break;
 	case 187:
 		// PWM gradient
 		if(readWrite == READ) {
@@ -756,114 +449,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_GCONF, TMC5240_EN_PWM_MODE_MASK, TMC5240_EN_PWM_MODE_SHIFT, (*value) ? 1 : 0);
 		}
 		break;
-	case 188:
-		// PWM amplitude
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_PWMCONF, TMC5240_PWM_OFS_MASK, TMC5240_PWM_OFS_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_PWMCONF, TMC5240_PWM_OFS_MASK, TMC5240_PWM_OFS_SHIFT, *value);
-		}
-		break;
-	case 191:
-		// PWM frequency
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_PWMCONF, TMC5240_PWM_FREQ_MASK, TMC5240_PWM_FREQ_SHIFT);
-		} else if(readWrite == WRITE) {
-			if(*value >= 0 && *value < 4)
-			{
-				TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_PWMCONF, TMC5240_PWM_FREQ_MASK, TMC5240_PWM_FREQ_SHIFT, *value);
-			}
-			else
-			{
-				errors |= TMC_ERROR_VALUE;
-			}
-		}
-		break;
-	case 192:
-		// PWM autoscale
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_PWMCONF, TMC5240_PWM_AUTOSCALE_MASK, TMC5240_PWM_AUTOSCALE_SHIFT);
-		} else if(readWrite == WRITE) {
-			if(*value >= 0 && *value < 2)
-			{
-				TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_PWMCONF, TMC5240_PWM_AUTOSCALE_MASK, TMC5240_PWM_AUTOSCALE_SHIFT, *value);
-			}
-			else
-			{
-				errors |= TMC_ERROR_VALUE;
-			}
-		}
-		break;
-	case 193:
-		// PWM scale sum
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_PWMSCALE, TMC5240_PWM_SCALE_SUM_MASK, TMC5240_PWM_SCALE_SUM_SHIFT);
-		} else if(readWrite == WRITE) {
-			errors |= TMC_ERROR_TYPE;
-		}
-		break;
-	case 194:
-		// MSCNT
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_MSCNT, TMC5240_MSCNT_MASK, TMC5240_MSCNT_SHIFT);
-		} else if(readWrite == WRITE) {
-			errors |= TMC_ERROR_TYPE;
-		}
-		break;
-	case 195:
-		// MEAS_SD_EN
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_PWMCONF, TMC5240_PWM_MEAS_SD_ENABLE_MASK, TMC5240_PWM_MEAS_SD_ENABLE_SHIFT);
-		} else if(readWrite == WRITE) {
-			if(*value >= 0 && *value < 2)
-				TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_PWMCONF, TMC5240_PWM_MEAS_SD_ENABLE_MASK, TMC5240_PWM_MEAS_SD_ENABLE_SHIFT, *value);
-			else
-				errors |= TMC_ERROR_TYPE;
-		}
-		break;
-	case 196:
-		// DIS_REG_STST
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_PWMCONF, TMC5240_PWM_DIS_REG_STST_MASK, TMC5240_PWM_DIS_REG_STST_SHIFT);
-		} else if(readWrite == WRITE) {
-			if(*value >= 0 && *value < 2)
-				TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_PWMCONF, TMC5240_PWM_DIS_REG_STST_MASK, TMC5240_PWM_DIS_REG_STST_SHIFT, *value);
-			else
-				errors |= TMC_ERROR_TYPE;
-		}
-		break;
-	case 204:
-		// Freewheeling mode
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_PWMCONF, TMC5240_FREEWHEEL_MASK, TMC5240_FREEWHEEL_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_PWMCONF, TMC5240_FREEWHEEL_MASK, TMC5240_FREEWHEEL_SHIFT, *value);
-		}
-		break;
-	case 206:
-		// Load value
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_DRVSTATUS, TMC5240_SG_RESULT_MASK, TMC5240_SG_RESULT_SHIFT);
-		} else if(readWrite == WRITE) {
-			errors |= TMC_ERROR_TYPE;
-		}
-		break;
-	case 209:
-		// Encoder position
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_XENC);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_XENC, *value);
-		}
-		break;
-	case 210:
-		// Encoder Resolution
-		if(readWrite == READ) {
-			*value = tmc5240_readInt(motorToIC(motor), TMC5240_ENC_CONST);
-		} else if(readWrite == WRITE) {
-			tmc5240_writeInt(motorToIC(motor), TMC5240_ENC_CONST, *value);
-		}
-		break;
 	case 211:
 		//ADC Scaling Resitors
 		if(readWrite == READ) {
@@ -909,55 +494,6 @@ static uint32_t handleParameter(uint8_t readWrite, uint8_t motor, uint8_t type,
 				}
 		}
 		break;
-	case 212:
-		// Current range from DRV_CONF reg
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_DRV_CONF, TMC5240_CURRENT_RANGE_MASK, TMC5240_CURRENT_RANGE_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_DRV_CONF, TMC5240_CURRENT_RANGE_MASK, TMC5240_CURRENT_RANGE_SHIFT, *value);
-		}
-		break;
-
-	case 213:
-		// ADCTemperatur
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_ADC_TEMP, TMC5240_ADC_TEMP_MASK, TMC5240_ADC_TEMP_SHIFT);
-		} else if(readWrite == WRITE) {
-			errors |= TMC_ERROR_TYPE;
-		}
-		break;
-	case 214:
-		// ADCIN
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_ADC_VSUPPLY_AIN, TMC5240_ADC_AIN_MASK, TMC5240_ADC_AIN_SHIFT);
-		} else if(readWrite == WRITE) {
-			errors |= TMC_ERROR_TYPE;
-		}
-		break;
-	case 215:
-		// ADCSupply
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_ADC_VSUPPLY_AIN, TMC5240_ADC_VSUPPLY_MASK, TMC5240_ADC_VSUPPLY_SHIFT);
-		} else if(readWrite == WRITE) {
-			errors |= TMC_ERROR_TYPE;
-		}
-		break;
-	case 216:
-		// Overvoltage Limit ADC value
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_OTW_OV_VTH, TMC5240_OVERVOLTAGE_VTH_MASK, TMC5240_OVERVOLTAGE_VTH_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_OTW_OV_VTH, TMC5240_OVERVOLTAGE_VTH_MASK, TMC5240_OVERVOLTAGE_VTH_SHIFT, *value);
-		}
-		break;
-	case 217:
-		// Overtemperature Warning Limit
-		if(readWrite == READ) {
-			*value = TMC5240_FIELD_READ(motorToIC(motor), TMC5240_OTW_OV_VTH, TMC5240_OVERTEMPPREWARNING_VTH_MASK, TMC5240_OVERTEMPPREWARNING_VTH_SHIFT);
-		} else if(readWrite == WRITE) {
-			TMC5240_FIELD_WRITE(motorToIC(motor), TMC5240_OTW_OV_VTH, TMC5240_OVERTEMPPREWARNING_VTH_MASK, TMC5240_OVERTEMPPREWARNING_VTH_SHIFT, *value);
-		}
-		break;
 	case 218:
 		// ADCTemperatur Converted
 		if(readWrite == READ) {
@@ -1046,6 +582,22 @@ static uint32_t GAP(uint8_t type, uint8_t motor, int32_t *value)
 	return handleParameter(READ, motor, type, value);
 }
 
+static uint32_t getMin(uint8_t type, uint8_t motor, int32_t *value)
+{
+	if(motor >= TMC5240_MOTORS)
+		return TMC_ERROR_MOTOR;
+
+	return axisparameter_getLimit(&axisParameters, LIMIT_MIN, type, value);
+}
+
+static uint32_t getMax(uint8_t type, uint8_t motor, int32_t *value)
+{
+	if(motor >= TMC5240_MOTORS)
+		return TMC_ERROR_MOTOR;
+
+	return axisparameter_getLimit(&axisParameters, LIMIT_MAX, type, value);
+}
+
 static uint32_t getMeasuredSpeed(uint8_t motor, int32_t *value)
 {
 	if(motor >= TMC5240_MOTORS)
@@ -1194,8 +746,20 @@ static uint32_t userFunction(uint8_t type, uint8_t motor, int32_t *value)
 	return errors;
 }
 
+static void loadMonitorRead(uint8_t motor, uint16_t *stallGuard, uint8_t *coolStep, int32_t *velocity)
+{
+	// SG_RESULT and CS_ACTUAL share the DRV_STATUS register
+	uint32_t drvStatus = tmc5240_readInt(motorToIC(motor), TMC5240_DRVSTATUS);
+
+	*stallGuard  = (drvStatus & TMC5240_SG_RESULT_MASK) >> TMC5240_SG_RESULT_SHIFT;
+	*coolStep    = (drvStatus & TMC5240_CS_ACTUAL_MASK) >> TMC5240_CS_ACTUAL_SHIFT;
+	*velocity    = CAST_Sn_TO_S32(tmc5240_readInt(motorToIC(motor), TMC5240_VACTUAL), 24);
+}
+
 static void deInit(void)
 {
+	loadmonitor_setReadFunction(NULL, 0);
+
 	HAL.IOs->config->setLow(Pins.DRV_ENN_CFG6);
 	HAL.IOs->config->setLow(Pins.UART_MODE);
 	//HAL.IOs->config->setLow(Pins.SPI_MODE);
@@ -1370,6 +934,8 @@ void TMC5240_init(void)
 	Evalboards.ch1.stop                 = stop;
 	Evalboards.ch1.GAP                  = GAP;
 	Evalboards.ch1.SAP                  = SAP;
+	Evalboards.ch1.getMin               = getMin;
+	Evalboards.ch1.getMax               = getMax;
 	Evalboards.ch1.moveTo               = moveTo;
 	Evalboards.ch1.moveBy               = moveBy;
 	Evalboards.ch1.writeRegister        = writeRegister;
@@ -1384,6 +950,8 @@ void TMC5240_init(void)
 	Evalboards.ch1.VMMax                = VM_MAX;
 	Evalboards.ch1.deInit               = deInit;
 
+	loadmonitor_setReadFunction(loadMonitorRead, TMC5240_MOTORS);
+
 	enableDriver(DRIVER_USE_GLOBAL_ENABLE);
 
 
@@ -19,6 +19,13 @@
 
 #define DEFAULT_MOTOR  0
 
+// Status snapshot: XACTUAL, VACTUAL (signed 24 bit), XTARGET and RAMP_STAT per motor
+static const SnapshotRegisterTypeDef snapshotRegisters[] =
+{
+	{ TMC5272_XACTUAL(0), 0 }, { TMC5272_VACTUAL(0), 24 }, { TMC5272_XTARGET(0), 0 }, { TMC5272_RAMP_STAT(0), 0 },
+	{ TMC5272_XACTUAL(1), 0 }, { TMC5272_VACTUAL(1), 24 }, { TMC5272_XTARGET(1), 0 }, { TMC5272_RAMP_STAT(1), 0 }
+};
+
 static bool vMaxModified = false;
 static uint32_t vmax_position[TMC5272_MOTORS];
 
@@ -38,6 +45,8 @@ static uint32_t SAP(uint8_t type, uint8_t motor, int32_t value);
 static void readRegister(uint8_t motor, uint8_t address, int32_t *value);
 static void writeRegister(uint8_t motor, uint8_t address, int32_t value);
 static uint32_t getMeasuredSpeed(uint8_t motor, int32_t *value);
+static uint32_t readSnapshot(uint8_t *data, size_t size, size_t *length);
+static int32_t snapshotRead(uint8_t address);
 
 static int32_t tmc5272_UARTreadInt(UART_Config *channel, uint8_t address);
 static void tmc5272_UARTwriteInt(UART_Config *channel, uint8_t address, int32_t value);
@@ -1394,15 +1403,25 @@ static void readRegister(uint8_t motor, uint8_t address, int32_t *value)
 	*value = tmc5272_readInt(motorToIC(motor), address);
 }
 
+// Status registers of both motors, pipelined over SPI. UART replies can't be pipelined.
+static uint32_t readSnapshot(uint8_t *data, size_t size, size_t *length)
+{
+	SPIChannelTypeDef *spi = (commMode == TMC_BOARD_COMM_SPI) ? TMC5272_SPIChannel : NULL;
+
+	return board_readSnapshot(spi, snapshotRead, snapshotRegisters, ARRAY_SIZE(snapshotRegisters), data, size, length);
+}
+
+static int32_t snapshotRead(uint8_t address)
+{
+	return tmc5272_readInt(&TMC5272, address);
+}
+
 static void periodicJob(uint32_t tick)
 {
 	if(!noRegResetnSLEEP)
-		{
-	//check if reset after nSLEEP to HIGH was performed
-	for(uint8_t motor = 0; motor < TMC5272_MOTORS; motor++)
-		{
-			tmc5272_periodicJob(&TMC5272, tick);
-		}
+	{
+		// Both motors share one IC - a single call covers them
+		tmc5272_periodicJob(&TMC5272, tick);
 	}
 	else
 	{
@@ -1704,6 +1723,7 @@ void TMC5272_init(void)
 	Evalboards.ch1.readRegister         = readRegister;
 	Evalboards.ch1.periodicJob          = periodicJob;
 	Evalboards.ch1.userFunction         = userFunction;
+	Evalboards.ch1.readSnapshot         = readSnapshot;
 	Evalboards.ch1.getMeasuredSpeed     = getMeasuredSpeed;
 	Evalboards.ch1.enableDriver         = enableDriver;
 	Evalboards.ch1.checkErrors          = checkErrors;
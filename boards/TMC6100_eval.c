@@ -229,6 +229,7 @@ void TMC6100_init(void)
 {
 	TMC6100_SPIChannel = &HAL.SPI->ch2;
 	TMC6100_SPIChannel->CSN = &HAL.IOs->pins->SPI2_CSN0;
+	Evalboards.ch2.spiProfile = SPI_PROFILE_FIXED(TMC6100_SPIChannel, 4000000);
 
 #ifdef COMPILE_FOR_TMC4671_TMC6100_BOB
 
@@ -298,5 +299,6 @@ void TMC6100_BOB_init(void)
 	// Instead store the pin in a separate variable
 	TMC6100_SPIchipSelect = &HAL.IOs->pins->SPI2_CSN0;
 
-	spi_setFrequency(TMC6100_SPIChannel, 1000000);
+	// The breakout board runs at 1 MHz
+	Evalboards.ch2.spiProfile = SPI_PROFILE_FIXED(TMC6100_SPIChannel, 1000000);
 }
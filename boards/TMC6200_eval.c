@@ -204,6 +204,7 @@ void TMC6200_init(void)
 {
 	TMC6200_SPIChannel = &HAL.SPI->ch2;
 	TMC6200_SPIChannel->CSN = &HAL.IOs->pins->SPI2_CSN0;
+	Evalboards.ch2.spiProfile = SPI_PROFILE_IOIN(TMC6200_SPIChannel, 4000000, 4000000, 0x10);
 
 	Evalboards.ch2.config->reset        = reset;
 	Evalboards.ch2.config->restore      = restore;
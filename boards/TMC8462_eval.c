@@ -9,6 +9,7 @@
 
 #include "Board.h"
 #include "tmc/ic/TMC8462/TMC8462.h"
+#include "EscPdi.h"
 
 /*
  * 255 motors needed here to prevent errors in lower level when passing the motor number to register read/write functions.
@@ -24,7 +25,9 @@
 typedef enum {
 	UF_PDI_RESET,
 	UF_EEP_READ,
-	UF_EEP_WRITE
+	UF_EEP_WRITE,
+	UF_PDI_CYCLE,
+	UF_PDI_CYCLE_STATS
 } tmc8462_user_functions;
 
 void TMC8462_init_ch1(void);
@@ -34,6 +37,8 @@ static void register_write(uint8_t motor, uint8_t address, int32_t value);
 static void register_read(uint8_t motor, uint8_t address, int32_t *value);
 static void memory_read(uint8_t motor, uint8_t address, int32_t *value);
 static void memory_write(uint8_t motor, uint8_t address, int32_t value);
+static uint32_t memory_readBlock(uint16_t address, uint8_t *data, size_t length);
+static uint32_t memory_writeBlock(uint16_t address, const uint8_t *data, size_t length);
 static void pdi_reset(void);
 static uint32_t eep_read(int32_t *value);
 static uint32_t eep_write(int32_t value);
@@ -141,14 +146,39 @@ static void register_read(uint8_t motor, uint8_t address, int32_t *value)
 
 static void memory_read(uint8_t motor, uint8_t address, int32_t *value)
 {
+	if(escpdi_cycleRunning())
+	{
+		*value = 0;
+		return;
+	}
+
 	*value = tmc8462_esc_read_16(&TMC8462, (motor << 8) | address);
 }
 
 static void memory_write(uint8_t motor, uint8_t address, int32_t value)
 {
+	if(escpdi_cycleRunning())
+		return;
+
 	tmc8462_esc_write_8(&TMC8462, (motor << 8) | address, BYTE(value, 0));
 }
 
+static uint32_t memory_readBlock(uint16_t address, uint8_t *data, size_t length)
+{
+	if(escpdi_cycleRunning())
+		return TMC_ERROR_NOT_DONE;
+
+	return escpdi_readBlock(address, data, length);
+}
+
+static uint32_t memory_writeBlock(uint16_t address, const uint8_t *data, size_t length)
+{
+	if(escpdi_cycleRunning())
+		return TMC_ERROR_NOT_DONE;
+
+	return escpdi_writeBlock(address, data, length);
+}
+
 static void pdi_reset(void)
 {
 	tmc8462_esc_write_8(&TMC8462, TMC8462_ESC_RESET_PDI, TMC8462_MAGIC_RESET_0);
@@ -209,10 +239,12 @@ static uint32_t eep_write(int32_t value)
 
 static uint32_t user_function(uint8_t type, uint8_t motor, int32_t *value)
 {
-	UNUSED(motor);
-
 	uint32_t reply = TMC_ERROR_NONE;
 
+	// The ESC SPI channel is in use by the PDI cycle engine
+	if(escpdi_cycleRunning() && type != UF_PDI_CYCLE && type != UF_PDI_CYCLE_STATS)
+		return TMC_ERROR_NOT_DONE;
+
 	switch(type)
 	{
 	case UF_PDI_RESET:
@@ -224,6 +256,12 @@ static uint32_t user_function(uint8_t type, uint8_t motor, int32_t *value)
 	case UF_EEP_WRITE:
 		reply = eep_write(*value);
 		break;
+	case UF_PDI_CYCLE:
+		reply = escpdi_cycleStart(*value, motor);
+		break;
+	case UF_PDI_CYCLE_STATS:
+		reply = escpdi_cycleStats(motor, value);
+		break;
 	default:
 		reply = TMC_ERROR_TYPE;
 		break;
@@ -239,7 +277,7 @@ static void enableDriver(DriverState state)
 
 static void deInit(void)
 {
-
+	escpdi_cycleStop();
 }
 
 static uint8_t reset()
@@ -286,6 +324,8 @@ void TMC8462_init_ch1(void)
 	Evalboards.ch1.VMMin                = 0;
 	Evalboards.ch1.VMMax                = ~0;
 
+	escpdi_init(tmc8462_spi_esc);
+
 	// Call this function manually here since ID detection on channel 2 does not work for this board.
 	TMC8462_init_ch2();
 }
@@ -308,6 +348,8 @@ void TMC8462_init_ch2(void)
 	Evalboards.ch2.config->configIndex  = 0;
 	Evalboards.ch2.writeRegister        = memory_write;
 	Evalboards.ch2.readRegister         = memory_read;
+	Evalboards.ch2.readBlock            = memory_readBlock;
+	Evalboards.ch2.writeBlock           = memory_writeBlock;
 	Evalboards.ch2.periodicJob          = periodicJob;
 	Evalboards.ch2.userFunction         = user_function;
 	Evalboards.ch2.enableDriver         = enableDriver;
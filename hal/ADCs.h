@@ -16,6 +16,36 @@
 
 static volatile uint16_t ADCValue[N_O_ADC_CHANNELS];
 
+// Index into ADCTypeDef.statistics
+typedef enum {
+	ADC_INPUT_AIN0,
+	ADC_INPUT_AIN1,
+	ADC_INPUT_AIN2,
+	ADC_INPUT_DIO4,
+	ADC_INPUT_DIO5,
+	ADC_INPUT_VM,
+	ADC_INPUT_AIN_EXT,
+	ADC_INPUT_COUNT
+} ADCInput;
+
+// Per input measurement statistics, updated by the ADC interrupt.
+// filtered: oversampled and low pass filtered value, same scale as the raw value
+// min/max:  extreme samples since the last resetStatistics()
+typedef struct
+{
+	uint16_t filtered;
+	uint16_t min;
+	uint16_t max;
+} ADCInputStatisticsTypeDef;
+
+// State of the first order low pass filter in 8 bit fixed point
+typedef struct
+{
+	uint32_t state;
+	uint16_t min;
+	uint16_t max;
+} ADCFilterTypeDef;
+
 typedef struct
 {
 	volatile uint16_t *AIN0;
@@ -27,8 +57,38 @@ typedef struct
 	volatile uint16_t *AIN_EXT; // Only LB_V3
 	void (*init)();
 	void (*deInit)();
+	// VM supervision: every VM sample outside of [low, high] (raw ADC values) calls vmLimit_callback from interrupt context.
+	// After a callback the supervision is disarmed until the limits get set again.
+	void (*setVMLimits)(uint16_t low, uint16_t high);
+	void (*vmLimit_callback)(uint16_t value);
+	volatile ADCInputStatisticsTypeDef *statistics; // ADC_INPUT_COUNT entries, indexed by ADCInput
+	void (*resetStatistics)(void);
 } ADCTypeDef;
 
+// Feeds one (oversampled) measurement into the filter of an input.
+// The first measurement after a reset initializes the filter, so the filtered value does not ramp up from zero.
+static inline void adc_filterUpdate(ADCFilterTypeDef *filter, volatile ADCInputStatisticsTypeDef *statistics, uint16_t value, uint16_t sampleMin, uint16_t sampleMax, uint8_t shift)
+{
+	if(filter->state == 0)
+		filter->state = (uint32_t) value << 8;
+	else
+		filter->state += ((int32_t) ((uint32_t) value << 8) - (int32_t) filter->state) >> shift;
+
+	if(sampleMin < filter->min)
+		filter->min = sampleMin;
+	if(sampleMax > filter->max)
+		filter->max = sampleMax;
+
+	statistics->filtered  = (filter->state + 0x80) >> 8;
+	statistics->min       = filter->min;
+	statistics->max       = filter->max;
+}
+
 extern ADCTypeDef ADCs;
 
+#if defined(LandungsbrueckeV3)
+// The ADC interrupt is shared with the BLDC current measurement, which forwards to this handler
+void ADCs_watchdogInterrupt(void);
+#endif
+
 #endif /* ADC_H */
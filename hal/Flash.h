@@ -0,0 +1,27 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#ifndef FLASH_H_
+#define FLASH_H_
+
+#include "derivative.h"
+
+// On-chip flash region reserved for firmware data (see the linker scripts).
+// The region is split into equally sized blocks, which are the erase unit.
+// Offsets are given in bytes from the start of the region, programming is done in aligned 32 bit words.
+typedef struct
+{
+	const volatile uint32_t  *memory;     // memory mapped region for reading
+	uint32_t                 blockSize;   // erase unit in [bytes]
+	uint8_t                  blocks;
+	void     (*init)    (void);
+	uint8_t  (*erase)   (uint8_t block);                       // returns true on success
+	uint8_t  (*program) (uint32_t offset, uint32_t data);      // returns true on success
+} FlashTypeDef;
+
+extern FlashTypeDef Flash;
+
+#endif /* FLASH_H_ */
@@ -22,6 +22,7 @@
 #include "Timer.h"
 #include "SysTick.h"
 #include "UART.h"
+#include "Flash.h"
 
 typedef struct
 {
@@ -43,6 +44,7 @@ typedef struct
 	RXTXTypeDef                *WLAN;
 	TimerTypeDef               *Timer;
 	UART_Config                *UART;
+	FlashTypeDef               *Flash;
 } HALTypeDef;
 
 extern const HALTypeDef HAL;
@@ -161,4 +161,27 @@ extern IOsTypeDef IOs;
 #define DUMMY_BITWEIGHT 0
 #define IS_DUMMY_PIN(pin) (pin->bitWeight == DUMMY_BITWEIGHT)
 
+// Register level pin access for hot paths (interrupts, SPI chip select), inlined instead of
+// calling through HAL.IOs->config. There is no dummy pin check: a dummy pin passed in here
+// needs valid set/reset registers and port (see StepDir's DummyPin), its bit weight of 0
+// then turns writes into no-ops and reads into low. Callers check IS_DUMMY_PIN() otherwise.
+static inline void io_setHigh(const IOPinTypeDef *pin)
+{
+	*pin->setBitRegister = pin->bitWeight;
+}
+
+static inline void io_setLow(const IOPinTypeDef *pin)
+{
+	*pin->resetBitRegister = pin->bitWeight;
+}
+
+static inline bool io_isHigh(const IOPinTypeDef *pin)
+{
+#if defined(Landungsbruecke) || defined(LandungsbrueckeSmall)
+	return (GPIO_PDIR_REG(pin->GPIOBase) & pin->bitWeight) != 0;
+#elif defined(LandungsbrueckeV3)
+	return (GPIO_ISTAT(pin->port) & pin->bitWeight) != 0;
+#endif
+}
+
 #endif /* _IO_H_ */
@@ -46,8 +46,18 @@
 #define AD30   0x1E  // VRefSL                     | -VRefSL     (differential)
 #define AD31   0x1F  // Module disabled            | Module diabled
 
+// Time constant of the low pass filter in ADC scans (2^shift)
+#define ADC_FILTER_SHIFT  6
+
+void __attribute__ ((interrupt)) DMA1_IRQHandler(void);
+void __attribute__ ((interrupt)) DMA3_IRQHandler(void);
+
 static void init(void);
 static void deInit(void);
+static void setVMLimits(uint16_t low, uint16_t high);
+static void resetStatistics(void);
+static void processSample(ADCInput input, uint16_t value);
+static void resetFilters(uint8_t adc, ADCInput first, ADCInput second, ADCInput third);
 
 /* ADCs are scanned using two DMA channels. Upon ADC read complete, the first DMA channel (Channel 1 for ADC 0, Channel 3 for ADC 1)
  * will write the result of the ADC measurement to the result array. Upon DMA completion the first channel triggers the
@@ -74,6 +84,17 @@ volatile uint16_t adc1_result[3] = { 0 };
 const uint8_t  adc0_mux[3] = { DAD1, AD12, AD13 };
 const uint8_t  adc1_mux[3] = { DAD0, DAD1, DAD3 };
 
+// VM supervision window, checked on every completed ADC0 scan
+static volatile uint16_t vmLow   = 0;
+static volatile uint16_t vmHigh  = 0xFFFF;
+static volatile bool vmArmed     = false;
+
+// The hardware averages 16 conversions per sample, the scan interrupts low pass filter these.
+// There is no AIN_EXT input, its statistics stay zero.
+static volatile ADCInputStatisticsTypeDef statistics[ADC_INPUT_COUNT];
+static ADCFilterTypeDef filters[ADC_INPUT_COUNT];
+static volatile uint8_t resetRequest = 0x03; // One bit per ADC
+
 ADCTypeDef ADCs =
 {
 	.AIN0    = &adc1_result[1],
@@ -83,7 +104,11 @@ ADCTypeDef ADCs =
 	.DIO5    = &adc0_result[2],
 	.VM      = &adc0_result[0],
 	.init    = init,
-	.deInit  = deInit
+	.deInit  = deInit,
+	.setVMLimits       = setVMLimits,
+	.vmLimit_callback  = NULL,
+	.statistics        = statistics,
+	.resetStatistics   = resetStatistics,
 };
 
 static void init(void)
@@ -111,9 +136,9 @@ static void init(void)
 	ADC0_SC2 = ADC_SC2_DMAEN_MASK;  // enable DMA
 	ADC1_SC2 = ADC_SC2_DMAEN_MASK;  // enable DMA;
 
-	// average over 4 samples, single measurement (trigger from having DMA write the MUX value to SC1A)
-	ADC0_SC3 = 	ADC_SC3_AVGE_MASK | ADC_SC3_AVGS(0);
-	ADC1_SC3 = 	ADC_SC3_AVGE_MASK | ADC_SC3_AVGS(0);
+	// average over 16 samples, single measurement (trigger from having DMA write the MUX value to SC1A)
+	ADC0_SC3 = 	ADC_SC3_AVGE_MASK | ADC_SC3_AVGS(2);
+	ADC1_SC3 = 	ADC_SC3_AVGE_MASK | ADC_SC3_AVGS(2);
 
 	ADC0_SC3 |= ADC_SC3_CAL_MASK;
 	while(ADC0_SC3 & ADC_SC3_CAL_MASK);
@@ -181,7 +206,7 @@ static void init(void)
 	DMA_TCD1_BITER_ELINKYES = (DMA_BITER_ELINKYES_ELINK_MASK|DMA_BITER_ELINKYES_LINKCH(0)|0x03);  // Enable channel link (to channel 0) on major loop step, beginning major iteration count: 3
 	DMA_TCD1_CITER_ELINKYES = (DMA_CITER_ELINKYES_ELINK_MASK|DMA_BITER_ELINKYES_LINKCH(0)|0x03);  // Enable channel link (to channel 0) on major loop step, current major iteration count: 3
 	DMA_TCD1_ATTR           = DMA_ATTR_SSIZE(1) | DMA_ATTR_DSIZE(1);                              // Source and destination size: 16 bit
-	DMA_TCD1_CSR            = (DMA_CSR_MAJORLINKCH(0) | DMA_CSR_MAJORELINK_MASK);                 // Major loop completion starts request for Channel 0
+	DMA_TCD1_CSR            = (DMA_CSR_MAJORLINKCH(0) | DMA_CSR_MAJORELINK_MASK | DMA_CSR_INTMAJOR_MASK); // Major loop completion starts request for Channel 0, interrupt for filtering and VM supervision
 
 	// Start the DMA Channel 1
 	DMA_SERQ = 1;
@@ -214,16 +239,90 @@ static void init(void)
 	DMA_TCD3_BITER_ELINKYES = DMA_BITER_ELINKYES_ELINK_MASK | DMA_BITER_ELINKYES_LINKCH(2) | 0x03;  // Enable channel link (to channel 2) on major loop step, beginning major iteration count: 3
 	DMA_TCD3_CITER_ELINKYES = DMA_CITER_ELINKYES_ELINK_MASK | DMA_CITER_ELINKYES_LINKCH(2) | 0x03;  // Enable channel link (to channel 2) on major loop step, current major iteration count: 3
 	DMA_TCD3_ATTR           = DMA_ATTR_SSIZE(1) | DMA_ATTR_DSIZE(1);                                // Source and destination size: 16 bit
-	DMA_TCD3_CSR            = DMA_CSR_MAJORLINKCH(2) | DMA_CSR_MAJORELINK_MASK;                     // Major loop completion starts request for Channel 2
+	DMA_TCD3_CSR            = DMA_CSR_MAJORLINKCH(2) | DMA_CSR_MAJORELINK_MASK | DMA_CSR_INTMAJOR_MASK; // Major loop completion starts request for Channel 2, interrupt for filtering
 
 	// Start the DMA Channel 3
 	DMA_SERQ = 3;
 
+	enable_irq(INT_DMA1-16);
+	enable_irq(INT_DMA3-16);
+
 	EnableInterrupts;
 }
 
+// The Kinetis ADC compare function would also suppress the DMA transfers of in-range samples,
+// so VM is checked by the DMA interrupt after each scan of ADC0 instead.
+static void setVMLimits(uint16_t low, uint16_t high)
+{
+	disable_irq(INT_DMA1-16);
+
+	vmLow   = low;
+	vmHigh  = high;
+	vmArmed = true;
+
+	enable_irq(INT_DMA1-16);
+}
+
+static void resetStatistics(void)
+{
+	// Executed by the next scan interrupt of each ADC to not race with the filter update
+	resetRequest = 0x03;
+}
+
+static void processSample(ADCInput input, uint16_t value)
+{
+	adc_filterUpdate(&filters[input], &statistics[input], value, value, value, ADC_FILTER_SHIFT);
+}
+
+static void resetFilters(uint8_t adc, ADCInput first, ADCInput second, ADCInput third)
+{
+	if(!(resetRequest & (1 << adc)))
+		return;
+
+	resetRequest &= ~(1 << adc);
+
+	filters[first].min = filters[second].min = filters[third].min = 0xFFFF;
+	filters[first].max = filters[second].max = filters[third].max = 0;
+}
+
+void DMA1_IRQHandler()
+{
+	DMA_CINT = DMA_CINT_CINT(1);
+
+	resetFilters(0, ADC_INPUT_VM, ADC_INPUT_DIO4, ADC_INPUT_DIO5);
+	processSample(ADC_INPUT_VM,   adc0_result[0]);
+	processSample(ADC_INPUT_DIO4, adc0_result[1]);
+	processSample(ADC_INPUT_DIO5, adc0_result[2]);
+
+	if(!vmArmed)
+		return;
+
+	uint16_t value = adc0_result[0];
+	if(value >= vmLow && value <= vmHigh)
+		return;
+
+	// Disarm until the limits get set again
+	vmArmed = false;
+
+	if(ADCs.vmLimit_callback)
+		ADCs.vmLimit_callback(value);
+}
+
+void DMA3_IRQHandler()
+{
+	DMA_CINT = DMA_CINT_CINT(3);
+
+	resetFilters(1, ADC_INPUT_AIN2, ADC_INPUT_AIN0, ADC_INPUT_AIN1);
+	processSample(ADC_INPUT_AIN2, adc1_result[0]);
+	processSample(ADC_INPUT_AIN0, adc1_result[1]);
+	processSample(ADC_INPUT_AIN1, adc1_result[2]);
+}
+
 static void deInit()
 {
+	disable_irq(INT_DMA1-16);
+	disable_irq(INT_DMA3-16);
+
 	// disable clock for DMA
 	SIM_SCGC7 &= ~(SIM_SCGC7_DMA_MASK);
 
@@ -0,0 +1,111 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#include "hal/HAL.h"
+#include "hal/Flash.h"
+
+// The last 8k of the program flash are reserved for firmware data.
+// Two blocks of two 2k flash sectors each.
+#if defined(Landungsbruecke)
+	#define FLASH_REGION_ADDRESS  0x0007E000
+#elif defined(LandungsbrueckeSmall)
+	#define FLASH_REGION_ADDRESS  0x0003E000
+#endif
+#define FLASH_SECTOR_SIZE     2048
+#define FLASH_BLOCK_SIZE      (2 * FLASH_SECTOR_SIZE)
+#define FLASH_BLOCKS          2
+
+#define FTFL_CMD_PROGRAM_LONGWORD  0x06
+#define FTFL_CMD_ERASE_SECTOR      0x09
+
+#define FTFL_ERROR_FLAGS  (FTFL_FSTAT_ACCERR_MASK | FTFL_FSTAT_FPVIOL_MASK | FTFL_FSTAT_MGSTAT0_MASK)
+
+static void init(void);
+static uint8_t erase(uint8_t block);
+static uint8_t program(uint32_t offset, uint32_t data);
+static uint8_t command(uint8_t cmd, uint32_t address, uint32_t data);
+static uint8_t launchCommand(void);
+
+FlashTypeDef Flash =
+{
+	.memory     = (const volatile uint32_t *) FLASH_REGION_ADDRESS,
+	.blockSize  = FLASH_BLOCK_SIZE,
+	.blocks     = FLASH_BLOCKS,
+	.init       = init,
+	.erase      = erase,
+	.program    = program,
+};
+
+static void init(void)
+{
+	// Wait for a command possibly still running from the bootloader
+	while(!(FTFL_FSTAT & FTFL_FSTAT_CCIF_MASK));
+}
+
+static uint8_t erase(uint8_t block)
+{
+	uint32_t address;
+
+	if(block >= FLASH_BLOCKS)
+		return false;
+
+	address = FLASH_REGION_ADDRESS + block * FLASH_BLOCK_SIZE;
+	for(uint32_t sector = 0; sector < FLASH_BLOCK_SIZE; sector += FLASH_SECTOR_SIZE)
+	{
+		if(!command(FTFL_CMD_ERASE_SECTOR, address + sector, 0))
+			return false;
+	}
+
+	return true;
+}
+
+static uint8_t program(uint32_t offset, uint32_t data)
+{
+	if((offset & 3) || offset >= FLASH_BLOCK_SIZE * FLASH_BLOCKS)
+		return false;
+
+	if(!command(FTFL_CMD_PROGRAM_LONGWORD, FLASH_REGION_ADDRESS + offset, data))
+		return false;
+
+	return Flash.memory[offset / 4] == data;
+}
+
+static uint8_t command(uint8_t cmd, uint32_t address, uint32_t data)
+{
+	uint8_t status;
+
+	// Clear the errors of the previous command
+	FTFL_FSTAT = FTFL_FSTAT_ACCERR_MASK | FTFL_FSTAT_FPVIOL_MASK;
+
+	FTFL_FCCOB0 = cmd;
+	FTFL_FCCOB1 = (address >> 16) & 0xFF;
+	FTFL_FCCOB2 = (address >> 8) & 0xFF;
+	FTFL_FCCOB3 = address & 0xFF;
+	FTFL_FCCOB4 = (data >> 24) & 0xFF;
+	FTFL_FCCOB5 = (data >> 16) & 0xFF;
+	FTFL_FCCOB6 = (data >> 8) & 0xFF;
+	FTFL_FCCOB7 = data & 0xFF;
+
+	// The code must not be fetched from the flash block under modification
+	// -> no interrupts and the launch runs from RAM.
+	DisableInterrupts;
+	status = launchCommand();
+	EnableInterrupts;
+
+	// Drop stale flash cache entries of the modified area
+	FMC_PFB0CR |= FMC_PFB0CR_CINV_WAY(0xF);
+
+	return !(status & FTFL_ERROR_FLAGS);
+}
+
+// Placed in .data, which the startup code copies to RAM
+static uint8_t __attribute__((section(".data.ramfunc"), noinline, long_call)) launchCommand(void)
+{
+	FTFL_FSTAT = FTFL_FSTAT_CCIF_MASK;
+	while(!(FTFL_FSTAT & FTFL_FSTAT_CCIF_MASK));
+
+	return FTFL_FSTAT;
+}
@@ -36,7 +36,8 @@ const HALTypeDef HAL =
 	.RS232        = &RS232,
 	.WLAN         = &WLAN,
 	.Timer        = &Timer,
-	.UART         = &UART
+	.UART         = &UART,
+	.Flash        = &Flash
 };
 
 static void init(void)
@@ -55,6 +56,7 @@ static void init(void)
 	ADCs.init();
 	SPI.init();
 	WLAN.init();
+	Flash.init();
 	RS232.init();
 	USB.init();
 
@@ -36,7 +36,14 @@ uint32_t systick_getTick()
 uint32_t systick_getMicrosecondTick()
 {
 	// 48 MHz CYCCNT / 48 -> µs counter
-	return DWT_CYCCNT / 48;
+	return DWT_CYCCNT / SYSTICK_CYCLES_PER_MICROSECOND;
+}
+
+// Raw CYCCNT value. Use this for duration measurements - unlike the µs tick,
+// differences of two cycle counts stay correct across the counter overflow.
+uint32_t systick_getCycleCount()
+{
+	return DWT_CYCCNT;
 }
 
 /* Systick values are in milliseconds, accessing the value is faster. As a result
@@ -16,18 +16,26 @@ void __attribute__ ((interrupt)) FTM0_IRQHandler(void);
 
 static void init(void);
 static void deInit(void);
-static void setDuty(timer_channel channel, float duty);
-static float getDuty(timer_channel channel);
+static void setDuty(timer_channel channel, uint32_t duty);
+static uint32_t getDuty(timer_channel channel);
 static void setModulo(timer_channel channel, uint16_t modulo);
 static uint16_t getModulo(timer_channel channel);
 static void setModuloMin(timer_channel channel, uint16_t modulo_min);
-static void setFrequency(timer_channel channel, float freq);
-static void setFrequencyMin(timer_channel channel, float freq_min);
+static void setFrequency(timer_channel channel, uint32_t freq);
+static void setFrequencyMin(timer_channel channel, uint32_t freq_min);
+static bool calculateTiming(timer_channel channel, uint32_t freq, TimerTimingTypeDef *timing);
+static void setTiming(timer_channel channel, const TimerTimingTypeDef *timing);
+static void beginUpdate(void);
+static void commitUpdate(void);
+
+// Compare values are 16 bit, so duty * modulo stays within 32 bit
+#define DUTY_TO_VALUE(duty, modulo)  (((duty) * (modulo)) >> TIMER_DUTY_SHIFT)
 
 static uint16_t modulo_buf = 0;
 static uint16_t modulo_min_buf = 0;
-static float duty_buf[] = { .5f, .5f, .5f };
-static float freq_min_buf = 0.0f;
+static uint32_t duty_buf[] = { TIMER_DUTY_MAX / 2, TIMER_DUTY_MAX / 2, TIMER_DUTY_MAX / 2 };
+static uint32_t freq_min_buf = 0;
+static bool updateBatch = false;
 
 TimerTypeDef Timer =
 {
@@ -41,6 +49,10 @@ TimerTypeDef Timer =
 	.setPeriodMin = setModuloMin,
 	.setFrequency = setFrequency,
 	.setFrequencyMin = setFrequencyMin,
+	.calculateTiming = calculateTiming,
+	.setTiming = setTiming,
+	.beginUpdate = beginUpdate,
+	.commitUpdate = commitUpdate,
 	.overflow_callback = NULL
 };
 
@@ -85,11 +97,11 @@ static void init(void)
 
 	// initialize setting of value registers to  duty cycle
 	FTM0_C0V = 0;
-	FTM0_C1V = (uint16_t)(duty_buf[1] * TIMER_MAX);
+	FTM0_C1V = DUTY_TO_VALUE(duty_buf[1], TIMER_MAX);
 	FTM0_C4V = 0;
-	FTM0_C5V = (uint16_t)(duty_buf[2] * TIMER_MAX);
+	FTM0_C5V = DUTY_TO_VALUE(duty_buf[2], TIMER_MAX);
 	FTM0_C6V = 0;
-	FTM0_C7V = (uint16_t)(duty_buf[0] * TIMER_MAX);
+	FTM0_C7V = DUTY_TO_VALUE(duty_buf[0], TIMER_MAX);
 
 	// set channel mode to generate positive PWM
 	FTM0_C0SC |= FTM_CnSC_ELSB_MASK;
@@ -135,30 +147,32 @@ static void deInit(void)
 	SIM_SCGC6 &= ~SIM_SCGC6_FTM0_MASK;
 }
 
-static void setDuty(timer_channel channel, float duty)
+static void setDuty(timer_channel channel, uint32_t duty)
 {
-	duty = (duty < 0.0f) ? 0.0f : duty;
-	duty = (duty > 1.0f) ? 1.0f : duty;
+	duty = MIN(duty, TIMER_DUTY_MAX);
 
 	switch(channel) {
 	case TIMER_CHANNEL_2:
 		duty_buf[1] = duty;
-		FTM0_C1V = (uint16_t) (duty * modulo_buf);
+		FTM0_C1V = DUTY_TO_VALUE(duty, modulo_buf);
 		break;
 	case TIMER_CHANNEL_3:
 		duty_buf[2] = duty;
-		FTM0_C5V = (uint16_t) (duty * modulo_buf);
+		FTM0_C5V = DUTY_TO_VALUE(duty, modulo_buf);
 		break;
 	case TIMER_CHANNEL_1:
 	default:
 		duty_buf[0] = duty;
-		FTM0_C7V = (uint16_t) (duty * modulo_buf);
+		FTM0_C7V = DUTY_TO_VALUE(duty, modulo_buf);
 		break;
 	}
-	FTM0_PWMLOAD = FTM_PWMLOAD_LDOK_MASK;
+
+	// The buffered values are loaded at the next loading point once LDOK is set
+	if(!updateBatch)
+		FTM0_PWMLOAD = FTM_PWMLOAD_LDOK_MASK;
 }
 
-static float getDuty(timer_channel channel)
+static uint32_t getDuty(timer_channel channel)
 {
 	uint16_t duty = 0;
 	switch(channel) {
@@ -174,7 +188,7 @@ static float getDuty(timer_channel channel)
 		break;
 	}
 
-	return (((float)duty) / modulo_buf);
+	return (modulo_buf != 0)? ((uint32_t) duty << TIMER_DUTY_SHIFT) / modulo_buf : 0;
 }
 
 static void setModulo(timer_channel channel, uint16_t modulo)
@@ -186,8 +200,11 @@ static void setModulo(timer_channel channel, uint16_t modulo)
 	modulo_buf = modulo;
 	FTM0_CNTIN = 0;
 	FTM0_SYNC |= FTM_SYNC_CNTMAX_MASK;
-	FTM0_SYNC |= FTM_SYNC_SWSYNC_MASK;
-	FTM0_PWMLOAD = FTM_PWMLOAD_LDOK_MASK;
+	if(!updateBatch)
+	{
+		FTM0_SYNC |= FTM_SYNC_SWSYNC_MASK;
+		FTM0_PWMLOAD = FTM_PWMLOAD_LDOK_MASK;
+	}
 	enable_irq(INT_FTM0-16);
 }
 
@@ -204,58 +221,98 @@ static void setModuloMin(timer_channel channel, uint16_t modulo_min)
 	modulo_min_buf = modulo_min;
 }
 
-static void setFrequencyMin(timer_channel channel, float freq_min)
+static void setFrequencyMin(timer_channel channel, uint32_t freq_min)
 {
 	UNUSED(channel);
 	freq_min_buf = freq_min;
 }
 
-static void setFrequency(timer_channel channel, float freq)
+static void setFrequency(timer_channel channel, uint32_t freq)
+{
+	TimerTimingTypeDef timing;
+
+	if(calculateTiming(channel, freq, &timing))
+		setTiming(channel, &timing);
+}
+
+// The prescaler of the FTM is a power of two, timing->prescaler holds the exponent
+static bool calculateTiming(timer_channel channel, uint32_t freq, TimerTimingTypeDef *timing)
 {
 	UNUSED(channel);
 
 	if(freq < freq_min_buf)
-		return;
+		return false;
 
-	if(freq < ((float)CPU_BUS_CLK_HZ / ((1 << 0b111) * 0xFFFF)))
-		return;
+	if(freq < (CPU_BUS_CLK_HZ / ((1 << 0b111) * 0xFFFF)))
+		return false;
 
-	if(freq > (float)CPU_BUS_CLK_HZ)
-		return;
+	if(freq > CPU_BUS_CLK_HZ)
+		return false;
 
-	disable_irq(INT_FTM0-16);
-
-  uint8_t ps = 0b000;
-	uint16_t modulo = 0xFFFF;
+	uint8_t ps = 0b000;
+	uint32_t modulo = 0xFFFF;
 
 	for(; ps < 0b111; ps++)
 	{
-		if(freq > ((float)CPU_BUS_CLK_HZ / ((1 << ps) * modulo)))
+		if(freq > (CPU_BUS_CLK_HZ / ((1 << ps) * modulo)))
 		{
-			modulo = (float)CPU_BUS_CLK_HZ / ((1 << ps) * freq);
+			modulo = CPU_BUS_CLK_HZ / ((1 << ps) * freq);
 			if((modulo < modulo_min_buf) && (ps > 0b000))
-			    modulo = (float)CPU_BUS_CLK_HZ / ((1 << (ps - 1)) * freq);
+				modulo = MIN(CPU_BUS_CLK_HZ / ((1 << (ps - 1)) * freq), 0xFFFF);
 			break;
 		}
 	}
 
-	modulo_buf = modulo;
+	timing->prescaler = ps;
+	timing->period = modulo;
+
+	return true;
+}
+
+static void setTiming(timer_channel channel, const TimerTimingTypeDef *timing)
+{
+	UNUSED(channel);
+
+	disable_irq(INT_FTM0-16);
+
+	modulo_buf = timing->period;
 
 	FTM0_MODE |= FTM_MODE_WPDIS_MASK;
-	FTM0_SC |= FTM_SC_PS(ps);
-	FTM0_MOD = modulo;
+	FTM0_SC = (FTM0_SC & ~FTM_SC_PS_MASK) | FTM_SC_PS(timing->prescaler);
+	FTM0_MOD = timing->period;
 	FTM0_CNTIN = 0;
 	FTM0_SYNC |= FTM_SYNC_CNTMAX_MASK;
-	FTM0_SYNC |= FTM_SYNC_SWSYNC_MASK;
-	FTM0_PWMLOAD = FTM_PWMLOAD_LDOK_MASK;
 
+	// Rescale the compare values to the new modulo
+	bool batch = updateBatch;
+	updateBatch = true;
 	setDuty(TIMER_CHANNEL_1, duty_buf[0]);
 	setDuty(TIMER_CHANNEL_2, duty_buf[1]);
 	setDuty(TIMER_CHANNEL_3, duty_buf[2]);
+	updateBatch = batch;
+
+	if(!updateBatch)
+	{
+		FTM0_SYNC |= FTM_SYNC_SWSYNC_MASK;
+		FTM0_PWMLOAD = FTM_PWMLOAD_LDOK_MASK;
+	}
 
 	enable_irq(INT_FTM0-16);
 }
 
+// Writes to MOD and CnV only reach the FTM write buffers until LDOK is set
+static void beginUpdate(void)
+{
+	updateBatch = true;
+}
+
+static void commitUpdate(void)
+{
+	updateBatch = false;
+	FTM0_SYNC |= FTM_SYNC_SWSYNC_MASK;
+	FTM0_PWMLOAD = FTM_PWMLOAD_LDOK_MASK;
+}
+
 void FTM0_IRQHandler()
 {
 	if(FTM0_SC & FTM_SC_TOF_MASK)
@@ -0,0 +1,199 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+/*
+ * Host simulation of the Landungsbruecke V3.
+ *
+ * The simulation build defines LandungsbrueckeV3 together with
+ * LandungsbrueckeSim, so all platform switches in the firmware select the V3
+ * code. Instead of the GigaDevice library this header provides the small part
+ * of its API that is used outside of the HAL (StepDir timer, EXTI and GPIO
+ * alternate function setup of the boards). The HAL itself is replaced by the
+ * simulated one in hal/LandungsbrueckeSim/tmc.
+ *
+ * Interrupts are emulated by a separate thread, which signals the main thread
+ * with the poll interval. The signal handler calls the registered handlers with
+ * their configured frequency on the main thread. Like real interrupts they can
+ * preempt the main loop at any time, and the main loop does not run while they
+ * do. __disable_irq() blocks the signal.
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include "tmc/helpers/API_Header.h"
+
+typedef enum { RESET = 0, SET = !RESET } FlagStatus;
+
+// ===== Interrupts =====
+
+typedef enum {
+	SIM_IRQ_TIMER1,   // ID detection
+	SIM_IRQ_TIMER2,   // StepDir
+	SIM_IRQ_TIMER3,   // HAL Timer overflow callback (RAMDebug)
+	SIM_IRQ_EXTI,     // Pin change interrupts
+
+	SIM_IRQ_COUNT
+} SimIRQ;
+
+void sim_setInterrupt(SimIRQ irq, void (*handler)(void), uint32_t frequency);
+void sim_startInterrupts(void);
+void sim_disableInterrupts(void);
+void sim_enableInterrupts(void);
+
+// Monotonic host time in [ns], base for the simulated systick and cycle counter
+uint64_t sim_getNanoseconds(void);
+
+#define __enable_irq()   sim_enableInterrupts()
+#define __disable_irq()  sim_disableInterrupts()
+
+// ===== GPIO =====
+
+#define GPIOA  0
+#define GPIOB  1
+#define GPIOC  2
+#define GPIOD  3
+#define GPIOE  4
+#define SIM_GPIO_PORTS  5
+
+typedef struct
+{
+	volatile uint32_t bop;    // bit set register, applied by sim_gpio_update()
+	volatile uint32_t bc;     // bit clear register, applied by sim_gpio_update()
+	volatile uint32_t tg;     // bit toggle register, applied by sim_gpio_update()
+	volatile uint32_t octl;   // output state
+	volatile uint32_t input;  // externally driven input state
+	volatile uint32_t output; // pins configured as output
+} SimGPIOTypeDef;
+
+extern SimGPIOTypeDef SimGPIO[SIM_GPIO_PORTS];
+
+// Direct register writes (e.g. the step pulse in the StepDir interrupt) are
+// latched and take effect with the next access to the port through the HAL.
+#define GPIO_BOP(port)  (SimGPIO[port].bop)
+#define GPIO_BC(port)   (SimGPIO[port].bc)
+#define GPIO_TG(port)   (SimGPIO[port].tg)
+
+// Read-only views of the port state
+#define GPIO_ISTAT(port)  sim_gpio_read(port)
+#define GPIO_OCTL(port)   (sim_gpio_update(port), SimGPIO[port].octl)
+
+void sim_gpio_update(uint32_t port);
+uint32_t sim_gpio_read(uint32_t port);
+void sim_gpio_setInput(uint32_t port, uint32_t bitWeight, bool high);
+
+#define GPIO_PIN_0   (1u << 0)
+#define GPIO_PIN_1   (1u << 1)
+#define GPIO_PIN_2   (1u << 2)
+#define GPIO_PIN_3   (1u << 3)
+#define GPIO_PIN_4   (1u << 4)
+#define GPIO_PIN_5   (1u << 5)
+#define GPIO_PIN_6   (1u << 6)
+#define GPIO_PIN_7   (1u << 7)
+#define GPIO_PIN_8   (1u << 8)
+#define GPIO_PIN_9   (1u << 9)
+#define GPIO_PIN_10  (1u << 10)
+#define GPIO_PIN_11  (1u << 11)
+#define GPIO_PIN_12  (1u << 12)
+#define GPIO_PIN_13  (1u << 13)
+#define GPIO_PIN_14  (1u << 14)
+#define GPIO_PIN_15  (1u << 15)
+
+#define GPIO_MODE_INPUT    0
+#define GPIO_MODE_OUTPUT   1
+#define GPIO_MODE_AF       2
+#define GPIO_MODE_ANALOG   3
+
+#define GPIO_PUPD_NONE      0
+#define GPIO_PUPD_PULLUP    1
+#define GPIO_PUPD_PULLDOWN  2
+
+#define GPIO_OTYPE_PP  0
+#define GPIO_OTYPE_OD  1
+
+#define GPIO_OSPEED_50MHZ  2
+#define GPIO_OSPEED_MAX    3
+
+#define GPIO_AF_0  0
+#define GPIO_AF_1  1
+
+void gpio_mode_set(uint32_t port, uint32_t mode, uint32_t pullUpDown, uint32_t pin);
+void gpio_output_options_set(uint32_t port, uint8_t outputType, uint32_t speed, uint32_t pin);
+void gpio_af_set(uint32_t port, uint32_t alternateFunction, uint32_t pin);
+
+// ===== Timer =====
+
+#define TIMER1  1
+#define TIMER2  2
+#define TIMER3  3
+
+#define RCU_TIMER1  1
+#define RCU_TIMER2  2
+#define RCU_TIMER3  3
+#define RCU_SYSCFG  10
+#define RCU_GPIOA   20
+#define RCU_GPIOB   21
+#define RCU_GPIOC   22
+#define RCU_GPIOD   23
+#define RCU_GPIOE   24
+
+#define RCU_CKOUT0SRC_HXTAL  0
+#define RCU_CKOUT0_DIV1      0
+
+void rcu_ckout0_config(uint32_t source, uint32_t divider);
+
+#define TIMER_INT_UP       1
+#define TIMER_INT_FLAG_UP  1
+
+typedef struct
+{
+	uint16_t prescaler;
+	uint16_t alignedmode;
+	uint16_t counterdirection;
+	uint16_t clockdivision;
+	uint32_t period;
+	uint8_t  repetitioncounter;
+} timer_parameter_struct;
+
+void rcu_periph_clock_enable(uint32_t periph);
+void timer_deinit(uint32_t timer);
+void timer_struct_para_init(timer_parameter_struct *initpara);
+void timer_init(uint32_t timer, timer_parameter_struct *initpara);
+void timer_interrupt_enable(uint32_t timer, uint32_t interrupt);
+void timer_update_event_enable(uint32_t timer);
+void timer_enable(uint32_t timer);
+void timer_disable(uint32_t timer);
+FlagStatus timer_interrupt_flag_get(uint32_t timer, uint32_t interrupt);
+void timer_interrupt_flag_clear(uint32_t timer, uint32_t interrupt);
+
+// ===== NVIC, EXTI =====
+
+#define TIMER1_IRQn   28
+#define TIMER2_IRQn   29
+#define EXTI5_9_IRQn  23
+
+#define EXTI_7  (1 << 7)
+#define EXTI_8  (1 << 8)
+
+#define EXTI_SOURCE_GPIOC  2
+#define EXTI_SOURCE_GPIOD  3
+#define EXTI_SOURCE_PIN7   7
+#define EXTI_SOURCE_PIN8   8
+
+#define EXTI_INTERRUPT  0
+#define EXTI_TRIG_BOTH  2
+
+void nvic_irq_enable(uint8_t irq, uint8_t preemptPriority, uint8_t subPriority);
+void nvic_irq_disable(uint8_t irq);
+void syscfg_exti_line_config(uint8_t port, uint8_t pin);
+void exti_init(uint32_t line, uint32_t mode, uint32_t trigger);
+void exti_deinit(void);
+FlagStatus exti_flag_get(uint32_t line);
+void exti_flag_clear(uint32_t line);
+FlagStatus exti_interrupt_flag_get(uint32_t line);
+void exti_interrupt_flag_clear(uint32_t line);
+
+#endif /* SIM_H_ */
@@ -0,0 +1,80 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#include <stdlib.h>
+
+#include "hal/HAL.h"
+#include "hal/ADCs.h"
+
+// Conversion of the V3 VM measurement: 4095 corresponds to 74.4V
+#define VM_FACTOR   744
+#define ADC_VM_RES  4095
+
+// Supply voltage in [100mV] if TMC_SIM_VM is not set
+#define VM_DEFAULT  240
+
+static void init(void);
+static void deInit(void);
+static void setVMLimits(uint16_t low, uint16_t high);
+static void resetStatistics(void);
+
+static volatile ADCInputStatisticsTypeDef statistics[ADC_INPUT_COUNT];
+
+ADCTypeDef ADCs =
+{
+	.AIN0    = &ADCValue[0],
+	.AIN1    = &ADCValue[1],
+	.AIN2    = &ADCValue[2],
+	.DIO4    = &ADCValue[3],
+	.DIO5    = &ADCValue[4],
+	.VM      = &ADCValue[5],
+	.AIN_EXT = &ADCValue[6],
+	.init    = init,
+	.deInit  = deInit,
+	.setVMLimits       = setVMLimits,
+	.vmLimit_callback  = NULL,
+	.statistics        = statistics,
+	.resetStatistics   = resetStatistics,
+};
+
+// The analog inputs are static. VM is taken from TMC_SIM_VM in [100mV],
+// so the vital signs monitor sees a powered board.
+static void init(void)
+{
+	char *vm = getenv("TMC_SIM_VM");
+	uint32_t voltage = (vm) ? strtoul(vm, NULL, 0) : VM_DEFAULT;
+
+	for(uint8_t i = 0; i < N_O_ADC_CHANNELS; i++)
+		ADCValue[i] = 0;
+
+	ADCValue[5] = MIN((voltage * ADC_VM_RES) / VM_FACTOR, ADC_VM_RES);
+
+	resetStatistics();
+}
+
+static void deInit(void)
+{
+}
+
+// Noise free inputs: the filtered value and the extremes equal the raw value
+static void resetStatistics(void)
+{
+	for(uint8_t i = 0; i < ADC_INPUT_COUNT; i++)
+	{
+		statistics[i].filtered  = ADCValue[i];
+		statistics[i].min       = ADCValue[i];
+		statistics[i].max       = ADCValue[i];
+	}
+}
+
+// VM does not change during a simulation run, so checking it once when arming is sufficient
+static void setVMLimits(uint16_t low, uint16_t high)
+{
+	uint16_t value = ADCValue[5];
+
+	if((value < low || value > high) && ADCs.vmLimit_callback)
+		ADCs.vmLimit_callback(value);
+}
@@ -0,0 +1,94 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal/HAL.h"
+#include "hal/Flash.h"
+
+// Same layout as the Landungsbruecke flash region, so the wrap around of the store gets exercised quickly
+#define FLASH_BLOCK_SIZE  4096
+#define FLASH_BLOCKS      2
+
+static void init(void);
+static uint8_t erase(uint8_t block);
+static uint8_t program(uint32_t offset, uint32_t data);
+static void save(void);
+
+static uint32_t memory[FLASH_BLOCKS * FLASH_BLOCK_SIZE / 4];
+
+// Backing file given by TMC_SIM_FLASH, without it the contents are lost on exit
+static const char *path = NULL;
+
+FlashTypeDef Flash =
+{
+	.memory     = memory,
+	.blockSize  = FLASH_BLOCK_SIZE,
+	.blocks     = FLASH_BLOCKS,
+	.init       = init,
+	.erase      = erase,
+	.program    = program,
+};
+
+static void init(void)
+{
+	FILE *file;
+
+	memset(memory, 0xFF, sizeof(memory));
+
+	path = getenv("TMC_SIM_FLASH");
+	if(!path)
+		return;
+
+	file = fopen(path, "rb");
+	if(!file)
+		return;
+
+	if(fread(memory, 1, sizeof(memory), file) != sizeof(memory))
+		memset(memory, 0xFF, sizeof(memory));
+
+	fclose(file);
+}
+
+static uint8_t erase(uint8_t block)
+{
+	if(block >= FLASH_BLOCKS)
+		return false;
+
+	memset(&memory[block * FLASH_BLOCK_SIZE / 4], 0xFF, FLASH_BLOCK_SIZE);
+	save();
+
+	return true;
+}
+
+// Like real flash, programming can only clear bits
+static uint8_t program(uint32_t offset, uint32_t data)
+{
+	if((offset & 3) || offset >= sizeof(memory))
+		return false;
+
+	memory[offset / 4] &= data;
+	save();
+
+	return memory[offset / 4] == data;
+}
+
+static void save(void)
+{
+	FILE *file;
+
+	if(!path)
+		return;
+
+	file = fopen(path, "wb");
+	if(!file)
+		return;
+
+	fwrite(memory, 1, sizeof(memory), file);
+	fclose(file);
+}
@@ -0,0 +1,75 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hal/derivative.h"
+#include "hal/HAL.h"
+
+static void init(void);
+static void reset(uint8_t ResetPeripherals);
+static void NVIC_DeInit(void);
+
+uint8_t hwid = 0;
+
+static const IOsFunctionsTypeDef IOFunctions =
+{
+	.config  = &IOs,
+	.pins    = &IOMap,
+};
+
+const HALTypeDef HAL =
+{
+	.init         = init,
+	.reset        = reset,
+	.NVIC_DeInit  = NVIC_DeInit,
+	.SPI          = &SPI,
+	.USB          = &USB,
+	.LEDs         = &LEDs,
+	.ADCs         = &ADCs,
+	.IOs          = &IOFunctions,
+	.RS232        = &RS232,
+	.WLAN         = &WLAN,
+	.Timer        = &Timer,
+	.UART         = &UART,
+	.Flash        = &Flash
+};
+
+static void init(void)
+{
+	// Unbuffered output, so log messages show up immediately
+	setvbuf(stdout, NULL, _IONBF, 0);
+
+	systick_init();
+
+	IOs.init();
+	IOMap.init();
+	USB.init();
+	SPI.init();
+	RS232.init();
+	LEDs.init();
+	ADCs.init();
+	WLAN.init();
+	Flash.init();
+
+	sim_startInterrupts();
+}
+
+static void __attribute((noreturn)) reset(uint8_t ResetPeripherals)
+{
+	UNUSED(ResetPeripherals);
+
+	// There is no bootloader to jump into - a reset ends the simulation
+	printf("Reset requested, exiting simulation\n");
+	exit(0);
+}
+
+static void NVIC_DeInit(void)
+{
+	for(uint8_t i = 0; i < SIM_IRQ_COUNT; i++)
+		sim_setInterrupt(i, NULL, 0);
+}
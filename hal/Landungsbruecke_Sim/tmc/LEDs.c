@@ -0,0 +1,8 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+// The simulated GPIO registers behave like the GD32 ones, so the V3 LEDs code is reused unchanged.
+#include "hal/Landungsbruecke_V3/tmc/LEDs.c"
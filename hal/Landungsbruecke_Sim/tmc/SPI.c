@@ -0,0 +1,241 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#include "hal/HAL.h"
+#include "tmc/Profiler.h"
+#include "hal/SPI.h"
+#include "VirtualChip.h"
+
+// Frequency reported for a channel until it gets changed, matches the V3 default
+#define SPI_DEFAULT_FREQUENCY  3750000
+
+static void init(void);
+static void reset_ch1();
+static void reset_ch2();
+
+static unsigned char readWrite(SPIChannelTypeDef *SPIChannel, uint8_t data, uint8_t lastTransfer);
+static unsigned char spi_ch1_readWrite(uint8_t data, uint8_t lastTransfer);
+static unsigned char spi_ch2_readWrite(uint8_t data, uint8_t lastTransfer);
+static void spi_ch1_readWriteArray(uint8_t *data, size_t length);
+static void spi_ch2_readWriteArray(uint8_t *data, size_t length);
+
+SPIChannelTypeDef *SPIChannel_1_default;
+SPIChannelTypeDef *SPIChannel_2_default;
+
+static IOPinTypeDef IODummy = { .bitWeight = DUMMY_BITWEIGHT };
+
+// The periphery field holds the virtual channel, the frequency is only stored
+static uint32_t frequencies[VIRTUAL_CHANNEL_COUNT] = { SPI_DEFAULT_FREQUENCY, SPI_DEFAULT_FREQUENCY };
+
+SPITypeDef SPI=
+{
+	.ch1 =
+	{
+		.periphery       = VIRTUAL_CHANNEL_1,
+		.CSN             = &IODummy,
+		.readWrite       = spi_ch1_readWrite,
+		.readWriteArray  = spi_ch1_readWriteArray,
+		.reset           = reset_ch1
+	},
+
+	.ch2 =
+	{
+		.periphery       = VIRTUAL_CHANNEL_2,
+		.CSN             = &IODummy,
+		.readWrite       = spi_ch2_readWrite,
+		.readWriteArray  = spi_ch2_readWriteArray,
+		.reset           = reset_ch2
+	},
+	.init = init
+};
+
+
+static void init(void)
+{
+	VirtualChip_init();
+
+	HAL.IOs->config->setHigh(&HAL.IOs->pins->SPI2_CSN0);
+	HAL.IOs->config->setHigh(&HAL.IOs->pins->SPI2_CSN1);
+	HAL.IOs->config->setHigh(&HAL.IOs->pins->SPI2_CSN2);
+
+	reset_ch1();
+	reset_ch2();
+
+	// configure default SPI channel_1
+	SPIChannel_1_default = &HAL.SPI->ch1;
+	SPIChannel_1_default->CSN = &HAL.IOs->pins->SPI1_CSN;
+	// configure default SPI channel_2
+	SPIChannel_2_default = &HAL.SPI->ch2;
+	SPIChannel_2_default->CSN = &HAL.IOs->pins->SPI2_CSN0;
+}
+
+static void reset_ch1()
+{
+	SPI.ch1.CSN        = &IODummy;
+	SPI.ch1.periphery  = VIRTUAL_CHANNEL_1;
+	SPI.ch1.readWrite  = spi_ch1_readWrite;
+}
+
+static void reset_ch2()
+{
+	SPI.ch2.CSN        = &IODummy;
+	SPI.ch2.periphery  = VIRTUAL_CHANNEL_2;
+	SPI.ch2.readWrite  = spi_ch2_readWrite;
+}
+
+uint32_t spi_getFrequency(SPIChannelTypeDef *SPIChannel)
+{
+	return frequencies[SPIChannel->periphery];
+}
+
+// Set the SPI frequency. Every frequency is accepted, since there is no real bus.
+// Returns the frequency set or 0 for an invalid frequency.
+uint32_t spi_setFrequency(SPIChannelTypeDef *SPIChannel, uint32_t desiredFrequency)
+{
+	if(desiredFrequency == 0)
+		return 0;
+
+	frequencies[SPIChannel->periphery] = desiredFrequency;
+
+	return desiredFrequency;
+}
+
+int32_t spi_readInt(SPIChannelTypeDef *SPIChannel, uint8_t address)
+{
+	// clear write bit
+	address &= 0x7F;
+
+	SPIChannel->readWrite(address, false);
+	int32_t value = SPIChannel->readWrite(0, false);
+	value <<= 8;
+	value |= SPIChannel->readWrite(0, false);
+	value <<= 8;
+	value |= SPIChannel->readWrite(0, false);
+	value <<= 8;
+	value |= SPIChannel->readWrite(0, true);
+
+	return value;
+}
+
+// Read <count> registers with pipelined datagrams. Each read datagram returns
+// the value requested by the previous one, so this takes count + 1 datagrams
+// instead of two per register.
+void spi_readIntArray(SPIChannelTypeDef *SPIChannel, const uint8_t *addresses, int32_t *values, size_t count)
+{
+	if(count == 0)
+		return;
+
+	// The first reply carries stale data
+	spi_readInt(SPIChannel, addresses[0]);
+
+	for(size_t i = 1; i < count; i++)
+	{
+		values[i-1] = spi_readInt(SPIChannel, addresses[i]);
+	}
+
+	// Clock out the last value by repeating its address
+	values[count-1] = spi_readInt(SPIChannel, addresses[count-1]);
+}
+
+int32_t spi_ch1_readInt(uint8_t address)
+{
+	return spi_readInt(SPIChannel_1_default, address);
+}
+
+int32_t spi_ch2_readInt(uint8_t address)
+{
+	return spi_readInt(SPIChannel_2_default, address);
+}
+
+void spi_writeInt(SPIChannelTypeDef *SPIChannel, uint8_t address, int32_t value)
+{
+	SPIChannel->readWrite(address | 0x80, false);
+	SPIChannel->readWrite(0xFF & (value>>24), false);
+	SPIChannel->readWrite(0xFF & (value>>16), false);
+	SPIChannel->readWrite(0xFF & (value>>8), false);
+	SPIChannel->readWrite(0xFF & (value>>0), true);
+}
+
+void spi_ch1_writeInt(uint8_t address, int32_t value)
+{
+	spi_writeInt(SPIChannel_1_default, address, value);
+}
+
+void spi_ch2_writeInt(uint8_t address, int32_t value)
+{
+	spi_writeInt(SPIChannel_2_default, address, value);
+}
+
+static unsigned char spi_ch1_readWrite(unsigned char data, unsigned char lastTransfer)
+{
+	 return readWrite(&SPI.ch1, data, lastTransfer);
+}
+
+static unsigned char spi_ch2_readWrite(unsigned char data, unsigned char lastTransfer)
+{
+	 return readWrite(&SPI.ch2, data,lastTransfer);
+}
+
+static void spi_ch1_readWriteArray(uint8_t *data, size_t length)
+{
+	for(uint32_t i = 0; i < length; i++)
+	{
+		data[i] = readWrite(&SPI.ch1, data[i], (i == (length - 1))? true:false);
+	}
+}
+
+static void spi_ch2_readWriteArray(uint8_t *data, size_t length)
+{
+	for(uint32_t i = 0; i < length; i++)
+	{
+		data[i] = readWrite(&SPI.ch2, data[i], (i == (length - 1))? true:false);
+	}
+}
+
+uint8_t spi_ch1_readWriteByte(uint8_t data, uint8_t lastTransfer)
+{
+	return readWrite(SPIChannel_1_default, data, lastTransfer);
+}
+
+uint8_t spi_ch2_readWriteByte(SPIChannelTypeDef *SPIChannel, uint8_t data, uint8_t lastTransfer)
+{
+	return SPIChannel->readWrite(data, lastTransfer);
+}
+
+static unsigned char readWrite(SPIChannelTypeDef *SPIChannel, uint8_t data, uint8_t lastTransfer)
+{
+	// Profile whole transactions, from the first byte until CSN gets released
+	static uint32_t transactionStart = 0;
+	static bool transactionActive = false;
+
+	if(IS_DUMMY_PIN(SPIChannel->CSN))
+		return 0;
+
+	bool first = !transactionActive;
+	if(first)
+	{
+		transactionStart = profiler_start();
+		transactionActive = true;
+	}
+
+	io_setLow(SPIChannel->CSN);
+
+	// The ID EEPROMs share the bus with the chips and get selected by the ID pins
+	uint8_t out;
+	if(SPIChannel->CSN == &HAL.IOs->pins->ID_CH0 || SPIChannel->CSN == &HAL.IOs->pins->ID_CH1)
+		out = VirtualEEPROM_transfer(SPIChannel->periphery, data, first, lastTransfer);
+	else
+		out = VirtualChip_transfer(SPIChannel->periphery, data, first, lastTransfer);
+
+	if(lastTransfer)
+	{
+		io_setHigh(SPIChannel->CSN);
+		profiler_stop(PROFILER_PROBE_SPI, transactionStart);
+		transactionActive = false;
+	}
+
+	return out;
+}
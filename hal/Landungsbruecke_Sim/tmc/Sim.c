@@ -0,0 +1,332 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+
+#include "hal/HAL.h"
+
+// Timer input clock of the APB1 timers on the Landungsbruecke V3
+#define SIM_TIMER_CLOCK  120000000
+
+// Interval in which the interrupt thread checks for due interrupts
+#define SIM_INTERRUPT_POLL_NS  20000
+
+// Signal that runs the due handlers on the main thread
+#define SIM_INTERRUPT_SIGNAL  SIGUSR1
+
+// Maximum number of calls of one handler per poll. If the host can't keep up,
+// the remaining calls get dropped instead of piling up.
+#define SIM_INTERRUPT_MAX_CATCHUP  1000
+
+extern void TIMER2_IRQHandler(void);
+
+typedef struct
+{
+	void (* volatile handler)(void);
+	volatile uint32_t frequency;
+	uint64_t start;
+	uint64_t calls;
+} SimInterruptTypeDef;
+
+static SimInterruptTypeDef interrupts[SIM_IRQ_COUNT];
+static pthread_t mainThread;
+static timer_parameter_struct timers[TIMER3 + 1];
+
+SimGPIOTypeDef SimGPIO[SIM_GPIO_PORTS];
+
+uint64_t sim_getNanoseconds(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+// ===== Interrupts =====
+
+// Runs on the main thread. Like on the MCU, the main loop is suspended until the
+// handlers return, so they never run concurrently with the firmware.
+static void interruptSignal(int signal)
+{
+	UNUSED(signal);
+
+	uint64_t now = sim_getNanoseconds();
+
+	for(uint8_t i = 0; i < SIM_IRQ_COUNT; i++)
+	{
+		SimInterruptTypeDef *irq = &interrupts[i];
+		void (*handler)(void) = irq->handler;
+
+		if(!handler || !irq->frequency)
+			continue;
+
+		uint64_t due = ((now - irq->start) * irq->frequency) / 1000000000;
+		if(due - irq->calls > SIM_INTERRUPT_MAX_CATCHUP)
+			irq->calls = due - SIM_INTERRUPT_MAX_CATCHUP;
+
+		for(; irq->calls < due; irq->calls++)
+			handler();
+	}
+}
+
+// Only triggers the main thread, signals arriving while the handlers still run are merged
+static void *interruptThread(void *arg)
+{
+	UNUSED(arg);
+
+	struct timespec pollInterval = { .tv_sec = 0, .tv_nsec = SIM_INTERRUPT_POLL_NS };
+
+	while(1)
+	{
+		pthread_kill(mainThread, SIM_INTERRUPT_SIGNAL);
+		nanosleep(&pollInterval, NULL);
+	}
+
+	return NULL;
+}
+
+void sim_setInterrupt(SimIRQ irq, void (*handler)(void), uint32_t frequency)
+{
+	if(irq >= SIM_IRQ_COUNT)
+		return;
+
+	// Disable the interrupt while changing it
+	interrupts[irq].handler    = NULL;
+	interrupts[irq].frequency  = frequency;
+	interrupts[irq].start      = sim_getNanoseconds();
+	interrupts[irq].calls      = 0;
+	interrupts[irq].handler    = handler;
+}
+
+void sim_startInterrupts(void)
+{
+	struct sigaction action = { .sa_handler = interruptSignal, .sa_flags = SA_RESTART };
+	sigset_t mask;
+	pthread_t thread;
+
+	mainThread = pthread_self();
+	sigemptyset(&action.sa_mask);
+	sigaction(SIM_INTERRUPT_SIGNAL, &action, NULL);
+
+	// Threads inherit the signal mask, keep the signal away from the interrupt thread
+	sigemptyset(&mask);
+	sigaddset(&mask, SIM_INTERRUPT_SIGNAL);
+	pthread_sigmask(SIG_BLOCK, &mask, NULL);
+	pthread_create(&thread, NULL, interruptThread, NULL);
+	pthread_sigmask(SIG_UNBLOCK, &mask, NULL);
+}
+
+void sim_disableInterrupts(void)
+{
+	sigset_t mask;
+
+	sigemptyset(&mask);
+	sigaddset(&mask, SIM_INTERRUPT_SIGNAL);
+	pthread_sigmask(SIG_BLOCK, &mask, NULL);
+}
+
+void sim_enableInterrupts(void)
+{
+	sigset_t mask;
+
+	sigemptyset(&mask);
+	sigaddset(&mask, SIM_INTERRUPT_SIGNAL);
+	pthread_sigmask(SIG_UNBLOCK, &mask, NULL);
+}
+
+// ===== GPIO =====
+
+void sim_gpio_update(uint32_t port)
+{
+	SimGPIOTypeDef *gpio = &SimGPIO[port];
+
+	uint32_t octl = gpio->octl;
+	octl |= gpio->bop;
+	octl &= ~gpio->bc;
+	octl ^= gpio->tg;
+
+	gpio->bop   = 0;
+	gpio->bc    = 0;
+	gpio->tg    = 0;
+	gpio->octl  = octl;
+}
+
+// Output pins read back their output state, input pins the externally driven state
+uint32_t sim_gpio_read(uint32_t port)
+{
+	SimGPIOTypeDef *gpio = &SimGPIO[port];
+
+	sim_gpio_update(port);
+
+	return (gpio->octl & gpio->output) | (gpio->input & ~gpio->output);
+}
+
+void sim_gpio_setInput(uint32_t port, uint32_t bitWeight, bool high)
+{
+	if(high)
+		SimGPIO[port].input |= bitWeight;
+	else
+		SimGPIO[port].input &= ~bitWeight;
+}
+
+void gpio_mode_set(uint32_t port, uint32_t mode, uint32_t pullUpDown, uint32_t pin)
+{
+	if(pullUpDown == GPIO_PUPD_PULLUP)
+		SimGPIO[port].input |= pin;
+	else if(pullUpDown == GPIO_PUPD_PULLDOWN)
+		SimGPIO[port].input &= ~pin;
+
+	if(mode == GPIO_MODE_OUTPUT)
+		SimGPIO[port].output |= pin;
+	else
+		SimGPIO[port].output &= ~pin;
+}
+
+void gpio_output_options_set(uint32_t port, uint8_t outputType, uint32_t speed, uint32_t pin)
+{
+	UNUSED(port);
+	UNUSED(outputType);
+	UNUSED(speed);
+	UNUSED(pin);
+}
+
+void gpio_af_set(uint32_t port, uint32_t alternateFunction, uint32_t pin)
+{
+	UNUSED(port);
+	UNUSED(alternateFunction);
+	UNUSED(pin);
+}
+
+// ===== Timer =====
+
+void rcu_periph_clock_enable(uint32_t periph)
+{
+	UNUSED(periph);
+}
+
+void rcu_ckout0_config(uint32_t source, uint32_t divider)
+{
+	UNUSED(source);
+	UNUSED(divider);
+}
+
+void timer_deinit(uint32_t timer)
+{
+	timer_disable(timer);
+	timer_struct_para_init(&timers[timer]);
+}
+
+void timer_struct_para_init(timer_parameter_struct *initpara)
+{
+	initpara->prescaler          = 0;
+	initpara->alignedmode        = 0;
+	initpara->counterdirection   = 0;
+	initpara->clockdivision      = 0;
+	initpara->period             = 65535;
+	initpara->repetitioncounter  = 0;
+}
+
+void timer_init(uint32_t timer, timer_parameter_struct *initpara)
+{
+	timers[timer] = *initpara;
+}
+
+void timer_interrupt_enable(uint32_t timer, uint32_t interrupt)
+{
+	UNUSED(timer);
+	UNUSED(interrupt);
+}
+
+void timer_update_event_enable(uint32_t timer)
+{
+	UNUSED(timer);
+}
+
+void timer_enable(uint32_t timer)
+{
+	uint32_t frequency = SIM_TIMER_CLOCK / ((timers[timer].prescaler + 1) * (timers[timer].period + 1));
+
+	// Only the StepDir timer interrupt is used outside of the simulated HAL
+	if(timer == TIMER2)
+		sim_setInterrupt(SIM_IRQ_TIMER2, TIMER2_IRQHandler, frequency);
+}
+
+void timer_disable(uint32_t timer)
+{
+	if(timer == TIMER2)
+		sim_setInterrupt(SIM_IRQ_TIMER2, NULL, 0);
+}
+
+FlagStatus timer_interrupt_flag_get(uint32_t timer, uint32_t interrupt)
+{
+	UNUSED(timer);
+	UNUSED(interrupt);
+
+	// The handlers only get called for the update interrupt
+	return SET;
+}
+
+void timer_interrupt_flag_clear(uint32_t timer, uint32_t interrupt)
+{
+	UNUSED(timer);
+	UNUSED(interrupt);
+}
+
+// ===== NVIC, EXTI =====
+// Pin change interrupts are not simulated.
+
+void nvic_irq_enable(uint8_t irq, uint8_t preemptPriority, uint8_t subPriority)
+{
+	UNUSED(irq);
+	UNUSED(preemptPriority);
+	UNUSED(subPriority);
+}
+
+void nvic_irq_disable(uint8_t irq)
+{
+	UNUSED(irq);
+}
+
+void syscfg_exti_line_config(uint8_t port, uint8_t pin)
+{
+	UNUSED(port);
+	UNUSED(pin);
+}
+
+void exti_init(uint32_t line, uint32_t mode, uint32_t trigger)
+{
+	UNUSED(line);
+	UNUSED(mode);
+	UNUSED(trigger);
+}
+
+void exti_deinit(void)
+{
+}
+
+FlagStatus exti_flag_get(uint32_t line)
+{
+	UNUSED(line);
+	return RESET;
+}
+
+void exti_flag_clear(uint32_t line)
+{
+	UNUSED(line);
+}
+
+FlagStatus exti_interrupt_flag_get(uint32_t line)
+{
+	UNUSED(line);
+	return RESET;
+}
+
+void exti_interrupt_flag_clear(uint32_t line)
+{
+	UNUSED(line);
+}
@@ -0,0 +1,60 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#include <time.h>
+
+#include "hal/HAL.h"
+#include "hal/SysTick.h"
+
+// Host time at systick_init(), all ticks count from there
+static uint64_t startTime = 0;
+
+void systick_init(void)
+{
+	startTime = sim_getNanoseconds();
+}
+
+uint32_t systick_getMicrosecondTick()
+{
+	return (sim_getNanoseconds() - startTime) / 1000;
+}
+
+// Emulates the 240 MHz DWT cycle counter of the Landungsbruecke V3, so cycle
+// based measurements (Scheduler, Profiler) report real host durations.
+uint32_t systick_getCycleCount()
+{
+	return ((sim_getNanoseconds() - startTime) * SYSTICK_CYCLES_PER_MICROSECOND) / 1000;
+}
+
+uint32_t systick_getTick(void)
+{
+	return (sim_getNanoseconds() - startTime) / 1000000;
+}
+
+void wait(uint32_t delay)	// wait for [delay] ms/systicks
+{
+	uint32_t startTick = systick_getTick();
+	struct timespec sleepTime = { .tv_sec = 0, .tv_nsec = 100000 };
+
+	while((systick_getTick()-startTick) <= delay)
+		nanosleep(&sleepTime, NULL);
+}
+
+uint32_t timeSince(uint32_t tick)	// time difference since the [tick] timestamp in ms/systicks
+{
+	return timeDiff(systick_getTick(), tick);
+}
+
+uint32_t timeDiff(uint32_t newTick, uint32_t oldTick) // Time difference between newTick and oldTick timestamps
+{
+	uint32_t tickDiff = newTick - oldTick;
+
+	// Prevent subtraction underflow - saturate to 0 instead
+	if(tickDiff != 0)
+		return tickDiff - 1;
+	else
+		return 0;
+}
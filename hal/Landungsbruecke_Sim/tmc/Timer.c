@@ -0,0 +1,173 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#include "hal/HAL.h"
+#include "hal/Timer.h"
+
+/*
+The simulated timers only store their settings. TIMER_CHANNEL_2 additionally
+calls the overflow callback (RAMDebug, board specific) with the set frequency.
+*/
+
+#define TIMER_BASE_CLK 240000000
+#define TIMER_CHANNELS 4
+
+static void init(void);
+static void deInit(void);
+static void setDuty(timer_channel channel, uint32_t duty);
+static uint32_t getDuty(timer_channel channel);
+static void setPeriod(timer_channel channel, uint16_t period);
+static uint16_t getPeriod(timer_channel channel);
+static void setPeriodMin(timer_channel channel, uint16_t period_min);
+static void setFrequency(timer_channel channel, uint32_t freq);
+static void setFrequencyMin(timer_channel channel, uint32_t freq_min);
+static bool calculateTiming(timer_channel channel, uint32_t freq, TimerTimingTypeDef *timing);
+static void setTiming(timer_channel channel, const TimerTimingTypeDef *timing);
+static void beginUpdate(void);
+static void commitUpdate(void);
+static void overflowInterrupt(void);
+
+// Active and shadow settings, the shadow values get active at commitUpdate()
+static uint32_t duties[TIMER_CHANNELS];
+static uint16_t periods[TIMER_CHANNELS];
+static uint32_t dutyShadows[TIMER_CHANNELS];
+static uint16_t periodShadows[TIMER_CHANNELS];
+static uint16_t periodMins[TIMER_CHANNELS];
+static bool updateBatch = false;
+
+TimerTypeDef Timer =
+{
+	.initialized     = false,
+	.init            = init,
+	.deInit          = deInit,
+	.setDuty         = setDuty,
+	.getDuty         = getDuty,
+	.setPeriod       = setPeriod,
+	.getPeriod       = getPeriod,
+	.setPeriodMin    = setPeriodMin,
+	.setFrequency    = setFrequency,
+	.setFrequencyMin = setFrequencyMin,
+	.calculateTiming = calculateTiming,
+	.setTiming       = setTiming,
+	.beginUpdate     = beginUpdate,
+	.commitUpdate    = commitUpdate,
+	.overflow_callback = NULL
+};
+
+static void init(void)
+{
+	for(uint8_t i = 0; i < TIMER_CHANNELS; i++)
+	{
+		duties[i] = 0;
+		periods[i] = TIMER_MAX;
+		dutyShadows[i] = 0;
+		periodShadows[i] = TIMER_MAX;
+		periodMins[i] = 0;
+	}
+
+	Timer.initialized = true;
+}
+
+static void deInit(void)
+{
+	sim_setInterrupt(SIM_IRQ_TIMER3, NULL, 0);
+	Timer.initialized = false;
+}
+
+static void setDuty(timer_channel channel, uint32_t duty)
+{
+	dutyShadows[channel] = MIN(duty, TIMER_DUTY_MAX);
+
+	if(!updateBatch)
+		duties[channel] = dutyShadows[channel];
+}
+
+static uint32_t getDuty(timer_channel channel)
+{
+	return duties[channel];
+}
+
+static void setPeriod(timer_channel channel, uint16_t period)
+{
+	periodShadows[channel] = period;
+
+	if(!updateBatch)
+		periods[channel] = period;
+}
+
+static uint16_t getPeriod(timer_channel channel)
+{
+	return periods[channel];
+}
+
+static void setPeriodMin(timer_channel channel, uint16_t period_min)
+{
+	periodMins[channel] = period_min;
+}
+
+static void setFrequencyMin(timer_channel channel, uint32_t freq_min)
+{
+	UNUSED(channel);
+	UNUSED(freq_min);
+}
+
+static void setFrequency(timer_channel channel, uint32_t freq)
+{
+	TimerTimingTypeDef timing;
+
+	if(!calculateTiming(channel, freq, &timing))
+		return;
+
+	setTiming(channel, &timing);
+
+	if(channel == TIMER_CHANNEL_2)
+		sim_setInterrupt(SIM_IRQ_TIMER3, overflowInterrupt, freq);
+}
+
+// Same prescaler/period split as the V3 timer
+static bool calculateTiming(timer_channel channel, uint32_t freq, TimerTimingTypeDef *timing)
+{
+	if(freq == 0 || freq > TIMER_BASE_CLK)
+		return false;
+
+	uint32_t divider = (TIMER_BASE_CLK / freq) / 0xFFFF + 1;
+	if(divider > 0x10000)
+		return false;
+
+	uint32_t period = TIMER_BASE_CLK / (divider * freq);
+
+	timing->prescaler = divider - 1;
+	timing->period = MAX(period, periodMins[channel]);
+
+	return true;
+}
+
+static void setTiming(timer_channel channel, const TimerTimingTypeDef *timing)
+{
+	setPeriod(channel, timing->period);
+}
+
+static void beginUpdate(void)
+{
+	updateBatch = true;
+}
+
+static void commitUpdate(void)
+{
+	for(uint8_t i = 0; i < TIMER_CHANNELS; i++)
+	{
+		duties[i] = dutyShadows[i];
+		periods[i] = periodShadows[i];
+	}
+
+	updateBatch = false;
+}
+
+static void overflowInterrupt(void)
+{
+	if(Timer.overflow_callback)
+		Timer.overflow_callback(TIMER_CHANNEL_2);
+}
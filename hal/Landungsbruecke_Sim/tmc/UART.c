@@ -0,0 +1,114 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+// UART chips are not simulated. Every request behaves like a request to an
+// unconnected chip and times out immediately.
+
+#include "hal/HAL.h"
+#include "hal/UART.h"
+
+static void init();
+static void deInit();
+static void tx(uint8_t ch);
+static uint8_t rx(uint8_t *ch);
+static void txN(uint8_t *str, unsigned char number);
+static uint8_t rxN(uint8_t *ch, unsigned char number);
+static void clearBuffers(void);
+static uint32_t bytesAvailable();
+
+UART_Config UART =
+{
+	.mode = UART_MODE_DUAL_WIRE,
+	.pinout = UART_PINS_1,
+	.rxtx =
+	{
+		.init            = init,
+		.deInit          = deInit,
+		.rx              = rx,
+		.tx              = tx,
+		.rxN             = rxN,
+		.txN             = txN,
+		.clearBuffers    = clearBuffers,
+		.baudRate        = 115200,
+		.bytesAvailable  = bytesAvailable
+	}
+};
+
+static void init()
+{
+}
+
+static void deInit()
+{
+}
+
+static void tx(uint8_t ch)
+{
+	UNUSED(ch);
+}
+
+static uint8_t rx(uint8_t *ch)
+{
+	UNUSED(ch);
+	return 0;
+}
+
+static void txN(uint8_t *str, unsigned char number)
+{
+	UNUSED(str);
+	UNUSED(number);
+}
+
+static uint8_t rxN(uint8_t *str, unsigned char number)
+{
+	UNUSED(str);
+	UNUSED(number);
+	return 0;
+}
+
+static void clearBuffers(void)
+{
+}
+
+static uint32_t bytesAvailable()
+{
+	return 0;
+}
+
+int32_t UART_readWrite(UART_Config *uart, uint8_t *data, size_t writeLength, uint8_t readLength)
+{
+	uart->rxtx.clearBuffers();
+	uart->rxtx.txN(data, writeLength);
+
+	// Abort early if no data needs to be read back
+	if (readLength <= 0)
+		return 0;
+
+	// No reply
+	return -1;
+}
+
+void UART_readInt(UART_Config *channel, uint8_t slave, uint8_t address, int32_t *value)
+{
+	UNUSED(channel);
+	UNUSED(slave);
+	UNUSED(address);
+	UNUSED(value);
+}
+
+void UART_writeInt(UART_Config *channel, uint8_t slave, uint8_t address, int32_t value)
+{
+	UNUSED(channel);
+	UNUSED(slave);
+	UNUSED(address);
+	UNUSED(value);
+}
+
+void UART_setEnabled(UART_Config *channel, uint8_t enabled)
+{
+	UNUSED(channel);
+	UNUSED(enabled);
+}
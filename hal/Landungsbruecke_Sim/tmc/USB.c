@@ -0,0 +1,188 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+/*
+ * The USB connection of the simulation is a pseudo terminal. The IDE or any
+ * other TMCL host connects to the printed /dev/pts/N device like to the
+ * virtual COM port of a real board. If the environment variable
+ * TMC_SIM_PTY_LINK is set, a symlink with that name gets created for a
+ * stable device path.
+ */
+
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "hal/HAL.h"
+#include "hal/USB.h"
+
+#define BUFFER_SIZE  2048
+
+static void init(void);
+static void deInit(void);
+static void tx(uint8_t ch);
+static uint8_t rx(uint8_t *ch);
+static void txN(uint8_t *str, unsigned char number);
+static uint8_t rxN(uint8_t *str, unsigned char number);
+static void clearBuffers(void);
+static uint32_t bytesAvailable(void);
+static void receive(void);
+
+static volatile uint8_t rxBuffer[BUFFER_SIZE];
+static volatile uint32_t available = 0;
+
+static int master = -1;
+static int slave = -1;
+
+RXTXTypeDef USB =
+{
+	.init            = init,
+	.deInit          = deInit,
+	.rx              = rx,
+	.tx              = tx,
+	.rxN             = rxN,
+	.txN             = txN,
+	.clearBuffers    = clearBuffers,
+	.baudRate        = 115200,
+	.bytesAvailable  = bytesAvailable
+};
+
+static RXTXBufferingTypeDef buffers =
+{
+	.rx =
+	{
+		.read    = 0,
+		.wrote   = 0,
+		.buffer  = rxBuffer
+	},
+};
+
+static void init(void)
+{
+	master = posix_openpt(O_RDWR | O_NOCTTY);
+	if(master < 0 || grantpt(master) || unlockpt(master))
+	{
+		perror("Creating the pseudo terminal failed");
+		exit(1);
+	}
+
+	char *name = ptsname(master);
+
+	// Keep the slave side open, so the master doesn't see a hangup between
+	// host connections. It also holds the raw mode settings.
+	slave = open(name, O_RDWR | O_NOCTTY);
+
+	struct termios settings;
+	tcgetattr(slave, &settings);
+	cfmakeraw(&settings);
+	tcsetattr(slave, TCSANOW, &settings);
+
+	fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+
+	char *link = getenv("TMC_SIM_PTY_LINK");
+	if(link)
+	{
+		unlink(link);
+		if(symlink(name, link))
+			perror("Creating the pseudo terminal link failed");
+	}
+
+	printf("TMCL interface: %s\n", name);
+}
+
+static void deInit(void)
+{
+	close(slave);
+	close(master);
+	master = slave = -1;
+}
+
+// Move all bytes waiting on the pseudo terminal into the receive buffer
+static void receive(void)
+{
+	uint8_t data[64];
+
+	if(master < 0)
+		return;
+
+	while(available < BUFFER_SIZE)
+	{
+		uint32_t space = BUFFER_SIZE - available;
+		ssize_t count = read(master, data, MIN(sizeof(data), space));
+		if(count <= 0)
+			break;
+
+		for(ssize_t i = 0; i < count; i++)
+		{
+			buffers.rx.buffer[buffers.rx.wrote] = data[i];
+			buffers.rx.wrote = (buffers.rx.wrote + 1) % BUFFER_SIZE;
+		}
+		available += count;
+	}
+}
+
+static void tx(uint8_t ch)
+{
+	txN(&ch, 1);
+}
+
+static uint8_t rx(uint8_t *ch)
+{
+	return rxN(ch, 1);
+}
+
+static void txN(uint8_t *str, unsigned char number)
+{
+	if(master < 0)
+		return;
+
+	// Without a connected host the data gets dropped
+	while(number > 0)
+	{
+		ssize_t count = write(master, str, number);
+		if(count <= 0)
+			break;
+
+		str += count;
+		number -= count;
+	}
+}
+
+static uint8_t rxN(uint8_t *str, unsigned char number)
+{
+	receive();
+
+	if(available < number)
+		return false;
+
+	for(int32_t i = 0; i < number; i++)
+	{
+		str[i] = buffers.rx.buffer[buffers.rx.read];
+		buffers.rx.read = (buffers.rx.read + 1) % BUFFER_SIZE;
+	}
+	available -= number;
+
+	return true;
+}
+
+static void clearBuffers(void)
+{
+	receive();
+
+	available         = 0;
+	buffers.rx.read   = 0;
+	buffers.rx.wrote  = 0;
+}
+
+static uint32_t bytesAvailable(void)
+{
+	receive();
+
+	return available;
+}
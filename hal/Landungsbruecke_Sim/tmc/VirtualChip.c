@@ -0,0 +1,167 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#include <string.h>
+
+#include "VirtualChip.h"
+
+// 25128 instructions
+#define EEPROM_WRITE_STATUS   0x01
+#define EEPROM_WRITE          0x02
+#define EEPROM_READ           0x03
+#define EEPROM_WRITE_DISABLE  0x04
+#define EEPROM_READ_STATUS    0x05
+#define EEPROM_WRITE_ENABLE   0x06
+
+#define EEPROM_STATUS_WEL  0x02
+#define EEPROM_PAGE_SIZE   64
+
+typedef struct
+{
+	int32_t registers[VIRTUAL_CHIP_REGISTERS];
+	uint8_t index;     // Byte position within the datagram
+	uint8_t address;
+	uint32_t data;
+	uint32_t reply;    // Read data of the previous datagram
+} VirtualChipTypeDef;
+
+typedef struct
+{
+	uint8_t memory[VIRTUAL_EEPROM_SIZE];
+	uint8_t status;
+	uint8_t instruction;
+	uint32_t index;    // Byte position within the transaction
+	uint16_t address;
+} VirtualEEPROMTypeDef;
+
+static VirtualChipTypeDef chips[VIRTUAL_CHANNEL_COUNT];
+static VirtualEEPROMTypeDef eeproms[VIRTUAL_CHANNEL_COUNT];
+
+void VirtualChip_init(void)
+{
+	memset(chips, 0, sizeof(chips));
+	memset(eeproms, 0, sizeof(eeproms));
+
+	// An unprogrammed EEPROM reads as 0xFF
+	for(uint8_t i = 0; i < VIRTUAL_CHANNEL_COUNT; i++)
+		memset(eeproms[i].memory, 0xFF, VIRTUAL_EEPROM_SIZE);
+}
+
+uint8_t VirtualChip_transfer(VirtualChannel channel, uint8_t data, bool first, bool last)
+{
+	VirtualChipTypeDef *chip = &chips[channel];
+	uint8_t out = 0;
+
+	if(first)
+	{
+		chip->index = 0;
+		chip->data = 0;
+	}
+
+	if(chip->index == 0)
+	{
+		chip->address = data;
+		out = 0; // Status
+	}
+	else if(chip->index <= 4)
+	{
+		chip->data = (chip->data << 8) | data;
+		out = chip->reply >> (8 * (4 - chip->index));
+	}
+
+	chip->index++;
+
+	if(chip->index == 5)
+	{
+		uint8_t address = chip->address & 0x7F;
+
+		if(chip->address & 0x80)
+			chip->registers[address] = chip->data;
+
+		chip->reply = chip->registers[address];
+	}
+
+	if(last)
+		chip->index = 0;
+
+	return out;
+}
+
+uint8_t VirtualEEPROM_transfer(VirtualChannel channel, uint8_t data, bool first, bool last)
+{
+	VirtualEEPROMTypeDef *eeprom = &eeproms[channel];
+	uint8_t out = 0xFF;
+
+	if(first)
+	{
+		eeprom->instruction = data;
+		eeprom->index = 0;
+	}
+
+	switch(eeprom->instruction)
+	{
+	case EEPROM_WRITE_ENABLE:
+		eeprom->status |= EEPROM_STATUS_WEL;
+		break;
+	case EEPROM_WRITE_DISABLE:
+		eeprom->status &= ~EEPROM_STATUS_WEL;
+		break;
+	case EEPROM_READ_STATUS:
+		if(eeprom->index > 0)
+			out = eeprom->status;
+		break;
+	case EEPROM_WRITE_STATUS:
+		break;
+	case EEPROM_READ:
+	case EEPROM_WRITE:
+		if(eeprom->index == 1)
+		{
+			eeprom->address = data << 8;
+		}
+		else if(eeprom->index == 2)
+		{
+			eeprom->address = (eeprom->address | data) % VIRTUAL_EEPROM_SIZE;
+		}
+		else if(eeprom->index > 2)
+		{
+			if(eeprom->instruction == EEPROM_READ)
+			{
+				out = eeprom->memory[eeprom->address];
+				eeprom->address = (eeprom->address + 1) % VIRTUAL_EEPROM_SIZE;
+			}
+			else if(eeprom->status & EEPROM_STATUS_WEL)
+			{
+				// Writes wrap around within the page, like on the real device
+				eeprom->memory[eeprom->address] = data;
+				eeprom->address = (eeprom->address & ~(EEPROM_PAGE_SIZE - 1)) | ((eeprom->address + 1) & (EEPROM_PAGE_SIZE - 1));
+			}
+		}
+		break;
+	}
+
+	eeprom->index++;
+
+	// A write cycle completes instantly and resets the write enable latch
+	if(last && eeprom->instruction == EEPROM_WRITE)
+		eeprom->status &= ~EEPROM_STATUS_WEL;
+
+	return out;
+}
+
+int32_t VirtualChip_readRegister(VirtualChannel channel, uint8_t address)
+{
+	return chips[channel].registers[address & 0x7F];
+}
+
+void VirtualChip_writeRegister(VirtualChannel channel, uint8_t address, int32_t value)
+{
+	chips[channel].registers[address & 0x7F] = value;
+}
+
+uint8_t *VirtualEEPROM_getMemory(VirtualChannel channel)
+{
+	return eeproms[channel].memory;
+}
@@ -0,0 +1,46 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+/*
+ * Virtual devices on the SPI channels of the simulated Landungsbruecke.
+ *
+ * Every channel has a virtual TMC chip and a virtual ID EEPROM. The chip
+ * models the common 40 bit TMC SPI datagram: The first byte holds the
+ * register address with the write bit (0x80), the following four bytes the
+ * data. Read data gets returned with the next datagram, the status byte is
+ * always 0. Chip specific behaviour (ramp generators, clear on read flags,
+ * the 20 bit protocol of the TMC26x) is not modeled.
+ *
+ * The EEPROM models the 25128 instruction set used by tmc/EEPROM.c.
+ */
+
+#ifndef VIRTUAL_CHIP_H_
+#define VIRTUAL_CHIP_H_
+
+#include "tmc/helpers/API_Header.h"
+
+#define VIRTUAL_CHIP_REGISTERS  128
+#define VIRTUAL_EEPROM_SIZE     16384
+
+typedef enum {
+	VIRTUAL_CHANNEL_1,
+	VIRTUAL_CHANNEL_2,
+
+	VIRTUAL_CHANNEL_COUNT
+} VirtualChannel;
+
+void VirtualChip_init(void);
+
+// SPI transfer of one byte. first/last mark the byte as start/end of a transaction (CSN edges)
+uint8_t VirtualChip_transfer(VirtualChannel channel, uint8_t data, bool first, bool last);
+uint8_t VirtualEEPROM_transfer(VirtualChannel channel, uint8_t data, bool first, bool last);
+
+// Direct access, bypassing the SPI protocol
+int32_t VirtualChip_readRegister(VirtualChannel channel, uint8_t address);
+void VirtualChip_writeRegister(VirtualChannel channel, uint8_t address, int32_t value);
+uint8_t *VirtualEEPROM_getMemory(VirtualChannel channel);
+
+#endif /* VIRTUAL_CHIP_H_ */
@@ -0,0 +1,100 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+// The simulation has no WLAN module. The interface drops all data and never
+// enters command mode.
+
+#include "hal/HAL.h"
+#include "hal/WLAN.h"
+
+static void init();
+static void deInit();
+static void tx(uint8_t ch);
+static uint8_t rx(uint8_t *ch);
+static void txN(uint8_t *str, unsigned char number);
+static uint8_t rxN(uint8_t *ch, unsigned char number);
+static void clearBuffers(void);
+static uint32_t bytesAvailable();
+
+RXTXTypeDef WLAN =
+{
+	.init            = init,
+	.deInit          = deInit,
+	.rx              = rx,
+	.tx              = tx,
+	.rxN             = rxN,
+	.txN             = txN,
+	.clearBuffers    = clearBuffers,
+	.baudRate        = 115200,
+	.bytesAvailable  = bytesAvailable
+};
+
+static void init()
+{
+}
+
+static void deInit()
+{
+}
+
+static void tx(uint8_t ch)
+{
+	UNUSED(ch);
+}
+
+static uint8_t rx(uint8_t *ch)
+{
+	UNUSED(ch);
+	return 0;
+}
+
+static void txN(uint8_t *str, unsigned char number)
+{
+	UNUSED(str);
+	UNUSED(number);
+}
+
+static uint8_t rxN(uint8_t *str, unsigned char number)
+{
+	UNUSED(str);
+	UNUSED(number);
+	return 0;
+}
+
+static void clearBuffers(void)
+{
+}
+
+static uint32_t bytesAvailable()
+{
+	return 0;
+}
+
+uint32_t checkReadyToSend()
+{
+	return false;
+}
+
+void enableWLANCommandMode()
+{
+}
+
+uint32_t checkCmdModeEnabled()
+{
+	return false;
+}
+
+uint32_t handleWLANCommand(BufferCommandTypedef cmd, uint32_t value)
+{
+	UNUSED(cmd);
+	UNUSED(value);
+	return 0;
+}
+
+uint32_t getCMDReply()
+{
+	return 0;
+}
@@ -13,8 +13,28 @@
 
 #define ADC1_DR_ADDRESS  ((uint32_t)0x4001204C)
 
+// Scans per DMA buffer half. With 144 cycle sample time one half takes about 1.2ms,
+// the filtering interrupt then runs at roughly 850Hz.
+#define ADC_OVERSAMPLING  64
+// Time constant of the low pass filter in buffer halves (2^shift)
+#define ADC_FILTER_SHIFT  3
+
+void DMA1_Channel0_IRQHandler(void);
+
 static void init(void);
 static void deInit(void);
+static void setVMLimits(uint16_t low, uint16_t high);
+static void resetStatistics(void);
+static void processSamples(volatile uint16_t (*samples)[N_O_ADC_CHANNELS]);
+
+static uint16_t vmHigh = 4095;
+
+// Circular DMA buffer, the interrupt processes one half while the DMA fills the other
+static volatile uint16_t dmaBuffer[2][ADC_OVERSAMPLING][N_O_ADC_CHANNELS];
+
+static volatile ADCInputStatisticsTypeDef statistics[ADC_INPUT_COUNT];
+static ADCFilterTypeDef filters[ADC_INPUT_COUNT];
+static volatile bool resetRequest = true;
 
 ADCTypeDef ADCs =
 {
@@ -27,6 +47,10 @@ ADCTypeDef ADCs =
 	.AIN_EXT = &ADCValue[6],
 	.init    = init,
 	.deInit  = deInit,
+	.setVMLimits       = setVMLimits,
+	.vmLimit_callback  = NULL,
+	.statistics        = statistics,
+	.resetStatistics   = resetStatistics,
 };
 
 void init(void)
@@ -48,18 +72,23 @@ void init(void)
 	dma_init_struct.periph_addr = (uint32_t) (ADC0 + 0x4CU);
 	dma_init_struct.periph_width = DMA_PERIPH_WIDTH_16BIT;
 	dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
-	dma_init_struct.memory0_addr = (uint32_t)&ADCValue[0];
+	dma_init_struct.memory0_addr = (uint32_t)&dmaBuffer[0][0][0];
 	dma_init_struct.memory_width = DMA_MEMORY_WIDTH_16BIT;
 	dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
 	dma_init_struct.memory_burst_width = DMA_MEMORY_BURST_SINGLE;
 	dma_init_struct.periph_burst_width = DMA_PERIPH_BURST_SINGLE;
 	dma_init_struct.circular_mode = DMA_CIRCULAR_MODE_ENABLE;
 	dma_init_struct.direction = DMA_PERIPH_TO_MEMORY;
-	dma_init_struct.number = N_O_ADC_CHANNELS;
+	dma_init_struct.number = sizeof(dmaBuffer) / sizeof(dmaBuffer[0][0][0]);
 	dma_init_struct.critical_value = DMA_FIFO_2_WORD;
 	dma_init_struct.priority = DMA_PRIORITY_HIGH;
 	dma_multi_data_mode_init(DMA1, DMA_CH0, &dma_init_struct);
 
+	// Half and full transfer interrupts for the double buffered processing
+	dma_interrupt_flag_clear(DMA1, DMA_CH0, DMA_INT_FLAG_HTF | DMA_INT_FLAG_FTF);
+	dma_interrupt_enable(DMA1, DMA_CH0, DMA_CHXCTL_HTFIE | DMA_CHXCTL_FTFIE);
+	nvic_irq_enable(DMA1_Channel0_IRQn, 1, 0);
+
 	dma_channel_enable(DMA1, DMA_CH0);
 	
 	adc_clock_config(ADC_ADCCK_PCLK2_DIV2);
@@ -73,16 +102,21 @@ void init(void)
 	adc_channel_length_config(ADC0, ADC_ROUTINE_CHANNEL, N_O_ADC_CHANNELS);
 	adc_dma_mode_enable(ADC0);
 
-	adc_routine_channel_config(ADC0, 0, ADC_CHANNEL_14, ADC_SAMPLETIME_15);
-	adc_routine_channel_config(ADC0, 1, ADC_CHANNEL_15, ADC_SAMPLETIME_15);
-	adc_routine_channel_config(ADC0, 2, ADC_CHANNEL_8, ADC_SAMPLETIME_15);
-	adc_routine_channel_config(ADC0, 3, ADC_CHANNEL_0, ADC_SAMPLETIME_15);
-	adc_routine_channel_config(ADC0, 4, ADC_CHANNEL_1, ADC_SAMPLETIME_15);
-	adc_routine_channel_config(ADC0, 5, ADC_CHANNEL_3, ADC_SAMPLETIME_15);
-	adc_routine_channel_config(ADC0, 6, ADC_CHANNEL_2, ADC_SAMPLETIME_15);
+	adc_routine_channel_config(ADC0, 0, ADC_CHANNEL_14, ADC_SAMPLETIME_144);
+	adc_routine_channel_config(ADC0, 1, ADC_CHANNEL_15, ADC_SAMPLETIME_144);
+	adc_routine_channel_config(ADC0, 2, ADC_CHANNEL_8, ADC_SAMPLETIME_144);
+	adc_routine_channel_config(ADC0, 3, ADC_CHANNEL_0, ADC_SAMPLETIME_144);
+	adc_routine_channel_config(ADC0, 4, ADC_CHANNEL_1, ADC_SAMPLETIME_144);
+	adc_routine_channel_config(ADC0, 5, ADC_CHANNEL_3, ADC_SAMPLETIME_144);
+	adc_routine_channel_config(ADC0, 6, ADC_CHANNEL_2, ADC_SAMPLETIME_144);
 
 	adc_dma_request_after_last_enable(ADC0);
 
+	// Analog watchdog on the VM channel, the interrupt gets enabled by setVMLimits()
+	adc_watchdog_single_channel_enable(ADC0, ADC_CHANNEL_3);
+	adc_watchdog_threshold_config(ADC0, 0, vmHigh);
+	nvic_irq_enable(ADC_IRQn, 0, 0);
+
 	adc_enable(ADC0);
 
 	adc_calibration_enable(ADC0);
@@ -92,5 +126,89 @@ void init(void)
 
 static void deInit(void)
 {
+	nvic_irq_disable(DMA1_Channel0_IRQn);
 	adc_deinit();
 }
+
+static void resetStatistics(void)
+{
+	// Executed by the next buffer interrupt to not race with the filter update
+	resetRequest = true;
+}
+
+static void processSamples(volatile uint16_t (*samples)[N_O_ADC_CHANNELS])
+{
+	if(resetRequest)
+	{
+		resetRequest = false;
+		for(uint8_t ch = 0; ch < ADC_INPUT_COUNT; ch++)
+		{
+			filters[ch].min = 0xFFFF;
+			filters[ch].max = 0;
+		}
+	}
+
+	for(uint8_t ch = 0; ch < N_O_ADC_CHANNELS; ch++)
+	{
+		uint32_t sum = 0;
+		uint16_t min = 0xFFFF;
+		uint16_t max = 0;
+
+		for(uint8_t i = 0; i < ADC_OVERSAMPLING; i++)
+		{
+			uint16_t sample = samples[i][ch];
+			sum += sample;
+			if(sample < min)
+				min = sample;
+			if(sample > max)
+				max = sample;
+		}
+
+		// Raw values keep their meaning: the latest single sample
+		ADCValue[ch] = samples[ADC_OVERSAMPLING-1][ch];
+
+		adc_filterUpdate(&filters[ch], &statistics[ch], (sum + ADC_OVERSAMPLING/2) / ADC_OVERSAMPLING, min, max, ADC_FILTER_SHIFT);
+	}
+}
+
+void DMA1_Channel0_IRQHandler(void)
+{
+	if(dma_interrupt_flag_get(DMA1, DMA_CH0, DMA_INT_FLAG_HTF) != RESET)
+	{
+		dma_interrupt_flag_clear(DMA1, DMA_CH0, DMA_INT_FLAG_HTF);
+		processSamples(dmaBuffer[0]);
+	}
+
+	if(dma_interrupt_flag_get(DMA1, DMA_CH0, DMA_INT_FLAG_FTF) != RESET)
+	{
+		dma_interrupt_flag_clear(DMA1, DMA_CH0, DMA_INT_FLAG_FTF);
+		processSamples(dmaBuffer[1]);
+	}
+}
+
+static void setVMLimits(uint16_t low, uint16_t high)
+{
+	adc_interrupt_disable(ADC0, ADC_INT_WDE);
+
+	vmHigh = high;
+	adc_watchdog_threshold_config(ADC0, low, high);
+
+	adc_interrupt_flag_clear(ADC0, ADC_INT_FLAG_WDE);
+	adc_interrupt_enable(ADC0, ADC_INT_WDE);
+}
+
+void ADCs_watchdogInterrupt(void)
+{
+	if(adc_interrupt_flag_get(ADC0, ADC_INT_FLAG_WDE) == RESET)
+		return;
+
+	// The watchdog triggers on every sample while VM is out of range -> disarm until the limits get set again
+	adc_interrupt_disable(ADC0, ADC_INT_WDE);
+	adc_interrupt_flag_clear(ADC0, ADC_INT_FLAG_WDE);
+
+	// The triggering sample is not processed into ADCValue yet - report at least the exceeded limit
+	uint16_t value = MAX(ADCValue[5], vmHigh + 1);
+
+	if(ADCs.vmLimit_callback)
+		ADCs.vmLimit_callback(value);
+}
@@ -0,0 +1,67 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#include "hal/HAL.h"
+#include "hal/Flash.h"
+
+// The last two 128k sectors (10 and 11) of the GD32F425VG are reserved for firmware data.
+// Note that the flash is a single bank: erasing a sector stalls all code fetches for up to ~1s.
+#define FLASH_REGION_ADDRESS  0x080C0000
+#define FLASH_BLOCK_SIZE      (128 * 1024)
+#define FLASH_BLOCKS          2
+
+#define FLASH_ERROR_FLAGS     (FMC_FLAG_END | FMC_FLAG_OPERR | FMC_FLAG_WPERR | FMC_FLAG_PGMERR | FMC_FLAG_PGSERR | FMC_FLAG_RDDERR)
+
+static void init(void);
+static uint8_t erase(uint8_t block);
+static uint8_t program(uint32_t offset, uint32_t data);
+
+static const uint32_t sectors[FLASH_BLOCKS] = { CTL_SECTOR_NUMBER_10, CTL_SECTOR_NUMBER_11 };
+
+FlashTypeDef Flash =
+{
+	.memory     = (const volatile uint32_t *) FLASH_REGION_ADDRESS,
+	.blockSize  = FLASH_BLOCK_SIZE,
+	.blocks     = FLASH_BLOCKS,
+	.init       = init,
+	.erase      = erase,
+	.program    = program,
+};
+
+static void init(void)
+{
+	fmc_lock();
+}
+
+static uint8_t erase(uint8_t block)
+{
+	fmc_state_enum state;
+
+	if(block >= FLASH_BLOCKS)
+		return false;
+
+	fmc_unlock();
+	fmc_flag_clear(FLASH_ERROR_FLAGS);
+	state = fmc_sector_erase(sectors[block]);
+	fmc_lock();
+
+	return state == FMC_READY;
+}
+
+static uint8_t program(uint32_t offset, uint32_t data)
+{
+	fmc_state_enum state;
+
+	if((offset & 3) || offset >= FLASH_BLOCK_SIZE * FLASH_BLOCKS)
+		return false;
+
+	fmc_unlock();
+	fmc_flag_clear(FLASH_ERROR_FLAGS);
+	state = fmc_word_program(FLASH_REGION_ADDRESS + offset, data);
+	fmc_lock();
+
+	return (state == FMC_READY) && (Flash.memory[offset / 4] == data);
+}
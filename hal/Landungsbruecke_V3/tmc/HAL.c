@@ -37,7 +37,8 @@ const HALTypeDef HAL =
 	.RS232        = &RS232,
 	.WLAN         = &WLAN,
 	.Timer        = &Timer,
-	.UART         = &UART
+	.UART         = &UART,
+	.Flash        = &Flash
 };
 
 static void init(void)
@@ -56,6 +57,7 @@ static void init(void)
 	LEDs.init();
 	ADCs.init();
 	WLAN.init();
+	Flash.init();
 }
 
 static void __attribute((noreturn)) reset(uint8_t ResetPeripherals)
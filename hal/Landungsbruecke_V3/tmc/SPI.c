@@ -8,6 +8,7 @@
 
 
 #include "hal/HAL.h"
+#include "tmc/Profiler.h"
 #include "hal/SPI.h"
 
 static void init(void);
@@ -192,6 +193,26 @@ int32_t spi_readInt(SPIChannelTypeDef *SPIChannel, uint8_t address)
 	return value;
 }
 
+// Read <count> registers with pipelined datagrams. Each read datagram returns
+// the value requested by the previous one, so this takes count + 1 datagrams
+// instead of two per register.
+void spi_readIntArray(SPIChannelTypeDef *SPIChannel, const uint8_t *addresses, int32_t *values, size_t count)
+{
+	if(count == 0)
+		return;
+
+	// The first reply carries stale data
+	spi_readInt(SPIChannel, addresses[0]);
+
+	for(size_t i = 1; i < count; i++)
+	{
+		values[i-1] = spi_readInt(SPIChannel, addresses[i]);
+	}
+
+	// Clock out the last value by repeating its address
+	values[count-1] = spi_readInt(SPIChannel, addresses[count-1]);
+}
+
 int32_t spi_ch1_readInt(uint8_t address)
 {
 	return spi_readInt(SPIChannel_1_default, address);
@@ -257,18 +278,71 @@ uint8_t spi_ch2_readWriteByte(SPIChannelTypeDef *SPIChannel, uint8_t data, uint8
 	return SPIChannel->readWrite(data, lastTransfer);
 }
 
+// Profiler state of the transaction in progress, per SPI channel.
+// A transaction is profiled from the first byte until CSN gets released.
+// Only main loop transactions get profiled, the profile is only written by
+// the main loop then. Interrupts just mark a running transaction as discarded.
+typedef struct
+{
+	uint32_t start;
+	volatile bool discard; // Set from an interrupt
+	volatile bool active;
+} SPIProfileTypeDef;
+
+static SPIProfileTypeDef spiProfile[2];
+
+static SPIProfileTypeDef *profileOf(SPIChannelTypeDef *SPIChannel)
+{
+	return &spiProfile[(SPIChannel->periphery == SPI.ch1.periphery)? 0 : 1];
+}
+
+static inline uint32_t activeContext(void)
+{
+	return __get_IPSR();
+}
+
 static unsigned char readWrite(SPIChannelTypeDef *SPIChannel, uint8_t data, uint8_t lastTransfer)
 {
+	SPIProfileTypeDef *profile;
+	bool profiling;
+
 	if(IS_DUMMY_PIN(SPIChannel->CSN))
 		return 0;
 
-	HAL.IOs->config->setLow(SPIChannel->CSN);
+	profile = profileOf(SPIChannel);
+	profiling = (activeContext() == 0);
+
+	if(profiling)
+	{
+		if(!profile->active)
+		{
+			profile->start    = profiler_start();
+			profile->discard  = false;
+			profile->active   = true;
+		}
+	}
+	else if(profile->active)
+	{
+		// An interrupt uses the channel within the transaction, its time would be counted as well
+		profile->discard = true;
+	}
+
+	io_setLow(SPIChannel->CSN);
 
 	while(spi_i2s_flag_get(SPIChannel->periphery, SPI_FLAG_TBE) == RESET);
 	spi_i2s_data_transmit(SPIChannel->periphery, data);
 	while(spi_i2s_flag_get(SPIChannel->periphery, SPI_FLAG_RBNE) == RESET);
 	if(lastTransfer)
-		HAL.IOs->config->setHigh(SPIChannel->CSN);
+	{
+		io_setHigh(SPIChannel->CSN);
+		if(profiling)
+		{
+			if(!profile->discard)
+				profiler_stop(PROFILER_PROBE_SPI, profile->start);
+
+			profile->active = false;
+		}
+	}
 
 	return spi_i2s_data_receive(SPIChannel->periphery);
 }
@@ -35,7 +35,14 @@ void SysTick_Handler(void)
 uint32_t systick_getMicrosecondTick()
 {
 	// 240 MHz CYCCNT / 240 -> µs counter
-	return DWT->CYCCNT / 240;
+	return DWT->CYCCNT / SYSTICK_CYCLES_PER_MICROSECOND;
+}
+
+// Raw CYCCNT value. Use this for duration measurements - unlike the µs tick,
+// differences of two cycle counts stay correct across the counter overflow.
+uint32_t systick_getCycleCount()
+{
+	return DWT->CYCCNT;
 }
 
 uint32_t systick_getTick(void)
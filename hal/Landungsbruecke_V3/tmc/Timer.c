@@ -23,16 +23,22 @@ TIMER_CHANNEL_4 = TIMER 0 Channel 1, PWM output DIO9
 
 static void init(void);
 static void deInit(void);
-static void setDuty(timer_channel channel, float duty);
-static float getDuty(timer_channel channel);
+static void setDuty(timer_channel channel, uint32_t duty);
+static uint32_t getDuty(timer_channel channel);
 static void setPeriod(timer_channel channel, uint16_t period);
 static uint16_t getPeriod(timer_channel channel);
 static void setPeriodMin(timer_channel channel, uint16_t period_min);
-static void setFrequency(timer_channel channel, float freq);
-static void setFrequencyMin(timer_channel channel, float freq_min);
+static void setFrequency(timer_channel channel, uint32_t freq);
+static void setFrequencyMin(timer_channel channel, uint32_t freq_min);
+static bool calculateTiming(timer_channel channel, uint32_t freq, TimerTimingTypeDef *timing);
+static void setTiming(timer_channel channel, const TimerTimingTypeDef *timing);
+static void beginUpdate(void);
+static void commitUpdate(void);
+static uint32_t timerPeripheral(timer_channel channel);
 
 static uint16_t period_min_buf[] = { 0, 0, 0 };
-static float freq_min_buf[] = { 0.0f, 0.0f, 0.0f };
+static uint32_t freq_min_buf[] = { 0, 0, 0 };
+static bool updateBatch = false;
 
 TimerTypeDef Timer =
 {
@@ -46,6 +52,10 @@ TimerTypeDef Timer =
 	.setPeriodMin = setPeriodMin,
 	.setFrequency = setFrequency,
 	.setFrequencyMin = setFrequencyMin,
+	.calculateTiming = calculateTiming,
+	.setTiming = setTiming,
+	.beginUpdate = beginUpdate,
+	.commitUpdate = commitUpdate,
 	.overflow_callback = NULL
 };
 
@@ -86,12 +96,12 @@ static void init(void)
 
 	timer_channel_output_pulse_value_config(TIMER0, TIMER_CH_2, TIMER_MAX >> 1);
 	timer_channel_output_mode_config(TIMER0, TIMER_CH_2, TIMER_OC_MODE_PWM1);
-	timer_channel_output_shadow_config(TIMER0, TIMER_CH_2, TIMER_OC_SHADOW_DISABLE);
+	timer_channel_output_shadow_config(TIMER0, TIMER_CH_2, TIMER_OC_SHADOW_ENABLE);
 
 	// TIMER_CHANNEL_4
 	timer_channel_output_pulse_value_config(TIMER0, TIMER_CH_1, TIMER_MAX >> 1);
 	timer_channel_output_mode_config(TIMER0, TIMER_CH_1, TIMER_OC_MODE_PWM0);
-	timer_channel_output_shadow_config(TIMER0, TIMER_CH_1, TIMER_OC_SHADOW_DISABLE);
+	timer_channel_output_shadow_config(TIMER0, TIMER_CH_1, TIMER_OC_SHADOW_ENABLE);
 
 	timer_primary_output_config(TIMER0, ENABLE);
 
@@ -142,39 +152,44 @@ static void deInit(void)
 	timer_deinit(TIMER4);
 }
 
-static void setDuty(timer_channel channel, float duty)
+// Compare values are 16 bit, so duty * period stays within 32 bit
+#define DUTY_TO_PULSE(duty, period)  (((duty) * ((period) & 0xFFFF)) >> TIMER_DUTY_SHIFT)
+#define PULSE_TO_DUTY(pulse, period) (((period) != 0)? ((pulse) << TIMER_DUTY_SHIFT) / (period) : 0)
+
+static void setDuty(timer_channel channel, uint32_t duty)
 {
-	duty = (duty < 0.0f) ? 0.0f : duty;
-	duty = (duty > 1.0f) ? 1.0f : duty;
+	duty = MIN(duty, TIMER_DUTY_MAX);
 
 	switch(channel) {
 	case TIMER_CHANNEL_1:
-		timer_channel_output_pulse_value_config(TIMER0, TIMER_CH_2, duty * TIMER_CAR(TIMER0));
+		timer_channel_output_pulse_value_config(TIMER0, TIMER_CH_2, DUTY_TO_PULSE(duty, TIMER_CAR(TIMER0)));
 		break;
 	case TIMER_CHANNEL_2:
-		timer_channel_output_pulse_value_config(TIMER3, TIMER_CH_0, duty * TIMER_CAR(TIMER3));
+		timer_channel_output_pulse_value_config(TIMER3, TIMER_CH_0, DUTY_TO_PULSE(duty, TIMER_CAR(TIMER3)));
 		break;
 	case TIMER_CHANNEL_3:
-		timer_channel_output_pulse_value_config(TIMER4, TIMER_CH_0, duty * TIMER_CAR(TIMER4));
+		timer_channel_output_pulse_value_config(TIMER4, TIMER_CH_0, DUTY_TO_PULSE(duty, TIMER_CAR(TIMER4)));
 		break;
 	case TIMER_CHANNEL_4:
-		timer_channel_output_pulse_value_config(TIMER0, TIMER_CH_1, duty * TIMER_CAR(TIMER0));
+		timer_channel_output_pulse_value_config(TIMER0, TIMER_CH_1, DUTY_TO_PULSE(duty, TIMER_CAR(TIMER0)));
 		break;
 	}
 }
 
-static float getDuty(timer_channel channel)
+static uint32_t getDuty(timer_channel channel)
 {
 	switch(channel) {
 	case TIMER_CHANNEL_1:
-		return (((float) timer_channel_capture_value_register_read(TIMER0, TIMER_CH_2)) / TIMER_CAR(TIMER0));
+		return PULSE_TO_DUTY(timer_channel_capture_value_register_read(TIMER0, TIMER_CH_2), TIMER_CAR(TIMER0));
 	case TIMER_CHANNEL_2:
-		return (((float) timer_channel_capture_value_register_read(TIMER3, TIMER_CH_0)) / TIMER_CAR(TIMER3));
+		return PULSE_TO_DUTY(timer_channel_capture_value_register_read(TIMER3, TIMER_CH_0), TIMER_CAR(TIMER3));
 	case TIMER_CHANNEL_3:
-		return (((float) timer_channel_capture_value_register_read(TIMER4, TIMER_CH_0)) / TIMER_CAR(TIMER4));
+		return PULSE_TO_DUTY(timer_channel_capture_value_register_read(TIMER4, TIMER_CH_0), TIMER_CAR(TIMER4));
 	case TIMER_CHANNEL_4:
-		return (((float) timer_channel_capture_value_register_read(TIMER0, TIMER_CH_1)) / TIMER_CAR(TIMER0));
+		return PULSE_TO_DUTY(timer_channel_capture_value_register_read(TIMER0, TIMER_CH_1), TIMER_CAR(TIMER0));
 	}
+
+	return 0;
 }
 
 static void setPeriod(timer_channel channel, uint16_t period)
@@ -222,7 +237,7 @@ static void setPeriodMin(timer_channel channel, uint16_t period_min)
 	}
 }
 
-static void setFrequencyMin(timer_channel channel, float freq_min)
+static void setFrequencyMin(timer_channel channel, uint32_t freq_min)
 {
 	switch(channel) {
 	case TIMER_CHANNEL_1:
@@ -238,67 +253,91 @@ static void setFrequencyMin(timer_channel channel, float freq_min)
 	}
 }
 
-static void setFrequency(timer_channel channel, float freq)
+static void setFrequency(timer_channel channel, uint32_t freq)
+{
+	TimerTimingTypeDef timing;
+
+	if(calculateTiming(channel, freq, &timing))
+		setTiming(channel, &timing);
+}
+
+static bool calculateTiming(timer_channel channel, uint32_t freq, TimerTimingTypeDef *timing)
 {
-	float freq_min;
 	uint16_t period_min;
-	uint32_t timer;
-	uint32_t timer_ch;
-	IRQn_Type irq;
 
 	switch(channel) {
-	case TIMER_CHANNEL_1:
-		freq_min = freq_min_buf[0];
-		period_min = period_min_buf[0];
-		timer = TIMER0;
-		timer_ch = TIMER_CH_2;
-		irq = TIMER0_Channel_IRQn;
-		break;
 	case TIMER_CHANNEL_2:
-		freq_min = freq_min_buf[1];
 		period_min = period_min_buf[1];
-		timer = TIMER3;
-		timer_ch = TIMER_CH_0;
-		irq = TIMER3_IRQn;
 		break;
 	case TIMER_CHANNEL_3:
-		freq_min = freq_min_buf[2];
 		period_min = period_min_buf[2];
-		timer = TIMER4;
-		timer_ch = TIMER_CH_0;
-		irq = TIMER4_IRQn;
 		break;
+	case TIMER_CHANNEL_1:
 	case TIMER_CHANNEL_4:
-		freq_min = freq_min_buf[0];
+	default:
 		period_min = period_min_buf[0];
-		timer = TIMER0;
-		timer_ch = TIMER_CH_1;
-		irq = TIMER0_Channel_IRQn;
 		break;
 	}
 
-	uint16_t prescaler = 0;
-	uint16_t period = 0xFFFF;
+	if(freq == 0 || freq > TIMER_BASE_CLK)
+		return false;
 
-	if(freq < ((float)TIMER_BASE_CLK / (0x0000FFFF * 0x0000FFFF)))
-		return;
+	// Smallest divider that keeps the period within 16 bit
+	uint32_t divider = (TIMER_BASE_CLK / freq) / 0xFFFF + 1;
+	if(divider > 0x10000)
+		return false;
 
-	if(freq > (float)TIMER_BASE_CLK)
-		return;
-
-	for(; prescaler < 0xFFFF; prescaler++)
+	uint32_t period = TIMER_BASE_CLK / (divider * freq);
+	if(period < period_min && divider > 1)
 	{
-		if(freq > ((float)TIMER_BASE_CLK / ((prescaler + 1) * period)))
-		{
-			period = (float)TIMER_BASE_CLK / ((prescaler + 1) * freq);
-			if(period < period_min)
-			    period = (float)TIMER_BASE_CLK / (prescaler * freq);
-			break;
-		}
+		divider--;
+		period = MIN(TIMER_BASE_CLK / (divider * freq), 0xFFFF);
 	}
 
-	timer_prescaler_config(timer, prescaler, TIMER_PSC_RELOAD_NOW);
-	timer_autoreload_value_config(timer, period);
+	timing->prescaler = divider - 1;
+	timing->period = period;
+
+	return true;
+}
+
+static void setTiming(timer_channel channel, const TimerTimingTypeDef *timing)
+{
+	uint32_t timer = timerPeripheral(channel);
+
+	timer_prescaler_config(timer, timing->prescaler, (updateBatch)? TIMER_PSC_RELOAD_UPDATE : TIMER_PSC_RELOAD_NOW);
+	timer_autoreload_value_config(timer, timing->period);
+}
+
+// While the update event is disabled the shadow registers keep their values.
+// The update interrupt of TIMER_CHANNEL_2 is held back as well, so keep the batch short.
+static void beginUpdate(void)
+{
+	updateBatch = true;
+	timer_update_event_disable(TIMER0);
+	timer_update_event_disable(TIMER3);
+	timer_update_event_disable(TIMER4);
+}
+
+static void commitUpdate(void)
+{
+	timer_update_event_enable(TIMER0);
+	timer_update_event_enable(TIMER3);
+	timer_update_event_enable(TIMER4);
+	updateBatch = false;
+}
+
+static uint32_t timerPeripheral(timer_channel channel)
+{
+	switch(channel) {
+	case TIMER_CHANNEL_2:
+		return TIMER3;
+	case TIMER_CHANNEL_3:
+		return TIMER4;
+	case TIMER_CHANNEL_1:
+	case TIMER_CHANNEL_4:
+	default:
+		return TIMER0;
+	}
 }
 
 void TIMER3_IRQHandler(void)
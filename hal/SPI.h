@@ -41,6 +41,7 @@
 
 	// read/write 32 bit value at address
 	int32_t spi_readInt(SPIChannelTypeDef *SPIChannel, uint8_t address);
+	void spi_readIntArray(SPIChannelTypeDef *SPIChannel, const uint8_t *addresses, int32_t *values, size_t count);
 	void spi_writeInt(SPIChannelTypeDef *SPIChannel, uint8_t address, int32_t value);
 
 	// for default channels
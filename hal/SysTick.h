@@ -18,8 +18,13 @@
 	uint32_t timeSince(uint32_t tick);
 	uint32_t timeDiff(uint32_t newTick, uint32_t oldTick);
 
-#if defined(Landungsbruecke) || defined(LandungsbrueckeSmall)
 	uint32_t systick_getMicrosecondTick();
+	uint32_t systick_getCycleCount();
+
+#if defined(Landungsbruecke) || defined(LandungsbrueckeSmall)
+	#define SYSTICK_CYCLES_PER_MICROSECOND 48
+#elif defined(LandungsbrueckeV3)
+	#define SYSTICK_CYCLES_PER_MICROSECOND 240
 #endif
 
 #endif /* SysTick_H */
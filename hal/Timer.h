@@ -18,6 +18,13 @@
 #define TIMER_MAX 65535
 #endif
 
+// Duty cycles are fixed point values, TIMER_DUTY_MAX equals 100%
+#define TIMER_DUTY_SHIFT  16
+#define TIMER_DUTY_MAX    (1UL << TIMER_DUTY_SHIFT)
+
+// Duty cycle of <value> out of <fullscale>. <value> must be below 65536.
+#define TIMER_DUTY(value, fullscale)  ((((uint32_t) (value)) << TIMER_DUTY_SHIFT) / (fullscale))
+
 typedef enum {
 	TIMER_CHANNEL_1,
 	TIMER_CHANNEL_2,
@@ -25,18 +32,32 @@ typedef enum {
 	TIMER_CHANNEL_4
 } timer_channel;
 
+// Prescaler and period register values for a frequency.
+// Calculate these once with calculateTiming() and apply them with setTiming() at runtime.
+typedef struct
+{
+	uint16_t prescaler;
+	uint16_t period;
+} TimerTimingTypeDef;
+
 typedef struct
 {
 	bool initialized;
 	void (*init) (void);
 	void (*deInit) (void);
-	void (*setDuty) (timer_channel channel, float duty);
-	float (*getDuty) (timer_channel channel);
+	void (*setDuty) (timer_channel channel, uint32_t duty);
+	uint32_t (*getDuty) (timer_channel channel);
 	void (*setPeriod) (timer_channel channel, uint16_t period);
 	uint16_t (*getPeriod) (timer_channel channel);
 	void (*setPeriodMin) (timer_channel channel, uint16_t period_min);
-	void (*setFrequency) (timer_channel channel, float freq);
-	void (*setFrequencyMin) (timer_channel channel, float freq_min);
+	void (*setFrequency) (timer_channel channel, uint32_t freq);
+	void (*setFrequencyMin) (timer_channel channel, uint32_t freq_min);
+	bool (*calculateTiming) (timer_channel channel, uint32_t freq, TimerTimingTypeDef *timing);
+	void (*setTiming) (timer_channel channel, const TimerTimingTypeDef *timing);
+	// Duty cycle and period changes between beginUpdate() and commitUpdate() only reach
+	// the shadow registers and get applied together at the next update event.
+	void (*beginUpdate) (void);
+	void (*commitUpdate) (void);
 	void (*overflow_callback) (timer_channel channel);
 } TimerTypeDef;
 
@@ -34,7 +34,12 @@
         #define __MK_xxx_H__
     #elif defined(LandungsbrueckeV3)
         #define MODULE_ID "0026"
-		#include "gd32f4xx.h"
+		#if defined(LandungsbrueckeSim)
+			// Host simulation of the V3, see hal/Landungsbruecke_Sim/Sim.h
+			#include "hal/Landungsbruecke_Sim/Sim.h"
+		#else
+			#include "gd32f4xx.h"
+		#endif
     #elif defined(LandungsbrueckeSmall)
         // The Landungsbruecke (Small) is a normal Landungsbruecke but with a MK20DX256VLL10 µC instead.
         // This other µC has less memory. We assign a different module ID, otherwise the functionality
@@ -15,6 +15,16 @@
 #include "tmc/VitalSignsMonitor.h"
 #include "tmc/BoardAssignment.h"
 #include "tmc/RAMDebug.h"
+#include "tmc/Scheduler.h"
+#include "tmc/Profiler.h"
+#include "tmc/Benchmark.h"
+#include "tmc/EEPROM.h"
+#include "tmc/ParameterStore.h"
+#include "tmc/LoadMonitor.h"
+#include "tmc/EventLog.h"
+#if defined(LandungsbrueckeSim)
+#include "tmc/StepDirBenchmark.h"
+#endif
 
 const char *VersionString = MODULE_ID "V309"; // module id and version of the firmware shown in the TMCL-IDE
 
@@ -86,6 +96,132 @@ void shallForceBoot()
 	tmcl_boot();
 }
 
+/* Scheduler task wrappers */
+static void vitalSignsTask(uint32_t tick)
+{
+	UNUSED(tick);
+	// Check all parameters and life signs and mark errors
+	vitalsignsmonitor_checkVitalSigns();
+}
+
+static void debugTask(uint32_t tick)
+{
+	UNUSED(tick);
+	// handle RAMDebug
+	debug_process();
+}
+
+static void periodicJobCh1Task(uint32_t tick)
+{
+	// Perodic jobs of Motion controller board
+	Evalboards.ch1.periodicJob(tick);
+}
+
+static void periodicJobCh2Task(uint32_t tick)
+{
+	// Perodic jobs of Driver board
+	Evalboards.ch2.periodicJob(tick);
+}
+
+static void restoreTask(uint32_t tick)
+{
+	// Apply stored axis parameters once freshly assigned boards finished their reset
+	Board_restoreParameters(tick);
+}
+
+static void tmclTask(uint32_t tick)
+{
+	UNUSED(tick);
+	// Process TMCL communication
+	tmcl_process();
+}
+
+static void eepromTask(uint32_t tick)
+{
+	UNUSED(tick);
+	// Write buffered EEPROM data
+	eeprom_process();
+}
+
+// Time the motors get to ramp down before a flash block gets erased [ms]
+#define PARAMSTORE_STOP_TIME  500
+
+static void stopAllMotors(void)
+{
+	for(uint8_t motor = 0; motor < Evalboards.ch1.numberOfMotors; motor++)
+		Evalboards.ch1.stop(motor);
+
+	for(uint8_t motor = 0; motor < Evalboards.ch2.numberOfMotors; motor++)
+		Evalboards.ch2.stop(motor);
+}
+
+// Register a main loop task. A task that does not fit into the scheduler never runs,
+// which is logged as a fault.
+static void addTask(SchedulerTaskFunc run, uint32_t period, uint32_t deadline, SchedulerPriority priority)
+{
+	if(scheduler_addTask(run, period, deadline, priority) < 0)
+		eventlog_write(EVENTLOG_SOURCE_SYSTEM, EVENTLOG_CODE_TASK | EVENTLOG_FAULT, Scheduler.taskCount);
+}
+
+static void paramstoreTask(uint32_t tick)
+{
+	static bool stopping = false;
+	static uint32_t stopTick;
+
+	if(!paramstore_erasePending())
+	{
+		stopping = false;
+		return;
+	}
+
+	// Erasing a flash block stalls the CPU (on the Landungsbruecke including all interrupts).
+	// Stop all motion first and erase once the motors had time to ramp down.
+	if(!stopping)
+	{
+		stopAllMotors();
+		stopping  = true;
+		stopTick  = tick;
+		return;
+	}
+
+	if((tick - stopTick) < PARAMSTORE_STOP_TIME)
+		return;
+
+	stopAllMotors();
+	paramstore_process();
+	stopping = false;
+}
+
+/* Called by the ID detection on boot and whenever a board change got detected */
+static void assignBoards(IdAssignmentTypeDef *ids)
+{
+	static uint8_t initialScan = true;
+
+	if(initialScan && !ids->ch1.id && !ids->ch2.id)
+	{
+		shallForceBoot();           // only checking to force jump into bootloader if there are no boards attached
+		// shallForceBoot() changes the ID pin settings, the background scans need them restored
+		IDDetection_init();
+	}
+	initialScan = false;
+
+	if (ID_CH1_DEFAULT && (!ids->ch1.id || ID_CH1_OVERRIDE))
+	{
+		ids->ch1.id = ID_CH1_DEFAULT;
+		ids->ch1.state = ID_STATE_DONE;
+	}
+
+	if (ID_CH2_DEFAULT && (!ids->ch2.id || ID_CH2_OVERRIDE))
+	{
+		ids->ch2.id = ID_CH2_DEFAULT;
+		ids->ch2.state = ID_STATE_DONE;
+	}
+
+	Board_assign(ids);             // assign boards with detected id
+
+	VitalSignsMonitor.busy 	= 0;    // not busy any more!
+}
+
 /* Call all standard initialization routines. */
 static void init()
 {
@@ -95,6 +231,8 @@ static void init()
 #endif
 
 	HAL.init();                  // Initialize Hardware Abstraction Layer
+	paramstore_init();           // Load the parameters stored in flash
+	eventlog_write(EVENTLOG_SOURCE_SYSTEM, EVENTLOG_CODE_BOOT, 0);
 	IDDetection_init();          // Initialize board detection
 	tmcl_init();                 // Initialize TMCL communication
 
@@ -110,33 +248,36 @@ static void init()
 	HAL.IOs->config->toOutput(&HAL.IOs->pins->DIO0);
 	HAL.IOs->config->setHigh(&HAL.IOs->pins->DIO0);
 
-	IdAssignmentTypeDef ids = { 0 };
-	IDDetection_initialScan(&ids);  // start initial board detection
-	IDDetection_initialScan(&ids);  // start second time, first time not 100% reliable, not sure why - too fast after startup?
-	if(!ids.ch1.id && !ids.ch2.id)
-	{
-		shallForceBoot();           // only checking to force jump into bootloader if there are no boards attached
-		// todo CHECK 2: Workaround: shallForceBoot() changes pin settings - change them again here, since otherwise IDDetection partially breaks (LH)
-		HAL.IOs->config->toOutput(&HAL.IOs->pins->ID_CLK);
-		HAL.IOs->config->toInput(&HAL.IOs->pins->ID_CH0);
-
-	}
-
-	if (ID_CH1_DEFAULT && (!ids.ch1.id || ID_CH1_OVERRIDE))
-	{
-		ids.ch1.id = ID_CH1_DEFAULT;
-		ids.ch1.state = ID_STATE_DONE;
-	}
-
-	if (ID_CH2_DEFAULT && (!ids.ch2.id || ID_CH2_OVERRIDE))
-	{
-		ids.ch2.id = ID_CH2_DEFAULT;
-		ids.ch2.state = ID_STATE_DONE;
-	}
-
-	Board_assign(&ids);             // assign boards with detected id
-
-	VitalSignsMonitor.busy 	= 0;    // not busy any more!
+	// The boards get detected and assigned in the background, see IdDetection.c
+	IDDetection.assign = assignBoards;
+
+	// Register the main loop tasks. The tasks get called in this order within each priority.
+	// Period 0 runs a task every loop pass, the deadlines are allowed execution times in µs.
+	addTask(vitalSignsTask,      0, 100,  SCHEDULER_PRIORITY_HIGH);
+	addTask(debugTask,           0, 50,   SCHEDULER_PRIORITY_HIGH);
+	addTask(tmclTask,            0, 500,  SCHEDULER_PRIORITY_HIGH);
+	addTask(periodicJobCh1Task,  0, 1000, SCHEDULER_PRIORITY_NORMAL);
+	addTask(periodicJobCh2Task,  0, 1000, SCHEDULER_PRIORITY_NORMAL);
+	addTask(restoreTask,         0, 1000, SCHEDULER_PRIORITY_NORMAL);
+	addTask(profiler_process,    0, 0,    SCHEDULER_PRIORITY_HIGH);
+	addTask(IDDetection_process, 0, 0,    SCHEDULER_PRIORITY_NORMAL); // Board initialisation exceeds any deadline
+	addTask(eepromTask,          0, 200,  SCHEDULER_PRIORITY_LOW);
+	addTask(loadmonitor_process, 0, 0,    SCHEDULER_PRIORITY_NORMAL); // UART boards exceed any deadline
+	addTask(eventlog_process,    0, 0,    SCHEDULER_PRIORITY_LOW);    // Saving to flash exceeds any deadline
+	addTask(paramstoreTask,      0, 0,    SCHEDULER_PRIORITY_LOW);    // Flash erase exceeds any deadline
+
+	// Global parameters stored with STGP, after the tasks exist for the stored scheduler settings.
+	// Axis parameters get restored when the boards are assigned.
+	tmcl_restoreGlobalParameters();
+
+#if defined(LandungsbrueckeSim)
+	// The simulated detection finishes immediately - assign the boards before running the benchmarks
+	while(VitalSignsMonitor.busy)
+		IDDetection_process(systick_getTick());
+
+	benchmark_runFromEnvironment();
+	stepdir_benchmark_runFromEnvironment();
+#endif
 }
 
 /* main function */
@@ -148,18 +289,8 @@ int main(void)
 	// Main loop
 	while(1)
 	{
-		// Check all parameters and life signs and mark errors
-		vitalsignsmonitor_checkVitalSigns();
-
-		// handle RAMDebug
-		debug_process();
-
-		// Perodic jobs of Motion controller/Driver boards
-		Evalboards.ch1.periodicJob(systick_getTick());
-		Evalboards.ch2.periodicJob(systick_getTick());
-
-		// Process TMCL communication
-		tmcl_process();
+		// Run all due tasks
+		scheduler_run();
 	}
 
 	return 0;
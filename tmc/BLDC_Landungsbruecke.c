@@ -406,7 +406,7 @@ void timer_callback(void)
 	static int32_t hallAngleDiffAccu = 0;
 
 	// Measure the hall sensor
-	HallStates actualHallState = inputToHallState(HAL.IOs->config->isHigh(Pins.HALL_U), HAL.IOs->config->isHigh(Pins.HALL_V), HAL.IOs->config->isHigh(Pins.HALL_W));
+	HallStates actualHallState = inputToHallState(io_isHigh(Pins.HALL_U), io_isHigh(Pins.HALL_V), io_isHigh(Pins.HALL_W));
 	hallAngle = hallStateToAngle(actualHallState);
 
 	// Calculate the hall angle difference
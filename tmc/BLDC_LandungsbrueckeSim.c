@@ -0,0 +1,172 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+// BLDC commutation of the host simulation. No motor is simulated, the
+// functions only keep the settings so they can be read back.
+
+#include "BLDC.h"
+#include "hal/HAL.h"
+
+#define PWM_FREQ  20000  // in Hz
+
+static int16_t  targetPWM        = 0;
+static uint32_t openloopVelocity = 60; // mechanical RPM
+static uint16_t openloopStepTime = 0;
+static BLDCMode commutationMode  = BLDC_OPENLOOP;
+static uint8_t  pwmEnabled       = 0;
+static uint8_t  bbmTime          = 50;
+static uint8_t  motorPolePairs   = 1;
+static uint8_t  hallOrder        = 0;
+static uint8_t  hallInvert       = 0;
+
+void BLDC_init(BLDCMeasurementType type, uint32_t currentScaling, IOPinTypeDef *hallU, IOPinTypeDef *hallV, IOPinTypeDef *hallW)
+{
+	UNUSED(type);
+	UNUSED(currentScaling);
+	UNUSED(hallU);
+	UNUSED(hallV);
+	UNUSED(hallW);
+
+	BLDC_setTargetOpenloopVelocity(openloopVelocity);
+}
+
+void BLDC_calibrateADCs()
+{
+}
+
+void BLDC_enablePWM(uint8_t enable)
+{
+	pwmEnabled = (enable)? 1:0;
+}
+
+uint8_t BLDC_isPWMenabled()
+{
+	return pwmEnabled;
+}
+
+void BLDC_setTargetPWM(int16_t pwm)
+{
+	targetPWM = pwm;
+}
+
+int16_t BLDC_getTargetPWM()
+{
+	return targetPWM;
+}
+
+int32_t BLDC_getMeasuredCurrent()
+{
+	return 0;
+}
+
+void BLDC_setCommutationMode(BLDCMode mode)
+{
+	commutationMode = mode;
+}
+
+BLDCMode BLDC_getCommutationMode()
+{
+	return commutationMode;
+}
+
+void BLDC_setPolePairs(uint8 polePairs)
+{
+	if (polePairs == 0)
+		return;
+
+	motorPolePairs = polePairs;
+}
+
+uint8_t BLDC_getPolePairs()
+{
+	return motorPolePairs;
+}
+
+void BLDC_setOpenloopStepTime(uint16_t stepTime)
+{
+	openloopStepTime = stepTime;
+}
+
+uint16_t BLDC_getOpenloopStepTime()
+{
+	return openloopStepTime;
+}
+
+int32_t BLDC_getTargetAngle()
+{
+	return 0;
+}
+
+int32_t BLDC_getHallAngle()
+{
+	return 0;
+}
+
+// Set the open loop velocity in RPM
+void BLDC_setTargetOpenloopVelocity(uint32_t velocity)
+{
+	if (velocity == 0)
+		return;
+
+	openloopStepTime = PWM_FREQ * 10 / velocity / motorPolePairs;
+	openloopVelocity = velocity;
+}
+
+uint32_t BLDC_getTargetOpenloopVelocity()
+{
+	return openloopVelocity;
+}
+
+int32_t BLDC_getActualOpenloopVelocity()
+{
+	if (commutationMode != BLDC_OPENLOOP)
+		return 0;
+
+	if (targetPWM > 0)
+		return openloopVelocity;
+	else if (targetPWM < 0)
+		return -openloopVelocity;
+	else
+		return 0;
+}
+
+int32_t BLDC_getActualHallVelocity()
+{
+	return 0;
+}
+
+void BLDC_setHallOrder(uint8_t order)
+{
+	if (order < 3)
+	{
+		hallOrder = order;
+	}
+}
+
+uint8_t BLDC_getHallOrder()
+{
+	return hallOrder;
+}
+
+void BLDC_setHallInvert(uint8_t invert)
+{
+	hallInvert = (invert)? 1:0;
+}
+
+uint8_t BLDC_getHallInvert()
+{
+	return hallInvert;
+}
+
+void BLDC_setBBMTime(uint8_t time)
+{
+	bbmTime = MIN(127, time);
+}
+
+uint8_t BLDC_getBBMTime()
+{
+	return bbmTime;
+}
@@ -335,6 +335,9 @@ void BLDC_calibrateADCs()
 
 void ADC_IRQHandler()
 {
+	// VM supervision of the ADC HAL
+	ADCs_watchdogInterrupt();
+
 	if(adc_interrupt_flag_get(ADC1, ADC_INT_FLAG_EOC) == SET)
 	{
 		uint16_t tmp = adc_routine_data_read(ADC1);
@@ -390,7 +393,7 @@ void TIMER0_UP_TIMER9_IRQHandler(void)
 		static int32_t hallAngleDiffAccu = 0;
 
 		// Measure the hall sensor
-		HallStates actualHallState = inputToHallState(HAL.IOs->config->isHigh(Pins.HALL_U), HAL.IOs->config->isHigh(Pins.HALL_V), HAL.IOs->config->isHigh(Pins.HALL_W));
+		HallStates actualHallState = inputToHallState(io_isHigh(Pins.HALL_U), io_isHigh(Pins.HALL_V), io_isHigh(Pins.HALL_W));
 		hallAngle = hallStateToAngle(actualHallState);
 
 		// Calculate the hall angle difference
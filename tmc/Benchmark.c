@@ -0,0 +1,345 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+/*
+ * TMCL command latency and throughput benchmark.
+ *
+ * A script is a fixed list of datagrams that gets fed through the same
+ * parse/execute/reply path as datagrams received from an interface. Each
+ * datagram is timed with the cycle counter. Per opcode a logarithmic histogram
+ * is kept from which the latency percentiles get estimated. The bucket upper
+ * bound is reported, so percentiles are pessimistic by at most 25%.
+ *
+ * On target a run is started with TMCL opcode 174 (TMCL_Benchmark). The host
+ * simulation runs a script on startup if TMC_SIM_BENCHMARK is set.
+ */
+
+#include "Benchmark.h"
+#include "TMCL.h"
+#include "hal/SysTick.h"
+
+#if defined(LandungsbrueckeSim)
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+// Opcodes used by the scripts
+#define BENCHMARK_SAP         5
+#define BENCHMARK_GAP         6
+#define BENCHMARK_GETVERSION  136
+#define BENCHMARK_RAMDEBUG    142
+
+// Script datagram flags
+#define BENCHMARK_VALUE_FIXED     0
+#define BENCHMARK_VALUE_PREVIOUS  1  // Use the reply value of the previous datagram. Skipped if that one failed.
+#define BENCHMARK_VALUE_PASS      2  // Add the pass number to the value
+
+typedef struct
+{
+	uint8_t  opcode;
+	uint8_t  type;
+	uint8_t  motor;
+	uint8_t  valueMode;
+	int32_t  value;
+} BenchmarkDatagram;
+
+typedef struct
+{
+	const BenchmarkDatagram  *datagrams;
+	uint8_t                  length;
+} BenchmarkScriptTypeDef;
+
+static const BenchmarkDatagram gapStorm[] =
+{
+	{ BENCHMARK_GAP, 0, 0, BENCHMARK_VALUE_FIXED, 0 },  // Target position
+	{ BENCHMARK_GAP, 1, 0, BENCHMARK_VALUE_FIXED, 0 },  // Actual position
+	{ BENCHMARK_GAP, 2, 0, BENCHMARK_VALUE_FIXED, 0 },  // Target velocity
+	{ BENCHMARK_GAP, 3, 0, BENCHMARK_VALUE_FIXED, 0 },  // Actual velocity
+	{ BENCHMARK_GAP, 4, 0, BENCHMARK_VALUE_FIXED, 0 },  // Maximum velocity
+	{ BENCHMARK_GAP, 5, 0, BENCHMARK_VALUE_FIXED, 0 },  // Maximum acceleration
+};
+
+// The SAPs write back the values read right before, so running this does not change the board configuration
+static const BenchmarkDatagram mixed[] =
+{
+	{ BENCHMARK_GAP,        4, 0, BENCHMARK_VALUE_FIXED,     0 },
+	{ BENCHMARK_SAP,        4, 0, BENCHMARK_VALUE_PREVIOUS,  0 },
+	{ BENCHMARK_GAP,        5, 0, BENCHMARK_VALUE_FIXED,     0 },
+	{ BENCHMARK_SAP,        5, 0, BENCHMARK_VALUE_PREVIOUS,  0 },
+	{ BENCHMARK_GAP,        1, 0, BENCHMARK_VALUE_FIXED,     0 },
+	{ BENCHMARK_GETVERSION, 1, 0, BENCHMARK_VALUE_FIXED,     0 },  // Binary version
+};
+
+// Polls the capture state and reads one sample per pass, like the TMCL-IDE download does.
+// Run this after a capture completed - otherwise the sample reads fail and are counted as errors.
+static const BenchmarkDatagram ramDebug[] =
+{
+	{ BENCHMARK_RAMDEBUG, 8, 0, BENCHMARK_VALUE_FIXED, 0 },  // Get state
+	{ BENCHMARK_RAMDEBUG, 9, 0, BENCHMARK_VALUE_PASS,  0 },  // Get sample
+};
+
+static const BenchmarkScriptTypeDef scripts[BENCHMARK_SCRIPT_COUNT] =
+{
+	{ gapStorm, ARRAY_SIZE(gapStorm) },
+	{ mixed,    ARRAY_SIZE(mixed)    },
+	{ ramDebug, ARRAY_SIZE(ramDebug) },
+};
+
+BenchmarkTypeDef Benchmark;
+
+const char *benchmark_scriptNames[BENCHMARK_SCRIPT_COUNT] =
+{
+	"GAP storm",
+	"Mixed SAP/GAP",
+	"RAMDebug download"
+};
+
+static void reset(void);
+static BenchmarkSlotTypeDef *getSlot(uint8_t opcode);
+static void buildDatagram(uint8_t *datagram, const BenchmarkDatagram *entry, int32_t value);
+static uint8_t getBucket(uint32_t cycles);
+static uint32_t getBucketLimit(uint8_t bucket);
+static uint32_t cyclesToNanoseconds(uint64_t cycles);
+
+// Runs all datagrams of the script the given number of times. Returns the number of executed datagrams.
+uint32_t benchmark_run(BenchmarkScript script, uint32_t passes)
+{
+	uint8_t request[9];
+	uint8_t reply[9];
+
+	reset();
+
+	if(script >= BENCHMARK_SCRIPT_COUNT)
+		return 0;
+
+	const BenchmarkScriptTypeDef *s = &scripts[script];
+
+	for(uint32_t pass = 0; pass < passes; pass++)
+	{
+		// Summing up the passes keeps the run duration free of cycle counter overflows
+		uint32_t passStart = systick_getCycleCount();
+		bool previousOk = false;
+		int32_t previousValue = 0;
+
+		for(uint8_t i = 0; i < s->length; i++)
+		{
+			const BenchmarkDatagram *entry = &s->datagrams[i];
+			int32_t value = entry->value;
+
+			if(entry->valueMode == BENCHMARK_VALUE_PREVIOUS)
+			{
+				if(!previousOk)
+					continue;
+				value = previousValue;
+			}
+			else if(entry->valueMode == BENCHMARK_VALUE_PASS)
+			{
+				value += pass;
+			}
+
+			BenchmarkSlotTypeDef *slot = getSlot(entry->opcode);
+			buildDatagram(request, entry, value);
+
+			uint32_t start = systick_getCycleCount();
+			previousOk = tmcl_executeDatagram(request, reply);
+			uint32_t cycles = systick_getCycleCount() - start;
+
+			previousValue = (reply[4] << 24) | (reply[5] << 16) | (reply[6] << 8) | reply[7];
+
+			Benchmark.count++;
+
+			if(!slot)
+				continue;
+
+			slot->count++;
+			slot->totalCycles += cycles;
+			slot->histogram[getBucket(cycles)]++;
+
+			if(cycles > slot->maxCycles)
+				slot->maxCycles = cycles;
+
+			if(!previousOk)
+				slot->errors++;
+		}
+
+		Benchmark.runCycles += systick_getCycleCount() - passStart;
+	}
+
+	return Benchmark.count;
+}
+
+// Estimated latency in [ns] below which the given share [0.1%] of the datagrams completed
+uint32_t benchmark_getPercentile(uint8_t slot, uint32_t permille)
+{
+	if(slot >= Benchmark.slotCount)
+		return 0;
+
+	BenchmarkSlotTypeDef *s = &Benchmark.slots[slot];
+	uint32_t threshold = ((uint64_t) s->count * permille + 999) / 1000;
+	uint32_t sum = 0;
+
+	for(uint8_t i = 0; i < BENCHMARK_HISTOGRAM_BUCKETS; i++)
+	{
+		sum += s->histogram[i];
+		if(sum > 0 && sum >= threshold)
+			return cyclesToNanoseconds(MIN(getBucketLimit(i), s->maxCycles));
+	}
+
+	return cyclesToNanoseconds(s->maxCycles);
+}
+
+// Maximum latency in [ns]
+uint32_t benchmark_getMaxTime(uint8_t slot)
+{
+	if(slot >= Benchmark.slotCount)
+		return 0;
+
+	return cyclesToNanoseconds(Benchmark.slots[slot].maxCycles);
+}
+
+// Average latency in [ns]
+uint32_t benchmark_getAverageTime(uint8_t slot)
+{
+	if(slot >= Benchmark.slotCount || Benchmark.slots[slot].count == 0)
+		return 0;
+
+	return cyclesToNanoseconds(Benchmark.slots[slot].totalCycles / Benchmark.slots[slot].count);
+}
+
+// Executed datagrams per second during the last run
+uint32_t benchmark_getThroughput(void)
+{
+	if(Benchmark.runCycles == 0)
+		return 0;
+
+	return ((uint64_t) Benchmark.count * SYSTICK_CYCLES_PER_MICROSECOND * 1000000) / Benchmark.runCycles;
+}
+
+static void reset(void)
+{
+	Benchmark.slotCount  = 0;
+	Benchmark.count      = 0;
+	Benchmark.runCycles  = 0;
+
+	for(uint8_t i = 0; i < BENCHMARK_SLOTS; i++)
+	{
+		BenchmarkSlotTypeDef *s = &Benchmark.slots[i];
+
+		s->opcode       = 0;
+		s->count        = 0;
+		s->errors       = 0;
+		s->maxCycles    = 0;
+		s->totalCycles  = 0;
+
+		for(uint8_t j = 0; j < BENCHMARK_HISTOGRAM_BUCKETS; j++)
+			s->histogram[j] = 0;
+	}
+}
+
+// Returns the result slot of the opcode, allocating a new one on first use. NULL if all slots are in use.
+static BenchmarkSlotTypeDef *getSlot(uint8_t opcode)
+{
+	for(uint8_t i = 0; i < Benchmark.slotCount; i++)
+	{
+		if(Benchmark.slots[i].opcode == opcode)
+			return &Benchmark.slots[i];
+	}
+
+	if(Benchmark.slotCount >= BENCHMARK_SLOTS)
+		return NULL;
+
+	Benchmark.slots[Benchmark.slotCount].opcode = opcode;
+	return &Benchmark.slots[Benchmark.slotCount++];
+}
+
+static void buildDatagram(uint8_t *datagram, const BenchmarkDatagram *entry, int32_t value)
+{
+	uint8_t checkSum = 0;
+
+	datagram[0] = 1; // Module address
+	datagram[1] = entry->opcode;
+	datagram[2] = entry->type;
+	datagram[3] = entry->motor;
+	datagram[4] = (value >> 24) & 0xFF;
+	datagram[5] = (value >> 16) & 0xFF;
+	datagram[6] = (value >> 8) & 0xFF;
+	datagram[7] = value & 0xFF;
+
+	for(uint8_t i = 0; i < 8; i++)
+		checkSum += datagram[i];
+
+	datagram[8] = checkSum;
+}
+
+// Bucket 2n covers [2^n, 1.5 * 2^n), bucket 2n+1 covers [1.5 * 2^n, 2^(n+1)). Buckets 0 and 1 hold 0 and 1 cycles.
+static uint8_t getBucket(uint32_t cycles)
+{
+	if(cycles < 2)
+		return cycles;
+
+	uint8_t exponent = 31 - __builtin_clz(cycles);
+	return 2 * exponent + ((cycles >> (exponent - 1)) & 1);
+}
+
+// Highest cycle count falling into the bucket
+static uint32_t getBucketLimit(uint8_t bucket)
+{
+	if(bucket < 2)
+		return bucket;
+
+	uint8_t exponent = bucket / 2;
+	uint32_t lower = (1UL << exponent) | ((uint32_t) (bucket & 1) << (exponent - 1));
+
+	return lower + ((1UL << (exponent - 1)) - 1);
+}
+
+static uint32_t cyclesToNanoseconds(uint64_t cycles)
+{
+	return (cycles * 1000) / SYSTICK_CYCLES_PER_MICROSECOND;
+}
+
+#if defined(LandungsbrueckeSim)
+
+// TMC_SIM_BENCHMARK=<script>[,<passes>] runs a script after startup, prints the results and exits
+void benchmark_runFromEnvironment(void)
+{
+	const char *config = getenv("TMC_SIM_BENCHMARK");
+	if(!config)
+		return;
+
+	char *end;
+	uint32_t script = strtoul(config, &end, 0);
+	uint32_t passes = (*end == ',') ? strtoul(end + 1, NULL, 0) : 1000;
+
+	if(script >= BENCHMARK_SCRIPT_COUNT || passes == 0 || passes > BENCHMARK_MAX_PASSES)
+	{
+		printf("TMC_SIM_BENCHMARK: invalid script or pass count\n");
+		exit(1);
+	}
+
+	benchmark_run(script, passes);
+
+	printf("Benchmark \"%s\": %lu datagrams, %lu datagrams/s\n", benchmark_scriptNames[script],
+			(unsigned long) Benchmark.count, (unsigned long) benchmark_getThroughput());
+	printf("opcode    count   errors   p50[ns]   p90[ns]   p99[ns]   max[ns]   avg[ns]\n");
+
+	for(uint8_t i = 0; i < Benchmark.slotCount; i++)
+	{
+		printf("%6u %8lu %8lu %9lu %9lu %9lu %9lu %9lu\n",
+				Benchmark.slots[i].opcode,
+				(unsigned long) Benchmark.slots[i].count,
+				(unsigned long) Benchmark.slots[i].errors,
+				(unsigned long) benchmark_getPercentile(i, 500),
+				(unsigned long) benchmark_getPercentile(i, 900),
+				(unsigned long) benchmark_getPercentile(i, 990),
+				(unsigned long) benchmark_getMaxTime(i),
+				(unsigned long) benchmark_getAverageTime(i));
+	}
+
+	exit(0);
+}
+
+#endif
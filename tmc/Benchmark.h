@@ -0,0 +1,60 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "tmc/helpers/API_Header.h"
+
+// Number of distinct opcodes that get their own latency histogram
+#define BENCHMARK_SLOTS              6
+// Logarithmic latency histogram: two buckets per power of two of the cycle count
+#define BENCHMARK_HISTOGRAM_BUCKETS  64
+// Upper limit for the passes of a single run, keeps an on-target run in the range of seconds
+#define BENCHMARK_MAX_PASSES         10000
+
+typedef enum {
+	BENCHMARK_SCRIPT_GAP_STORM,  // GAP of the common axis parameters
+	BENCHMARK_SCRIPT_MIXED,      // GAP/SAP pairs writing back the read values, GetVersion
+	BENCHMARK_SCRIPT_RAMDEBUG,   // RAMDebug download: state polling and sample readout
+
+	BENCHMARK_SCRIPT_COUNT
+} BenchmarkScript;
+
+typedef struct
+{
+	uint8_t   opcode;
+	uint32_t  count;
+	uint32_t  errors;       // datagrams not answered with REPLY_OK
+	uint32_t  maxCycles;
+	uint64_t  totalCycles;
+	uint32_t  histogram[BENCHMARK_HISTOGRAM_BUCKETS];
+} BenchmarkSlotTypeDef;
+
+typedef struct
+{
+	BenchmarkSlotTypeDef  slots[BENCHMARK_SLOTS];
+	uint8_t               slotCount;
+	uint32_t              count;        // datagrams executed during the last run
+	uint64_t              runCycles;    // duration of the last run including the script handling
+} BenchmarkTypeDef;
+
+extern BenchmarkTypeDef Benchmark;
+
+extern const char *benchmark_scriptNames[BENCHMARK_SCRIPT_COUNT];
+
+uint32_t benchmark_run(BenchmarkScript script, uint32_t passes);
+
+uint32_t benchmark_getPercentile(uint8_t slot, uint32_t permille);
+uint32_t benchmark_getMaxTime(uint8_t slot);
+uint32_t benchmark_getAverageTime(uint8_t slot);
+uint32_t benchmark_getThroughput(void);
+
+#if defined(LandungsbrueckeSim)
+void benchmark_runFromEnvironment(void);
+#endif
+
+#endif /* BENCHMARK_H */
@@ -13,16 +13,33 @@
 #include "TMCL.h"
 #include "IdDetection.h"
 #include "EEPROM.h"
+#include "ParameterStore.h"
+#include "EventLog.h"
 #include "BoardAssignment.h"
 
+// Maximum time for the boards to write their register defaults before stored parameters get restored [ms]
+#define RESTORE_TIMEOUT  100
+
 static uint8_t assignCh1(uint8_t id, uint8_t justCheck);
 static uint8_t assignCh2(uint8_t id, uint8_t justCheck);
 static void hookDriverSPI(IdAssignmentTypeDef *ids);
 static void unassign(IdAssignmentTypeDef *ids);
+static void scheduleRestore(uint8_t idCh1, uint8_t idCh2);
+static void applySPIProfiles(IdAssignmentTypeDef *ids, uint8_t ch1, uint8_t ch2);
+
+// Boards waiting for their stored axis parameters, see Board_restoreParameters()
+static struct
+{
+	uint8_t ch1;     // board id, 0: nothing to restore
+	uint8_t ch2;
+	uint32_t start;  // systick of the assignment
+} PendingRestore = { 0 };
 
 int32_t Board_assign(IdAssignmentTypeDef *ids)
 {
 	int32_t out = 0;
+	uint8_t restoreCh1 = 0;
+	uint8_t restoreCh2 = 0;
 
 	// Test mode // todo REM 2: still needed? (LH)
 	if((ids->ch1.id == 0xFF) || (ids->ch2.id == 0xFF))
@@ -49,9 +66,12 @@ int32_t Board_assign(IdAssignmentTypeDef *ids)
 	else
 	{
 		Evalboards.ch1.deInit(); // todo REM 2: Hot-Unplugging is not maintained currently, should probably be removed (LH) #1
+		board_releaseSPIProfile(&Evalboards.ch1);
 		if(ids->ch1.state == ID_STATE_DONE)
 			ids->ch1.state = assignCh1(ids->ch1.id, false);
 		Evalboards.ch1.config->reset();
+		if(ids->ch1.state == ID_STATE_DONE)
+			restoreCh1 = ids->ch1.id;
 	}
 
 	// Assign driver
@@ -62,11 +82,17 @@ int32_t Board_assign(IdAssignmentTypeDef *ids)
 	else
 	{
 		Evalboards.ch2.deInit(); // todo REM 2: Hot-Unplugging is not maintained currently, should probably be removed (LH) #2
+		board_releaseSPIProfile(&Evalboards.ch2);
 		if(ids->ch2.state == ID_STATE_DONE)
 			ids->ch2.state = assignCh2(ids->ch2.id, false);
 		Evalboards.ch2.config->reset();
+		if(ids->ch2.state == ID_STATE_DONE)
+			restoreCh2 = ids->ch2.id;
 	}
 
+	// Switch the freshly initialised boards to their SPI clock before they write their registers
+	applySPIProfiles(ids, restoreCh1 != 0, restoreCh2 != 0);
+
 	// Reroute SPI 2 (that the driver uses) to run through the motion controller if required
 	// This allows the chaining of a motion controller and a driver.
 	// Note that the motion controller has to invoke reset() or restore() of the driver
@@ -74,6 +100,14 @@ int32_t Board_assign(IdAssignmentTypeDef *ids)
 	// This is currently done on completed motion controller reset/restore
 	hookDriverSPI(ids);
 
+	// Apply the parameters stored with STAP to freshly initialised boards once they finished their reset
+	scheduleRestore(restoreCh1, restoreCh2);
+
+	if(Evalboards.ch1.id != ids->ch1.id)
+		eventlog_write(EVENTLOG_SOURCE_CH1, EVENTLOG_CODE_BOARD, (ids->ch1.state << 8) | ids->ch1.id);
+	if(Evalboards.ch2.id != ids->ch2.id)
+		eventlog_write(EVENTLOG_SOURCE_CH2, EVENTLOG_CODE_BOARD, (ids->ch2.state << 8) | ids->ch2.id);
+
 	Evalboards.ch1.id = ids->ch1.id;
 	Evalboards.ch2.id = ids->ch2.id;
 
@@ -168,6 +202,57 @@ static void hookDriverSPI(IdAssignmentTypeDef *ids)
 	}
 }
 
+// A driver chained behind the TMC4361A is accessed through the motion controller,
+// its own bus is not used and keeps its clock.
+static void applySPIProfiles(IdAssignmentTypeDef *ids, uint8_t ch1, uint8_t ch2)
+{
+	if(ch1)
+		board_applySPIProfile(&Evalboards.ch1, Evalboards.spiProbe);
+
+	if(ch2 && (ids->ch1.id != ID_TMC4361A))
+		board_applySPIProfile(&Evalboards.ch2, Evalboards.spiProbe);
+}
+
+// Apply the SPI profiles of the assigned boards again, e.g. after enabling the probing
+void Board_applySPIProfiles(void)
+{
+	IdAssignmentTypeDef ids;
+
+	ids.ch1.id = Evalboards.ch1.id;
+	ids.ch2.id = Evalboards.ch2.id;
+
+	applySPIProfiles(&ids, ids.ch1.id != 0, ids.ch2.id != 0);
+}
+
+static void scheduleRestore(uint8_t idCh1, uint8_t idCh2)
+{
+	PendingRestore.ch1    = (idCh1 && paramstore_hasRecords(PARAMSTORE_SCOPE_CH1, idCh1)) ? idCh1 : 0;
+	PendingRestore.ch2    = (idCh2 && paramstore_hasRecords(PARAMSTORE_SCOPE_CH2, idCh2)) ? idCh2 : 0;
+	PendingRestore.start  = systick_getTick();
+}
+
+// Main loop task after the periodic jobs. The boards write their register defaults from the
+// periodic job, so the stored values get applied once the reset is done - otherwise the defaults
+// would overwrite them. The driver goes last, it might be accessed through the motion controller.
+void Board_restoreParameters(uint32_t tick)
+{
+	if(!PendingRestore.ch1 && !PendingRestore.ch2)
+		return;
+
+	if((Evalboards.ch1.config->state != CONFIG_READY || Evalboards.ch2.config->state != CONFIG_READY)
+			&& ((tick - PendingRestore.start) < RESTORE_TIMEOUT))
+		return;
+
+	if(PendingRestore.ch1 && (Evalboards.ch1.id == PendingRestore.ch1))
+		paramstore_restore(PARAMSTORE_SCOPE_CH1, PendingRestore.ch1, Evalboards.ch1.SAP);
+
+	if(PendingRestore.ch2 && (Evalboards.ch2.id == PendingRestore.ch2))
+		paramstore_restore(PARAMSTORE_SCOPE_CH2, PendingRestore.ch2, Evalboards.ch2.SAP);
+
+	PendingRestore.ch1 = 0;
+	PendingRestore.ch2 = 0;
+}
+
 static void unassign(IdAssignmentTypeDef *ids)
 {
 	UNUSED(ids);
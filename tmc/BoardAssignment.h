@@ -39,6 +39,8 @@ extern IdAssignmentTypeDef IdState;
 
 int32_t Board_assign(IdAssignmentTypeDef *ids);     // ids and states of assigned driver and motion controller board
 int32_t Board_supported(IdAssignmentTypeDef *ids);  // ids and states of supported driver and motion controller board
+void Board_applySPIProfiles(void);                  // set the SPI clock of the assigned boards from their profiles
+void Board_restoreParameters(uint32_t tick);        // main loop task, applies stored axis parameters after an assignment
 
 #include "boards/SelfTest.h"
 
@@ -138,50 +140,125 @@ typedef struct {
 	void (*init)(void);
 } init_assignment;
 
+// Boards left out by the BOARDS build option are excluded, see BOARD_ENABLED() in Board.h
 static const init_assignment init_ch1[] =
 {
+#if BOARD_ENABLED(BOARD_TMC5031)
 	{ .id = ID_TMC5031,     .init = TMC5031_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC5130)
 	{ .id = ID_TMC5130,     .init = TMC5130_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC5041)
 	{ .id = ID_TMC5041,     .init = TMC5041_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC5072)
 	{ .id = ID_TMC5072,     .init = TMC5072_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC4361A)
 	{ .id = ID_TMC4361A,    .init = TMC4361A_init    },
+#endif
+#if BOARD_ENABLED(BOARD_TMC4671)
 	{ .id = ID_TMC4671,     .init = TMC4671_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC5160)
 	{ .id = ID_TMC5160,     .init = TMC5160_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC5240)
 	{ .id = ID_TMC5240,     .init = TMC5240_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC5271)
 	{ .id = ID_TMC5271,     .init = TMC5271_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC5272)
 	{ .id = ID_TMC5272,     .init = TMC5272_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC5062)
 	{ .id = ID_TMC5062,     .init = TMC5062_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC8461)
 	{ .id = ID_TMC8461,     .init = TMC8461_init_ch1 },
+#endif
+#if BOARD_ENABLED(BOARD_TMC8462)
 	{ .id = ID_TMC8462,     .init = TMC8462_init_ch1 },
+#endif
 	{ .id = ID_SELFTEST,    .init = SelfTest_init    }
 };
 
 static const init_assignment init_ch2[] =
 {
+#if BOARD_ENABLED(BOARD_TMC2660)
 	{ .id = ID_TMC2660,       .init = TMC2660_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC2130)
 	{ .id = ID_TMC2130,       .init = TMC2130_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC2100)
 	{ .id = ID_TMC2100,       .init = TMC2100_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC2208)
 	{ .id = ID_TMC2208,       .init = TMC2208_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC2224)
 	{ .id = ID_TMC2224,       .init = TMC2224_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC2240)
 	{ .id = ID_TMC2240,       .init = TMC2240_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC2590)
 	{ .id = ID_TMC2590,       .init = TMC2590_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC6100)
 	{ .id = ID_TMC6100,       .init = TMC6100_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC6100)
 	{ .id = ID_TMC6100_BOB,   .init = TMC6100_BOB_init },
+#endif
+#if BOARD_ENABLED(BOARD_TMC6200)
 	{ .id = ID_TMC6200,       .init = TMC6200_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC7300)
 	{ .id = ID_TMC7300,       .init = TMC7300_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC2160)
 	{ .id = ID_TMC2160,       .init = TMC2160_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC2210)
 	{ .id = ID_TMC2210,       .init = TMC2210_init     },
+#endif
+#if BOARD_ENABLED(BOARD_MAX22216)
 	{ .id = ID_MAX22216_EVAL, .init = MAX22216_init    },
+#endif
+#if BOARD_ENABLED(BOARD_MAX22216)
 	{ .id = ID_MAX22216_BOB,  .init = MAX22216_init    },
+#endif
+#if BOARD_ENABLED(BOARD_MAX22204)
 	{ .id = ID_MAX22204_EVAL, .init = MAX22204_init    },
+#endif
+#if BOARD_ENABLED(BOARD_MAX22210)
 	{ .id = ID_MAX22210_EVAL, .init = MAX22210_init    },
+#endif
+#if BOARD_ENABLED(BOARD_TMC2209)
 	{ .id = ID_TMC2209,     .init = TMC2209_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC2225)
 	{ .id = ID_TMC2225,     .init = TMC2225_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC2226)
 	{ .id = ID_TMC2226,     .init = TMC2226_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC2300)
 	{ .id = ID_TMC2300,     .init = TMC2300_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC6300)
 	{ .id = ID_TMC6300,     .init = TMC6300_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC6140)
 	{ .id = ID_TMC6140,     .init = TMC6140_init     },
+#endif
+#if BOARD_ENABLED(BOARD_TMC8100)
 	{ .id = ID_TMC8100,     .init = TMC8100_init     },
+#endif
 };
 
 #endif /* BOARD_ASSIGNMENT_H */
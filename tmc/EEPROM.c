@@ -10,6 +10,59 @@
 #include "EEPROM.h"
 #include <string.h>
 
+/*
+ * Write buffering:
+ * Writes are collected in page sized buffers, so consecutive writes into one
+ * EEPROM page need a single write cycle. eeprom_process() writes one buffered
+ * page per call and polls for the end of the write cycle in the following
+ * calls instead of busy waiting. Reads wait for a running write cycle of their
+ * channel and return buffered, not yet written data.
+ *
+ * The metadata (name, id, hw, magic) of both EEPROMs is mirrored in RAM. The
+ * mirror gets refreshed by eeprom_check() and updated by writes, reads of the
+ * metadata area are served from it.
+ *
+ * A removed board reads 0xFF, which looks like a write cycle that never ends.
+ * When a write cycle exceeds EEPROM_WRITE_TIMEOUT, all buffered pages of that
+ * channel get dropped together with its metadata mirror.
+ */
+
+#define CMD_WRITE_ENABLE   0x06
+#define CMD_WRITE_DISABLE  0x04
+#define CMD_READ_STATUS    0x05
+#define CMD_WRITE          0x02
+#define CMD_READ           0x03
+
+#define STATUS_WIP  0x01  // write in progress
+#define STATUS_WEL  0x02  // write enable latch
+
+#define EEPROM_WRITE_TIMEOUT  20  // [ms], the 25128 write cycle takes up to 5ms
+
+typedef struct
+{
+	SPIChannelTypeDef *SPIChannel;  // NULL: buffer is free
+	uint16_t address;               // start address of the page
+	uint64_t dirty;                 // one bit per byte to be written
+	uint8_t data[EEPROM_PAGE_SIZE];
+} EEPROM_PageBuffer;
+
+static IOPinTypeDef *selectEEPROM(SPIChannelTypeDef *SPIChannel);
+static void deselectEEPROM(SPIChannelTypeDef *SPIChannel, IOPinTypeDef *io);
+static uint8_t readStatus(SPIChannelTypeDef *SPIChannel);
+static void readChip(SPIChannelTypeDef *SPIChannel, uint16_t address, uint8_t *data, uint16_t size);
+static void waitForWrite(SPIChannelTypeDef *SPIChannel);
+static bool hasPendingWrites(SPIChannelTypeDef *SPIChannel);
+static void dropPendingWrites(SPIChannelTypeDef *SPIChannel);
+static void startPageWrite(EEPROM_PageBuffer *page);
+static void updateMirror(SPIChannelTypeDef *SPIChannel, uint16_t address, uint8_t *data, uint16_t size);
+static void decodeMirror(SPIChannelTypeDef *SPIChannel);
+
+static EEPROM_PageBuffer pageBuffers[EEPROM_WRITE_BUFFERS];
+static EEPROM_PageBuffer *writingPage = NULL;  // page whose write cycle is running
+static uint32_t writeStartTick = 0;             // systick of the start of the running write cycle
+static uint8_t metaMirror[2][EEPROM_SIZE_META];
+
+
 EEPROM_Channels EEPROM =
 {
 	.ch1 =
@@ -30,23 +83,34 @@ EEPROM_Channels EEPROM =
 	}
 };
 
+#define MIRROR_INDEX(SPIChannel)  (((SPIChannel) == &SPI.ch1) ? 0 : 1)
+#define MIRROR_DATA(SPIChannel)   (((SPIChannel) == &SPI.ch1) ? &EEPROM.ch1 : &EEPROM.ch2)
+
 // Perform initial scan and store to struct
 void eeprom_init(SPIChannelTypeDef *SPIChannel)
 {
-	uint8_t buffer[EEPROM_SIZE_META] = { 0 };
-	EEPROM_Data *eep = (SPIChannel == &SPI.ch1) ? &EEPROM.ch1 : &EEPROM.ch2;
-	eeprom_read_array(SPIChannel, EEPROM_ADDR_META, buffer, EEPROM_SIZE_META);
-	memcpy(eep->name, &buffer[EEPROM_ADDR_NAME - EEPROM_ADDR_META], EEPROM_SIZE_NAME);
-	eep->id = _8_16(buffer[EEPROM_ADDR_ID - EEPROM_ADDR_META], buffer[(EEPROM_ADDR_ID + 1) - EEPROM_ADDR_META]);
-	eep->hw = _8_16(buffer[EEPROM_ADDR_HW - EEPROM_ADDR_META], buffer[(EEPROM_ADDR_HW + 1) - EEPROM_ADDR_META]);
-	eep->magic = _8_16(buffer[EEPROM_ADDR_MAGIC - EEPROM_ADDR_META], buffer[(EEPROM_ADDR_MAGIC + 1) - EEPROM_ADDR_META]);
-	eep->init = true;
-//	eeprom_read_array(&SPI.ch2, EEPROM_ADDR_META, buffer, EEPROM_SIZE_META);
-//	memcpy(EEPROM.ch2.name, &buffer[EEPROM_ADDR_NAME - EEPROM_ADDR_META], EEPROM_SIZE_NAME);
-//	EEPROM.ch2.id = _8_16(buffer[EEPROM_ADDR_ID - EEPROM_ADDR_META], buffer[(EEPROM_ADDR_ID + 1) - EEPROM_ADDR_META]);
-//	EEPROM.ch2.hw = _8_16(buffer[EEPROM_ADDR_HW - EEPROM_ADDR_META], buffer[(EEPROM_ADDR_HW + 1) - EEPROM_ADDR_META]);
-//	EEPROM.ch2.magic = _8_16(buffer[EEPROM_ADDR_MAGIC - EEPROM_ADDR_META], buffer[(EEPROM_ADDR_MAGIC + 1) - EEPROM_ADDR_META]);
-//	EEPROM.ch2.init = true;
+	uint8_t *buffer = metaMirror[MIRROR_INDEX(SPIChannel)];
+
+	readChip(SPIChannel, EEPROM_ADDR_META, buffer, EEPROM_SIZE_META);
+
+	// Apply buffered writes that did not reach the EEPROM yet
+	MIRROR_DATA(SPIChannel)->init = false;
+	for(uint8_t i = 0; i < EEPROM_WRITE_BUFFERS; i++)
+	{
+		EEPROM_PageBuffer *page = &pageBuffers[i];
+		if(page->SPIChannel != SPIChannel || page == writingPage)
+			continue;
+
+		for(uint8_t j = 0; j < EEPROM_PAGE_SIZE; j++)
+		{
+			// Addresses below the metadata wrap around to large offsets
+			uint16_t offset = page->address + j - EEPROM_ADDR_META;
+			if((page->dirty & ((uint64_t) 1 << j)) && offset < EEPROM_SIZE_META)
+				buffer[offset] = page->data[j];
+		}
+	}
+
+	decodeMirror(SPIChannel);
 }
 
 /*******************************************************************
@@ -56,51 +120,36 @@ void eeprom_init(SPIChannelTypeDef *SPIChannel)
 	Returns: false when an Eeprom has been successfully detected and is in ready status
 			The status of the eeprom otherwise
 
-	Purpose: checking whether Eeprom is connected and ready
+	Purpose: checking whether Eeprom is connected and ready.
+	The metadata mirror gets refreshed when an Eeprom is found.
 ********************************************************************/
 uint8_t eeprom_check(SPIChannelTypeDef *SPIChannel)
 {
+	// Buffered writes must not make a removed board look present: finish them first,
+	// the write timeout drops them if the Eeprom does not answer anymore
+	if(hasPendingWrites(SPIChannel))
+		eeprom_flush();
+
 	// Prüfen, ob der SPI-Bus schon funktioniert: Im Status-Register des EEPROMs
 	// müssen Bit 6, 5, 4 und 0 auf jedem Fall 0 sein und nicht 1.
 	// Watchdog darf an dieser Stelle ruhig zuschlagen.
-
-	// select CSN of eeprom
-	IOPinTypeDef* io = SPIChannel->CSN;
-	if(SPIChannel == &SPI.ch1)
-		SPIChannel->CSN = &HAL.IOs->pins->ID_CH0;
-	else
-		SPIChannel->CSN = &HAL.IOs->pins->ID_CH1;
-
-	IOs.toOutput(SPIChannel->CSN);
-
-	SPIChannel->readWrite(0x05, false);  // Befehl "Get Status"
-	uint8_t out = SPIChannel->readWrite(0x00, true);
+	uint8_t out = readStatus(SPIChannel);
 	// check whether bits 6, 5, 4 and 0 are cleared
 	if((out & 0x71) != 0)
-		goto end;
-
-	out = 0;
-
-	//check for magic number in eeprom
-	uint8_t number[2];
-
-	eeprom_read_array(SPIChannel, EEPROM_ADDR_MAGIC, number, 2);
-
-	if(number[0] != MAGICNUMBER_LOW || number[1] != MAGICNUMBER_HIGH)
 	{
-		out = ID_CHECKERROR_MAGICNUMBER;
+		MIRROR_DATA(SPIChannel)->init = false;
+		return out;
 	}
 
-	end:
-	HAL.IOs->config->toInput(SPIChannel->CSN);
-	SPIChannel->CSN = io;
+	// Reload the metadata, the board might have been swapped
+	eeprom_init(SPIChannel);
 
-	if(out && ((SPIChannel == &SPI.ch1 && !EEPROM.ch1.init)
-			|| (SPIChannel == &SPI.ch2 && !EEPROM.ch2.init))) {
-		eeprom_init(SPIChannel);
-	}
+	//check for magic number in eeprom
+	uint8_t *number = &metaMirror[MIRROR_INDEX(SPIChannel)][EEPROM_ADDR_MAGIC - EEPROM_ADDR_META];
+	if(number[0] != MAGICNUMBER_LOW || number[1] != MAGICNUMBER_HIGH)
+		return ID_CHECKERROR_MAGICNUMBER;
 
-	return out;
+	return 0;
 }
 
 
@@ -113,49 +162,11 @@ uint8_t eeprom_check(SPIChannelTypeDef *SPIChannel)
 	Rückgabewert: ---
 
 	Zweck: Schreiben eines Bytes in das EEPROM auf dem Evalboard.
+	Kehrt erst zurück, wenn alle gepufferten Schreibvorgänge beendet sind.
 ********************************************************************/
 void eeprom_write_byte(SPIChannelTypeDef *SPIChannel, uint16_t address, uint8_t value)
 {
-	// select CSN of eeprom
-	IOPinTypeDef* io = SPIChannel->CSN;
-	if(SPIChannel == &SPI.ch1) {
-		SPIChannel->CSN = &HAL.IOs->pins->ID_CH0;
-		EEPROM.ch1.init = false;
-	} else {
-		SPIChannel->CSN = &HAL.IOs->pins->ID_CH1;
-		EEPROM.ch2.init = false;
-	}
-
-	IOs.toOutput(SPIChannel->CSN);
-
-	// Schreiben erlauben
-	SPIChannel->readWrite(0x06, true); // Befehl "Write Enable"
-	do
-	{
-		SPIChannel->readWrite(0x05, false); // Befehl "Get Status"
-	} while((SPIChannel->readWrite(0x00, true) & 0x02) == 0x00);  // Warte bis "Write Enable"-Bit gesetzt ist
-
-	// Eigentliches Schreiben
-	SPIChannel->readWrite(0x02, false); // Befehl "Write"
-	SPIChannel->readWrite(address >> 8, false);
-	SPIChannel->readWrite(address & 0xFF, false);
-	SPIChannel->readWrite(value, true);
-
-	// Warten bis Schreibvorgang beendet ist
-	do
-	{
-		SPIChannel->readWrite(0x05, false); //Befehl "Get Status"
-	} while(SPIChannel->readWrite(0x00, true) & 0x01);
-
-	//block writing
-	SPIChannel->readWrite(0x04, true); //Befehl "Write Disable"
-	do
-	{
-		SPIChannel->readWrite(0x05, false); //Befehl "Get Status"
-	} while((SPIChannel->readWrite(0x00, true) & 0x02) != 0x00); //Warte bis "Write Enable"-Bit zurückgesetzt wird
-
-	HAL.IOs->config->toInput(SPIChannel->CSN);
-	SPIChannel->CSN = io;
+	eeprom_write_array(SPIChannel, address, &value, 1);
 }
 
 
@@ -172,82 +183,142 @@ void eeprom_write_byte(SPIChannelTypeDef *SPIChannel, uint16_t address, uint8_t
 	Dabei können beliebig viele Bytes (also auch das gesamte EEPROM
 	beschrieben werden (die speziellen Eigenschaften des 25128 werden
 	dabei beachtet).
+	Kehrt erst zurück, wenn alle gepufferten Schreibvorgänge beendet sind.
 ********************************************************************/
 void eeprom_write_array(SPIChannelTypeDef *SPIChannel, uint16_t address, uint8_t *data, uint16_t size)
 {
-	uint16_t i;
+	eeprom_write_async(SPIChannel, address, data, size);
+	eeprom_flush();
+}
 
-	//select CSN of eeprom
-	IOPinTypeDef* io = SPIChannel->CSN;
-	if(SPIChannel == &SPI.ch1) {
-		SPIChannel->CSN = &HAL.IOs->pins->ID_CH0;
-		EEPROM.ch1.init = false;
-	} else {
-		SPIChannel->CSN = &HAL.IOs->pins->ID_CH1;
-		EEPROM.ch2.init = false;
-	}
 
-	IOs.toOutput(SPIChannel->CSN);
+/*******************************************************************
+	Function: eeprom_write_async
+	Parameters:	SPI channel of the Eeprom
+				address: address in the Eeprom (0..16383)
+				data: data to be written
+				size: number of bytes
 
-	// Schreiben erlauben
-	SPIChannel->readWrite(0x06, true); // Befehl "Write Enable"
-	do
-	{
-		SPIChannel->readWrite( 0x05, false); //Befehl "Get Status"
-	} while((SPIChannel->readWrite(0x00, true) & 0x02)==0x00); //Warte bis "Write Enable"-Bit gesetzt
+	Returns: ---
 
-	// Schreibvorgang (Startadresse)
-	SPIChannel->readWrite(0x02, false); // Befehl "Write"
-	SPIChannel->readWrite(address >> 8, false);
-	SPIChannel->readWrite(address & 0xFF, false);
+	Purpose: Buffers the data for eeprom_process(). Only blocks if more
+	pages are written than there are write buffers.
+********************************************************************/
+void eeprom_write_async(SPIChannelTypeDef *SPIChannel, uint16_t address, uint8_t *data, uint16_t size)
+{
+	updateMirror(SPIChannel, address, data, size);
 
-	// Eigentliches Schreiben der Daten
-	for(i = 0; i < size; i++)
+	for(uint16_t i = 0; i < size; i++, address++)
 	{
-		// Adresse mitzählen und bei Überlauf der untersten sechs Bits das EEPROM deselektieren
-		// und neuen Write-Befehl senden (bzw. beim letzten Datenbyte einfach nur EEPROM
-		// deselektieren).
-		// Dies ist erforderlich, da beim Beschreiben im 25128 nur die untersten sechs Bits der
-		// Adresse hochgezählt werden (anders als beim Lesen).
-		address++;
-		SPIChannel->readWrite(*(data+i), (address & 0x0000003F)==0 || i==size-1);
-		if((address & 0x0000003F)==0 && i<size-1)  // Adressbits übergelaufen, aber noch Bytes zu schreiben?
+		uint16_t pageAddress = address & ~(EEPROM_PAGE_SIZE - 1);
+		EEPROM_PageBuffer *page = NULL;
+
+		while(page == NULL)
 		{
-			// Warte bis Schreibvorgang beendet
-			do
-			{
-				SPIChannel->readWrite(0x05, false);  // Befehl "Get Status"
-			} while(SPIChannel->readWrite(0x00, true) & 0x01);
+			EEPROM_PageBuffer *freePage = NULL;
 
-			// Neuer "Write Enable"-Befehl
-			SPIChannel->readWrite(0x06, true);  // Befehl "Write Enable"
-			do
+			// A page in its write cycle can not take new data
+			for(uint8_t j = 0; j < EEPROM_WRITE_BUFFERS; j++)
 			{
-				SPIChannel->readWrite(0x05, false);  // Befehl "Get Status"
-			} while((SPIChannel->readWrite(0x00, true) & 0x02)==0x00); //Warte bis "Write Enable"-Bit gesetzt
+				if(&pageBuffers[j] == writingPage)
+					continue;
+
+				if(pageBuffers[j].SPIChannel == SPIChannel && pageBuffers[j].address == pageAddress)
+				{
+					page = &pageBuffers[j];
+					break;
+				}
 
-			// Neuer "Write"-Befehl (mit der nächsten Adresse)
-			SPIChannel->readWrite(0x02, false); // Befehl "Write"
-			SPIChannel->readWrite(address >> 8, false);
-			SPIChannel->readWrite(address & 0xFF, false);
+				if(pageBuffers[j].SPIChannel == NULL && freePage == NULL)
+					freePage = &pageBuffers[j];
+			}
+
+			if(page == NULL && freePage != NULL)
+			{
+				page              = freePage;
+				page->SPIChannel  = SPIChannel;
+				page->address     = pageAddress;
+				page->dirty       = 0;
+			}
+
+			// All buffers in use -> write one out
+			if(page == NULL)
+				eeprom_process();
 		}
+
+		uint8_t offset = address - pageAddress;
+		page->data[offset]  = data[i];
+		page->dirty        |= (uint64_t) 1 << offset;
 	}
+}
 
-	// Warte bis Schreibvorgang beendet
-	do
+
+/*******************************************************************
+	Function: eeprom_process
+	Parameters: ---
+
+	Returns: ---
+
+	Purpose: Background state machine of the buffered writes. Checks
+	whether a running write cycle has finished, otherwise starts writing
+	the next buffered page. Does not block.
+********************************************************************/
+void eeprom_process(void)
+{
+	if(writingPage)
 	{
-		SPIChannel->readWrite(0x05, false); // Befehl "Get Status"
-	} while(SPIChannel->readWrite(0x00, true) & 0x01);
+		if(readStatus(writingPage->SPIChannel) & STATUS_WIP)
+		{
+			if((systick_getTick() - writeStartTick) > EEPROM_WRITE_TIMEOUT)
+				dropPendingWrites(writingPage->SPIChannel);
 
-	// block writing
-	SPIChannel->readWrite(0x04, true); // Befehl "Write Disable"
-	do
+			return;
+		}
+
+		writingPage->SPIChannel  = NULL;
+		writingPage              = NULL;
+	}
+
+	for(uint8_t i = 0; i < EEPROM_WRITE_BUFFERS; i++)
 	{
-		SPIChannel->readWrite(0x05, false); // Befehl "Get Status"
-	} while((SPIChannel->readWrite(0x00, true) & 0x02) != 0x00);  // Warte bis "Write Enable"-Bit zurückgesetzt wird
+		if(pageBuffers[i].SPIChannel != NULL)
+		{
+			startPageWrite(&pageBuffers[i]);
+			return;
+		}
+	}
+}
 
-	HAL.IOs->config->toInput(SPIChannel->CSN);
-	SPIChannel->CSN = io;
+
+/*******************************************************************
+	Function: eeprom_flush
+	Parameters: ---
+
+	Returns: ---
+
+	Purpose: Writes all buffered data and waits for the end of the
+	write cycles.
+********************************************************************/
+void eeprom_flush(void)
+{
+	while(eeprom_busy())
+		eeprom_process();
+}
+
+
+/*******************************************************************
+	Function: eeprom_busy
+	Parameters: ---
+
+	Returns: true while buffered data has not been written completely
+********************************************************************/
+bool eeprom_busy(void)
+{
+	for(uint8_t i = 0; i < EEPROM_WRITE_BUFFERS; i++)
+		if(pageBuffers[i].SPIChannel != NULL)
+			return true;
+
+	return false;
 }
 
 
@@ -262,23 +333,9 @@ void eeprom_write_array(SPIChannelTypeDef *SPIChannel, uint16_t address, uint8_t
 ********************************************************************/
 uint8_t eeprom_read_byte(SPIChannelTypeDef *SPIChannel, uint16_t address)
 {
-	//select CSN of eeprom
-	IOPinTypeDef* io = SPIChannel->CSN;
-	if(SPIChannel == &SPI.ch1)
-		SPIChannel->CSN = &HAL.IOs->pins->ID_CH0;
-	else
-		SPIChannel->CSN = &HAL.IOs->pins->ID_CH1;
-
-	IOs.toOutput(SPIChannel->CSN);
-
-	SPIChannel->readWrite(0x03, false); //Befehl "Read"
-	SPIChannel->readWrite(address >> 8, false);
-	SPIChannel->readWrite(address & 0xFF, false);
+	uint8_t out;
 
-	uint8_t out = SPIChannel->readWrite(0, true);
-
-	HAL.IOs->config->toInput(SPIChannel->CSN);
-	SPIChannel->CSN = io;
+	eeprom_read_array(SPIChannel, address, &out, 1);
 
 	return out;
 }
@@ -295,12 +352,38 @@ uint8_t eeprom_read_byte(SPIChannelTypeDef *SPIChannel, uint16_t address)
 
 	Zweck: Lesen mehrerer Bytes aus dem Konfigurations-EEPROM.
 	Dabei dürfen ab beliebiger Adresse beliebig viele Bytes gelesen
-	werden.
+	werden. Gepufferte, noch nicht geschriebene Daten werden
+	berücksichtigt, Metadaten kommen aus dem RAM-Abbild.
 ********************************************************************/
 void eeprom_read_array(SPIChannelTypeDef *SPIChannel, uint16_t address, uint8_t *data, uint16_t size)
 {
-	uint16_t i;
+	// The mirror already contains the buffered writes
+	if(MIRROR_DATA(SPIChannel)->init && (address + size) <= (EEPROM_ADDR_META + EEPROM_SIZE_META))
+	{
+		memcpy(data, &metaMirror[MIRROR_INDEX(SPIChannel)][address - EEPROM_ADDR_META], size);
+		return;
+	}
+
+	readChip(SPIChannel, address, data, size);
 
+	// Apply buffered writes that did not reach the EEPROM yet
+	for(uint8_t i = 0; i < EEPROM_WRITE_BUFFERS; i++)
+	{
+		EEPROM_PageBuffer *page = &pageBuffers[i];
+		if(page->SPIChannel != SPIChannel || page == writingPage)
+			continue;
+
+		for(uint8_t j = 0; j < EEPROM_PAGE_SIZE; j++)
+		{
+			uint16_t byteAddress = page->address + j;
+			if((page->dirty & ((uint64_t) 1 << j)) && byteAddress >= address && byteAddress < address + size)
+				data[byteAddress - address] = page->data[j];
+		}
+	}
+}
+
+static IOPinTypeDef *selectEEPROM(SPIChannelTypeDef *SPIChannel)
+{
 	// select CSN of eeprom
 	IOPinTypeDef* io = SPIChannel->CSN;
 	if(SPIChannel == &SPI.ch1)
@@ -310,13 +393,163 @@ void eeprom_read_array(SPIChannelTypeDef *SPIChannel, uint16_t address, uint8_t
 
 	IOs.toOutput(SPIChannel->CSN);
 
-	SPIChannel->readWrite(0x03, false); // Befehl "Read"
+	return io;
+}
+
+static void deselectEEPROM(SPIChannelTypeDef *SPIChannel, IOPinTypeDef *io)
+{
+	HAL.IOs->config->toInput(SPIChannel->CSN);
+	SPIChannel->CSN = io;
+}
+
+static uint8_t readStatus(SPIChannelTypeDef *SPIChannel)
+{
+	IOPinTypeDef *io = selectEEPROM(SPIChannel);
+
+	SPIChannel->readWrite(CMD_READ_STATUS, false);
+	uint8_t status = SPIChannel->readWrite(0x00, true);
+
+	deselectEEPROM(SPIChannel, io);
+
+	return status;
+}
+
+static void readChip(SPIChannelTypeDef *SPIChannel, uint16_t address, uint8_t *data, uint16_t size)
+{
+	// The Eeprom does not answer reads during a write cycle
+	waitForWrite(SPIChannel);
+
+	IOPinTypeDef *io = selectEEPROM(SPIChannel);
+
+	// Sequential read: the Eeprom increments the address by itself (unlike writes, across pages)
+	SPIChannel->readWrite(CMD_READ, false);
 	SPIChannel->readWrite(address >> 8, false);
 	SPIChannel->readWrite(address & 0xFF, false);
 
-	for(i = 0; i < size; i++)
-		*(data+i) = SPIChannel->readWrite(0, i == size-1); // beim letzten Byte EEPROM deselektieren
+	for(uint16_t i = 0; i < size; i++)
+		data[i] = SPIChannel->readWrite(0, i == size-1); // beim letzten Byte EEPROM deselektieren
 
-	HAL.IOs->config->toInput(SPIChannel->CSN);
-	SPIChannel->CSN = io;
+	deselectEEPROM(SPIChannel, io);
+}
+
+static void waitForWrite(SPIChannelTypeDef *SPIChannel)
+{
+	if(!writingPage || writingPage->SPIChannel != SPIChannel)
+		return;
+
+	while(readStatus(SPIChannel) & STATUS_WIP)
+	{
+		if((systick_getTick() - writeStartTick) > EEPROM_WRITE_TIMEOUT)
+		{
+			dropPendingWrites(SPIChannel);
+			return;
+		}
+	}
+
+	writingPage->SPIChannel  = NULL;
+	writingPage              = NULL;
+}
+
+static bool hasPendingWrites(SPIChannelTypeDef *SPIChannel)
+{
+	for(uint8_t i = 0; i < EEPROM_WRITE_BUFFERS; i++)
+		if(pageBuffers[i].SPIChannel == SPIChannel)
+			return true;
+
+	return false;
+}
+
+static void dropPendingWrites(SPIChannelTypeDef *SPIChannel)
+{
+	for(uint8_t i = 0; i < EEPROM_WRITE_BUFFERS; i++)
+		if(pageBuffers[i].SPIChannel == SPIChannel)
+			pageBuffers[i].SPIChannel = NULL;
+
+	if(writingPage && writingPage->SPIChannel == NULL)
+		writingPage = NULL;
+
+	// The mirror contains the dropped data
+	MIRROR_DATA(SPIChannel)->init = false;
+}
+
+static void startPageWrite(EEPROM_PageBuffer *page)
+{
+	SPIChannelTypeDef *SPIChannel = page->SPIChannel;
+
+	// Only the range from the first to the last buffered byte gets written.
+	// Gaps in between are filled with the current Eeprom content.
+	uint8_t first  = __builtin_ctzll(page->dirty);
+	uint8_t last   = 63 - __builtin_clzll(page->dirty);
+
+	for(uint8_t i = first; i <= last; i++)
+	{
+		if(!(page->dirty & ((uint64_t) 1 << i)))
+		{
+			uint8_t buffer[EEPROM_PAGE_SIZE];
+			readChip(SPIChannel, page->address + first, buffer, last - first + 1);
+			for(uint8_t j = first; j <= last; j++)
+				if(!(page->dirty & ((uint64_t) 1 << j)))
+					page->data[j] = buffer[j - first];
+			break;
+		}
+	}
+
+	// The gap readout waited for a write cycle that timed out
+	if(page->SPIChannel == NULL)
+		return;
+
+	IOPinTypeDef *io = selectEEPROM(SPIChannel);
+
+	// Schreiben erlauben
+	SPIChannel->readWrite(CMD_WRITE_ENABLE, true);
+	writeStartTick = systick_getTick();
+	do
+	{
+		SPIChannel->readWrite(CMD_READ_STATUS, false);
+		if((systick_getTick() - writeStartTick) > EEPROM_WRITE_TIMEOUT)
+		{
+			SPIChannel->readWrite(0x00, true);
+			deselectEEPROM(SPIChannel, io);
+			dropPendingWrites(SPIChannel);
+			return;
+		}
+	} while((SPIChannel->readWrite(0x00, true) & STATUS_WEL) == 0x00);  // Warte bis "Write Enable"-Bit gesetzt ist
+
+	// Page write: the Eeprom only increments the lowest six address bits, so the range must not cross the page
+	SPIChannel->readWrite(CMD_WRITE, false);
+	SPIChannel->readWrite((page->address + first) >> 8, false);
+	SPIChannel->readWrite((page->address + first) & 0xFF, false);
+
+	for(uint8_t i = first; i <= last; i++)
+		SPIChannel->readWrite(page->data[i], i == last);
+
+	deselectEEPROM(SPIChannel, io);
+
+	// The write enable latch gets reset by the Eeprom at the end of the write cycle
+	writingPage     = page;
+	writeStartTick  = systick_getTick();
+}
+
+static void updateMirror(SPIChannelTypeDef *SPIChannel, uint16_t address, uint8_t *data, uint16_t size)
+{
+	if(!MIRROR_DATA(SPIChannel)->init)
+		return;
+
+	for(uint16_t i = 0; i < size; i++)
+		if(address + i >= EEPROM_ADDR_META && address + i < EEPROM_ADDR_META + EEPROM_SIZE_META)
+			metaMirror[MIRROR_INDEX(SPIChannel)][address + i - EEPROM_ADDR_META] = data[i];
+
+	decodeMirror(SPIChannel);
+}
+
+static void decodeMirror(SPIChannelTypeDef *SPIChannel)
+{
+	uint8_t *buffer = metaMirror[MIRROR_INDEX(SPIChannel)];
+	EEPROM_Data *eep = MIRROR_DATA(SPIChannel);
+
+	memcpy(eep->name, &buffer[EEPROM_ADDR_NAME - EEPROM_ADDR_META], EEPROM_SIZE_NAME);
+	eep->id = _8_16(buffer[EEPROM_ADDR_ID - EEPROM_ADDR_META], buffer[(EEPROM_ADDR_ID + 1) - EEPROM_ADDR_META]);
+	eep->hw = _8_16(buffer[EEPROM_ADDR_HW - EEPROM_ADDR_META], buffer[(EEPROM_ADDR_HW + 1) - EEPROM_ADDR_META]);
+	eep->magic = _8_16(buffer[EEPROM_ADDR_MAGIC - EEPROM_ADDR_META], buffer[(EEPROM_ADDR_MAGIC + 1) - EEPROM_ADDR_META]);
+	eep->init = true;
 }
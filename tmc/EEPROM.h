@@ -27,6 +27,9 @@
 #define EEPROM_SIZE_MAGIC  2
 #define EEPROM_SIZE_META   (EEPROM_SIZE_NAME + EEPROM_SIZE_ID + EEPROM_SIZE_HW + EEPROM_SIZE_MAGIC)
 
+#define EEPROM_PAGE_SIZE       64  // 25128: writes only increment the lowest six address bits
+#define EEPROM_WRITE_BUFFERS   4   // pages that can be buffered for writing
+
 #define MAGICNUMBER_LOW   0x12
 #define MAGICNUMBER_HIGH  0x34
 
@@ -53,6 +56,11 @@ uint8_t eeprom_check(SPIChannelTypeDef *SPIChannel);
 
 void eeprom_write_byte(SPIChannelTypeDef *SPIChannel, uint16_t address, uint8_t value);
 void eeprom_write_array(SPIChannelTypeDef *SPIChannel, uint16_t address, uint8_t *data, uint16_t size);
+void eeprom_write_async(SPIChannelTypeDef *SPIChannel, uint16_t address, uint8_t *data, uint16_t size);
+
+void eeprom_process(void);
+void eeprom_flush(void);
+bool eeprom_busy(void);
 
 uint8_t eeprom_read_byte(SPIChannelTypeDef *SPIChannel, uint16_t address);
 void eeprom_read_array(SPIChannelTypeDef *SPIChannel, uint16_t address, uint8_t *block, uint16_t size);
@@ -0,0 +1,245 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+/*
+ * Event log.
+ *
+ * Fixed size ring of timestamped (source, code, value) entries for faults and
+ * state transitions. Entries are numbered continuously, the ring holds the
+ * newest EVENTLOG_ENTRIES of them.
+ *
+ * Writing is lock-free and allowed from interrupts and the main loop: a slot
+ * is reserved with an atomic increment of the entry number, so two writers
+ * never share a slot. The sequence field of a slot is invalidated before and
+ * set after the entry data. Reading happens in the main loop only and skips
+ * entries whose sequence doesn't match, which covers slots being reused by an
+ * interrupt while they get copied.
+ *
+ * After a fault the newest EVENTLOG_PERSIST_ENTRIES entries can be saved to the
+ * parameter store once, so they survive a reset. A marker record in the store
+ * keeps this limit across resets, clearing the log re-arms it. The fault path
+ * never compacts the store: if the free records don't suffice, saving is skipped.
+ */
+
+#include "EventLog.h"
+#include "ParameterStore.h"
+#include "hal/SysTick.h"
+
+#define SEQUENCE(number)  ((uint16_t) ((number) & 0xFFFF))
+
+// Words of a saved entry in the parameter store
+#define PERSIST_WORD_TICK   0
+#define PERSIST_WORD_CODE   1
+#define PERSIST_WORD_VALUE  2
+
+// Record marking that the log has been saved, stored after the entry slots
+#define PERSIST_MARKER      EVENTLOG_PERSIST_ENTRIES
+#define PERSIST_RECORDS     (3 * EVENTLOG_PERSIST_ENTRIES + 1)
+
+EventLogTypeDef EventLog =
+{
+	.written       = 0,
+	.start         = 0,
+	.faultPending  = false,
+	.persist       = false
+};
+
+static uint32_t available(uint32_t written);
+static bool readEntry(uint32_t number, EventLogEntryTypeDef *entry);
+static size_t packEntry(const EventLogEntryTypeDef *entry, uint8_t *data);
+static bool saved(void);
+static void save(void);
+
+void eventlog_write(uint8_t source, uint8_t code, int32_t value)
+{
+	uint32_t tick = systick_getTick();
+	uint32_t number = __atomic_fetch_add(&EventLog.written, 1, __ATOMIC_RELAXED);
+	volatile EventLogEntryTypeDef *entry = &EventLog.entries[number % EVENTLOG_ENTRIES];
+
+	// Inverting the sequence never matches the number of an entry sharing this slot
+	entry->sequence  = (uint16_t) ~SEQUENCE(number);
+	entry->tick      = tick;
+	entry->source    = source;
+	entry->code      = code;
+	entry->value     = value;
+	entry->sequence  = SEQUENCE(number);
+
+	if(code & EVENTLOG_FAULT)
+	{
+		EventLog.faultTick     = tick;
+		EventLog.faultPending  = true;
+	}
+}
+
+void eventlog_clear(void)
+{
+	EventLog.start         = EventLog.written;
+	EventLog.faultPending  = false;
+
+	if(saved())
+		paramstore_store(PARAMSTORE_SCOPE_EVENTLOG, 0, PERSIST_MARKER, 0, 0);
+}
+
+// Saves the log once the persist delay after a fault has passed
+void eventlog_process(uint32_t tick)
+{
+	if(!EventLog.faultPending)
+		return;
+
+	if((tick - EventLog.faultTick) < EVENTLOG_PERSIST_DELAY)
+		return;
+
+	EventLog.faultPending = false;
+
+	if(!EventLog.persist || saved())
+		return;
+
+	// Compacting would erase a flash block, which is left to the main loop task
+	if(paramstore_getFreeRecords() < PERSIST_RECORDS)
+		return;
+
+	save();
+}
+
+// Copies the entries from number <first> on into <data>, EVENTLOG_ENTRY_SIZE bytes each.
+// Entries which are no longer available are skipped, the sequence field tells the caller where the dump starts.
+// Returns the number of bytes written.
+size_t eventlog_read(uint32_t first, uint8_t *data, size_t size)
+{
+	uint32_t written = EventLog.written;
+	uint32_t oldest = written - available(written);
+	size_t length = 0;
+
+	// Numbers older than the oldest entry start the dump at the oldest one,
+	// numbers past the newest entry return nothing
+	if((int32_t) (first - oldest) < 0)
+		first = oldest;
+	if((int32_t) (written - first) < 0)
+		return 0;
+
+	for(uint32_t number = first; (number != written) && (length + EVENTLOG_ENTRY_SIZE <= size); number++)
+	{
+		EventLogEntryTypeDef entry;
+
+		if(!readEntry(number, &entry))
+			continue;
+
+		length += packEntry(&entry, &data[length]);
+	}
+
+	return length;
+}
+
+// Copies the entries saved after the last fault into <data>. Returns the number of bytes written.
+size_t eventlog_readPersisted(uint8_t *data, size_t size)
+{
+	size_t length = 0;
+
+	for(uint8_t i = 0; (i < EVENTLOG_PERSIST_ENTRIES) && (length + EVENTLOG_ENTRY_SIZE <= size); i++)
+	{
+		int32_t tick, code, value;
+
+		if(paramstore_load(PARAMSTORE_SCOPE_EVENTLOG, 0, i, PERSIST_WORD_TICK, &tick) != TMC_ERROR_NONE)
+			continue;
+		if(paramstore_load(PARAMSTORE_SCOPE_EVENTLOG, 0, i, PERSIST_WORD_CODE, &code) != TMC_ERROR_NONE)
+			continue;
+		if(paramstore_load(PARAMSTORE_SCOPE_EVENTLOG, 0, i, PERSIST_WORD_VALUE, &value) != TMC_ERROR_NONE)
+			continue;
+
+		EventLogEntryTypeDef entry =
+		{
+			.tick      = tick,
+			.source    = code & 0xFF,
+			.code      = (code >> 8) & 0xFF,
+			.sequence  = (code >> 16) & 0xFFFF,
+			.value     = value
+		};
+
+		// Code 0 marks a slot that was empty when saving
+		if(entry.code == 0)
+			continue;
+
+		length += packEntry(&entry, &data[length]);
+	}
+
+	return length;
+}
+
+// Number of entries in the ring since the last clear
+static uint32_t available(uint32_t written)
+{
+	return MIN(written - EventLog.start, EVENTLOG_ENTRIES);
+}
+
+static bool readEntry(uint32_t number, EventLogEntryTypeDef *entry)
+{
+	volatile EventLogEntryTypeDef *slot = &EventLog.entries[number % EVENTLOG_ENTRIES];
+
+	if(slot->sequence != SEQUENCE(number))
+		return false;
+
+	entry->tick      = slot->tick;
+	entry->source    = slot->source;
+	entry->code      = slot->code;
+	entry->value     = slot->value;
+	entry->sequence  = SEQUENCE(number);
+
+	// An interrupt might have reused the slot meanwhile
+	return slot->sequence == SEQUENCE(number);
+}
+
+// Little endian: tick, source, code, sequence, value
+static size_t packEntry(const EventLogEntryTypeDef *entry, uint8_t *data)
+{
+	data[0]   = entry->tick & 0xFF;
+	data[1]   = (entry->tick >> 8) & 0xFF;
+	data[2]   = (entry->tick >> 16) & 0xFF;
+	data[3]   = (entry->tick >> 24) & 0xFF;
+	data[4]   = entry->source;
+	data[5]   = entry->code;
+	data[6]   = entry->sequence & 0xFF;
+	data[7]   = (entry->sequence >> 8) & 0xFF;
+	data[8]   = entry->value & 0xFF;
+	data[9]   = (entry->value >> 8) & 0xFF;
+	data[10]  = (entry->value >> 16) & 0xFF;
+	data[11]  = (entry->value >> 24) & 0xFF;
+
+	return EVENTLOG_ENTRY_SIZE;
+}
+
+// True if the log has been saved since the last clear
+static bool saved(void)
+{
+	int32_t marker;
+
+	if(paramstore_load(PARAMSTORE_SCOPE_EVENTLOG, 0, PERSIST_MARKER, 0, &marker) != TMC_ERROR_NONE)
+		return false;
+
+	return marker != 0;
+}
+
+// Saves the newest entries to the parameter store, three records per entry, followed by the marker.
+// All slots get written, so no entries of an earlier fault are left over.
+static void save(void)
+{
+	uint32_t written = EventLog.written;
+	uint32_t count = MIN(available(written), EVENTLOG_PERSIST_ENTRIES);
+
+	for(uint8_t i = 0; i < EVENTLOG_PERSIST_ENTRIES; i++)
+	{
+		EventLogEntryTypeDef entry = { 0 };
+
+		// A failed read leaves the slot empty
+		if((i < count) && !readEntry(written - count + i, &entry))
+			entry = (EventLogEntryTypeDef) { 0 };
+
+		paramstore_store(PARAMSTORE_SCOPE_EVENTLOG, 0, i, PERSIST_WORD_TICK, entry.tick);
+		paramstore_store(PARAMSTORE_SCOPE_EVENTLOG, 0, i, PERSIST_WORD_CODE, entry.source | (entry.code << 8) | ((uint32_t) entry.sequence << 16));
+		paramstore_store(PARAMSTORE_SCOPE_EVENTLOG, 0, i, PERSIST_WORD_VALUE, entry.value);
+	}
+
+	paramstore_store(PARAMSTORE_SCOPE_EVENTLOG, 0, PERSIST_MARKER, 0, 1);
+}
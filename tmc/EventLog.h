@@ -0,0 +1,61 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include "tmc/helpers/API_Header.h"
+
+#define EVENTLOG_ENTRIES          64    // Ring size, has to be a power of two
+#define EVENTLOG_ENTRY_SIZE       12    // Bytes per entry in the dump
+#define EVENTLOG_PERSIST_ENTRIES  8     // Newest entries saved to flash after a fault
+#define EVENTLOG_PERSIST_DELAY    1000  // Time in [ms] between a fault and saving, so the following events are included
+
+// Event sources
+#define EVENTLOG_SOURCE_SYSTEM  0
+#define EVENTLOG_SOURCE_VSM     1  // VitalSignsMonitor
+#define EVENTLOG_SOURCE_CH1     2  // Motion controller board
+#define EVENTLOG_SOURCE_CH2     3  // Driver board
+
+// Event codes
+#define EVENTLOG_CODE_BOOT       0x01  // Firmware started
+#define EVENTLOG_CODE_ERRORS     0x02  // Error bits changed, value: new error bits
+#define EVENTLOG_CODE_VM_CUTOFF  0x03  // Overvoltage cutoff by the ADC interrupt, value: VM [100mV]
+#define EVENTLOG_CODE_RESTORE    0x04  // Board configurations restored after a brownout
+#define EVENTLOG_CODE_BOARD      0x05  // Board assignment changed, value: ID state << 8 | board ID
+#define EVENTLOG_CODE_MARKER     0x06  // Written by the host, value: given by the host
+#define EVENTLOG_CODE_TASK       0x07  // Main loop task could not be registered, value: number of registered tasks
+#define EVENTLOG_FAULT           0x80  // Code flag: the event is a fault and triggers saving the log
+
+typedef struct
+{
+	uint32_t  tick;      // systick [ms]
+	uint8_t   source;
+	uint8_t   code;
+	uint16_t  sequence;  // Low 16 bits of the entry number, written last
+	int32_t   value;
+} EventLogEntryTypeDef;
+
+typedef struct
+{
+	volatile uint32_t     written;       // Entry number of the next entry
+	uint32_t              start;         // Entry number of the first entry after the last clear
+	volatile bool         faultPending;  // A fault was logged and not saved yet
+	uint32_t              faultTick;
+	bool                  persist;       // Save the newest entries to flash once after a fault, cleared with the log to limit flash wear
+	EventLogEntryTypeDef  entries[EVENTLOG_ENTRIES];
+} EventLogTypeDef;
+
+extern EventLogTypeDef EventLog;
+
+void eventlog_write(uint8_t source, uint8_t code, int32_t value);
+void eventlog_clear(void);
+void eventlog_process(uint32_t tick);
+
+size_t eventlog_read(uint32_t first, uint8_t *data, size_t size);
+size_t eventlog_readPersisted(uint8_t *data, size_t size);
+
+#endif /* EVENT_LOG_H */
@@ -0,0 +1,207 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+/*
+ * Asynchronous board ID detection.
+ *
+ * IDDetection_process() runs as a main loop task and steps the platform
+ * specific monoflop measurement without blocking. A scan is started on boot
+ * and on request. Background scans every rescanPeriod ms to detect swapped
+ * boards are opt-in, they toggle ID_CLK and access the EEPROMs on the shared
+ * SPI buses. They are only started while both boards are idle.
+ *
+ * A scan result is only accepted if the following scan confirms it, so a
+ * single disturbed measurement can not reassign the boards. Confirmed results
+ * that differ from the current assignment are passed to the assign callback.
+ *
+ * EEPROM IDs are cached: as long as the monoflop result of a channel does not
+ * change, the EEPROM of that channel is only read again every
+ * ID_EEPROM_VERIFY_SCANS scans. This keeps the SPI traffic of background scans
+ * away from the boards.
+ */
+
+#include <string.h>
+
+#include "IdDetection.h"
+
+#include "hal/HAL.h"
+
+// Scans in a row that may disagree before the last result is accepted anyway
+#define MAX_UNCONFIRMED_SCANS  4
+
+typedef struct
+{
+	uint8_t valid;       // cache entry is in use
+	uint8_t id;          // EEPROM ID, 0: no EEPROM found
+	uint8_t monoflopID;  // monoflop result this entry was read with
+	uint8_t monoflopState;
+} EEPROMCacheTypeDef;
+
+static uint8_t sameIDs(IdAssignmentTypeDef *a, IdAssignmentTypeDef *b);
+static void readEEPROM(uint8_t channel, IdStateTypeDef *state, IdStateTypeDef *globalState, EEPROMCacheTypeDef *cache, uint8_t verify);
+static void evaluate(IdAssignmentTypeDef *ids);
+static uint8_t boardsBusy(void);
+
+IDDetectionTypeDef IDDetection =
+{
+	.rescanPeriod  = ID_RESCAN_PERIOD_DEFAULT,
+	.scans         = 0,
+	.changes       = 0,
+	.paused        = false,
+	.assign        = NULL
+};
+
+static EEPROMCacheTypeDef eepromCache[2];
+
+static uint8_t scanning        = false;
+static uint8_t scanRequested   = true;  // Initial scan
+static uint8_t forceAssign     = false;
+static uint8_t resultReady     = false;
+static uint8_t unconfirmed     = 0;
+static uint8_t assigned        = false;
+static uint32_t lastScanTick   = 0;
+
+static IdAssignmentTypeDef scanIDs;
+static IdAssignmentTypeDef lastIDs;
+static IdAssignmentTypeDef assignedIDs;
+
+// Single non-blocking scan - returns true when done
+uint8_t IDDetection_detect(IdAssignmentTypeDef *ids)
+{
+	// Try to identify the IDs via monoflop pulse duration
+	if(!IDDetection_detectMonoflop(ids))
+		return false;
+
+	// Try to identify the IDs via EEPROM readout
+	uint8_t verify = forceAssign || (IDDetection.scans % ID_EEPROM_VERIFY_SCANS) == 0;
+	readEEPROM(1, &ids->ch1, &IdState.ch1, &eepromCache[0], verify);
+	readEEPROM(2, &ids->ch2, &IdState.ch2, &eepromCache[1], verify);
+
+	// Detection finished
+	return true;
+}
+
+// Requests a scan whose result gets assigned even if the IDs did not change.
+// Returns true with the detected IDs once a requested scan finished.
+uint8_t IDDetection_scan(IdAssignmentTypeDef *ids)
+{
+	if(resultReady)
+	{
+		resultReady = false;
+		*ids = assignedIDs;
+		return true;
+	}
+
+	scanRequested  = true;
+	forceAssign    = true;
+
+	return false;
+}
+
+void IDDetection_process(uint32_t tick)
+{
+	if(!scanning)
+	{
+		// A board owns its SPI channel (e.g. cyclic transfers from a timer interrupt)
+		// -> the EEPROM chip select must not be swapped, wait until it is released
+		if(IDDetection.paused)
+			return;
+
+		uint8_t due = scanRequested || (unconfirmed > 0)
+		              || (IDDetection.rescanPeriod && (tick - lastScanTick) >= IDDetection.rescanPeriod && !boardsBusy());
+
+		if(!due)
+			return;
+
+		scanRequested  = false;
+		scanning       = true;
+		memset(&scanIDs, 0, sizeof(scanIDs));
+	}
+
+	if(!IDDetection_detect(&scanIDs))
+		return;
+
+	scanning      = false;
+	lastScanTick  = tick;
+	IDDetection.scans++;
+
+	evaluate(&scanIDs);
+}
+
+static uint8_t boardsBusy(void)
+{
+	return (Evalboards.ch1.config->state != CONFIG_READY)
+	    || (Evalboards.ch2.config->state != CONFIG_READY);
+}
+
+static void evaluate(IdAssignmentTypeDef *ids)
+{
+	uint8_t confirmed = sameIDs(ids, &lastIDs);
+	lastIDs = *ids;
+
+	if(!confirmed && ++unconfirmed < MAX_UNCONFIRMED_SCANS)
+		return; // Scan again right away
+
+	unconfirmed = 0;
+
+	if(assigned && !forceAssign && sameIDs(ids, &assignedIDs))
+		return;
+
+	if(assigned && !sameIDs(ids, &assignedIDs))
+		IDDetection.changes++;
+
+	assigned     = true;
+	assignedIDs  = *ids;
+
+	if(IDDetection.assign)
+	{
+		// The callback may change the states, e.g. to ID_STATE_NOT_IN_FW
+		IdAssignmentTypeDef buffer = *ids;
+		IDDetection.assign(&buffer);
+	}
+
+	if(forceAssign)
+	{
+		forceAssign  = false;
+		resultReady  = true;
+	}
+}
+
+static uint8_t sameIDs(IdAssignmentTypeDef *a, IdAssignmentTypeDef *b)
+{
+	return (a->ch1.id == b->ch1.id) && (a->ch1.state == b->ch1.state)
+	    && (a->ch2.id == b->ch2.id) && (a->ch2.state == b->ch2.state);
+}
+
+static void readEEPROM(uint8_t channel, IdStateTypeDef *state, IdStateTypeDef *globalState, EEPROMCacheTypeDef *cache, uint8_t verify)
+{
+	// Found by monoflop -> an EEPROM is not checked
+	if(state->state == ID_STATE_DONE)
+	{
+		cache->valid = false;
+		return;
+	}
+
+	// The cache is only valid as long as the monoflop measurement of the channel stays the same
+	if(cache->valid && !verify && (cache->monoflopID == state->id) && (cache->monoflopState == state->state))
+	{
+		if(cache->id)
+		{
+			state->id               = cache->id;
+			state->state            = ID_STATE_DONE;
+			globalState->detectedBy = FOUND_BY_EEPROM;
+		}
+		return;
+	}
+
+	cache->valid          = true;
+	cache->monoflopID     = state->id;
+	cache->monoflopState  = state->state;
+
+	IDDetection_detectEEPROM(channel, state);
+
+	cache->id = (state->state == ID_STATE_DONE) ? state->id : 0;
+}
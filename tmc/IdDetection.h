@@ -21,9 +21,29 @@
 	#define ID_STATE_TIMEOUT    5  // id detection failed - board id pulse went high but not low
 	#define ID_STATE_NOT_IN_FW  6  // id detection detected a valid id that is not supported in this firmware
 
+	#define ID_RESCAN_PERIOD_DEFAULT  0     // default time between background scans in [ms], hot-plug detection is opt-in (SGP 27)
+	#define ID_EEPROM_VERIFY_SCANS    10    // scans between two readouts of an unchanged EEPROM channel
+
+	typedef struct
+	{
+		uint32_t rescanPeriod;  // time between background scans in [ms], 0 disables the hot-plug detection
+		uint32_t scans;         // number of completed scans
+		uint32_t changes;       // number of detected board changes after the initial assignment
+		volatile uint8_t paused;  // set by boards that drive their SPI channel from an interrupt, no scans are started while set
+		void (*assign)(IdAssignmentTypeDef *ids);  // called with confirmed, changed IDs
+	} IDDetectionTypeDef;
+
+	extern IDDetectionTypeDef IDDetection;
+
+	// Platform specific, IdDetection_<platform>.c
 	void IDDetection_init(void);
 	void IDDetection_deInit(void);
-	uint8_t IDDetection_detect(IdAssignmentTypeDef *out);
-	void IDDetection_initialScan(IdAssignmentTypeDef *ids);
+	uint8_t IDDetection_detectMonoflop(IdAssignmentTypeDef *ids);  // non-blocking, returns true when done
+	void IDDetection_detectEEPROM(uint8_t channel, IdStateTypeDef *state);  // channel 1 or 2
+
+	// Asynchronous detection, IdDetection.c
+	uint8_t IDDetection_detect(IdAssignmentTypeDef *ids);
+	uint8_t IDDetection_scan(IdAssignmentTypeDef *ids);
+	void IDDetection_process(uint32_t tick);
 
 #endif /* ID_DETECTION_H */
@@ -7,13 +7,13 @@
 *******************************************************************************/
 
 /*
- *  Calling IDDetection_detect(IdAssignmentTypeDef *result) will start the ID detection process.
+ *  Calling IDDetection_detectMonoflop(IdAssignmentTypeDef *result) will start the monoflop ID detection.
  *  The function returns the ID Results through the IdAssignmentTypeDef struct result points to.
- *  The detection will be done by monoflop pulse duration measurement or via EEPROM readout.
- *  While this process is still ongoing the function will return ID_STATE_WAIT_HIGH. Once the
- *  ID detection of both channels has been finished, ID_STATE_DONE will be returned.
+ *  While this process is still ongoing the function will return false. Once the
+ *  ID detection of both channels has been finished, true will be returned.
  *
  *  Calling the function again after the detection has finished will start another scan.
+ *  Boards without monoflop get identified by IDDetection_detectEEPROM(), see IdDetection.c.
  */
 
 #include "tmc/helpers/API_Header.h"
@@ -23,12 +23,9 @@
 #include "BoardAssignment.h"
 #include "EEPROM.h"
 #include "IdDetection.h"
-#include "VitalSignsMonitor.h"
-#include "TMCL.h"
 
 // Helper functions
-static int32_t detectID_Monoflop(IdAssignmentTypeDef *ids);
-static int32_t detectID_EEPROM(IdAssignmentTypeDef *ids);
+static void configureIDPin(IOPinTypeDef *pin);
 
 // Helper macros
 #define ID_CLK_LOW()   HAL.IOs->config->setLow(&HAL.IOs->pins->ID_CLK);   // set id clk signal to low
@@ -177,8 +174,8 @@ void IDDetection_init(void)
 	HAL.IOs->config->toOutput(&HAL.IOs->pins->ID_CLK);
 
 	// Enable GPIO, edge-triggered interrupt, and PullUp
-	PORT_PCR_REG(HAL.IOs->pins->ID_CH0.portBase, HAL.IOs->pins->ID_CH0.bit)  = PORT_PCR_MUX(1) | PORT_PCR_IRQC(0x0B) | PORT_PCR_PE_MASK | PORT_PCR_PS_MASK;
-	PORT_PCR_REG(HAL.IOs->pins->ID_CH1.portBase, HAL.IOs->pins->ID_CH1.bit)  = PORT_PCR_MUX(1) | PORT_PCR_IRQC(0x0B) | PORT_PCR_PE_MASK | PORT_PCR_PS_MASK;
+	configureIDPin(&HAL.IOs->pins->ID_CH0);
+	configureIDPin(&HAL.IOs->pins->ID_CH1);
 
 	// Clear interrupt flags
 	PORTB_ISFR = -1;
@@ -241,32 +238,13 @@ static uint8_t assign(uint32_t pulse)
 	return 0; // error
 }
 
-// Detect IDs of attached boards - returns true when done
-uint8_t IDDetection_detect(IdAssignmentTypeDef *out)
+static void configureIDPin(IOPinTypeDef *pin)
 {
-	// Try to identify the IDs via monoflop pulse duration
-	if (!detectID_Monoflop(out))
-		return false;
-
-	// Try to identify the IDs via EEPROM readout
-	detectID_EEPROM(out);
-
-	// Detection finished
-	return true;
+	PORT_PCR_REG(pin->portBase, pin->bit) = PORT_PCR_MUX(1) | PORT_PCR_IRQC(0x0B) | PORT_PCR_PE_MASK | PORT_PCR_PS_MASK;
 }
 
-void IDDetection_initialScan(IdAssignmentTypeDef *ids)
-{
-	while(!IDDetection_detect(ids))
-	{
-		vitalsignsmonitor_checkVitalSigns();
-		tmcl_process();
-	}
-}
-
-
-// Helper functions
-static int32_t detectID_Monoflop(IdAssignmentTypeDef *ids)
+// Detect IDs of attached boards via monoflop pulse duration - returns true when done
+uint8_t IDDetection_detectMonoflop(IdAssignmentTypeDef *ids)
 {
 	switch (monoflopState)
 	{
@@ -279,6 +257,11 @@ static int32_t detectID_Monoflop(IdAssignmentTypeDef *ids)
 		IdState.ch2.state       = ID_STATE_WAIT_LOW;
 		IdState.ch2.detectedBy  = FOUND_BY_NONE;
 
+		// The ID pins are also the EEPROM chip selects
+		configureIDPin(&HAL.IOs->pins->ID_CH0);
+		configureIDPin(&HAL.IOs->pins->ID_CH1);
+		PORTB_ISFR = -1;
+
 		// Update the monoflop state before activating the timer. Otherwise bad
 		// luck with other unrelated interrupts might cause enough delay to
 		// trigger the timer overflow after starting the timer before updating
@@ -365,51 +348,34 @@ static int32_t detectID_Monoflop(IdAssignmentTypeDef *ids)
 	return false;
 }
 
-static int32_t detectID_EEPROM(IdAssignmentTypeDef *ids)
+// Detect the ID of a board via EEPROM readout
+void IDDetection_detectEEPROM(uint8_t channel, IdStateTypeDef *state)
 {
-	// ====== EEPROM Check ======
 	// EEPROM spec reserves 2 bytes for the ID buffer.
 	// Currently we only use one byte for IDs, both here in the firmware
 	// and in the IDE - once we deplete that ID pool, this needs to be extended
 	// (uint8_t to uint16_t and change EEPROM read to read two bytes instead of one)
 	uint8_t idBuffer[2];
-	// ====== CH1 ======
-	if(ids->ch1.state != ID_STATE_DONE)
-	{
-		// EEPROM is not ready -> assume it is not connected -> skip EEPROM ID read
-		if(!eeprom_check(&SPI.ch1))
-		{
-			eeprom_read_array(&SPI.ch1, EEPROM_ADDR_ID, &idBuffer[0], 1);
-			ids->ch1.id = idBuffer[0];
-			// ID was correctly detected via EEPROM
-			if(ids->ch1.id)
-			{
-				ids->ch1.state = ID_STATE_DONE;
-				IdState.ch1.detectedBy = FOUND_BY_EEPROM;
-			}
-		}
-		// EEPROM access changes the ID_CH0 pin configuration -> write it again // todo CHECK 2: workaround, do this better later (LH) #1
-		PORT_PCR_REG(HAL.IOs->pins->ID_CH0.portBase, HAL.IOs->pins->ID_CH0.bit) = PORT_PCR_MUX(1) | PORT_PCR_IRQC(0x0B) | PORT_PCR_PE_MASK | PORT_PCR_PS_MASK;
-	}
 
-	// ====== CH2 ======
-	if(ids->ch2.state != ID_STATE_DONE)
+	SPIChannelTypeDef *SPIChannel  = (channel == 1) ? &SPI.ch1 : &SPI.ch2;
+	IOPinTypeDef *idPin            = (channel == 1) ? &HAL.IOs->pins->ID_CH0 : &HAL.IOs->pins->ID_CH1;
+	IdStateTypeDef *globalState    = (channel == 1) ? &IdState.ch1 : &IdState.ch2;
+
+	// EEPROM is not ready -> assume it is not connected -> skip EEPROM ID read
+	if(!eeprom_check(SPIChannel))
 	{
-		// EEPROM is not ready -> assume it is not connected -> skip EEPROM ID read
-		if(!eeprom_check(&SPI.ch2))
+		eeprom_read_array(SPIChannel, EEPROM_ADDR_ID, &idBuffer[0], 1);
+		// ID was correctly detected via EEPROM
+		if(idBuffer[0])
 		{
-			eeprom_read_array(&SPI.ch2, EEPROM_ADDR_ID, &idBuffer[0], 1);
-			ids->ch2.id = idBuffer[0];
-			//id was correctly detected via EEPROM
-			if(ids->ch2.id)
-			{
-				ids->ch2.state = ID_STATE_DONE;
-				IdState.ch2.detectedBy = FOUND_BY_EEPROM;
-			}
+			state->id     = idBuffer[0];
+			state->state  = ID_STATE_DONE;
+			globalState->detectedBy = FOUND_BY_EEPROM;
 		}
-		// EEPROM access changes the ID_CH1 pin configuration -> write it again // todo CHECK 2: workaround, do this better later (LH) #2
-		PORT_PCR_REG(HAL.IOs->pins->ID_CH1.portBase, HAL.IOs->pins->ID_CH1.bit) = PORT_PCR_MUX(1) | PORT_PCR_IRQC(0x0B) | PORT_PCR_PE_MASK | PORT_PCR_PS_MASK;
 	}
 
-	return true;
+	// The ID pin is the EEPROM chip select -> keep the EEPROM deselected until
+	// the next monoflop scan configures the pin as ID input again
+	HAL.IOs->config->toOutput(idPin);
+	HAL.IOs->config->setHigh(idPin);
 }
@@ -0,0 +1,77 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+/*
+ *  ID detection of the host simulation. There is no monoflop to measure, the
+ *  board IDs get taken from the environment variables TMC_SIM_ID_CH1 and
+ *  TMC_SIM_ID_CH2 instead. Channels without an ID fall back to the EEPROM
+ *  readout of the virtual ID EEPROMs, like on the real hardware.
+ *
+ *  The detection finishes immediately, IDDetection_detectMonoflop() always returns true.
+ */
+
+#include <stdlib.h>
+
+#include "IdDetection.h"
+
+#include "hal/derivative.h"
+#include "hal/HAL.h"
+#include "BoardAssignment.h"
+#include "EEPROM.h"
+
+static void detectID_Environment(IdStateTypeDef *state, const char *variable);
+
+IdAssignmentTypeDef IdState = { 0 };
+
+void IDDetection_init(void)
+{
+}
+
+void IDDetection_deInit()
+{
+}
+
+// Detect IDs of attached boards in place of the monoflop - returns true when done
+uint8_t IDDetection_detectMonoflop(IdAssignmentTypeDef *ids)
+{
+	detectID_Environment(&ids->ch1, "TMC_SIM_ID_CH1");
+	detectID_Environment(&ids->ch2, "TMC_SIM_ID_CH2");
+
+	IdState.ch1.detectedBy = ids->ch1.detectedBy;
+	IdState.ch2.detectedBy = ids->ch2.detectedBy;
+
+	// Detection finished
+	return true;
+}
+
+static void detectID_Environment(IdStateTypeDef *state, const char *variable)
+{
+	char *value = getenv(variable);
+
+	state->id          = (value) ? strtoul(value, NULL, 0) : 0;
+	state->state       = (state->id) ? ID_STATE_DONE : ID_STATE_NO_ANSWER;
+	state->detectedBy  = (state->id) ? FOUND_BY_MONOFLOP : FOUND_BY_NONE;
+}
+
+void IDDetection_detectEEPROM(uint8_t channel, IdStateTypeDef *state)
+{
+	// EEPROM spec reserves 2 bytes for the ID buffer, only one is used
+	uint8_t id;
+	SPIChannelTypeDef *SPIChannel = (channel == 1) ? &SPI.ch1 : &SPI.ch2;
+
+	// EEPROM is not ready or not programmed -> skip EEPROM ID read
+	if(eeprom_check(SPIChannel))
+		return;
+
+	eeprom_read_array(SPIChannel, EEPROM_ADDR_ID, &id, 1);
+	if(id)
+	{
+		state->id          = id;
+		state->state       = ID_STATE_DONE;
+		state->detectedBy  = FOUND_BY_EEPROM;
+
+		((channel == 1) ? &IdState.ch1 : &IdState.ch2)->detectedBy = FOUND_BY_EEPROM;
+	}
+}
@@ -0,0 +1,181 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+/*
+ * StallGuard/CoolStep load monitor.
+ *
+ * Samples SG_RESULT, CS_ACTUAL and the actual velocity of one motor in the
+ * background at a fixed interval. Besides minimum, maximum and average of
+ * both values, a histogram over the absolute velocity is kept. Each bin holds
+ * the StallGuard minimum, maximum and average as well as the CoolStep average,
+ * which is what a StallGuard threshold gets tuned against.
+ */
+
+#include "LoadMonitor.h"
+#include "hal/SysTick.h"
+
+LoadMonitorTypeDef LoadMonitor =
+{
+	.read      = NULL,
+	.motors    = 0,
+	.interval  = 0,
+	.binWidth  = 10000
+};
+
+static void addStat(LoadMonitorStatTypeDef *stat, uint16_t value);
+static void addBin(int32_t velocity, uint16_t stallGuard, uint8_t coolStep);
+
+// Boards register their read function on init and remove it with NULL on deInit
+void loadmonitor_setReadFunction(LoadMonitorRead read, uint8_t motors)
+{
+	LoadMonitor.read      = read;
+	LoadMonitor.motors    = motors;
+	LoadMonitor.interval  = 0;
+}
+
+// Starts sampling <motor> every <interval> µs, an interval of 0 stops sampling
+uint32_t loadmonitor_start(uint8_t motor, uint32_t interval)
+{
+	if(interval == 0)
+	{
+		LoadMonitor.interval = 0;
+		return TMC_ERROR_NONE;
+	}
+
+	if(!LoadMonitor.read)
+		return TMC_ERROR_FUNCTION;
+
+	if(motor >= LoadMonitor.motors)
+		return TMC_ERROR_MOTOR;
+
+	if(interval < LOADMONITOR_INTERVAL_MIN)
+		return TMC_ERROR_VALUE;
+
+	if(motor != LoadMonitor.motor)
+		loadmonitor_reset();
+
+	LoadMonitor.motor       = motor;
+	LoadMonitor.lastSample  = systick_getMicrosecondTick();
+	LoadMonitor.interval    = interval;
+
+	return TMC_ERROR_NONE;
+}
+
+// The histogram gets reset since the old bins do not match anymore
+void loadmonitor_setBinWidth(uint32_t binWidth)
+{
+	LoadMonitor.binWidth = MAX(binWidth, 1);
+	loadmonitor_reset();
+}
+
+void loadmonitor_reset(void)
+{
+	LoadMonitor.stallGuard.count  = 0;
+	LoadMonitor.coolStep.count    = 0;
+
+	for(uint8_t i = 0; i < LOADMONITOR_BINS; i++)
+		LoadMonitor.bins[i].count = 0;
+}
+
+// Called once per main loop pass
+void loadmonitor_process(uint32_t tick)
+{
+	UNUSED(tick);
+
+	if(LoadMonitor.interval == 0)
+		return;
+
+	uint32_t now = systick_getMicrosecondTick();
+	if((now - LoadMonitor.lastSample) < LoadMonitor.interval)
+		return;
+
+	// Keep the sample grid, unless the main loop fell behind by more than one interval
+	LoadMonitor.lastSample += LoadMonitor.interval;
+	if((now - LoadMonitor.lastSample) >= LoadMonitor.interval)
+		LoadMonitor.lastSample = now;
+
+	uint16_t stallGuard = 0;
+	uint8_t coolStep = 0;
+	int32_t velocity = 0;
+
+	LoadMonitor.read(LoadMonitor.motor, &stallGuard, &coolStep, &velocity);
+
+	addStat(&LoadMonitor.stallGuard, stallGuard);
+	addStat(&LoadMonitor.coolStep, coolStep);
+	addBin(velocity, stallGuard, coolStep);
+}
+
+uint32_t loadmonitor_getAverage(const LoadMonitorStatTypeDef *stat)
+{
+	return (stat->count)? stat->sum / stat->count : 0;
+}
+
+// Writes the histogram to <data>. Per bin 12 bytes (little endian):
+// sample count (4), StallGuard minimum (2), maximum (2), average (2), CoolStep average (2)
+// Returns the number of bytes written.
+size_t loadmonitor_getHistogram(uint8_t *data, size_t size)
+{
+	size_t length = 0;
+
+	for(uint8_t i = 0; i < LOADMONITOR_BINS && (length + LOADMONITOR_BIN_SIZE) <= size; i++)
+	{
+		LoadMonitorBinTypeDef *bin = &LoadMonitor.bins[i];
+		uint16_t stallGuardAverage = (bin->count)? bin->stallGuardSum / bin->count : 0;
+		uint16_t coolStepAverage   = (bin->count)? bin->coolStepSum / bin->count : 0;
+		uint16_t stallGuardMin     = (bin->count)? bin->stallGuardMin : 0;
+		uint16_t stallGuardMax     = (bin->count)? bin->stallGuardMax : 0;
+
+		data[length++] = BYTE(bin->count, 0);
+		data[length++] = BYTE(bin->count, 1);
+		data[length++] = BYTE(bin->count, 2);
+		data[length++] = BYTE(bin->count, 3);
+		data[length++] = BYTE(stallGuardMin, 0);
+		data[length++] = BYTE(stallGuardMin, 1);
+		data[length++] = BYTE(stallGuardMax, 0);
+		data[length++] = BYTE(stallGuardMax, 1);
+		data[length++] = BYTE(stallGuardAverage, 0);
+		data[length++] = BYTE(stallGuardAverage, 1);
+		data[length++] = BYTE(coolStepAverage, 0);
+		data[length++] = BYTE(coolStepAverage, 1);
+	}
+
+	return length;
+}
+
+static void addStat(LoadMonitorStatTypeDef *stat, uint16_t value)
+{
+	if(stat->count == 0)
+	{
+		stat->min = value;
+		stat->max = value;
+		stat->sum = 0;
+	}
+
+	stat->min = MIN(stat->min, value);
+	stat->max = MAX(stat->max, value);
+	stat->sum += value;
+	stat->count++;
+}
+
+static void addBin(int32_t velocity, uint16_t stallGuard, uint8_t coolStep)
+{
+	uint32_t index = (uint32_t) abs(velocity) / LoadMonitor.binWidth;
+	LoadMonitorBinTypeDef *bin = &LoadMonitor.bins[MIN(index, LOADMONITOR_BINS - 1)];
+
+	if(bin->count == 0)
+	{
+		bin->stallGuardMin  = stallGuard;
+		bin->stallGuardMax  = stallGuard;
+		bin->stallGuardSum  = 0;
+		bin->coolStepSum    = 0;
+	}
+
+	bin->stallGuardMin  = MIN(bin->stallGuardMin, stallGuard);
+	bin->stallGuardMax  = MAX(bin->stallGuardMax, stallGuard);
+	bin->stallGuardSum  += stallGuard;
+	bin->coolStepSum    += coolStep;
+	bin->count++;
+}
@@ -0,0 +1,60 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#ifndef LOAD_MONITOR_H
+#define LOAD_MONITOR_H
+
+#include "tmc/helpers/API_Header.h"
+
+#define LOADMONITOR_BINS          16   // Velocity bins of the histogram
+#define LOADMONITOR_BIN_SIZE      12   // Bytes per bin in the histogram dump
+#define LOADMONITOR_INTERVAL_MIN  100  // Shortest sample interval in [µs]
+
+// Reads one sample of <motor>. The board provides this function while it is assigned.
+typedef void (*LoadMonitorRead)(uint8_t motor, uint16_t *stallGuard, uint8_t *coolStep, int32_t *velocity);
+
+typedef struct
+{
+	uint32_t  count;
+	uint16_t  min;
+	uint16_t  max;
+	uint64_t  sum;
+} LoadMonitorStatTypeDef;
+
+typedef struct
+{
+	uint32_t  count;
+	uint16_t  stallGuardMin;
+	uint16_t  stallGuardMax;
+	uint64_t  stallGuardSum;
+	uint64_t  coolStepSum;
+} LoadMonitorBinTypeDef;
+
+typedef struct
+{
+	LoadMonitorRead        read;
+	uint8_t                motors;       // Number of motors of the board providing <read>
+	uint8_t                motor;        // Sampled motor
+	uint32_t               interval;     // Sample interval in [µs], 0 when stopped
+	uint32_t               lastSample;   // Microsecond tick of the last sample
+	uint32_t               binWidth;     // Width of a velocity bin in the velocity unit of the board
+	LoadMonitorStatTypeDef stallGuard;
+	LoadMonitorStatTypeDef coolStep;
+	LoadMonitorBinTypeDef  bins[LOADMONITOR_BINS];
+} LoadMonitorTypeDef;
+
+extern LoadMonitorTypeDef LoadMonitor;
+
+void loadmonitor_setReadFunction(LoadMonitorRead read, uint8_t motors);
+uint32_t loadmonitor_start(uint8_t motor, uint32_t interval);
+void loadmonitor_setBinWidth(uint32_t binWidth);
+void loadmonitor_reset(void);
+void loadmonitor_process(uint32_t tick);
+
+uint32_t loadmonitor_getAverage(const LoadMonitorStatTypeDef *stat);
+size_t loadmonitor_getHistogram(uint8_t *data, size_t size);
+
+#endif /* LOAD_MONITOR_H */
@@ -0,0 +1,409 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#include "hal/HAL.h"
+#include "boards/Board.h"
+#include "ParameterStore.h"
+
+// Log structured parameter storage in the on-chip flash.
+//
+// Each flash block starts with a header { magic, generation } followed by records { key, value, crc }.
+// A store appends a record, the newest record of a key is the valid one. When the active block is full,
+// the newest record of every key gets copied into the next block (round robin over all blocks, which
+// spreads the erase cycles), followed by its header. Only then the old block gets erased.
+// A reset during any of these steps leaves either the old or the new block as the newest valid one.
+//
+// Records get written key first and CRC last, so an interrupted write is detected by the CRC.
+//
+// Erasing a block stalls the CPU for up to a second, so it never happens on a TMCL command.
+// Blocks no longer in use are queued and erased by paramstore_process() from the main loop.
+// A compaction or clear needs the following block erased, until then the store answers
+// TMC_ERROR_NOT_DONE.
+
+#define PARAMSTORE_MAGIC  0x50535431 // "PST1"
+
+#define HEADER_SIZE       8
+#define RECORD_SIZE       12
+#define ERASED            0xFFFFFFFF
+
+#define KEY(scope, id, type, motor)  (((uint32_t) (scope) << 24) | ((uint32_t) (id) << 16) | ((uint32_t) (type) << 8) | (motor))
+#define KEY_OWNER(scope, id)         (((uint32_t) (scope) << 8) | (id))
+
+static const volatile uint32_t *blockMemory(uint8_t block);
+static bool isBlank(uint8_t block);
+static bool readHeader(uint8_t block, uint32_t *generation);
+static bool format(uint8_t block, uint32_t generation);
+static uint32_t recordCRC(uint32_t key, uint32_t value);
+static bool recordValid(const volatile uint32_t *record);
+static bool findNewest(uint32_t key, int32_t *value);
+static bool writeRecord(uint8_t block, uint32_t offset, uint32_t key, uint32_t value);
+static bool compact(void);
+static uint8_t spareBlock(void);
+static bool spareReady(void);
+
+ParameterStoreTypeDef ParameterStore =
+{
+	.block        = 0,
+	.generation   = 0,
+	.writeOffset  = 0,
+	.compactions  = 0,
+	.corrupted    = 0,
+};
+
+static uint32_t eraseRequests = 0; // one bit per block to be erased by paramstore_process()
+static uint32_t restoreKeys[PARAMSTORE_RESTORE_MAX];
+static int32_t restoreValues[PARAMSTORE_RESTORE_MAX];
+
+void paramstore_init(void)
+{
+	uint32_t generation;
+	bool found = false;
+
+	// The newest valid block is the active one
+	for(uint8_t block = 0; block < HAL.Flash->blocks; block++)
+	{
+		if(!readHeader(block, &generation))
+			continue;
+
+		if(!found || generation > ParameterStore.generation)
+		{
+			ParameterStore.block       = block;
+			ParameterStore.generation  = generation;
+			found = true;
+		}
+	}
+
+	// Older valid blocks are left over from an interrupted compaction
+	for(uint8_t block = 0; block < HAL.Flash->blocks; block++)
+	{
+		if((!found || (block != ParameterStore.block)) && !isBlank(block))
+			eraseRequests |= 1 << block;
+	}
+
+	if(!found)
+	{
+		// First use: the store can not start without an erased block
+		if(!isBlank(0))
+			HAL.Flash->erase(0);
+
+		eraseRequests &= ~(1 << 0);
+		format(0, 1);
+		return;
+	}
+
+	// Find the end of the log. Corrupted records stay part of it, their slot is used up.
+	const volatile uint32_t *memory = blockMemory(ParameterStore.block);
+	ParameterStore.writeOffset = HEADER_SIZE;
+	while(ParameterStore.writeOffset + RECORD_SIZE <= HAL.Flash->blockSize)
+	{
+		const volatile uint32_t *record = &memory[ParameterStore.writeOffset / 4];
+
+		if(record[0] == ERASED)
+			break;
+
+		if(!recordValid(record))
+			ParameterStore.corrupted++;
+
+		ParameterStore.writeOffset += RECORD_SIZE;
+	}
+}
+
+uint32_t paramstore_store(uint8_t scope, uint8_t id, uint8_t type, uint8_t motor, int32_t value)
+{
+	uint32_t key = KEY(scope, id, type, motor);
+	int32_t stored;
+
+	// Storing an unchanged value costs no flash write
+	if(findNewest(key, &stored) && (stored == value))
+		return TMC_ERROR_NONE;
+
+	if(ParameterStore.writeOffset + RECORD_SIZE > HAL.Flash->blockSize)
+	{
+		if(!spareReady())
+			return TMC_ERROR_NOT_DONE;
+
+		if(!compact())
+			return TMC_ERROR_CHIP;
+
+		if(ParameterStore.writeOffset + RECORD_SIZE > HAL.Flash->blockSize)
+			return TMC_ERROR_CHIP;
+	}
+
+	// The slot is used up even if writing fails
+	uint32_t offset = ParameterStore.writeOffset;
+	ParameterStore.writeOffset += RECORD_SIZE;
+
+	return writeRecord(ParameterStore.block, offset, key, value) ? TMC_ERROR_NONE : TMC_ERROR_CHIP;
+}
+
+uint32_t paramstore_load(uint8_t scope, uint8_t id, uint8_t type, uint8_t motor, int32_t *value)
+{
+	return findNewest(KEY(scope, id, type, motor), value) ? TMC_ERROR_NONE : TMC_ERROR_VALUE;
+}
+
+// Drop all stored parameters. Continues with the next block to keep the wear balanced.
+uint32_t paramstore_clear(void)
+{
+	uint8_t block = spareBlock();
+
+	if(!spareReady())
+		return TMC_ERROR_NOT_DONE;
+
+	if(!format(block, ParameterStore.generation + 1))
+		return TMC_ERROR_CHIP;
+
+	for(uint8_t i = 0; i < HAL.Flash->blocks; i++)
+	{
+		if(i != block)
+			eraseRequests |= 1 << i;
+	}
+
+	return TMC_ERROR_NONE;
+}
+
+bool paramstore_erasePending(void)
+{
+	return eraseRequests != 0;
+}
+
+// Erase one of the queued blocks. The caller makes sure nothing suffers from the stall.
+void paramstore_process(void)
+{
+	for(uint8_t block = 0; block < HAL.Flash->blocks; block++)
+	{
+		if(!(eraseRequests & (1 << block)))
+			continue;
+
+		if(!isBlank(block))
+			HAL.Flash->erase(block);
+
+		eraseRequests &= ~(1 << block);
+		return;
+	}
+}
+
+bool paramstore_hasRecords(uint8_t scope, uint8_t id)
+{
+	const volatile uint32_t *memory = blockMemory(ParameterStore.block);
+
+	for(uint32_t offset = HEADER_SIZE; offset < ParameterStore.writeOffset; offset += RECORD_SIZE)
+	{
+		const volatile uint32_t *record = &memory[offset / 4];
+
+		if(((record[0] >> 16) == KEY_OWNER(scope, id)) && recordValid(record))
+			return true;
+	}
+
+	return false;
+}
+
+// Apply the newest value of every parameter stored for the given board with its SAP function.
+// Returns the number of parameters accepted by SAP.
+uint32_t paramstore_restore(uint8_t scope, uint8_t id, uint32_t (*SAP)(uint8_t type, uint8_t motor, int32_t value))
+{
+	const volatile uint32_t *memory = blockMemory(ParameterStore.block);
+	uint32_t count = 0;
+	uint32_t restored = 0;
+
+	// Walk the log backwards, the first record seen of each key is the newest one
+	for(uint32_t offset = ParameterStore.writeOffset; (offset > HEADER_SIZE) && (count < PARAMSTORE_RESTORE_MAX);)
+	{
+		offset -= RECORD_SIZE;
+		const volatile uint32_t *record = &memory[offset / 4];
+		uint32_t key = record[0];
+
+		if(((key >> 16) != KEY_OWNER(scope, id)) || !recordValid(record))
+			continue;
+
+		uint32_t i;
+		for(i = 0; i < count; i++)
+			if(restoreKeys[i] == key)
+				break;
+
+		if(i < count)
+			continue;
+
+		restoreKeys[count]    = key;
+		restoreValues[count]  = record[1];
+		count++;
+	}
+
+	// Apply them in the order they were stored
+	while(count--)
+	{
+		if(SAP((restoreKeys[count] >> 8) & 0xFF, restoreKeys[count] & 0xFF, restoreValues[count]) == TMC_ERROR_NONE)
+			restored++;
+	}
+
+	return restored;
+}
+
+uint32_t paramstore_getFreeRecords(void)
+{
+	if(ParameterStore.writeOffset + RECORD_SIZE > HAL.Flash->blockSize)
+		return 0;
+
+	return (HAL.Flash->blockSize - ParameterStore.writeOffset) / RECORD_SIZE;
+}
+
+static const volatile uint32_t *blockMemory(uint8_t block)
+{
+	return &HAL.Flash->memory[block * (HAL.Flash->blockSize / 4)];
+}
+
+static bool isBlank(uint8_t block)
+{
+	const volatile uint32_t *memory = blockMemory(block);
+
+	for(uint32_t i = 0; i < HAL.Flash->blockSize / 4; i++)
+		if(memory[i] != ERASED)
+			return false;
+
+	return true;
+}
+
+static bool readHeader(uint8_t block, uint32_t *generation)
+{
+	const volatile uint32_t *memory = blockMemory(block);
+
+	if((memory[0] != PARAMSTORE_MAGIC) || (memory[1] == ERASED))
+		return false;
+
+	*generation = memory[1];
+	return true;
+}
+
+// Start an empty log in the given, erased block
+static bool format(uint8_t block, uint32_t generation)
+{
+	uint32_t offset = block * HAL.Flash->blockSize;
+	if(!HAL.Flash->program(offset + 4, generation) || !HAL.Flash->program(offset, PARAMSTORE_MAGIC))
+		return false;
+
+	ParameterStore.block        = block;
+	ParameterStore.generation   = generation;
+	ParameterStore.writeOffset  = HEADER_SIZE;
+
+	return true;
+}
+
+// CRC-32 (IEEE 802.3) of key and value
+static uint32_t recordCRC(uint32_t key, uint32_t value)
+{
+	uint32_t crc = 0xFFFFFFFF;
+	uint32_t words[2] = { key, value };
+
+	for(uint8_t i = 0; i < 2; i++)
+	{
+		for(uint8_t byte = 0; byte < 4; byte++)
+		{
+			crc ^= (words[i] >> (byte * 8)) & 0xFF;
+			for(uint8_t bit = 0; bit < 8; bit++)
+				crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+		}
+	}
+
+	return ~crc;
+}
+
+static bool recordValid(const volatile uint32_t *record)
+{
+	return (record[0] != ERASED) && (record[2] == recordCRC(record[0], record[1]));
+}
+
+static bool findNewest(uint32_t key, int32_t *value)
+{
+	const volatile uint32_t *memory = blockMemory(ParameterStore.block);
+
+	for(uint32_t offset = ParameterStore.writeOffset; offset > HEADER_SIZE;)
+	{
+		offset -= RECORD_SIZE;
+		const volatile uint32_t *record = &memory[offset / 4];
+
+		if((record[0] == key) && recordValid(record))
+		{
+			*value = record[1];
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool writeRecord(uint8_t block, uint32_t offset, uint32_t key, uint32_t value)
+{
+	offset += block * HAL.Flash->blockSize;
+
+	return HAL.Flash->program(offset, key)
+		&& HAL.Flash->program(offset + 4, value)
+		&& HAL.Flash->program(offset + 8, recordCRC(key, value));
+}
+
+static uint8_t spareBlock(void)
+{
+	return (ParameterStore.block + 1) % HAL.Flash->blocks;
+}
+
+// The spare block takes the next compaction or clear. If it is not erased yet, queue it.
+static bool spareReady(void)
+{
+	uint8_t spare = spareBlock();
+
+	if(eraseRequests & (1 << spare))
+		return false;
+
+	if(isBlank(spare))
+		return true;
+
+	eraseRequests |= 1 << spare;
+	return false;
+}
+
+// Copy the newest record of every key into the erased spare block and switch over to it
+static bool compact(void)
+{
+	uint8_t target = spareBlock();
+	const volatile uint32_t *source = blockMemory(ParameterStore.block);
+	const volatile uint32_t *destination = blockMemory(target);
+	uint32_t writeOffset = HEADER_SIZE;
+
+	// Walking backwards, a key already present in the target has been superseded
+	for(uint32_t offset = ParameterStore.writeOffset; offset > HEADER_SIZE;)
+	{
+		offset -= RECORD_SIZE;
+		const volatile uint32_t *record = &source[offset / 4];
+
+		if(!recordValid(record))
+			continue;
+
+		uint32_t copied;
+		for(copied = HEADER_SIZE; copied < writeOffset; copied += RECORD_SIZE)
+			if(destination[copied / 4] == record[0])
+				break;
+
+		if(copied < writeOffset)
+			continue;
+
+		if(!writeRecord(target, writeOffset, record[0], record[1]))
+			return false;
+
+		writeOffset += RECORD_SIZE;
+	}
+
+	// The header validates the new block, the magic number gets written last
+	uint32_t offset = target * HAL.Flash->blockSize;
+	if(!HAL.Flash->program(offset + 4, ParameterStore.generation + 1) || !HAL.Flash->program(offset, PARAMSTORE_MAGIC))
+		return false;
+
+	eraseRequests |= 1 << ParameterStore.block;
+
+	ParameterStore.block        = target;
+	ParameterStore.generation  += 1;
+	ParameterStore.writeOffset  = writeOffset;
+	ParameterStore.compactions++;
+
+	return true;
+}
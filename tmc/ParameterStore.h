@@ -0,0 +1,46 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#ifndef PARAMETER_STORE_H_
+#define PARAMETER_STORE_H_
+
+#include "tmc/helpers/API_Header.h"
+
+// Parameter scopes. Axis parameters are stored per board ID, so they only get restored to the same board type.
+#define PARAMSTORE_SCOPE_CH1       1
+#define PARAMSTORE_SCOPE_CH2       2
+#define PARAMSTORE_SCOPE_GLOBAL    3
+#define PARAMSTORE_SCOPE_EVENTLOG  4  // Event log entries saved after a fault
+
+// Maximum number of parameters restored per board
+#define PARAMSTORE_RESTORE_MAX   64
+
+typedef struct
+{
+	uint8_t   block;         // flash block holding the log
+	uint32_t  generation;    // incremented on every compaction, the newest valid block is the active one
+	uint32_t  writeOffset;   // byte offset of the next free record within the block
+	uint32_t  compactions;   // since boot
+	uint32_t  corrupted;     // records skipped because of a CRC mismatch
+} ParameterStoreTypeDef;
+
+extern ParameterStoreTypeDef ParameterStore;
+
+void paramstore_init(void);
+
+uint32_t paramstore_store(uint8_t scope, uint8_t id, uint8_t type, uint8_t motor, int32_t value);
+uint32_t paramstore_load(uint8_t scope, uint8_t id, uint8_t type, uint8_t motor, int32_t *value);
+uint32_t paramstore_clear(void);
+
+// Blocks freed by a compaction or clear get erased from the main loop
+bool paramstore_erasePending(void);
+void paramstore_process(void);
+
+bool paramstore_hasRecords(uint8_t scope, uint8_t id);
+uint32_t paramstore_restore(uint8_t scope, uint8_t id, uint32_t (*SAP)(uint8_t type, uint8_t motor, int32_t value));
+uint32_t paramstore_getFreeRecords(void);
+
+#endif /* PARAMETER_STORE_H_ */
@@ -0,0 +1,108 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+/*
+ * Lightweight firmware profiling.
+ *
+ * Probes measure the execution time of a code section with the DWT cycle
+ * counter. For each probe the minimum, maximum and average time as well as the
+ * number of measurements is kept. Additionally the CPU share of each probe
+ * (e.g. the interrupt load of the StepDir ISR) and the main loop frequency get
+ * calculated over a window of PROFILER_WINDOW milliseconds.
+ */
+
+#include "Profiler.h"
+
+ProfilerTypeDef Profiler;
+
+const char *profiler_probeNames[PROFILER_PROBE_COUNT] =
+{
+	"TMCL command",
+	"GAP",
+	"SPI transaction",
+	"StepDir ISR"
+};
+
+void profiler_stop(ProfilerProbe probe, uint32_t start)
+{
+	uint32_t cycles = systick_getCycleCount() - start;
+	ProfilerProbeTypeDef *p = &Profiler.probes[probe];
+
+	if(p->count == 0 || cycles < p->minCycles)
+		p->minCycles = cycles;
+
+	if(cycles > p->maxCycles)
+		p->maxCycles = cycles;
+
+	p->count++;
+	p->totalCycles   += cycles;
+	p->windowCycles  += cycles;
+}
+
+// Called once per main loop pass
+void profiler_process(uint32_t tick)
+{
+	static uint32_t windowStartTick = 0;
+	static uint32_t windowStartCycles = 0;
+
+	Profiler.loopCount++;
+
+	uint32_t elapsedTicks = tick - windowStartTick;
+	if(elapsedTicks < PROFILER_WINDOW)
+		return;
+
+	uint32_t cycles = systick_getCycleCount();
+	uint32_t elapsedCycles = cycles - windowStartCycles;
+
+	for(uint8_t i = 0; i < PROFILER_PROBE_COUNT; i++)
+	{
+		// An interrupt probe firing between reading and clearing is lost for the load value - good enough here
+		uint32_t windowCycles = Profiler.probes[i].windowCycles;
+		Profiler.probes[i].windowCycles = 0;
+
+		Profiler.probes[i].load = ((uint64_t) windowCycles * 10000) / elapsedCycles;
+	}
+
+	Profiler.loopFrequency  = (Profiler.loopCount * 1000) / elapsedTicks;
+	Profiler.loopCount      = 0;
+
+	windowStartTick    = tick;
+	windowStartCycles  = cycles;
+}
+
+void profiler_reset(ProfilerProbe probe)
+{
+	Profiler.probes[probe].count        = 0;
+	Profiler.probes[probe].minCycles    = 0;
+	Profiler.probes[probe].maxCycles    = 0;
+	Profiler.probes[probe].totalCycles  = 0;
+}
+
+static uint32_t cyclesToNanoseconds(uint64_t cycles)
+{
+	return (cycles * 1000) / SYSTICK_CYCLES_PER_MICROSECOND;
+}
+
+// Minimum execution time in [ns]
+uint32_t profiler_getMinTime(ProfilerProbe probe)
+{
+	return cyclesToNanoseconds(Profiler.probes[probe].minCycles);
+}
+
+// Maximum execution time in [ns]
+uint32_t profiler_getMaxTime(ProfilerProbe probe)
+{
+	return cyclesToNanoseconds(Profiler.probes[probe].maxCycles);
+}
+
+// Average execution time in [ns]
+uint32_t profiler_getAverageTime(ProfilerProbe probe)
+{
+	if(Profiler.probes[probe].count == 0)
+		return 0;
+
+	return cyclesToNanoseconds(Profiler.probes[probe].totalCycles / Profiler.probes[probe].count);
+}
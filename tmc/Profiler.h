@@ -0,0 +1,64 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "tmc/helpers/API_Header.h"
+#include "hal/SysTick.h"
+
+// Measurement window for the load and main loop frequency values in [ms]
+#define PROFILER_WINDOW  1000
+
+typedef enum {
+	PROFILER_PROBE_TMCL_COMMAND,  // ExecuteActualCommand()
+	PROFILER_PROBE_GAP,           // GAP of the evalboards
+	PROFILER_PROBE_SPI,           // SPI transaction, from the first byte until CSN gets released
+	PROFILER_PROBE_STEPDIR_ISR,   // StepDir timer interrupt
+
+	PROFILER_PROBE_COUNT
+} ProfilerProbe;
+
+typedef struct
+{
+	uint32_t  count;          // number of measurements since the last reset
+	uint32_t  minCycles;
+	uint32_t  maxCycles;
+	uint64_t  totalCycles;
+	uint32_t  windowCycles;   // cycles spent in the probe during the current measurement window
+	uint32_t  load;           // share of the CPU time during the last measurement window in [0.01%]
+} ProfilerProbeTypeDef;
+
+typedef struct
+{
+	ProfilerProbeTypeDef  probes[PROFILER_PROBE_COUNT];
+	uint32_t              loopCount;      // main loop passes in the current measurement window
+	uint32_t              loopFrequency;  // main loop passes per second during the last measurement window
+} ProfilerTypeDef;
+
+extern ProfilerTypeDef Profiler;
+
+extern const char *profiler_probeNames[PROFILER_PROBE_COUNT];
+
+// Probes are used as:
+//     uint32_t start = profiler_start();
+//     <measured code>
+//     profiler_stop(PROFILER_PROBE_x, start);
+// Each probe must only be used from one context (either main loop or a single interrupt).
+static inline uint32_t profiler_start(void)
+{
+	return systick_getCycleCount();
+}
+
+void profiler_stop(ProfilerProbe probe, uint32_t start);
+void profiler_process(uint32_t tick);
+void profiler_reset(ProfilerProbe probe);
+
+uint32_t profiler_getMinTime(ProfilerProbe probe);
+uint32_t profiler_getMaxTime(ProfilerProbe probe);
+uint32_t profiler_getAverageTime(ProfilerProbe probe);
+
+#endif /* PROFILER_H */
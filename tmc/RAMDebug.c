@@ -19,7 +19,9 @@
 
 // Debug parameters
 #define RAMDEBUG_MAX_CHANNELS     4
-#define RAMDEBUG_BUFFER_SIZE      32768
+#ifndef RAMDEBUG_BUFFER_SIZE
+#define RAMDEBUG_BUFFER_SIZE      32768 // can be set by the build, see Makefile
+#endif
 #define RAMDEBUG_BUFFER_ELEMENTS  (RAMDEBUG_BUFFER_SIZE / 4)
 
 bool captureEnabled = false;
@@ -39,6 +41,7 @@ static bool next_process = false;
 
 // Sampling options
 static uint32_t prescaler   = 1;
+static uint32_t decimation  = 1;
 static uint32_t frequency	= RAMDEBUG_FREQUENCY;
 static uint32_t sampleCount = RAMDEBUG_BUFFER_ELEMENTS;
 static uint32_t sampleCountPre = 0;
@@ -61,12 +64,36 @@ typedef struct {
 
 Trigger trigger;
 
+// Decimation: Average this many samples per channel into one buffer entry. Register
+// channels hold raw words with packed fields, these keep the last sample instead.
+static uint32_t decimationCount = 0;
+static int64_t decimationSum[RAMDEBUG_MAX_CHANNELS];
+
+// Board specific burst read of the register channels
+static RAMDebugBurstRead burstRead = NULL;
+static uint8_t burstEvalChannel = 0;
+
+// Capture configuration kept by debug_saveConfig() while a module uses the capture itself
+static struct
+{
+	Channel   channels[RAMDEBUG_MAX_CHANNELS];
+	Trigger   trigger;
+	uint32_t  prescaler;
+	uint32_t  decimation;
+	uint32_t  sampleCount;
+	uint32_t  sampleCountPre;
+	bool      globalEnable;
+} savedConfig;
+
 // Store whether the last sampling point was above or below the trigger threshold
 static bool wasAboveSigned   = 0;
 static bool wasAboveUnsigned = 0;
 
 // Function declarations
 static uint32_t readChannel(Channel channel);
+static void readChannels(uint32_t *samples);
+static void resetDecimation(void);
+static bool isAveraged(Channel channel);
 
 // === Capture and trigger logic ===============================================
 
@@ -149,6 +176,29 @@ void handleTriggering()
 void handleDebugging()
 {
 	int32_t i;
+	uint32_t samples[RAMDEBUG_MAX_CHANNELS];
+
+	// Waiting for the trigger without pretrigger samples: Nothing gets stored,
+	// handleTriggering() already read the trigger channel
+	if ((state == RAMDEBUG_TRIGGER) && (sampleCountPre == 0))
+		return;
+
+	readChannels(samples);
+
+	if (decimation > 1)
+	{
+		for (i = 0; i < RAMDEBUG_MAX_CHANNELS; i++)
+			decimationSum[i] += (int32_t) samples[i];
+
+		if (++decimationCount < decimation)
+			return;
+
+		for (i = 0; i < RAMDEBUG_MAX_CHANNELS; i++)
+			if (isAveraged(channels[i]))
+				samples[i] = decimationSum[i] / (int32_t) decimation;
+
+		resetDecimation();
+	}
 
 	for (i = 0; i < RAMDEBUG_MAX_CHANNELS; i++)
 	{
@@ -158,7 +208,7 @@ void handleDebugging()
         if(state == RAMDEBUG_CAPTURE)
         {
             // Add the sample value to the buffer
-            debug_buffer[debug_write_index++] = readChannel(channels[i]);
+            debug_buffer[debug_write_index++] = samples[i];
 
             if (debug_write_index >= sampleCount)
             {
@@ -170,7 +220,7 @@ void handleDebugging()
         }
         else if((state != RAMDEBUG_COMPLETE) && (sampleCountPre > 0))
         {
-            debug_buffer[pre_index] = readChannel(channels[i]);
+            debug_buffer[pre_index] = samples[i];
             pre_index = (pre_index + 1) % sampleCountPre;
         }
 	}
@@ -279,6 +329,11 @@ static inline uint32_t readChannel(Channel channel)
 		case 6:
 			sample = *HAL.ADCs->VM;
 			break;
+		default:
+			// Filtered values, same indices as in TMCL.c GetInput()
+			if(channel.address >= 10 && channel.address < 10 + ADC_INPUT_COUNT)
+				sample = HAL.ADCs->statistics[channel.address - 10].filtered;
+			break;
 		}
 		break;
 	default:
@@ -289,6 +344,70 @@ static inline uint32_t readChannel(Channel channel)
 	return sample;
 }
 
+// Read one sample of all enabled channels. Register channels of the board
+// with a burst read function get read together in one go.
+static void readChannels(uint32_t *samples)
+{
+	uint8_t types[RAMDEBUG_MAX_CHANNELS];
+	uint32_t addresses[RAMDEBUG_MAX_CHANNELS];
+	uint32_t burstSamples[RAMDEBUG_MAX_CHANNELS];
+	uint8_t burstIndex[RAMDEBUG_MAX_CHANNELS];
+	uint8_t count = 0;
+
+	for (uint8_t i = 0; i < RAMDEBUG_MAX_CHANNELS; i++)
+	{
+		samples[i] = 0;
+
+		if (channels[i].type == CAPTURE_DISABLED)
+			continue;
+
+		if (burstRead
+		&& ((channels[i].type == CAPTURE_REGISTER) || (channels[i].type == CAPTURE_STACKED_REGISTER))
+		&& (channels[i].eval_channel == burstEvalChannel))
+		{
+			types[count]      = channels[i].type;
+			addresses[count]  = channels[i].address;
+			burstIndex[count] = i;
+			count++;
+		}
+		else
+		{
+			samples[i] = readChannel(channels[i]);
+		}
+	}
+
+	if (count == 0)
+		return;
+
+	burstRead(types, addresses, burstSamples, count);
+
+	for (uint8_t i = 0; i < count; i++)
+		samples[burstIndex[i]] = burstSamples[i];
+}
+
+// Parameters and analog inputs are plain numbers and can be averaged. Register words
+// may pack several fields or unsigned values, averaging them mixes the fields up.
+static bool isAveraged(Channel channel)
+{
+	switch (channel.type)
+	{
+	case CAPTURE_PARAMETER:
+	case CAPTURE_ANALOG_INPUT:
+	case CAPTURE_SYSTICK:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static void resetDecimation(void)
+{
+	decimationCount = 0;
+
+	for (uint8_t i = 0; i < RAMDEBUG_MAX_CHANNELS; i++)
+		decimationSum[i] = 0;
+}
+
 // === Interfacing with the debugger ===========================================
 void debug_init()
 {
@@ -310,6 +429,8 @@ void debug_init()
 
 	// Set default values for the capture configuration
 	prescaler   = 1;
+	decimation  = 1;
+	resetDecimation();
 	sampleCount = RAMDEBUG_BUFFER_ELEMENTS;
     sampleCountPre = 0;
 
@@ -330,6 +451,40 @@ void debug_init()
 	global_enable = true;
 }
 
+// Keep the capture configuration of the host while the firmware uses the capture
+// itself (e.g. the TMC4671 autotuning). The captured samples are not kept.
+void debug_saveConfig(void)
+{
+	memcpy(savedConfig.channels, channels, sizeof(channels));
+	savedConfig.trigger         = trigger;
+	savedConfig.prescaler       = prescaler;
+	savedConfig.decimation      = decimation;
+	savedConfig.sampleCount     = sampleCount;
+	savedConfig.sampleCountPre  = sampleCountPre;
+	savedConfig.globalEnable    = global_enable;
+}
+
+// Put back the configuration saved with debug_saveConfig(). The capture is left
+// idle, the host has to enable the trigger again.
+void debug_restoreConfig(void)
+{
+	captureEnabled = false;
+	state = RAMDEBUG_IDLE;
+
+	memcpy(channels, savedConfig.channels, sizeof(channels));
+	trigger         = savedConfig.trigger;
+	prescaler       = savedConfig.prescaler;
+	decimation      = savedConfig.decimation;
+	sampleCount     = savedConfig.sampleCount;
+	sampleCountPre  = savedConfig.sampleCountPre;
+	global_enable   = savedConfig.globalEnable;
+	resetDecimation();
+
+	debug_read_index   = 0;
+	debug_write_index  = sampleCountPre;
+	pre_index          = 0;
+}
+
 bool debug_setChannel(uint8_t type, uint32_t channel_value)
 {
 	return (
@@ -523,6 +678,9 @@ int32_t debug_enableTrigger(uint8_t type, uint32_t threshold)
 	wasAboveSigned   = (int32_t)  triggerValue > (int32_t)  trigger.threshold;
 	wasAboveUnsigned = (uint32_t) triggerValue > (uint32_t) trigger.threshold;
 
+	// Start averaging from a clean state
+	resetDecimation();
+
 	// Enable the trigger
 	state = RAMDEBUG_TRIGGER;
 
@@ -537,6 +695,16 @@ void debug_setPrescaler(uint32_t divider)
 	prescaler = divider;
 }
 
+// Average [factor] consecutive samples into one buffer entry. Unlike the
+// prescaler, which drops samples, this low-pass filters the signal. Values
+// are averaged as signed 32 bit numbers, so registers packing two fields
+// should be captured with the prescaler instead.
+void debug_setDecimation(uint32_t factor)
+{
+	decimation = (factor > 0) ? factor : 1;
+	resetDecimation();
+}
+
 void debug_setSampleCount(uint32_t count)
 {
 	if (count > RAMDEBUG_BUFFER_ELEMENTS)
@@ -608,6 +776,9 @@ int32_t debug_getInfo(uint32_t type)
 	case 3:
 		return debug_write_index;
 		break;
+	case 4:
+		return decimation;
+		break;
 	default:
 		break;
 	}
@@ -629,3 +800,11 @@ void debug_setGlobalEnable(bool enable)
 {
 	global_enable = enable;
 }
+
+// Boards register a burst read for their register channels here and clear it
+// with NULL on deinit.
+void debug_setBurstRead(uint8_t eval_channel, RAMDebugBurstRead function)
+{
+	burstEvalChannel = eval_channel;
+	burstRead = function;
+}
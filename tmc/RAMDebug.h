@@ -50,8 +50,15 @@ typedef enum {
 	TRIGGER_END
 } RAMDebugTrigger;
 
+// Optional board hook that reads all register channels of one sample in a
+// single SPI burst. The addresses use the encoding of CAPTURE_REGISTER and
+// CAPTURE_STACKED_REGISTER channels.
+typedef void (*RAMDebugBurstRead)(const uint8_t *types, const uint32_t *addresses, uint32_t *samples, uint8_t count);
+
 void debug_init();
 void debug_process();
+void debug_saveConfig(void);
+void debug_restoreConfig(void);
 bool debug_setChannel(uint8_t type, uint32_t channel_value);
 bool debug_setTriggerChannel(uint8_t type, uint32_t channel_value);
 bool debug_setType(uint8_t type);
@@ -67,6 +74,7 @@ void debug_setTriggerMaskShift(uint32_t mask, uint8_t shift);
 int32_t debug_enableTrigger(uint8_t type, uint32_t threshold);
 
 void debug_setPrescaler(uint32_t divider);
+void debug_setDecimation(uint32_t factor);
 void debug_setSampleCount(uint32_t count);
 uint32_t debug_getSampleCount();
 void debug_setPretriggerSampleCount(uint32_t count);
@@ -80,5 +88,6 @@ int32_t debug_getInfo(uint32_t type);
 void debug_useNextProcess(bool enable);
 void debug_nextProcess(void);
 void debug_setGlobalEnable(bool enable);
+void debug_setBurstRead(uint8_t eval_channel, RAMDebugBurstRead burstRead);
 
 #endif /* RAMDEBUG_H */
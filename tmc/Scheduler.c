@@ -0,0 +1,148 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+/*
+ * Cooperative scheduler for the main loop.
+ *
+ * Every subsystem registers a task with a period and a priority. Each call of
+ * scheduler_run() is one main loop pass: all due tasks are run, ordered by
+ * priority. Execution times are measured with the DWT cycle counter.
+ *
+ * If a loop budget is set and a pass already took longer than that budget, due
+ * tasks of normal and low priority are deferred to the next pass. A deferred
+ * task is never deferred twice in a row, so heavy high priority tasks can not
+ * starve the rest of the system.
+ */
+
+#include "Scheduler.h"
+
+#include "hal/HAL.h"
+
+SchedulerTypeDef Scheduler =
+{
+	.taskCount   = 0,
+	.loopBudget  = 0
+};
+
+int32_t scheduler_addTask(SchedulerTaskFunc run, uint32_t period, uint32_t deadline, SchedulerPriority priority)
+{
+	if(Scheduler.taskCount >= SCHEDULER_MAX_TASKS)
+		return -1;
+
+	SchedulerTaskTypeDef *task = &Scheduler.tasks[Scheduler.taskCount];
+
+	task->run       = run;
+	task->period    = period;
+	task->deadline  = deadline;
+	task->priority  = priority;
+	task->deferred  = 0;
+	task->lastRun   = systick_getTick();
+
+	return Scheduler.taskCount++;
+}
+
+static void runTask(SchedulerTaskTypeDef *task, uint32_t tick)
+{
+	uint32_t start = systick_getCycleCount();
+	task->run(tick);
+	uint32_t cycles = systick_getCycleCount() - start;
+
+	task->lastRun  = tick;
+	task->deferred = 0;
+	task->runs++;
+	task->totalCycles += cycles;
+
+	if(cycles > task->maxCycles)
+		task->maxCycles = cycles;
+
+	if(task->deadline && (cycles / SYSTICK_CYCLES_PER_MICROSECOND) > task->deadline)
+		task->deadlineMisses++;
+}
+
+void scheduler_run()
+{
+	uint32_t passStart = systick_getCycleCount();
+	uint32_t budget = Scheduler.loopBudget * SYSTICK_CYCLES_PER_MICROSECOND;
+
+	for(uint8_t priority = SCHEDULER_PRIORITY_HIGH; priority <= SCHEDULER_PRIORITY_LOW; priority++)
+	{
+		for(uint8_t i = 0; i < Scheduler.taskCount; i++)
+		{
+			SchedulerTaskTypeDef *task = &Scheduler.tasks[i];
+			if(task->priority != priority)
+				continue;
+
+			uint32_t tick = systick_getTick();
+			if(task->period && (tick - task->lastRun) < task->period)
+				continue;
+
+			if(budget && priority != SCHEDULER_PRIORITY_HIGH && !task->deferred
+					&& (systick_getCycleCount() - passStart) > budget)
+			{
+				task->deferred = 1;
+				continue;
+			}
+
+			runTask(task, tick);
+		}
+	}
+
+	uint32_t passCycles = systick_getCycleCount() - passStart;
+
+	Scheduler.loopPasses++;
+	Scheduler.loopTotalCycles += passCycles;
+
+	if(passCycles > Scheduler.loopMaxCycles)
+		Scheduler.loopMaxCycles = passCycles;
+}
+
+void scheduler_resetStatistics()
+{
+	for(uint8_t i = 0; i < Scheduler.taskCount; i++)
+	{
+		Scheduler.tasks[i].runs            = 0;
+		Scheduler.tasks[i].deadlineMisses  = 0;
+		Scheduler.tasks[i].maxCycles       = 0;
+		Scheduler.tasks[i].totalCycles     = 0;
+	}
+
+	Scheduler.loopPasses       = 0;
+	Scheduler.loopMaxCycles    = 0;
+	Scheduler.loopTotalCycles  = 0;
+}
+
+// Worst case execution time of a task in [µs]
+uint32_t scheduler_getTaskMaxTime(uint8_t index)
+{
+	if(index >= Scheduler.taskCount)
+		return 0;
+
+	return Scheduler.tasks[index].maxCycles / SYSTICK_CYCLES_PER_MICROSECOND;
+}
+
+// Average execution time of a task in [µs]
+uint32_t scheduler_getTaskAverageTime(uint8_t index)
+{
+	if(index >= Scheduler.taskCount || Scheduler.tasks[index].runs == 0)
+		return 0;
+
+	return (Scheduler.tasks[index].totalCycles / Scheduler.tasks[index].runs) / SYSTICK_CYCLES_PER_MICROSECOND;
+}
+
+// Worst case main loop pass time in [µs]
+uint32_t scheduler_getLoopMaxTime()
+{
+	return Scheduler.loopMaxCycles / SYSTICK_CYCLES_PER_MICROSECOND;
+}
+
+// Average main loop pass time in [µs]
+uint32_t scheduler_getLoopAverageTime()
+{
+	if(Scheduler.loopPasses == 0)
+		return 0;
+
+	return (Scheduler.loopTotalCycles / Scheduler.loopPasses) / SYSTICK_CYCLES_PER_MICROSECOND;
+}
@@ -0,0 +1,57 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "tmc/helpers/API_Header.h"
+
+#define SCHEDULER_MAX_TASKS  16 // main.c registers 12 tasks, scheduler_addTask() returns -1 when full
+
+typedef enum {
+	SCHEDULER_PRIORITY_HIGH,    // runs whenever due, even if the loop budget is exceeded
+	SCHEDULER_PRIORITY_NORMAL,
+	SCHEDULER_PRIORITY_LOW
+} SchedulerPriority;
+
+typedef void (*SchedulerTaskFunc)(uint32_t tick);
+
+typedef struct
+{
+	SchedulerTaskFunc  run;
+	uint8_t            priority;        // SchedulerPriority
+	uint8_t            deferred;        // task was due but postponed by the loop budget in the last pass
+	uint32_t           period;          // time between two runs in [ms], 0 means every loop pass
+	uint32_t           deadline;        // allowed execution time in [µs], 0 disables deadline checking
+	uint32_t           lastRun;         // systick of the last run
+	uint32_t           runs;            // number of runs since the last statistics reset
+	uint32_t           deadlineMisses;  // number of runs that took longer than the deadline
+	uint32_t           maxCycles;       // worst case execution time in CPU cycles
+	uint64_t           totalCycles;     // sum of all execution times in CPU cycles
+} SchedulerTaskTypeDef;
+
+typedef struct
+{
+	SchedulerTaskTypeDef  tasks[SCHEDULER_MAX_TASKS];
+	uint8_t               taskCount;
+	uint32_t              loopBudget;       // main loop pass time in [µs] after which non-high priority tasks get deferred, 0 disables
+	uint32_t              loopPasses;       // number of loop passes since the last statistics reset
+	uint32_t              loopMaxCycles;    // worst case loop pass time in CPU cycles
+	uint64_t              loopTotalCycles;  // sum of all loop pass times in CPU cycles
+} SchedulerTypeDef;
+
+extern SchedulerTypeDef Scheduler;
+
+int32_t scheduler_addTask(SchedulerTaskFunc run, uint32_t period, uint32_t deadline, SchedulerPriority priority);
+void scheduler_run();
+void scheduler_resetStatistics();
+
+uint32_t scheduler_getTaskMaxTime(uint8_t index);
+uint32_t scheduler_getTaskAverageTime(uint8_t index);
+uint32_t scheduler_getLoopMaxTime();
+uint32_t scheduler_getLoopAverageTime();
+
+#endif /* SCHEDULER_H */
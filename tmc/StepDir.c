@@ -79,6 +79,17 @@
  *   to any value.
  *   Position mode will start a new ramp towards the target after a stall.
  *
+ * Homing:
+ *   homingStart() runs a sensorless homing sequence using the stall detection
+ *   above: The channel drives towards the end stop with the homing velocity
+ *   until a stall is detected, moves away by the back-off distance, then
+ *   approaches the end stop again at the (lower) approach velocity. On the
+ *   second stall the actual position is set to zero. The sequence is advanced
+ *   by periodicJob(), so the stall reaction does not depend on the host.
+ *   The homing StallGuard threshold has to be reached by both velocities,
+ *   otherwise no stall can be detected. VMAX and the StallGuard threshold are
+ *   restored afterwards. A normal or emergency stop aborts the homing.
+ *
  * Emergency Stop:
  *   The stop function implements an emergency stop. This will result in the
  *   channel immediately stopping any movements. No parameters are updated to
@@ -125,6 +136,7 @@
 
 #include "StepDir.h"
 #include "hal/derivative.h"
+#include "Profiler.h"
 
 #if defined(Landungsbruecke) || defined(LandungsbrueckeSmall)
 	#define TIMER_INTERRUPT FTM1_IRQHandler
@@ -138,12 +150,38 @@
 // so this value is rather randomly chosen. Leaving it at zero means stall detection turned off.
 #define STALLGUARD_THRESHOLD 0
 
+// Homing reset values. These depend on the motor and mechanics as well and
+// should be adjusted before starting a homing run.
+#define HOMING_DEFAULT_VELOCITY           (-20000)
+#define HOMING_DEFAULT_APPROACH_VELOCITY  5000
+#define HOMING_DEFAULT_BACK_OFF           2000
+#define HOMING_DEFAULT_THRESHOLD          5000
+#define HOMING_DEFAULT_TIMEOUT            30000 // [ms]
+
+#define HOMING_ACTIVE(state) (((state) == HOMING_SEEK) || ((state) == HOMING_BACK_OFF) || ((state) == HOMING_APPROACH))
+
 StepDirectionTypedef StepDir[STEP_DIR_CHANNELS];
 
-IOPinTypeDef DummyPin = { .bitWeight = DUMMY_BITWEIGHT };
+// Placeholder for unassigned pins. The interrupt accesses pins without checks:
+// writes go to a scratch register, reads go to a real port and get masked to low.
+static volatile uint32_t dummyPinRegister;
+
+IOPinTypeDef DummyPin =
+{
+#if defined(Landungsbruecke) || defined(LandungsbrueckeSmall)
+	.GPIOBase          = PTA_BASE_PTR,
+#elif defined(LandungsbrueckeV3)
+	.port              = GPIOA,
+#endif
+	.setBitRegister    = &dummyPinRegister,
+	.resetBitRegister  = &dummyPinRegister,
+	.bitWeight         = DUMMY_BITWEIGHT
+};
 
 // Helper functions
 static int32_t calculateStepDifference(int32_t velocity, uint32_t oldAccel, uint32_t newAccel);
+static void homing(uint8_t channel);
+static void homingFinish(uint8_t channel, StepDirHomingState state);
 // These helper functions are for optimizing the interrupt without duplicating
 // logic for both interrupt and main loop. We save time in them by omitting
 // safety checks needed only for the main loop in these functions.
@@ -151,6 +189,7 @@ static int32_t calculateStepDifference(int32_t velocity, uint32_t oldAccel, uint
 // necessary safety checks.
 static inline void checkStallguard(StepDirectionTypedef *channel, bool stallSignalActive);
 static inline void stop(StepDirectionTypedef *channel, StepDirStop stopType);
+static inline void tick(void);
 
 void TIMER_INTERRUPT()
 {
@@ -162,6 +201,24 @@ void TIMER_INTERRUPT()
 	timer_interrupt_flag_clear(TIMER2, TIMER_INT_FLAG_UP);
 #endif
 
+	uint32_t start = profiler_start();
+
+	tick();
+
+	profiler_stop(PROFILER_PROBE_STEPDIR_ISR, start);
+}
+
+#if defined(LandungsbrueckeSim)
+// Runs the interrupt body once without the timer - used by the StepDir benchmark of the host simulation
+void StepDir_tick(void)
+{
+	tick();
+}
+#endif
+
+// Interrupt body: ramp calculation, StallGuard check, pin updates and acceleration sync for all channels
+static inline void tick(void)
+{
 	for (uint8_t ch = 0; ch < STEP_DIR_CHANNELS; ch++)
 	{
 		// Temporary variable for the current channel
@@ -172,18 +229,12 @@ void TIMER_INTERRUPT()
 			continue;
 
 		// Reset step output (falling edge of last pulse)
-
-		//*currCh->stepPin->resetBitRegister = currCh->stepPin->bitWeight;
-		HAL.IOs->config->setLow(currCh->stepPin);
+		io_setLow(currCh->stepPin);
 
 		// Check if StallGuard pin is high
 		// Note: If no stall pin is registered, isStallSignalHigh becomes FALSE
 		//       and checkStallguard won't do anything.
-#if defined(Landungsbruecke) || defined(LandungsbrueckeSmall)
-		bool isStallSignalHigh = (GPIO_PDIR_REG(currCh->stallGuardPin->GPIOBase) & currCh->stallGuardPin->bitWeight) != 0;
-#elif defined(LandungsbrueckeV3)
-		bool isStallSignalHigh = HAL.IOs->config->isHigh(currCh->stallGuardPin);
-#endif
+		bool isStallSignalHigh = io_isHigh(currCh->stallGuardPin);
 		checkStallguard(currCh, isStallSignalHigh);
 
 		// Compute ramp
@@ -197,7 +248,7 @@ void TIMER_INTERRUPT()
 		*((dx > 0) ? currCh->dirPin->resetBitRegister : currCh->dirPin->setBitRegister) = currCh->dirPin->bitWeight;
 
 		// Set step output (rising edge of step pulse)
-		*currCh->stepPin->setBitRegister = currCh->stepPin->bitWeight;
+		io_setHigh(currCh->stepPin);
 
 skipStep:
 		// Synchronised Acceleration update
@@ -262,10 +313,19 @@ void StepDir_periodicJob(uint8_t channel)
 	{
 		StepDir[channel].stallGuardActive = false;
 	}
+
+	homing(channel);
 }
 
 void StepDir_stop(uint8_t channel, StepDirStop stopType)
 {
+	if (channel >= STEP_DIR_CHANNELS)
+		return;
+
+	// Stall stops are part of the homing sequence, any other stop aborts it
+	if ((stopType != STOP_STALL) && HOMING_ACTIVE(StepDir[channel].homing.state))
+		homingFinish(channel, HOMING_IDLE);
+
 	stop(&StepDir[channel], stopType);
 }
 
@@ -567,6 +627,206 @@ int32_t StepDir_getMaxAcceleration(uint8_t channel)
 	return s32_MAX;
 }
 
+StepDirHomingState StepDir_getHomingState(uint8_t channel)
+{
+	if (channel >= STEP_DIR_CHANNELS)
+		return HOMING_IDLE;
+
+	return StepDir[channel].homing.state;
+}
+
+int32_t StepDir_getHomingVelocity(uint8_t channel)
+{
+	if (channel >= STEP_DIR_CHANNELS)
+		return -1;
+
+	return StepDir[channel].homing.velocity;
+}
+
+int32_t StepDir_getHomingApproachVelocity(uint8_t channel)
+{
+	if (channel >= STEP_DIR_CHANNELS)
+		return -1;
+
+	return StepDir[channel].homing.approachVelocity;
+}
+
+int32_t StepDir_getHomingBackOff(uint8_t channel)
+{
+	if (channel >= STEP_DIR_CHANNELS)
+		return -1;
+
+	return StepDir[channel].homing.backOff;
+}
+
+int32_t StepDir_getHomingStallGuardThreshold(uint8_t channel)
+{
+	if (channel >= STEP_DIR_CHANNELS)
+		return -1;
+
+	return StepDir[channel].homing.stallGuardThreshold;
+}
+
+uint32_t StepDir_getHomingTimeout(uint8_t channel)
+{
+	if (channel >= STEP_DIR_CHANNELS)
+		return 0;
+
+	return StepDir[channel].homing.timeout;
+}
+
+// ===== Homing =====
+uint32_t StepDir_homingStart(uint8_t channel)
+{
+	if (channel >= STEP_DIR_CHANNELS)
+		return TMC_ERROR_MOTOR;
+
+	StepDirHomingTypedef *homing = &StepDir[channel].homing;
+
+	// The channel needs to be initialised with pins assigned. A NULL step pin
+	// means StepDir_init() was never called by the current board.
+	if (!StepDir[channel].stepPin || (StepDir[channel].haltingCondition & (STATUS_EMERGENCY_STOP | STATUS_NO_STEP_PIN | STATUS_NO_DIR_PIN)))
+		return TMC_ERROR_FUNCTION;
+
+	// StallGuard has to become active at both velocities, otherwise the end stop is never detected
+	if ((homing->velocity == 0) || (homing->approachVelocity <= 0) || (homing->backOff < 0)
+	 || (homing->stallGuardThreshold <= 0)
+	 || (homing->stallGuardThreshold > homing->approachVelocity)
+	 || (homing->stallGuardThreshold > abs(homing->velocity)))
+		return TMC_ERROR_VALUE;
+
+	// Only save the settings when not restarting a running homing sequence
+	if (!HOMING_ACTIVE(homing->state))
+	{
+		homing->oldVelocityMax          = StepDir_getVelocityMax(channel);
+		homing->oldStallGuardThreshold  = StepDir[channel].stallGuardThreshold;
+	}
+
+	homing->startTick = systick_getTick();
+	homing->state     = HOMING_SEEK;
+
+	// Setting the threshold also clears any previous stall
+	StepDir_setStallGuardThreshold(channel, homing->stallGuardThreshold);
+	StepDir_rotate(channel, homing->velocity);
+
+	return TMC_ERROR_NONE;
+}
+
+void StepDir_homingStop(uint8_t channel)
+{
+	if (channel >= STEP_DIR_CHANNELS)
+		return;
+
+	if (HOMING_ACTIVE(StepDir[channel].homing.state))
+		homingFinish(channel, HOMING_IDLE);
+}
+
+void StepDir_setHomingVelocity(uint8_t channel, int32_t velocity)
+{
+	if (channel >= STEP_DIR_CHANNELS)
+		return;
+
+	StepDir[channel].homing.velocity = velocity;
+}
+
+void StepDir_setHomingApproachVelocity(uint8_t channel, int32_t velocity)
+{
+	if (channel >= STEP_DIR_CHANNELS)
+		return;
+
+	StepDir[channel].homing.approachVelocity = velocity;
+}
+
+void StepDir_setHomingBackOff(uint8_t channel, int32_t distance)
+{
+	if (channel >= STEP_DIR_CHANNELS)
+		return;
+
+	StepDir[channel].homing.backOff = distance;
+}
+
+void StepDir_setHomingStallGuardThreshold(uint8_t channel, int32_t threshold)
+{
+	if (channel >= STEP_DIR_CHANNELS)
+		return;
+
+	StepDir[channel].homing.stallGuardThreshold = threshold;
+}
+
+void StepDir_setHomingTimeout(uint8_t channel, uint32_t timeout)
+{
+	if (channel >= STEP_DIR_CHANNELS)
+		return;
+
+	StepDir[channel].homing.timeout = timeout;
+}
+
+// Advance the homing sequence of a channel. Called by periodicJob()
+static void homing(uint8_t channel)
+{
+	StepDirectionTypedef *currCh = &StepDir[channel];
+	StepDirHomingTypedef *homing = &currCh->homing;
+
+	if (!HOMING_ACTIVE(homing->state))
+		return;
+
+	if ((homing->timeout != 0) && ((systick_getTick() - homing->startTick) > homing->timeout))
+	{
+		homingFinish(channel, HOMING_FAILED);
+		return;
+	}
+
+	int32_t direction = (homing->velocity < 0) ? -1 : 1;
+
+	switch(homing->state)
+	{
+	case HOMING_SEEK:
+		if (currCh->haltingCondition & STATUS_STALLED)
+		{
+			// Disable StallGuard before clearing the stall - the stall signal
+			// is still present and would stop the back-off move immediately
+			currCh->stallGuardActive = false;
+			StepDir_setStallGuardThreshold(channel, 0);
+
+			StepDir_setVelocityMax(channel, abs(homing->velocity));
+			StepDir_moveTo(channel, StepDir_getActualPosition(channel) - direction * homing->backOff);
+			homing->state = HOMING_BACK_OFF;
+		}
+		break;
+	case HOMING_BACK_OFF:
+		if ((StepDir_getStatus(channel) & STATUS_TARGET_REACHED) && (StepDir_getActualVelocity(channel) == 0))
+		{
+			StepDir_setStallGuardThreshold(channel, homing->stallGuardThreshold);
+			StepDir_rotate(channel, direction * homing->approachVelocity);
+			homing->state = HOMING_APPROACH;
+		}
+		break;
+	case HOMING_APPROACH:
+		if (currCh->haltingCondition & STATUS_STALLED)
+		{
+			// The generator is halted in velocity mode, so the position can be changed directly
+			StepDir_setActualPosition(channel, 0);
+			homingFinish(channel, HOMING_DONE);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+// End the homing sequence: stop the motor and restore the previous settings
+static void homingFinish(uint8_t channel, StepDirHomingState state)
+{
+	StepDirHomingTypedef *homing = &StepDir[channel].homing;
+
+	homing->state = state;
+
+	stop(&StepDir[channel], STOP_NORMAL);
+	StepDir_setVelocityMax(channel, homing->oldVelocityMax);
+	// Restoring the threshold also clears the stall of the approach
+	StepDir_setStallGuardThreshold(channel, homing->oldStallGuardThreshold);
+}
+
 // ===================
 
 void StepDir_init(uint32_t precision)
@@ -593,6 +853,13 @@ void StepDir_init(uint32_t precision)
 
 		StepDir[i].stallGuardThreshold  = STALLGUARD_THRESHOLD;
 
+		StepDir[i].homing.state                = HOMING_IDLE;
+		StepDir[i].homing.velocity             = HOMING_DEFAULT_VELOCITY;
+		StepDir[i].homing.approachVelocity     = HOMING_DEFAULT_APPROACH_VELOCITY;
+		StepDir[i].homing.backOff              = HOMING_DEFAULT_BACK_OFF;
+		StepDir[i].homing.stallGuardThreshold  = HOMING_DEFAULT_THRESHOLD;
+		StepDir[i].homing.timeout              = HOMING_DEFAULT_TIMEOUT;
+
 		StepDir[i].mode                 = STEPDIR_INTERNAL;
 		StepDir[i].frequency            = precision;
 
@@ -644,6 +911,14 @@ void StepDir_init(uint32_t precision)
 
 void StepDir_deInit()
 {
+	// Drop any running homing sequence and keep homingStart() from
+	// driving the pins of a board that is no longer present
+	for (uint8_t i = 0; i < STEP_DIR_CHANNELS; i++)
+	{
+		StepDir[i].homing.state = HOMING_IDLE;
+		StepDir[i].haltingCondition |= STATUS_NO_STEP_PIN | STATUS_NO_DIR_PIN;
+	}
+
 	#if defined(Landungsbruecke) || defined(LandungsbrueckeSmall)
 		// Only disable the module if it has been enabled before
 		if (SIM_SCGC6 & SIM_SCGC6_FTM1_MASK)
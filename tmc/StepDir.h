@@ -41,6 +41,15 @@
 		SYNC_UPDATE_DATA          // Main code calculated an accelerationSteps difference which the interrupt needs to apply.
 	} StepDirSync;
 
+	typedef enum {
+		HOMING_IDLE,      // No homing run or aborted
+		HOMING_SEEK,      // Drive towards the end stop until StallGuard detects a stall
+		HOMING_BACK_OFF,  // Move away from the end stop by the back-off distance
+		HOMING_APPROACH,  // Drive towards the end stop again at the approach velocity
+		HOMING_DONE,      // End stop found, actual position set to zero
+		HOMING_FAILED     // No stall detected before the timeout
+	} StepDirHomingState;
+
 	// StepDir status bits
 	#define STATUS_EMERGENCY_STOP     0x01  // Halting condition - Emergency Off
 	#define STATUS_NO_STEP_PIN        0x02  // Halting condition - No pin set for Step output
@@ -50,6 +59,21 @@
 	#define STATUS_STALLGUARD_ACTIVE  0x20  // Stallguard status - Velocity threshold reached, Stallguard enabled
 	#define STATUS_MODE               0x40  // 0: Positioning mode, 1: Velocity mode
 
+	typedef struct
+	{
+		StepDirHomingState state;
+		// Parameters
+		int32_t       velocity;             // Seek velocity, the sign selects the homing direction
+		int32_t       approachVelocity;     // Slow approach velocity (magnitude)
+		int32_t       backOff;              // Distance to move away from the end stop before approaching
+		int32_t       stallGuardThreshold;  // StallGuard velocity threshold used during homing
+		uint32_t      timeout;              // [ms], 0 disables the timeout
+		// Values restored after homing
+		int32_t       oldVelocityMax;
+		int32_t       oldStallGuardThreshold;
+		uint32_t      startTick;
+	} StepDirHomingTypedef;
+
 	typedef struct
 	{	// Generic parameters
 		uint8_t       haltingCondition;
@@ -71,6 +95,8 @@
 		int32_t       stepDifference;
 		StepDirMode   mode;
 		uint32_t      frequency;
+		// StallGuard homing
+		StepDirHomingTypedef homing;
 
 		TMC_LinearRamp ramp;
 	} StepDirectionTypedef;
@@ -82,6 +108,8 @@
 	uint8_t StepDir_getStatus(uint8_t channel);
 	void StepDir_setPins(uint8_t channel, IOPinTypeDef *stepPin, IOPinTypeDef *dirPin, IOPinTypeDef *stallPin);
 	void StepDir_stallGuard(uint8_t channel, bool stall);
+	uint32_t StepDir_homingStart(uint8_t channel);
+	void StepDir_homingStop(uint8_t channel);
 
 	// ===== Setters =====
 	void StepDir_setActualPosition(uint8_t channel, int32_t actualPosition);
@@ -91,6 +119,11 @@
 	void StepDir_setMode(uint8_t channel, StepDirMode mode);
 	void StepDir_setFrequency(uint8_t channel, uint32_t frequency);
 	void StepDir_setPrecision(uint8_t channel, uint32_t precision);
+	void StepDir_setHomingVelocity(uint8_t channel, int32_t velocity);
+	void StepDir_setHomingApproachVelocity(uint8_t channel, int32_t velocity);
+	void StepDir_setHomingBackOff(uint8_t channel, int32_t distance);
+	void StepDir_setHomingStallGuardThreshold(uint8_t channel, int32_t threshold);
+	void StepDir_setHomingTimeout(uint8_t channel, uint32_t timeout);
 	// ===== Getters =====
 	int32_t StepDir_getActualPosition(uint8_t channel);
 	int32_t StepDir_getTargetPosition(uint8_t channel);
@@ -103,8 +136,18 @@
 	uint32_t StepDir_getFrequency(uint8_t channel);
 	uint32_t StepDir_getPrecision(uint8_t channel);
 	int32_t StepDir_getMaxAcceleration(uint8_t channel);
+	StepDirHomingState StepDir_getHomingState(uint8_t channel);
+	int32_t StepDir_getHomingVelocity(uint8_t channel);
+	int32_t StepDir_getHomingApproachVelocity(uint8_t channel);
+	int32_t StepDir_getHomingBackOff(uint8_t channel);
+	int32_t StepDir_getHomingStallGuardThreshold(uint8_t channel);
+	uint32_t StepDir_getHomingTimeout(uint8_t channel);
 
 	void StepDir_init(uint32_t precision);
 	void StepDir_deInit(void);
 
+#if defined(LandungsbrueckeSim)
+	void StepDir_tick(void);
+#endif
+
 #endif /* STEP_DIR_H_ */
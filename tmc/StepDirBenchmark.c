@@ -0,0 +1,406 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+/*
+ * StepDir interrupt microbenchmark and golden trace harness (host simulation only).
+ *
+ * The interrupt body is run tick by tick through StepDir_tick() against
+ * simulated step/dir registers and StallGuard inputs, while a fixed scenario
+ * repeatedly exercises position and velocity ramps, acceleration changes
+ * through the sync mechanism and stalls on both channels.
+ *
+ * The cycles of each tick are collected per execution path. Every generated
+ * step gets written into a trace (tick, channel, direction, position), which
+ * can be saved and compared against a golden reference of a previous run.
+ * Changes to the ramp calculation or the interrupt are behaviour preserving if
+ * the trace still matches.
+ *
+ * Environment variables:
+ *   TMC_SIM_STEPDIR_BENCH=<ticks>  Run the harness after startup and exit (0: default tick count)
+ *   TMC_SIM_STEPDIR_TRACE=<file>   Write the step trace
+ *   TMC_SIM_STEPDIR_GOLDEN=<file>  Compare the step trace, exit code 1 on a mismatch
+ */
+
+#include "StepDirBenchmark.h"
+#include "StepDir.h"
+#include "hal/derivative.h"
+#include "hal/SysTick.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define CHANNELS  2
+
+// The scenario repeats every 4 s of StepDir time
+#define SCENARIO_PERIOD  (4 * STEPDIR_FREQUENCY)
+#define AT(seconds)      ((uint32_t) ((seconds) * STEPDIR_FREQUENCY))
+
+// StepDir_periodicJob() is called about every millisecond, like the board periodic jobs do
+#define PERIODIC_JOB_TICKS  128
+
+// The StallGuard inputs use otherwise unused upper bits of a simulated port
+#define STALL_PORT  GPIOE
+
+extern StepDirectionTypedef StepDir[];
+
+typedef enum {
+	EVENT_MOVE_TO,
+	EVENT_ROTATE,
+	EVENT_ACCELERATION,
+	EVENT_VELOCITY_MAX,
+	EVENT_STALLGUARD_THRESHOLD,
+	EVENT_STALL_SIGNAL
+} EventType;
+
+typedef struct
+{
+	uint32_t   tick;  // within the scenario period
+	uint8_t    channel;
+	EventType  type;
+	int32_t    value;
+} ScenarioEvent;
+
+static const ScenarioEvent scenario[] =
+{
+	{ AT(0.0),    0, EVENT_ACCELERATION,          2000000 },
+	{ AT(0.0),    0, EVENT_VELOCITY_MAX,          100000  },
+	{ AT(0.0),    0, EVENT_MOVE_TO,               200000  },
+	{ AT(0.0),    1, EVENT_ROTATE,                50000   },
+	{ AT(0.25),   0, EVENT_ACCELERATION,          500000  },  // Sync update during the ramp
+	{ AT(0.5),    1, EVENT_ROTATE,                -80000  },
+	{ AT(1.0),    0, EVENT_MOVE_TO,               -50000  },  // Reversal before reaching the target
+	{ AT(1.2),    0, EVENT_ACCELERATION,          3000000 },  // Sync update while braking
+	{ AT(1.5),    1, EVENT_STALLGUARD_THRESHOLD,  1000    },
+	{ AT(1.6),    1, EVENT_STALL_SIGNAL,          1       },
+	{ AT(2.0),    1, EVENT_STALL_SIGNAL,          0       },
+	{ AT(2.0),    1, EVENT_STALLGUARD_THRESHOLD,  0       },  // Clears the stall
+	{ AT(2.0),    1, EVENT_MOVE_TO,               0       },
+	{ AT(2.5),    0, EVENT_MOVE_TO,               -49990  },  // Short move inside the homing range
+	{ AT(2.75),   0, EVENT_MOVE_TO,               -50001  },
+	{ AT(3.0),    0, EVENT_ROTATE,                -131072 },  // Maximum velocity
+	{ AT(3.5),    0, EVENT_MOVE_TO,               0       },
+};
+
+typedef struct
+{
+	volatile uint32_t  stepSet;
+	volatile uint32_t  stepReset;
+	volatile uint32_t  dirSet;
+	volatile uint32_t  dirReset;
+	IOPinTypeDef       stepPin;
+	IOPinTypeDef       dirPin;
+	IOPinTypeDef       stallPin;
+	bool               dirHigh;
+} SimStepDirPins;
+
+typedef struct
+{
+	uint8_t   channel;
+	uint32_t  acceleration;
+	volatile bool done;
+} AccelerationRequest;
+
+static SimStepDirPins pins[CHANNELS];
+static StepDirBenchmarkPathTypeDef paths[STEPDIR_BENCHMARK_PATH_COUNT];
+static FILE *traceFile = NULL;
+static FILE *goldenFile = NULL;
+static uint32_t traceLines = 0;
+static uint32_t traceHash = 2166136261UL;
+static bool traceMismatch = false;
+
+static const char *pathNames[STEPDIR_BENCHMARK_PATH_COUNT] =
+{
+	"all",
+	"step",
+	"sync",
+	"near target"
+};
+
+static void initPins(void);
+static void runTick(uint32_t tick);
+static void applyEvent(const ScenarioEvent *event, uint32_t *tick);
+static void *accelerationThread(void *arg);
+static void addSample(StepDirBenchmarkPath path, uint32_t cycles, uint32_t tick);
+static void trace(const char *line);
+static void printResults(uint32_t ticks);
+
+void stepdir_benchmark_runFromEnvironment(void)
+{
+	const char *config = getenv("TMC_SIM_STEPDIR_BENCH");
+	if(!config)
+		return;
+
+	uint32_t ticks = strtoul(config, NULL, 0);
+	if(ticks == 0)
+		ticks = STEPDIR_BENCHMARK_TICKS;
+
+	const char *tracePath = getenv("TMC_SIM_STEPDIR_TRACE");
+	const char *goldenPath = getenv("TMC_SIM_STEPDIR_GOLDEN");
+
+	if(tracePath && !(traceFile = fopen(tracePath, "w")))
+	{
+		printf("StepDir benchmark: cannot write %s\n", tracePath);
+		exit(1);
+	}
+
+	if(goldenPath && !(goldenFile = fopen(goldenPath, "r")))
+	{
+		printf("StepDir benchmark: cannot read %s\n", goldenPath);
+		exit(1);
+	}
+
+	// Take the StepDir generator away from the timer interrupt
+	StepDir_init(0);
+	sim_setInterrupt(SIM_IRQ_TIMER2, NULL, 0);
+	initPins();
+
+	for(uint8_t i = 0; i < STEPDIR_BENCHMARK_PATH_COUNT; i++)
+		memset(&paths[i], 0, sizeof(paths[i]));
+
+	uint8_t nextEvent = 0;
+	uint32_t periodStart = 0;
+	uint32_t lastPeriodicJob = 0;
+	uint32_t tick = 0;
+
+	while(tick < ticks)
+	{
+		if(tick - periodStart >= SCENARIO_PERIOD)
+		{
+			periodStart += SCENARIO_PERIOD;
+			nextEvent = 0;
+		}
+
+		// Acceleration events run sync ticks themselves and advance the tick counter
+		while(nextEvent < ARRAY_SIZE(scenario) && scenario[nextEvent].tick <= tick - periodStart)
+			applyEvent(&scenario[nextEvent++], &tick);
+
+		if(tick - lastPeriodicJob >= PERIODIC_JOB_TICKS)
+		{
+			for(uint8_t ch = 0; ch < CHANNELS; ch++)
+				StepDir_periodicJob(ch);
+
+			lastPeriodicJob = tick;
+		}
+
+		runTick(tick++);
+	}
+
+	if(goldenFile)
+	{
+		char line[64];
+		if(!traceMismatch && fgets(line, sizeof(line), goldenFile))
+		{
+			printf("Trace mismatch: golden trace has more than %lu lines\n", (unsigned long) traceLines);
+			traceMismatch = true;
+		}
+		fclose(goldenFile);
+	}
+
+	if(traceFile)
+		fclose(traceFile);
+
+	printResults(ticks);
+
+	exit(traceMismatch ? 1 : 0);
+}
+
+static void initPins(void)
+{
+	for(uint8_t ch = 0; ch < CHANNELS; ch++)
+	{
+		SimStepDirPins *p = &pins[ch];
+
+		p->stepPin.setBitRegister    = &p->stepSet;
+		p->stepPin.resetBitRegister  = &p->stepReset;
+		p->stepPin.bitWeight         = 1;
+
+		p->dirPin.setBitRegister     = &p->dirSet;
+		p->dirPin.resetBitRegister   = &p->dirReset;
+		p->dirPin.bitWeight          = 1;
+
+		p->stallPin.port       = STALL_PORT;
+		p->stallPin.bitWeight  = 1UL << (16 + ch);
+		sim_gpio_setInput(STALL_PORT, p->stallPin.bitWeight, false);
+
+		StepDir_setPins(ch, &p->stepPin, &p->dirPin, &p->stallPin);
+	}
+}
+
+static void runTick(uint32_t tick)
+{
+	bool sync = false;
+	bool nearTarget = false;
+
+	for(uint8_t ch = 0; ch < CHANNELS; ch++)
+	{
+		StepDirSync flag = ACCESS_ONCE(StepDir[ch].syncFlag);
+		sync |= (flag == SYNC_SNAPSHOT_REQUESTED) || (flag == SYNC_UPDATE_DATA);
+
+		if(StepDir[ch].haltingCondition == 0 && tmc_ramp_linear_get_mode(&StepDir[ch].ramp) == TMC_RAMP_LINEAR_MODE_POSITION)
+		{
+			uint32_t distance = abs(StepDir_getTargetPosition(ch) - StepDir_getActualPosition(ch));
+			nearTarget |= (distance != 0) && (distance <= StepDir[ch].ramp.homingDistance);
+		}
+	}
+
+	uint32_t start = systick_getCycleCount();
+	StepDir_tick();
+	uint32_t cycles = systick_getCycleCount() - start;
+
+	bool step = false;
+
+	for(uint8_t ch = 0; ch < CHANNELS; ch++)
+	{
+		SimStepDirPins *p = &pins[ch];
+
+		if(p->dirSet)
+			p->dirHigh = true;
+		if(p->dirReset)
+			p->dirHigh = false;
+
+		if(p->stepSet)
+		{
+			char line[64];
+			snprintf(line, sizeof(line), "%lu %u %c %ld\n", (unsigned long) tick, ch, p->dirHigh ? '-' : '+', (long) StepDir_getActualPosition(ch));
+			trace(line);
+			step = true;
+		}
+
+		p->stepSet    = 0;
+		p->stepReset  = 0;
+		p->dirSet     = 0;
+		p->dirReset   = 0;
+	}
+
+	addSample(STEPDIR_BENCHMARK_ALL, cycles, tick);
+	if(step)
+		addSample(STEPDIR_BENCHMARK_STEP, cycles, tick);
+	if(sync)
+		addSample(STEPDIR_BENCHMARK_SYNC, cycles, tick);
+	if(nearTarget)
+		addSample(STEPDIR_BENCHMARK_NEAR_TARGET, cycles, tick);
+}
+
+static void applyEvent(const ScenarioEvent *event, uint32_t *tick)
+{
+	char line[64];
+	snprintf(line, sizeof(line), "# %lu %u event %u %ld\n", (unsigned long) *tick, event->channel, event->type, (long) event->value);
+	trace(line);
+
+	switch(event->type)
+	{
+	case EVENT_MOVE_TO:
+		StepDir_moveTo(event->channel, event->value);
+		break;
+	case EVENT_ROTATE:
+		StepDir_rotate(event->channel, event->value);
+		break;
+	case EVENT_ACCELERATION:
+		{
+			// The setter waits for the interrupt in position mode. Run it in a second thread
+			// and tick exactly when the sync mechanism requests it, so the trace stays deterministic.
+			AccelerationRequest request = { event->channel, event->value, false };
+			pthread_t thread;
+			pthread_create(&thread, NULL, accelerationThread, &request);
+
+			while(!request.done)
+			{
+				StepDirSync flag = ACCESS_ONCE(StepDir[event->channel].syncFlag);
+				if(flag == SYNC_SNAPSHOT_REQUESTED || flag == SYNC_UPDATE_DATA)
+					runTick((*tick)++);
+			}
+
+			pthread_join(thread, NULL);
+		}
+		break;
+	case EVENT_VELOCITY_MAX:
+		StepDir_setVelocityMax(event->channel, event->value);
+		break;
+	case EVENT_STALLGUARD_THRESHOLD:
+		StepDir_setStallGuardThreshold(event->channel, event->value);
+		break;
+	case EVENT_STALL_SIGNAL:
+		sim_gpio_setInput(STALL_PORT, pins[event->channel].stallPin.bitWeight, event->value);
+		break;
+	}
+}
+
+static void *accelerationThread(void *arg)
+{
+	AccelerationRequest *request = arg;
+
+	StepDir_setAcceleration(request->channel, request->acceleration);
+	request->done = true;
+
+	return NULL;
+}
+
+static void addSample(StepDirBenchmarkPath path, uint32_t cycles, uint32_t tick)
+{
+	StepDirBenchmarkPathTypeDef *p = &paths[path];
+
+	if(p->count == 0 || cycles < p->minCycles)
+		p->minCycles = cycles;
+
+	if(cycles > p->maxCycles)
+	{
+		p->maxCycles = cycles;
+		p->maxTick = tick;
+	}
+
+	if(cycles > SYSTICK_CYCLES_PER_MICROSECOND * 1000000 / STEPDIR_FREQUENCY)
+		p->overBudget++;
+
+	p->count++;
+	p->totalCycles += cycles;
+}
+
+static void trace(const char *line)
+{
+	// FNV-1a hash of the whole trace for a quick comparison
+	for(const char *c = line; *c; c++)
+		traceHash = (traceHash ^ (uint8_t) *c) * 16777619UL;
+
+	traceLines++;
+
+	if(traceFile)
+		fputs(line, traceFile);
+
+	if(goldenFile && !traceMismatch)
+	{
+		char golden[64] = "<end of trace>\n";
+		bool found = fgets(golden, sizeof(golden), goldenFile) != NULL;
+
+		if(!found || strcmp(golden, line) != 0)
+		{
+			printf("Trace mismatch in line %lu:\n  expected: %s  actual:   %s", (unsigned long) traceLines, golden, line);
+			traceMismatch = true;
+		}
+	}
+}
+
+static void printResults(uint32_t ticks)
+{
+	printf("StepDir benchmark: %lu ticks, %lu trace lines, trace hash %08lx%s\n", (unsigned long) ticks,
+			(unsigned long) traceLines, (unsigned long) traceHash, goldenFile ? (traceMismatch ? ", golden trace MISMATCH" : ", golden trace matches") : "");
+	printf("path             count   min[ns]   avg[ns]   max[ns]  max@tick  over budget\n");
+
+	for(uint8_t i = 0; i < STEPDIR_BENCHMARK_PATH_COUNT; i++)
+	{
+		StepDirBenchmarkPathTypeDef *p = &paths[i];
+		uint32_t average = (p->count) ? p->totalCycles / p->count : 0;
+
+		printf("%-12s %9lu %9lu %9lu %9lu %9lu %12lu\n", pathNames[i],
+				(unsigned long) p->count,
+				(unsigned long) (p->minCycles * 1000ULL / SYSTICK_CYCLES_PER_MICROSECOND),
+				(unsigned long) (average * 1000ULL / SYSTICK_CYCLES_PER_MICROSECOND),
+				(unsigned long) (p->maxCycles * 1000ULL / SYSTICK_CYCLES_PER_MICROSECOND),
+				(unsigned long) p->maxTick,
+				(unsigned long) p->overBudget);
+	}
+}
@@ -0,0 +1,36 @@
+/*******************************************************************************
+* Copyright © 2023 Analog Devices Inc. All Rights Reserved. This software is
+* proprietary & confidential to Analog Devices, Inc. and its licensors.
+*******************************************************************************/
+
+
+#ifndef STEPDIR_BENCHMARK_H
+#define STEPDIR_BENCHMARK_H
+
+#include "tmc/helpers/API_Header.h"
+
+// Default number of interrupt ticks of a run (32 s of StepDir time)
+#define STEPDIR_BENCHMARK_TICKS  (1 << 22)
+
+typedef enum {
+	STEPDIR_BENCHMARK_ALL,          // every tick
+	STEPDIR_BENCHMARK_STEP,         // ticks generating at least one step pulse
+	STEPDIR_BENCHMARK_SYNC,         // ticks applying an acceleration sync update
+	STEPDIR_BENCHMARK_NEAR_TARGET,  // ticks homing in within the homing distance of the target
+
+	STEPDIR_BENCHMARK_PATH_COUNT
+} StepDirBenchmarkPath;
+
+typedef struct
+{
+	uint32_t  count;
+	uint32_t  minCycles;
+	uint32_t  maxCycles;
+	uint64_t  totalCycles;
+	uint32_t  maxTick;     // tick of the worst case
+	uint32_t  overBudget;  // ticks exceeding the interrupt period
+} StepDirBenchmarkPathTypeDef;
+
+void stepdir_benchmark_runFromEnvironment(void);
+
+#endif /* STEPDIR_BENCHMARK_H */
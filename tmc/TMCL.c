@@ -14,8 +14,14 @@
 #include "VitalSignsMonitor.h"
 #include "tmc/StepDir.h"
 #include "EEPROM.h"
+#include "ParameterStore.h"
 #include "RAMDebug.h"
 #include "hal/Timer.h"
+#include "Scheduler.h"
+#include "Profiler.h"
+#include "Benchmark.h"
+#include "LoadMonitor.h"
+#include "EventLog.h"
 
 // these addresses are fixed
 #define SERIAL_MODULE_ADDRESS  1
@@ -126,6 +132,12 @@
 #define TMCL_MIN                     170
 #define TMCL_MAX                     171
 #define TMCL_OTP                     172
+#define TMCL_Profiler                173
+#define TMCL_Benchmark               174
+#define TMCL_BlockTransfer           175
+#define TMCL_LoadMonitor             176
+#define TMCL_Snapshot                177
+#define TMCL_EventLog                178
 
 #define TMCL_Boot                    242
 #define TMCL_SoftwareReset           255
@@ -165,6 +177,9 @@
 #define TMCL_RX_ERROR_NODATA    1
 #define TMCL_RX_ERROR_CHECKSUM  2
 
+// Maximum size of a TMCL_BlockTransfer block
+#define BLOCK_TRANSFER_SIZE  256
+
 extern const char *VersionString;
 
 // TMCL request
@@ -204,6 +219,8 @@ void ExecuteActualCommand();
 uint8_t setTMCLStatus(uint8_t evalError);
 void rx(RXTXTypeDef *RXTX);
 void tx(RXTXTypeDef *RXTX);
+static void parseDatagram(const uint8_t *cmd);
+static void buildReply(uint8_t *reply);
 
 // Helper functions - used to prevent ExecuteActualCommand() from getting too big.
 // No parameters or return value are used.
@@ -223,6 +240,20 @@ static void GetInput(void);
 static void HandleWlanCommand(void);
 static void handleRamDebug(void);
 static void handleOTP(void);
+static void handleProfiler(void);
+static void handleBenchmark(void);
+static void handleBlockTransfer(void);
+static void blockReply(uint16_t length);
+static void handleLoadMonitor(void);
+static void handleReferenceSearch(void);
+static void handleSnapshot(void);
+static void handleEventLog(void);
+static void storeAxisParameter(void);
+static void restoreAxisParameter(void);
+static bool isStorableGlobalParameter(uint8_t type);
+static void storeGlobalParameter(void);
+static void restoreGlobalParameter(void);
+static uint32_t applyGlobalParameter(uint8_t type, uint8_t motor, int32_t value);
 
 TMCLCommandTypeDef ActualCommand;
 TMCLReplyTypeDef ActualReply;
@@ -230,6 +261,22 @@ RXTXTypeDef interfaces[4];
 uint32_t numberOfInterfaces;
 uint32_t resetRequest = 0;
 
+// Block transfer buffer. Block reads (BlockTransfer, LoadMonitor histogram, Snapshot,
+// EventLog dumps) fill it and reply with the number of bytes. By default the host pages
+// through it with TMCL_BlockTransfer type 4, 4 bytes per reply, which keeps the 9 byte
+// framing on every interface (including RS485): n bytes take 1 + n/4 round trips.
+// On USB the host can enable stream mode with TMCL_BlockTransfer type 5, then the bytes
+// follow the reply directly and a block read takes a single round trip.
+static struct
+{
+	uint8_t data[BLOCK_TRANSFER_SIZE];
+	uint16_t length;   // Valid bytes of the last block read
+	uint16_t pending;  // Bytes sent after the current reply in stream mode
+	bool stream;       // Stream mode enabled on USB
+} BlockTransfer;
+
+static uint32_t currentInterface = 0;
+
 #if defined(Landungsbruecke) || defined(LandungsbrueckeSmall)
     // ToDo: Remove the duplicate declaration of the struct here and in main.c
     struct BootloaderConfig {
@@ -296,6 +343,9 @@ void ExecuteActualCommand()
 			setTMCLStatus(Evalboards.ch2.stop(ActualCommand.Motor));
 		}
 		break;
+	case TMCL_RFS:
+		handleReferenceSearch();
+		break;
 	case TMCL_MVP:
 		// if function doesn't exist for ch1 try ch2
 		switch(ActualCommand.Type)
@@ -332,18 +382,34 @@ void ExecuteActualCommand()
 		}
 		break;
 	case TMCL_GAP:
-		// if function doesn't exist for ch1 try ch2
-		if(setTMCLStatus(Evalboards.ch1.GAP(ActualCommand.Type, ActualCommand.Motor, &ActualReply.Value.Int32)) & (TMC_ERROR_TYPE | TMC_ERROR_FUNCTION))
 		{
-			setTMCLStatus(Evalboards.ch2.GAP(ActualCommand.Type, ActualCommand.Motor, &ActualReply.Value.Int32));
+			uint32_t start = profiler_start();
+			// if function doesn't exist for ch1 try ch2
+			if(setTMCLStatus(Evalboards.ch1.GAP(ActualCommand.Type, ActualCommand.Motor, &ActualReply.Value.Int32)) & (TMC_ERROR_TYPE | TMC_ERROR_FUNCTION))
+			{
+				setTMCLStatus(Evalboards.ch2.GAP(ActualCommand.Type, ActualCommand.Motor, &ActualReply.Value.Int32));
+			}
+			profiler_stop(PROFILER_PROBE_GAP, start);
 		}
 		break;
+	case TMCL_STAP:
+		storeAxisParameter();
+		break;
+	case TMCL_RSAP:
+		restoreAxisParameter();
+		break;
 	case TMCL_SGP:
 		SetGlobalParameter();
 		break;
 	case TMCL_GGP:
 		GetGlobalParameter();
 		break;
+	case TMCL_STGP:
+		storeGlobalParameter();
+		break;
+	case TMCL_RSGP:
+		restoreGlobalParameter();
+		break;
 	case TMCL_GIO:
 		GetInput();
 		break;
@@ -387,6 +453,10 @@ void ExecuteActualCommand()
 	case TMCL_GetVersion:
 		GetVersion();
 		break;
+	case TMCL_FactoryDefault:
+		// Drop all parameters stored with STAP/STGP
+		setTMCLStatus(paramstore_clear());
+		break;
 	case TMCL_GetIds:
 		boardAssignment();
 		break;
@@ -443,6 +513,24 @@ void ExecuteActualCommand()
 	case TMCL_OTP:
 		handleOTP();
 		break;
+	case TMCL_Profiler:
+		handleProfiler();
+		break;
+	case TMCL_Benchmark:
+		handleBenchmark();
+		break;
+	case TMCL_BlockTransfer:
+		handleBlockTransfer();
+		break;
+	case TMCL_LoadMonitor:
+		handleLoadMonitor();
+		break;
+	case TMCL_Snapshot:
+		handleSnapshot();
+		break;
+	case TMCL_EventLog:
+		handleEventLog();
+		break;
 	case TMCL_MIN:
 		if(setTMCLStatus(Evalboards.ch1.getMin(ActualCommand.Type, ActualCommand.Motor, &ActualReply.Value.Int32)) & (TMC_ERROR_TYPE | TMC_ERROR_FUNCTION))
 		{
@@ -484,13 +572,14 @@ void tmcl_init()
 
 void tmcl_process()
 {
-	static int32_t currentInterface = 0;
-
 	if(ActualCommand.Error != TMCL_RX_ERROR_NODATA)
 		tx(&interfaces[currentInterface]);
 
 	if(resetRequest)
+	{
+		eeprom_flush(); // Buffered EEPROM writes would get lost
 		HAL.reset(true);
+	}
 
 	ActualReply.IsSpecial = 0;
 
@@ -500,18 +589,67 @@ void tmcl_process()
 		if(ActualCommand.Error != TMCL_RX_ERROR_NODATA)
 		{
 			currentInterface = i;
+			uint32_t start = profiler_start();
 			ExecuteActualCommand();
+			profiler_stop(PROFILER_PROBE_TMCL_COMMAND, start);
 			return;
 		}
 	}
 }
 
-void tx(RXTXTypeDef *RXTX)
+// Executes a raw 9 byte datagram without going through an interface and writes the 9 byte reply.
+// The command currently being processed is preserved, so this may be called from within a TMCL command.
+// Returns true if the command was answered with REPLY_OK.
+bool tmcl_executeDatagram(const uint8_t *request, uint8_t *reply)
 {
-	uint8_t checkSum = 0;
+	TMCLCommandTypeDef savedCommand = ActualCommand;
+	TMCLReplyTypeDef savedReply = ActualReply;
+	uint16_t savedPending = BlockTransfer.pending;
+
+	ActualReply.IsSpecial = 0;
+	parseDatagram(request);
+	ExecuteActualCommand();
+	buildReply(reply);
+
+	bool ok = (ActualReply.Status == REPLY_OK);
 
+	ActualCommand = savedCommand;
+	ActualReply = savedReply;
+	BlockTransfer.pending = savedPending;
+
+	return ok;
+}
+
+void tx(RXTXTypeDef *RXTX)
+{
 	uint8_t reply[9];
 
+	buildReply(reply);
+	RXTX->txN(reply, 9);
+
+	// Stream mode: the block follows the reply, txN takes at most 255 bytes per call
+	if(RXTX == &interfaces[0])
+	{
+		for(uint16_t i = 0; i < BlockTransfer.pending; i += 128)
+			RXTX->txN(&BlockTransfer.data[i], MIN(128, BlockTransfer.pending - i));
+	}
+
+	BlockTransfer.pending = 0;
+}
+
+// Completes a block read of <length> bytes in the block buffer. The reply value is the
+// number of bytes. In stream mode they get sent after the reply, otherwise they are fetched with type 4.
+static void blockReply(uint16_t length)
+{
+	BlockTransfer.length = length;
+	BlockTransfer.pending = (BlockTransfer.stream && currentInterface == 0) ? length : 0;
+	ActualReply.Value.UInt32 = length;
+}
+
+static void buildReply(uint8_t *reply)
+{
+	uint8_t checkSum = 0;
+
 	if(ActualReply.IsSpecial)
 	{
 		for(uint8_t i = 0; i < 9; i++)
@@ -538,13 +676,10 @@ void tx(RXTXTypeDef *RXTX)
 		reply[7] = ActualReply.Value.Byte[0];
 		reply[8] = checkSum;
 	}
-
-	RXTX->txN(reply, 9);
 }
 
 void rx(RXTXTypeDef *RXTX)
 {
-	uint8_t checkSum = 0;
 	uint8_t cmd[9];
 
 	if(!RXTX->rxN(cmd, 9))
@@ -553,6 +688,13 @@ void rx(RXTXTypeDef *RXTX)
 		return;
 	}
 
+	parseDatagram(cmd);
+}
+
+static void parseDatagram(const uint8_t *cmd)
+{
+	uint8_t checkSum = 0;
+
 	// todo ADD CHECK 2: check for SERIAL_MODULE_ADDRESS byte ( cmd[0] ) ? (LH)
 
 	for(uint8_t i = 0; i < 8; i++)
@@ -588,6 +730,8 @@ void tmcl_boot()
 		BLConfig.drvEnableResetValue = 1;
 	}
 #endif
+	eeprom_flush(); // Buffered EEPROM writes would get lost
+
 	Evalboards.driverEnable = DRIVER_DISABLE;
 	Evalboards.ch1.enableDriver(DRIVER_DISABLE); // todo CHECK 2: the ch1/2 deInit() calls should already disable the drivers - keep this driver disabling to be sure or remove it and leave the disabling to deInit? (LH)
 	Evalboards.ch2.enableDriver(DRIVER_DISABLE);
@@ -676,7 +820,8 @@ static void writeIdEeprom(void)
 		return;
 	}
 
-	eeprom_write_byte(spi, ActualCommand.Value.Int32, ActualCommand.Motor);
+	// Written in the background by eeprom_process(), reads already return the new value
+	eeprom_write_async(spi, ActualCommand.Value.Int32, &ActualCommand.Motor, 1);
 
 	return;
 }
@@ -717,6 +862,44 @@ static void SetGlobalParameter()
 	case 8:
 		ActualReply.Value.UInt32 = spi_setFrequency(&HAL.SPI->ch2, ActualCommand.Value.UInt32);
 		break;
+	case 9: // Reset scheduler statistics
+		scheduler_resetStatistics();
+		break;
+	case 10: // Scheduler task period [ms]
+		if(ActualCommand.Motor >= Scheduler.taskCount)
+		{
+			ActualReply.Status = REPLY_INVALID_VALUE;
+			break;
+		}
+		Scheduler.tasks[ActualCommand.Motor].period = ActualCommand.Value.UInt32;
+		break;
+	case 11: // Scheduler task deadline [µs]
+		if(ActualCommand.Motor >= Scheduler.taskCount)
+		{
+			ActualReply.Status = REPLY_INVALID_VALUE;
+			break;
+		}
+		Scheduler.tasks[ActualCommand.Motor].deadline = ActualCommand.Value.UInt32;
+		break;
+	case 17: // Scheduler loop budget [µs]
+		Scheduler.loopBudget = ActualCommand.Value.UInt32;
+		break;
+	case 19: // Reset VM log
+		vitalsignsmonitor_resetVMLog();
+		break;
+	case 20: // Reset ADC min/max statistics
+		HAL.ADCs->resetStatistics();
+		break;
+	case 27: // Board ID rescan period [ms], 0 disables the hot-plug detection
+		IDDetection.rescanPeriod = ActualCommand.Value.UInt32;
+		break;
+	case 31: // Save the event log to flash after a fault (store with STGP to keep it enabled after a reset)
+		EventLog.persist = (ActualCommand.Value.Int32) ? true : false;
+		break;
+	case 32: // Probe the fastest reliable SPI clock of boards with an SPI profile (store with STGP to probe on every assignment)
+		Evalboards.spiProbe = (ActualCommand.Value.Int32) ? true : false;
+		Board_applySPIProfiles();
+		break;
 	default:
 		ActualReply.Status = REPLY_INVALID_TYPE;
 		break;
@@ -756,12 +939,220 @@ static void GetGlobalParameter()
 		case 8:
 			ActualReply.Value.UInt32 = spi_getFrequency(&HAL.SPI->ch2);
 			break;
+		case 9: // Number of scheduler tasks
+			ActualReply.Value.UInt32 = Scheduler.taskCount;
+			break;
+		case 10: // Scheduler task period [ms]
+		case 11: // Scheduler task deadline [µs]
+		case 12: // Scheduler task worst case execution time [µs]
+		case 13: // Scheduler task average execution time [µs]
+		case 14: // Scheduler task run count
+		case 15: // Scheduler task deadline misses
+			if(ActualCommand.Motor >= Scheduler.taskCount)
+			{
+				ActualReply.Status = REPLY_INVALID_VALUE;
+				break;
+			}
+			switch(ActualCommand.Type)
+			{
+			case 10:
+				ActualReply.Value.UInt32 = Scheduler.tasks[ActualCommand.Motor].period;
+				break;
+			case 11:
+				ActualReply.Value.UInt32 = Scheduler.tasks[ActualCommand.Motor].deadline;
+				break;
+			case 12:
+				ActualReply.Value.UInt32 = scheduler_getTaskMaxTime(ActualCommand.Motor);
+				break;
+			case 13:
+				ActualReply.Value.UInt32 = scheduler_getTaskAverageTime(ActualCommand.Motor);
+				break;
+			case 14:
+				ActualReply.Value.UInt32 = Scheduler.tasks[ActualCommand.Motor].runs;
+				break;
+			case 15:
+				ActualReply.Value.UInt32 = Scheduler.tasks[ActualCommand.Motor].deadlineMisses;
+				break;
+			}
+			break;
+		case 16: // Main loop worst case pass time [µs]
+			ActualReply.Value.UInt32 = scheduler_getLoopMaxTime();
+			break;
+		case 17: // Main loop budget [µs]
+			ActualReply.Value.UInt32 = Scheduler.loopBudget;
+			break;
+		case 18: // Main loop average pass time [µs]
+			ActualReply.Value.UInt32 = scheduler_getLoopAverageTime();
+			break;
+		case 19: // Minimum VM [100mV]
+			ActualReply.Value.UInt32 = VitalSignsMonitor.VMLog.min;
+			break;
+		case 20: // Time of the minimum VM [ms]
+			ActualReply.Value.UInt32 = VitalSignsMonitor.VMLog.minTick;
+			break;
+		case 21: // Maximum VM [100mV]
+			ActualReply.Value.UInt32 = VitalSignsMonitor.VMLog.max;
+			break;
+		case 22: // Time of the maximum VM [ms]
+			ActualReply.Value.UInt32 = VitalSignsMonitor.VMLog.maxTick;
+			break;
+		case 23: // Average VM [100mV]
+			ActualReply.Value.UInt32 = vitalsignsmonitor_getAverageVM();
+			break;
+		case 24: // Number of overvoltage driver cutoffs
+			ActualReply.Value.UInt32 = VitalSignsMonitor.VMLog.cutoffs;
+			break;
+		case 25: // Time of the last overvoltage cutoff [ms]
+			ActualReply.Value.UInt32 = VitalSignsMonitor.VMLog.cutoffTick;
+			break;
+		case 26: // VM of the last overvoltage cutoff [100mV]
+			ActualReply.Value.UInt32 = VitalSignsMonitor.VMLog.cutoffVM;
+			break;
+		case 27: // Board ID rescan period [ms]
+			ActualReply.Value.UInt32 = IDDetection.rescanPeriod;
+			break;
+		case 28: // Number of detected board changes
+			ActualReply.Value.UInt32 = IDDetection.changes;
+			break;
+		case 29: // Free records in the parameter store before the next compaction
+			ActualReply.Value.UInt32 = paramstore_getFreeRecords();
+			break;
+		case 30: // Parameter store generation (number of compactions since the store was created)
+			ActualReply.Value.UInt32 = ParameterStore.generation;
+			break;
+		case 31: // Save the event log to flash after a fault
+			ActualReply.Value.UInt32 = EventLog.persist;
+			break;
+		case 32: // SPI clock probing
+			ActualReply.Value.UInt32 = Evalboards.spiProbe;
+			break;
 		default:
 			ActualReply.Status = REPLY_INVALID_TYPE;
 			break;
 	}
 }
 
+// STAP: Store the current value of an axis parameter in flash.
+// The value is stored for the channel that knows the parameter and its board ID.
+static void storeAxisParameter(void)
+{
+	int32_t value;
+	uint8_t scope = PARAMSTORE_SCOPE_CH1;
+	uint8_t id = Evalboards.ch1.id;
+
+	if(setTMCLStatus(Evalboards.ch1.GAP(ActualCommand.Type, ActualCommand.Motor, &value)) & (TMC_ERROR_TYPE | TMC_ERROR_FUNCTION))
+	{
+		scope = PARAMSTORE_SCOPE_CH2;
+		id = Evalboards.ch2.id;
+		setTMCLStatus(Evalboards.ch2.GAP(ActualCommand.Type, ActualCommand.Motor, &value));
+	}
+
+	if(ActualReply.Status != REPLY_OK)
+		return;
+
+	if(!id)
+	{
+		ActualReply.Status = REPLY_INVALID_CMD;
+		return;
+	}
+
+	setTMCLStatus(paramstore_store(scope, id, ActualCommand.Type, ActualCommand.Motor, value));
+	ActualReply.Value.Int32 = value;
+}
+
+// RSAP: Set an axis parameter to its stored value
+static void restoreAxisParameter(void)
+{
+	int32_t value;
+
+	if(Evalboards.ch1.id && paramstore_load(PARAMSTORE_SCOPE_CH1, Evalboards.ch1.id, ActualCommand.Type, ActualCommand.Motor, &value) == TMC_ERROR_NONE)
+	{
+		setTMCLStatus(Evalboards.ch1.SAP(ActualCommand.Type, ActualCommand.Motor, value));
+	}
+	else if(Evalboards.ch2.id && paramstore_load(PARAMSTORE_SCOPE_CH2, Evalboards.ch2.id, ActualCommand.Type, ActualCommand.Motor, &value) == TMC_ERROR_NONE)
+	{
+		setTMCLStatus(Evalboards.ch2.SAP(ActualCommand.Type, ActualCommand.Motor, value));
+	}
+	else
+	{
+		ActualReply.Status = REPLY_INVALID_VALUE;
+		return;
+	}
+
+	ActualReply.Value.Int32 = value;
+}
+
+// Global parameters whose GGP value gets applied again by SGP. Statistics and
+// the SGP types that reset them (or read back something else) can't be stored.
+static bool isStorableGlobalParameter(uint8_t type)
+{
+	switch(type)
+	{
+	case 2:  // Driver enable
+	case 3:  // Debug mode
+	case 6:  // Pin state
+	case 7:  // SPI channel 1 frequency
+	case 8:  // SPI channel 2 frequency
+	case 10: // Scheduler task period
+	case 11: // Scheduler task deadline
+	case 17: // Scheduler loop budget
+	case 27: // Board ID rescan period
+	case 31: // Event log persistence
+	case 32: // SPI clock probing
+		return true;
+	default:
+		return false;
+	}
+}
+
+// STGP: Store the current value of a global parameter in flash
+static void storeGlobalParameter(void)
+{
+	if(!isStorableGlobalParameter(ActualCommand.Type))
+	{
+		ActualReply.Status = REPLY_INVALID_TYPE;
+		return;
+	}
+
+	GetGlobalParameter();
+
+	if(ActualReply.Status != REPLY_OK)
+		return;
+
+	setTMCLStatus(paramstore_store(PARAMSTORE_SCOPE_GLOBAL, 0, ActualCommand.Type, ActualCommand.Motor, ActualReply.Value.Int32));
+}
+
+// RSGP: Set a global parameter to its stored value
+static void restoreGlobalParameter(void)
+{
+	int32_t value;
+
+	if(setTMCLStatus(paramstore_load(PARAMSTORE_SCOPE_GLOBAL, 0, ActualCommand.Type, ActualCommand.Motor, &value)) != TMC_ERROR_NONE)
+		return;
+
+	ActualCommand.Value.Int32 = value;
+	ActualReply.Value.Int32 = value;
+	SetGlobalParameter();
+}
+
+// Apply the global parameters stored with STGP at startup
+void tmcl_restoreGlobalParameters(void)
+{
+	paramstore_restore(PARAMSTORE_SCOPE_GLOBAL, 0, applyGlobalParameter);
+}
+
+static uint32_t applyGlobalParameter(uint8_t type, uint8_t motor, int32_t value)
+{
+	ActualCommand.Type         = type;
+	ActualCommand.Motor        = motor;
+	ActualCommand.Value.Int32  = value;
+	ActualReply.Status         = REPLY_OK;
+
+	SetGlobalParameter();
+
+	return (ActualReply.Status == REPLY_OK) ? TMC_ERROR_NONE : TMC_ERROR_TYPE;
+}
+
 static void boardAssignment(void)
 {
 	uint8_t testOnly = 0;
@@ -885,7 +1276,8 @@ static void checkIDs(void)
 {
 	IdAssignmentTypeDef ids = { 0 };
 
-	if(IDDetection_detect(&ids))
+	// The scan runs in the background and assigns the boards when done
+	if(IDDetection_scan(&ids))
 	{
 		ActualReply.Value.Int32	= (uint32_t)
 		(
@@ -894,8 +1286,6 @@ static void checkIDs(void)
 			| (ids.ch2.id    << 16)
 			| (ids.ch2.state << 24)
 		);
-
-		Board_assign(&ids);
 	}
 	else
 	{
@@ -988,7 +1378,27 @@ static void GetInput(void)
 		ActualReply.Value.Int32 = *HAL.ADCs->AIN_EXT;
 		break;
 	default:
-		ActualReply.Status = REPLY_INVALID_TYPE;
+		// Filtered value (10-16), minimum (20-26) and maximum (30-36) of the analog inputs,
+		// in the order AIN0, AIN1, AIN2, DIO4, DIO5, VM, AIN_EXT. Raw ADC scale.
+		if((ActualCommand.Type % 10) >= ADC_INPUT_COUNT || ActualCommand.Type < 10 || ActualCommand.Type >= 40)
+		{
+			ActualReply.Status = REPLY_INVALID_TYPE;
+			break;
+		}
+
+		volatile ADCInputStatisticsTypeDef *statistics = &HAL.ADCs->statistics[ActualCommand.Type % 10];
+		switch(ActualCommand.Type / 10)
+		{
+		case 1:
+			ActualReply.Value.Int32 = statistics->filtered;
+			break;
+		case 2:
+			ActualReply.Value.Int32 = statistics->min;
+			break;
+		case 3:
+			ActualReply.Value.Int32 = statistics->max;
+			break;
+		}
 		break;
 	}
 }
@@ -1107,6 +1517,9 @@ static void handleRamDebug(void)
 		if (!debug_setTriggerAddress(ActualCommand.Value.UInt32))
 			ActualReply.Status = REPLY_MAX_EXCEEDED;
 		break;
+	case 22:
+		debug_setDecimation(ActualCommand.Value.UInt32);
+		break;
 	default:
 		ActualReply.Status = REPLY_INVALID_TYPE;
 		break;
@@ -1140,3 +1553,325 @@ static void handleOTP(void)
 		break;
 	}
 }
+
+static void handleProfiler(void)
+{
+	// Type 6 and 7 are not probe specific
+	if(ActualCommand.Type < 6 && ActualCommand.Motor >= PROFILER_PROBE_COUNT)
+	{
+		ActualReply.Status = REPLY_INVALID_VALUE;
+		return;
+	}
+
+	switch(ActualCommand.Type)
+	{
+	case 0: // Number of measurements
+		ActualReply.Value.UInt32 = Profiler.probes[ActualCommand.Motor].count;
+		break;
+	case 1: // Minimum time [ns]
+		ActualReply.Value.UInt32 = profiler_getMinTime(ActualCommand.Motor);
+		break;
+	case 2: // Maximum time [ns]
+		ActualReply.Value.UInt32 = profiler_getMaxTime(ActualCommand.Motor);
+		break;
+	case 3: // Average time [ns]
+		ActualReply.Value.UInt32 = profiler_getAverageTime(ActualCommand.Motor);
+		break;
+	case 4: // CPU load [0.01%]
+		ActualReply.Value.UInt32 = Profiler.probes[ActualCommand.Motor].load;
+		break;
+	case 5: // Reset probe
+		profiler_reset(ActualCommand.Motor);
+		break;
+	case 6: // Main loop frequency [Hz]
+		ActualReply.Value.UInt32 = Profiler.loopFrequency;
+		break;
+	case 7: // Number of probes
+		ActualReply.Value.UInt32 = PROFILER_PROBE_COUNT;
+		break;
+	default:
+		ActualReply.Status = REPLY_INVALID_TYPE;
+		break;
+	}
+}
+
+static void handleBenchmark(void)
+{
+	// Types 2 to 9 are result slot specific
+	if(ActualCommand.Type >= 2 && ActualCommand.Type <= 9 && ActualCommand.Motor >= Benchmark.slotCount)
+	{
+		ActualReply.Status = REPLY_INVALID_VALUE;
+		return;
+	}
+
+	switch(ActualCommand.Type)
+	{
+	case 0: // Run script <Motor> for <Value> passes, returns the number of executed datagrams
+		if(ActualCommand.Motor >= BENCHMARK_SCRIPT_COUNT || ActualCommand.Value.UInt32 == 0)
+		{
+			ActualReply.Status = REPLY_INVALID_VALUE;
+			break;
+		}
+		if(ActualCommand.Value.UInt32 > BENCHMARK_MAX_PASSES)
+		{
+			ActualReply.Status = REPLY_MAX_EXCEEDED;
+			break;
+		}
+		ActualReply.Value.UInt32 = benchmark_run(ActualCommand.Motor, ActualCommand.Value.UInt32);
+		break;
+	case 1: // Number of result slots (one per opcode)
+		ActualReply.Value.UInt32 = Benchmark.slotCount;
+		break;
+	case 2: // Opcode of the result slot
+		ActualReply.Value.UInt32 = Benchmark.slots[ActualCommand.Motor].opcode;
+		break;
+	case 3: // Number of executed datagrams
+		ActualReply.Value.UInt32 = Benchmark.slots[ActualCommand.Motor].count;
+		break;
+	case 4: // Number of datagrams not answered with REPLY_OK
+		ActualReply.Value.UInt32 = Benchmark.slots[ActualCommand.Motor].errors;
+		break;
+	case 5: // Median latency [ns]
+		ActualReply.Value.UInt32 = benchmark_getPercentile(ActualCommand.Motor, 500);
+		break;
+	case 6: // 90th percentile latency [ns]
+		ActualReply.Value.UInt32 = benchmark_getPercentile(ActualCommand.Motor, 900);
+		break;
+	case 7: // 99th percentile latency [ns]
+		ActualReply.Value.UInt32 = benchmark_getPercentile(ActualCommand.Motor, 990);
+		break;
+	case 8: // Maximum latency [ns]
+		ActualReply.Value.UInt32 = benchmark_getMaxTime(ActualCommand.Motor);
+		break;
+	case 9: // Average latency [ns]
+		ActualReply.Value.UInt32 = benchmark_getAverageTime(ActualCommand.Motor);
+		break;
+	case 10: // Throughput of the last run [datagrams/s]
+		ActualReply.Value.UInt32 = benchmark_getThroughput();
+		break;
+	case 11: // Number of scripts
+		ActualReply.Value.UInt32 = BENCHMARK_SCRIPT_COUNT;
+		break;
+	default:
+		ActualReply.Status = REPLY_INVALID_TYPE;
+		break;
+	}
+}
+
+// Burst access to a memory mapped evalboard (e.g. the ESC memory of the TMC8461/TMC8462).
+// For read and write the value holds the start address in the lower and the length in the upper 16 bits.
+// Reading n bytes takes 1 + n/4 round trips when paging with type 4, 1 round trip in stream mode (USB).
+static void handleBlockTransfer(void)
+{
+	uint16_t address = ActualCommand.Value.UInt32 & 0xFFFF;
+	uint16_t length  = ActualCommand.Value.UInt32 >> 16;
+
+	switch(ActualCommand.Type)
+	{
+	case 0: // Read <length> bytes into the block buffer, sent after the reply in stream mode, otherwise fetched with type 4
+	case 2: // Write <length> bytes from the block buffer
+		if(length == 0)
+		{
+			ActualReply.Status = REPLY_INVALID_VALUE;
+			break;
+		}
+		if(length > BLOCK_TRANSFER_SIZE)
+		{
+			ActualReply.Status = REPLY_MAX_EXCEEDED;
+			break;
+		}
+		if(ActualCommand.Type == 0)
+		{
+			if(setTMCLStatus(Evalboards.ch1.readBlock(address, BlockTransfer.data, length)) & TMC_ERROR_FUNCTION)
+				setTMCLStatus(Evalboards.ch2.readBlock(address, BlockTransfer.data, length));
+
+			blockReply((ActualReply.Status == REPLY_OK) ? length : 0);
+		}
+		else
+		{
+			if(setTMCLStatus(Evalboards.ch1.writeBlock(address, BlockTransfer.data, length)) & TMC_ERROR_FUNCTION)
+				setTMCLStatus(Evalboards.ch2.writeBlock(address, BlockTransfer.data, length));
+		}
+		ActualReply.Value.UInt32 = length;
+		break;
+	case 1: // Load 4 bytes (little endian) into the block buffer at offset <Motor> * 4
+		if(ActualCommand.Motor >= BLOCK_TRANSFER_SIZE / 4)
+		{
+			ActualReply.Status = REPLY_INVALID_VALUE;
+			break;
+		}
+		for(uint8_t i = 0; i < 4; i++)
+			BlockTransfer.data[ActualCommand.Motor * 4 + i] = BYTE(ActualCommand.Value.UInt32, i);
+		break;
+	case 3: // Block buffer size
+		ActualReply.Value.UInt32 = BLOCK_TRANSFER_SIZE;
+		break;
+	case 4: // Fetch 4 bytes (little endian) of the last block read from offset <Motor> * 4
+		if(ActualCommand.Motor * 4 >= BlockTransfer.length)
+		{
+			ActualReply.Status = REPLY_INVALID_VALUE;
+			break;
+		}
+		ActualReply.Value.UInt32 = 0;
+		for(uint8_t i = 0; i < 4; i++)
+			ActualReply.Value.UInt32 |= (uint32_t) BlockTransfer.data[ActualCommand.Motor * 4 + i] << (8 * i);
+		break;
+	case 5: // Stream mode: 1 sends block reads directly after the reply, 0 pages them with type 4. USB only.
+		if(currentInterface != 0)
+		{
+			ActualReply.Status = REPLY_INVALID_VALUE;
+			break;
+		}
+		BlockTransfer.stream = (ActualCommand.Value.UInt32) ? true : false;
+		break;
+	default:
+		ActualReply.Status = REPLY_INVALID_TYPE;
+		break;
+	}
+}
+
+static void handleLoadMonitor(void)
+{
+	switch(ActualCommand.Type)
+	{
+	case 0: // Sample motor <Motor> every <Value> µs, 0 stops sampling
+		setTMCLStatus(loadmonitor_start(ActualCommand.Motor, ActualCommand.Value.UInt32));
+		break;
+	case 1: // Set the velocity bin width, resets the statistics
+		loadmonitor_setBinWidth(ActualCommand.Value.UInt32);
+		break;
+	case 2: // Reset the statistics
+		loadmonitor_reset();
+		break;
+	case 3: // Number of samples
+		ActualReply.Value.UInt32 = LoadMonitor.stallGuard.count;
+		break;
+	case 4: // StallGuard minimum
+		ActualReply.Value.UInt32 = LoadMonitor.stallGuard.min;
+		break;
+	case 5: // StallGuard maximum
+		ActualReply.Value.UInt32 = LoadMonitor.stallGuard.max;
+		break;
+	case 6: // StallGuard average
+		ActualReply.Value.UInt32 = loadmonitor_getAverage(&LoadMonitor.stallGuard);
+		break;
+	case 7: // CoolStep minimum
+		ActualReply.Value.UInt32 = LoadMonitor.coolStep.min;
+		break;
+	case 8: // CoolStep maximum
+		ActualReply.Value.UInt32 = LoadMonitor.coolStep.max;
+		break;
+	case 9: // CoolStep average
+		ActualReply.Value.UInt32 = loadmonitor_getAverage(&LoadMonitor.coolStep);
+		break;
+	case 10: // Histogram block read (see TMCL_BlockTransfer). Returns the number of bytes.
+		blockReply(loadmonitor_getHistogram(BlockTransfer.data, BLOCK_TRANSFER_SIZE));
+		break;
+	case 11: // Number of histogram bins
+		ActualReply.Value.UInt32 = LOADMONITOR_BINS;
+		break;
+	case 12: // Sample interval [µs], 0 when stopped
+		ActualReply.Value.UInt32 = LoadMonitor.interval;
+		break;
+	case 13: // Velocity bin width
+		ActualReply.Value.UInt32 = LoadMonitor.binWidth;
+		break;
+	default:
+		ActualReply.Status = REPLY_INVALID_TYPE;
+		break;
+	}
+}
+
+// Status registers of all motors of a board, read in one go as a block read (see TMCL_BlockTransfer).
+// The reply value is the number of bytes, the layout is board specific. With stream mode on USB the
+// whole snapshot arrives with the reply, paged it takes one extra round trip per register.
+static void handleSnapshot(void)
+{
+	size_t length = 0;
+
+	// if function doesn't exist for ch1 try ch2
+	if(setTMCLStatus(Evalboards.ch1.readSnapshot(BlockTransfer.data, BLOCK_TRANSFER_SIZE, &length)) & TMC_ERROR_FUNCTION)
+	{
+		setTMCLStatus(Evalboards.ch2.readSnapshot(BlockTransfer.data, BLOCK_TRANSFER_SIZE, &length));
+	}
+
+	blockReply(length);
+}
+
+static void handleEventLog(void)
+{
+	switch(ActualCommand.Type)
+	{
+	case 0: // Entry number of the next entry
+		ActualReply.Value.UInt32 = EventLog.written;
+		break;
+	case 1: // Entries from number <Value> on as a block read (see TMCL_BlockTransfer). Returns the number of bytes.
+		blockReply(eventlog_read(ActualCommand.Value.UInt32, BlockTransfer.data, BLOCK_TRANSFER_SIZE));
+		break;
+	case 2: // Clear the log, re-arms saving after a fault
+		eventlog_clear();
+		break;
+	case 3: // Entries saved to flash after the last fault as a block read (see TMCL_BlockTransfer). Returns the number of bytes.
+		blockReply(eventlog_readPersisted(BlockTransfer.data, BLOCK_TRANSFER_SIZE));
+		break;
+	case 4: // Ring size in entries
+		ActualReply.Value.UInt32 = EVENTLOG_ENTRIES;
+		break;
+	case 5: // Write a marker entry with value <Value>, e.g. to tag a test run
+		eventlog_write(EVENTLOG_SOURCE_SYSTEM, EVENTLOG_CODE_MARKER, ActualCommand.Value.Int32);
+		break;
+	default:
+		ActualReply.Status = REPLY_INVALID_TYPE;
+		break;
+	}
+}
+
+// StallGuard homing of the StepDir generator (boards driven via Step/Dir only)
+static void handleReferenceSearch(void)
+{
+	switch(ActualCommand.Type)
+	{
+	case 0: // Start homing of StepDir channel <Motor>
+		setTMCLStatus(StepDir_homingStart(ActualCommand.Motor));
+		break;
+	case 1: // Abort homing
+		StepDir_homingStop(ActualCommand.Motor);
+		break;
+	case 2: // Homing state (StepDirHomingState)
+		ActualReply.Value.Int32 = StepDir_getHomingState(ActualCommand.Motor);
+		break;
+	case 3: // Set the seek velocity, the sign selects the homing direction
+		StepDir_setHomingVelocity(ActualCommand.Motor, ActualCommand.Value.Int32);
+		break;
+	case 4: // Set the approach velocity
+		StepDir_setHomingApproachVelocity(ActualCommand.Motor, ActualCommand.Value.Int32);
+		break;
+	case 5: // Set the back-off distance
+		StepDir_setHomingBackOff(ActualCommand.Motor, ActualCommand.Value.Int32);
+		break;
+	case 6: // Set the StallGuard velocity threshold used while homing
+		StepDir_setHomingStallGuardThreshold(ActualCommand.Motor, ActualCommand.Value.Int32);
+		break;
+	case 7: // Set the timeout [ms], 0 disables the timeout
+		StepDir_setHomingTimeout(ActualCommand.Motor, ActualCommand.Value.UInt32);
+		break;
+	case 8: // Seek velocity
+		ActualReply.Value.Int32 = StepDir_getHomingVelocity(ActualCommand.Motor);
+		break;
+	case 9: // Approach velocity
+		ActualReply.Value.Int32 = StepDir_getHomingApproachVelocity(ActualCommand.Motor);
+		break;
+	case 10: // Back-off distance
+		ActualReply.Value.Int32 = StepDir_getHomingBackOff(ActualCommand.Motor);
+		break;
+	case 11: // StallGuard velocity threshold
+		ActualReply.Value.Int32 = StepDir_getHomingStallGuardThreshold(ActualCommand.Motor);
+		break;
+	case 12: // Timeout [ms]
+		ActualReply.Value.UInt32 = StepDir_getHomingTimeout(ActualCommand.Motor);
+		break;
+	default:
+		ActualReply.Status = REPLY_INVALID_TYPE;
+		break;
+	}
+}
@@ -15,5 +15,7 @@
 void tmcl_init();
 void tmcl_process();
 void tmcl_boot();
+void tmcl_restoreGlobalParameters(void);
+bool tmcl_executeDatagram(const uint8_t *request, uint8_t *reply);
 
 #endif /* TMCL_H */
@@ -8,6 +8,7 @@
 
 
 #include "VitalSignsMonitor.h"
+#include "EventLog.h"
 
 #include "hal/derivative.h"
 #include "boards/Board.h"
@@ -30,6 +31,9 @@
 
 #define VSM_BROWNOUT_DELAY 100 // Delay (in 10ms) between voltage (re-)application and configuration restoration
 
+// Error bits which don't light up the error LED and are no fault for the event log
+#define VSM_NO_FAULT (VSM_BUSY | VSM_BUSY_CH1 | VSM_BUSY_CH2 | VSM_WARNING_CPU_SUPPLY_LOW)
+
 VitalSignsMonitorTypeDef VitalSignsMonitor =
 {
 	.brownOut   = 0,                     // motor supply to low
@@ -47,6 +51,16 @@ VitalSignsMonitorTypeDef VitalSignsMonitor =
 	#define ADC_VM_RES 4095
 #endif
 
+// Interrupt driven overvoltage supervision. The main loop check below only runs every 10ms,
+// the ADC HAL compares every VM sample against the limit and calls onVMLimit() right away.
+static volatile uint8_t vmCutoff = 0;  // set by the interrupt, cleared by the main loop once VM is back in range
+static uint32_t vmLimit = 0;           // raw ADC limit the supervision is armed with, 0: not armed
+
+static void onVMLimit(uint16_t value);
+static void updateVMSupervision(int32_t VM);
+static void logVM(uint32_t VM, uint32_t tick);
+static void logErrors(uint8_t source, uint32_t errors, uint32_t *lastErrors, uint32_t noFault, bool ready);
+
 // Make the status LED blink
 // Frequency informs about normal operation or busy state
 void heartBeat(uint32_t tick)
@@ -70,17 +84,25 @@ void checkVM()
 	static uint8_t stable = VSM_BROWNOUT_DELAY + 1; // delay value + 1 is the state during normal voltage levels - set here to prevent restore shortly after boot
 	static uint8_t vio_state = 1;
 
-	VM = *HAL.ADCs->VM;              // read ADC value for motor supply VM
+	VM = HAL.ADCs->statistics[ADC_INPUT_VM].filtered; // read filtered ADC value for motor supply VM, spikes are caught by the VM supervision
 	VM = (VM*VM_FACTOR)/ADC_VM_RES;  // calculate voltage from ADC value
 
 	VitalSignsMonitor.VM           = VM;  // write to interface
 	VitalSignsMonitor.overVoltage  = 0;   // reset overvoltage status
 	VitalSignsMonitor.brownOut     = 0;   // reset undervoltage status
 
+	logVM(VM, systick_getTick());
+
+	// A cutoff by the interrupt is checked like a measurement of the voltage that caused it,
+	// so short spikes between two checks still show up as overvoltage errors
+	int32_t peakVM = (vmCutoff) ? MAX(VM, (int32_t) VitalSignsMonitor.VMLog.cutoffVM) : VM;
+
 	// check for over/undervoltage and set according status if necessary
-	if(VM > VM_MAX_INTERFACE_BOARD)  VitalSignsMonitor.overVoltage  |= VSM_CHX;
-	if(VM >	Evalboards.ch1.VMMax)    VitalSignsMonitor.overVoltage  |= VSM_CHX | VSM_CH1;
-	if(VM >	Evalboards.ch2.VMMax)    VitalSignsMonitor.overVoltage  |= VSM_CHX | VSM_CH2;
+	if(peakVM > VM_MAX_INTERFACE_BOARD)  VitalSignsMonitor.overVoltage  |= VSM_CHX;
+	if(peakVM >	Evalboards.ch1.VMMax)    VitalSignsMonitor.overVoltage  |= VSM_CHX | VSM_CH1;
+	if(peakVM >	Evalboards.ch2.VMMax)    VitalSignsMonitor.overVoltage  |= VSM_CHX | VSM_CH2;
+
+	updateVMSupervision(VM);
 
 	// check for over/undervoltage and set according status if necessary
 	if (Evalboards.ch1.VMMin > 0)
@@ -122,6 +144,8 @@ void checkVM()
 			Evalboards.ch2.config->restore();
 			Evalboards.ch1.config->restore();
 
+			eventlog_write(EVENTLOG_SOURCE_VSM, EVENTLOG_CODE_RESTORE, VM);
+
 			stable++;
 		}
 	}
@@ -132,7 +156,12 @@ void vitalsignsmonitor_checkVitalSigns()
 {
 	int32_t errors = 0;
 	static uint32_t lastTick = 0;
+	static bool seeded = false;
+	static uint32_t lastErrors = 0;
+	static uint32_t lastErrorsCh1 = 0;
+	static uint32_t lastErrorsCh2 = 0;
 	uint32_t tick;
+	bool ready;
 
 	tick = systick_getTick();
 
@@ -182,6 +211,23 @@ void vitalsignsmonitor_checkVitalSigns()
 
 	VitalSignsMonitor.errors = errors & VitalSignsMonitor.errorMask; // write collected errors to interface
 
+	// The first check only takes over the error bits present since startup
+	if(!seeded)
+	{
+		lastErrors     = VitalSignsMonitor.errors;
+		lastErrorsCh1  = Evalboards.ch1.errors;
+		lastErrorsCh2  = Evalboards.ch2.errors;
+		seeded         = true;
+	}
+
+	// Faults only count once the boards are configured, so errors while booting
+	// or restoring (e.g. a missing motor supply) don't trigger saving the event log
+	ready = (Evalboards.ch1.config->state == CONFIG_READY) && (Evalboards.ch2.config->state == CONFIG_READY);
+
+	logErrors(EVENTLOG_SOURCE_CH1, Evalboards.ch1.errors, &lastErrorsCh1, 0, ready);
+	logErrors(EVENTLOG_SOURCE_CH2, Evalboards.ch2.errors, &lastErrorsCh2, 0, ready);
+	logErrors(EVENTLOG_SOURCE_VSM, VitalSignsMonitor.errors, &lastErrors, VSM_NO_FAULT, ready);
+
 	// disable drivers on overvoltage
 	if(errors & (VSM_ERRORS_OVERVOLTAGE | VSM_ERRORS_OVERVOLTAGE_CH1 | VSM_ERRORS_OVERVOLTAGE_CH2))
 	{
@@ -194,7 +240,7 @@ void vitalsignsmonitor_checkVitalSigns()
 	// set status LED if not in debug mode
 	if(!VitalSignsMonitor.debugMode)
 	{
-		if(VitalSignsMonitor.errors & (~(VSM_BUSY | VSM_BUSY_CH1 | VSM_BUSY_CH2 | VSM_WARNING_CPU_SUPPLY_LOW)))
+		if(VitalSignsMonitor.errors & (~VSM_NO_FAULT))
 			HAL.LEDs->error.on();
 		else
 			HAL.LEDs->error.off();
@@ -210,3 +256,114 @@ void vitalsignsmonitor_clearOvervoltageErrors()
 {
 	VitalSignsMonitor.errors &= ~(VSM_ERRORS_OVERVOLTAGE | VSM_ERRORS_OVERVOLTAGE_CH1 | VSM_ERRORS_OVERVOLTAGE_CH2);
 }
+
+void vitalsignsmonitor_resetVMLog()
+{
+	VitalSignsMonitor.VMLog.min         = 0;
+	VitalSignsMonitor.VMLog.minTick     = 0;
+	VitalSignsMonitor.VMLog.max         = 0;
+	VitalSignsMonitor.VMLog.maxTick     = 0;
+	VitalSignsMonitor.VMLog.sum         = 0;
+	VitalSignsMonitor.VMLog.count       = 0;
+	VitalSignsMonitor.VMLog.cutoffs     = 0;
+	VitalSignsMonitor.VMLog.cutoffTick  = 0;
+	VitalSignsMonitor.VMLog.cutoffVM    = 0;
+}
+
+// Average VM in [100mV] since the last log reset
+uint32_t vitalsignsmonitor_getAverageVM()
+{
+	if(VitalSignsMonitor.VMLog.count == 0)
+		return 0;
+
+	return VitalSignsMonitor.VMLog.sum / VitalSignsMonitor.VMLog.count;
+}
+
+// Called by the ADC HAL in interrupt context as soon as a VM sample exceeds the limit.
+// Only the common driver enable pin (DIO0, DRV_ENN of the evalboards) is driven here. Some boards
+// implement enableDriver() with a register write over SPI or UART, which must not run in the
+// interrupt, so the boards get disabled by checkVM() with the recorded cutoff voltage.
+// The HAL disarms the supervision until it gets armed again by updateVMSupervision().
+static void onVMLimit(uint16_t value)
+{
+	uint32_t VM = (value * VM_FACTOR) / ADC_VM_RES;
+	uint32_t tick = systick_getTick();
+
+	Evalboards.driverEnable = DRIVER_DISABLE;
+	HAL.IOs->config->setHigh(&HAL.IOs->pins->DIO0);
+
+	VitalSignsMonitor.VMLog.cutoffs++;
+	VitalSignsMonitor.VMLog.cutoffTick  = tick;
+	VitalSignsMonitor.VMLog.cutoffVM    = VM;
+
+	eventlog_write(EVENTLOG_SOURCE_VSM, EVENTLOG_CODE_VM_CUTOFF | EVENTLOG_FAULT, VM);
+
+	if(VM > VitalSignsMonitor.VMLog.max)
+	{
+		VitalSignsMonitor.VMLog.max      = VM;
+		VitalSignsMonitor.VMLog.maxTick  = tick;
+	}
+
+	vmCutoff = 1;
+}
+
+// Arms the interrupt supervision with the lowest maximum voltage of the interface board and both evalboards.
+// Called with every VM check, so board changes and recovered supply voltages are picked up.
+static void updateVMSupervision(int32_t VM)
+{
+	int32_t VMMax = MIN(VM_MAX_INTERFACE_BOARD, MIN(Evalboards.ch1.VMMax, Evalboards.ch2.VMMax));
+
+	// Highest ADC value which is still converted to VMMax or less by checkVM()
+	uint32_t limit = MIN(((((uint64_t) VMMax + 1) * ADC_VM_RES) + VM_FACTOR - 1) / VM_FACTOR - 1, ADC_VM_RES);
+
+	if(vmCutoff)
+	{
+		// Stay disarmed until VM is back in range
+		if(VM > VMMax)
+			return;
+
+		vmCutoff = 0;
+		vmLimit = 0;
+	}
+
+	if(limit == vmLimit)
+		return;
+
+	HAL.ADCs->vmLimit_callback = onVMLimit;
+	HAL.ADCs->setVMLimits(0, limit);
+	vmLimit = limit;
+}
+
+static void logVM(uint32_t VM, uint32_t tick)
+{
+	VitalSignsVMLogTypeDef *log = &VitalSignsMonitor.VMLog;
+
+	if(log->count == 0 || VM < log->min)
+	{
+		log->min      = VM;
+		log->minTick  = tick;
+	}
+
+	if(log->count == 0 || VM > log->max)
+	{
+		log->max      = VM;
+		log->maxTick  = tick;
+	}
+
+	log->sum += VM;
+	log->count++;
+}
+
+// Logs changed error bits. Newly set bits outside of <noFault> mark a fault once the boards are <ready>.
+static void logErrors(uint8_t source, uint32_t errors, uint32_t *lastErrors, uint32_t noFault, bool ready)
+{
+	if(errors == *lastErrors)
+		return;
+
+	uint8_t code = EVENTLOG_CODE_ERRORS;
+	if(ready && (errors & ~(*lastErrors) & ~noFault))
+		code |= EVENTLOG_FAULT;
+
+	eventlog_write(source, code, errors);
+	*lastErrors = errors;
+}
@@ -12,6 +12,20 @@
 
 #include "tmc/helpers/API_Header.h"
 
+// Motor supply VM history, values in [100mV], timestamps in systick [ms]
+typedef struct
+{
+	uint32_t  min;
+	uint32_t  minTick;
+	uint32_t  max;
+	uint32_t  maxTick;
+	uint64_t  sum;
+	uint32_t  count;
+	uint32_t  cutoffs;     // driver cutoffs by the interrupt driven overvoltage supervision
+	uint32_t  cutoffTick;  // time of the last cutoff
+	uint32_t  cutoffVM;    // VM that caused the last cutoff
+} VitalSignsVMLogTypeDef;
+
 typedef struct
 {
 	int8_t    debugMode;    // while debugMode is set, the error LED does not get set by VSM and status LED heartrate does not get updated
@@ -22,6 +36,7 @@ typedef struct
 	int32_t   errors;       // actual error bits
 	uint32_t  heartRate;    // status LED blinking frequency
 	uint32_t  VM;           // actual measured motor supply VM
+	VitalSignsVMLogTypeDef  VMLog;
 } VitalSignsMonitorTypeDef;
 
 extern VitalSignsMonitorTypeDef VitalSignsMonitor; // global implementation of interface for system
@@ -48,5 +63,7 @@ extern VitalSignsMonitorTypeDef VitalSignsMonitor; // global implementation of i
 
 void vitalsignsmonitor_checkVitalSigns();
 void vitalsignsmonitor_clearOvervoltageErrors();
+void vitalsignsmonitor_resetVMLog();
+uint32_t vitalsignsmonitor_getAverageVM();
 
 #endif /* VITAL_SIGNS_MONITOR_H */